@@ -1,9 +1,37 @@
 #include "mainwindow.h"
+#include "timeset/timingrulechecker.h"
 
 #include <QApplication>
+#include <QCoreApplication>
+#include <cstdio>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
 
 int main(int argc, char *argv[])
 {
+    // 命令行检查时序规则，供导出pattern前的脚本调用：VecEdit --check-timing <项目文件>
+    if (argc >= 2 && std::strcmp(argv[1], "--check-timing") == 0)
+    {
+#ifdef Q_OS_WIN
+        // 程序按窗口程序构建，从命令行启动时需要连接到父进程的控制台才能输出
+        if (AttachConsole(ATTACH_PARENT_PROCESS))
+        {
+            freopen("CONOUT$", "w", stdout);
+            freopen("CONOUT$", "w", stderr);
+        }
+#endif
+        QCoreApplication app(argc, argv);
+        if (argc < 3)
+        {
+            std::fprintf(stderr, "用法: %s --check-timing <项目文件>\n", argv[0]);
+            return 2;
+        }
+        return TimingRuleChecker::runCommandLine(QString::fromLocal8Bit(argv[2]));
+    }
+
     QApplication a(argc, argv);
     MainWindow w;
     w.show();
@@ -1,6 +1,8 @@
 #include "mainwindow.h"
 #include "database/databasemanager.h"
 #include "database/databaseviewdialog.h"
+#include "database/storagemaintenance.h"
+#include "database/storagemaintenancedialog.h"
 #include "pin/pinlistdialog.h"
 #include "timeset/timesetdialog.h"
 #include "timeset/filltimesetdialog.h"
@@ -11,7 +13,19 @@
 #include "common/dialogmanager.h"
 #include "pin/vectorpinsettingsdialog.h"
 #include "pin/pinsettingsdialog.h"
+#include "pin/pindeletioncascade.h"
 #include "vector/deleterangevectordialog.h"
+#include "vector/waveformdialog.h"
+#include "vector/vectorfindbar.h"
+#include "vector/labelnavigatordock.h"
+#include "vector/vectordiffdialog.h"
+#include "vector/vectorrepeatdialog.h"
+#include "vector/vectorvalidationdock.h"
+#include "vector/testtimeestimator.h"
+#include "vector/timeheaderview.h"
+#include "vector/pinbuscolumns.h"
+#include "vector/vectorclipboard.h"
+#include "vector/editjournal.h"
 #include "common/tablestylemanager.h"
 
 #include <QMenuBar>
@@ -48,6 +62,7 @@
 #include <QTimer>
 #include <QListWidget>
 #include <QListWidgetItem>
+#include <QSignalBlocker>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent), m_isUpdatingUI(false)
@@ -114,6 +129,74 @@ void MainWindow::setupUI()
     m_vectorTableContainer->setVisible(false);
 
     setCentralWidget(m_centralWidget);
+
+    // 标签导航停靠窗口，默认隐藏，通过"查看"菜单打开
+    m_labelDock = new LabelNavigatorDock(this);
+    addDockWidget(Qt::LeftDockWidgetArea, m_labelDock);
+    m_labelDock->hide();
+    connect(m_labelDock, &LabelNavigatorDock::labelActivated, this, &MainWindow::scrollToVectorRow);
+
+    // 表格行增删和标签编辑时增量更新标签列表
+    connect(m_vectorTableWidget->model(), &QAbstractItemModel::rowsInserted, m_labelDock, &LabelNavigatorDock::onRowsInserted);
+    connect(m_vectorTableWidget->model(), &QAbstractItemModel::rowsRemoved, m_labelDock, &LabelNavigatorDock::onRowsRemoved);
+    connect(m_itemDelegate, &QAbstractItemDelegate::commitData, this, [this](QWidget *)
+            {
+        QModelIndex index = m_vectorTableWidget->currentIndex();
+        if (index.isValid() && index.column() == 0)
+        {
+            m_labelDock->updateLabel(index.row(), index.data().toString());
+        } });
+
+    // 校验结果停靠窗口，默认隐藏，通过"工具"菜单校验时打开
+    m_validationDock = new VectorValidationDock(m_vectorTableWidget, this);
+    addDockWidget(Qt::BottomDockWidgetArea, m_validationDock);
+    m_validationDock->hide();
+    connect(m_validationDock, &VectorValidationDock::cellActivated, this, [this](int row, int column)
+            {
+        scrollToVectorRow(row);
+        if (column >= 0 && row < m_vectorTableWidget->rowCount())
+            m_vectorTableWidget->setCurrentCell(row, column); });
+
+    // 状态栏中的测试时间显示，表格内容或选区变化后合并刷新
+    m_testTimeEstimator = new TestTimeEstimator(m_vectorTableWidget, this);
+    m_testTimeLabel = new QLabel(this);
+    statusBar()->addPermanentWidget(m_testTimeLabel);
+    m_testTimeTimer = new QTimer(this);
+    m_testTimeTimer->setSingleShot(true);
+    m_testTimeTimer->setInterval(100);
+    connect(m_testTimeTimer, &QTimer::timeout, this, &MainWindow::updateTestTimeReadout);
+    connect(m_testTimeEstimator, &TestTimeEstimator::changed, m_testTimeTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+    connect(m_vectorTableWidget, &QTableWidget::itemSelectionChanged, m_testTimeTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+    connect(DatabaseManager::instance(), &DatabaseManager::timeSetPeriodChanged, m_testTimeEstimator, &TestTimeEstimator::updateTimeSetPeriod);
+
+    // 行表头可选显示每行的绝对时间
+    m_timeHeader = new TimeHeaderView(m_testTimeEstimator, m_vectorTableWidget);
+    m_timeHeader->setDefaultSectionSize(m_vectorTableWidget->verticalHeader()->defaultSectionSize());
+    m_vectorTableWidget->setVerticalHeader(m_timeHeader);
+
+    // 管脚分组的总线列
+    m_pinBusColumns = new PinBusColumns(m_vectorTableWidget, this);
+    connect(m_pinBusColumns, &PinBusColumns::editRejected, this, [this](const QString &message)
+            { statusBar()->showMessage(message, 5000); });
+
+    // 未保存编辑的日志，异常退出后可恢复
+    m_editJournal = new EditJournal(m_vectorTableWidget, this);
+
+    // 批量删除后的后台增量清理
+    m_storageTask = new StorageMaintenanceTask(this);
+    connect(m_storageTask, &StorageMaintenanceTask::finished, this, [this](bool success, const QString &message)
+            {
+                qDebug() << "MainWindow - 后台存储清理结束:" << success << message;
+                if (!message.isEmpty())
+                    statusBar()->showMessage(message, 5000); });
+
+    // 大表的剩余行在事件循环空闲时分批加载
+    m_editTriggers = m_vectorTableWidget->editTriggers();
+    m_loadingTableId = -1;
+    m_startupPhaseStart = 0;
+    m_rowLoadTimer = new QTimer(this);
+    m_rowLoadTimer->setInterval(0);
+    connect(m_rowLoadTimer, &QTimer::timeout, this, &MainWindow::loadPendingVectorRows);
 }
 
 void MainWindow::setupMenu()
@@ -143,12 +226,91 @@ void MainWindow::setupMenu()
     QAction *exitAction = fileMenu->addAction(tr("退出(&Q)"));
     connect(exitAction, &QAction::triggered, this, &QWidget::close);
 
+    // 创建编辑菜单
+    QMenu *editMenu = menuBar()->addMenu(tr("编辑(&E)"));
+
+    // 复制/粘贴向量行
+    QAction *copyAction = editMenu->addAction(tr("复制(&C)"));
+    copyAction->setShortcut(QKeySequence::Copy);
+    connect(copyAction, &QAction::triggered, this, &MainWindow::copyVectorSelection);
+
+    QAction *pasteAction = editMenu->addAction(tr("粘贴(&V)"));
+    pasteAction->setShortcut(QKeySequence::Paste);
+    connect(pasteAction, &QAction::triggered, this, &MainWindow::pasteVectorClipboard);
+
+    editMenu->addSeparator();
+
+    // 查找
+    QAction *findAction = editMenu->addAction(tr("查找(&F)"));
+    findAction->setShortcut(QKeySequence::Find);
+    connect(findAction, &QAction::triggered, this, &MainWindow::showFindBar);
+
+    // 查找下一个/上一个
+    QAction *findNextAction = editMenu->addAction(tr("查找下一个(&N)"));
+    findNextAction->setShortcut(QKeySequence::FindNext);
+    connect(findNextAction, &QAction::triggered, m_findBar, &VectorFindBar::findNext);
+
+    QAction *findPreviousAction = editMenu->addAction(tr("查找上一个(&P)"));
+    findPreviousAction->setShortcut(QKeySequence::FindPrevious);
+    connect(findPreviousAction, &QAction::triggered, m_findBar, &VectorFindBar::findPrevious);
+
+    editMenu->addSeparator();
+
+    // 跳转到时间
+    QAction *gotoTimeAction = editMenu->addAction(tr("跳转到时间(&T)..."));
+    gotoTimeAction->setShortcut(QKeySequence(tr("Ctrl+Shift+G")));
+    connect(gotoTimeAction, &QAction::triggered, this, &MainWindow::gotoTime);
+
     // 创建查看菜单
     QMenu *viewMenu = menuBar()->addMenu(tr("查看(&V)"));
 
     // 查看数据库
     QAction *viewDatabaseAction = viewMenu->addAction(tr("查看数据库(&D)"));
     connect(viewDatabaseAction, &QAction::triggered, this, &MainWindow::showDatabaseViewDialog);
+
+    // 存储维护
+    QAction *storageMaintenanceAction = viewMenu->addAction(tr("存储维护(&S)..."));
+    connect(storageMaintenanceAction, &QAction::triggered, this, &MainWindow::showStorageMaintenanceDialog);
+
+    // 查看波形图
+    QAction *viewWaveformAction = viewMenu->addAction(tr("波形图(&W)"));
+    connect(viewWaveformAction, &QAction::triggered, this, &MainWindow::showWaveformView);
+
+    // 标签导航
+    QAction *labelNavigatorAction = m_labelDock->toggleViewAction();
+    labelNavigatorAction->setText(tr("标签导航(&L)"));
+    viewMenu->addAction(labelNavigatorAction);
+
+    // 行表头显示绝对时间
+    QAction *rowTimeAction = viewMenu->addAction(tr("显示行时间(&T)"));
+    rowTimeAction->setCheckable(true);
+    connect(rowTimeAction, &QAction::toggled, m_timeHeader, &TimeHeaderView::setTimeVisible);
+
+    viewMenu->addSeparator();
+
+    // 管脚分组总线列
+    QAction *busBinaryAction = viewMenu->addAction(tr("总线以二进制显示(&B)"));
+    busBinaryAction->setCheckable(true);
+    connect(busBinaryAction, &QAction::toggled, m_pinBusColumns, &PinBusColumns::setBinaryDisplay);
+
+    QAction *busExpandAction = viewMenu->addAction(tr("展开所有总线(&E)"));
+    busExpandAction->setCheckable(true);
+    connect(busExpandAction, &QAction::toggled, m_pinBusColumns, &PinBusColumns::setAllExpanded);
+
+    // 创建工具菜单
+    QMenu *toolsMenu = menuBar()->addMenu(tr("工具(&T)"));
+
+    // 比较向量表
+    QAction *diffAction = toolsMenu->addAction(tr("比较向量表(&D)"));
+    connect(diffAction, &QAction::triggered, this, &MainWindow::showVectorDiffDialog);
+
+    // 重复检测与折叠
+    QAction *repeatAction = toolsMenu->addAction(tr("重复检测与折叠(&R)"));
+    connect(repeatAction, &QAction::triggered, this, &MainWindow::showRepeatAnalyzerDialog);
+
+    // 校验向量表
+    QAction *validateAction = toolsMenu->addAction(tr("校验向量表(&V)"));
+    connect(validateAction, &QAction::triggered, this, &MainWindow::validateCurrentVectorTable);
 }
 
 void MainWindow::createNewProject()
@@ -173,6 +335,7 @@ void MainWindow::createNewProject()
     if (DatabaseManager::instance()->initializeNewDatabase(dbPath, schemaPath))
     {
         m_currentDbPath = dbPath;
+        m_editJournal->open(dbPath);
         setWindowTitle(QString("VecEdit - 矢量测试编辑器 [%1]").arg(QFileInfo(dbPath).fileName()));
         statusBar()->showMessage(tr("数据库创建成功: %1").arg(dbPath));
 
@@ -250,10 +413,16 @@ void MainWindow::openExistingProject()
         return;
     }
 
+    // 按阶段记录打开项目的耗时，直到第一个向量表全部加载
+    m_startupTrace.start();
+    m_startupPhaseStart = 0;
+
     // 使用DatabaseManager打开数据库
     if (DatabaseManager::instance()->openExistingDatabase(dbPath))
     {
+        traceStartupPhase("打开数据库(含版本检查和升级)");
         m_currentDbPath = dbPath;
+        m_editJournal->open(dbPath);
         setWindowTitle(QString("VecEdit - 矢量测试编辑器 [%1]").arg(QFileInfo(dbPath).fileName()));
 
         // 显示当前数据库版本
@@ -263,11 +432,31 @@ void MainWindow::openExistingProject()
         // 加载向量表数据
         loadVectorTable();
 
+        // 升级等操作留下的空闲页在后台分步归还
+        compactStorageInBackground();
+
+        // 上次有未保存的编辑时切换到对应的向量表，加载时提示恢复
+        int recoverTableId = m_editJournal->recoverableTableId();
+        if (recoverTableId >= 0)
+        {
+            int comboIndex = m_vectorTableSelector->findData(recoverTableId);
+            if (comboIndex < 0)
+            {
+                qDebug() << "MainWindow::openExistingProject - 待恢复编辑的向量表已不存在，ID:" << recoverTableId;
+                m_editJournal->discardRecovery();
+            }
+            else if (comboIndex != m_vectorTableSelector->currentIndex())
+            {
+                m_vectorTableSelector->setCurrentIndex(comboIndex);
+            }
+        }
+
         QMessageBox::information(this, tr("成功"),
                                  tr("项目数据库已打开！当前版本：%1\n您可以通过\"查看\"菜单打开数据库查看器").arg(version));
     }
     else
     {
+        m_startupTrace.invalidate();
         statusBar()->showMessage(tr("错误: %1").arg(DatabaseManager::instance()->lastError()));
         QMessageBox::critical(this, tr("错误"),
                               tr("打开项目数据库失败：\n%1").arg(DatabaseManager::instance()->lastError()));
@@ -278,6 +467,21 @@ void MainWindow::closeCurrentProject()
 {
     if (!m_currentDbPath.isEmpty())
     {
+        // 停止正在进行的查找
+        m_findBar->setTableId(-1);
+        m_findBar->hide();
+        m_labelDock->setTableId(-1);
+        m_validationDock->setTableId(-1);
+        m_testTimeTimer->stop();
+        m_testTimeLabel->clear();
+
+        // 停止后台加载，关闭编辑日志，没有未保存的编辑时删除日志文件
+        m_rowLoadTimer->stop();
+        m_dataHandler->cancelPendingRows();
+        m_vectorTableWidget->setEditTriggers(m_editTriggers);
+        m_editJournal->close();
+        m_storageTask->stop();
+
         // 关闭数据库连接
         DatabaseManager::instance()->closeDatabase();
         m_currentDbPath.clear();
@@ -308,6 +512,39 @@ void MainWindow::showDatabaseViewDialog()
     m_dialogManager->showDatabaseViewDialog();
 }
 
+void MainWindow::showStorageMaintenanceDialog()
+{
+    // 检查是否有打开的数据库
+    if (m_currentDbPath.isEmpty() || !DatabaseManager::instance()->isDatabaseConnected())
+    {
+        QMessageBox::warning(this, tr("警告"), tr("请先打开或创建一个项目数据库"));
+        return;
+    }
+
+    // 非模态显示，维护在后台进行时可以继续编辑
+    StorageMaintenanceDialog *dialog = new StorageMaintenanceDialog(m_currentDbPath, this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->show();
+}
+
+void MainWindow::compactStorageInBackground()
+{
+    if (m_currentDbPath.isEmpty() || m_storageTask->isRunning())
+        return;
+
+    // 旧项目文件未启用增量清理，需要在存储维护面板中手动启用
+    QSqlDatabase db = DatabaseManager::instance()->database();
+    QSqlQuery query(db);
+    if (!query.exec("PRAGMA auto_vacuum") || !query.next() || query.value(0).toInt() != 2)
+        return;
+    if (!query.exec("PRAGMA freelist_count") || !query.next() || query.value(0).toLongLong() == 0)
+        return;
+    query.finish();
+
+    qDebug() << "MainWindow::compactStorageInBackground - 开始后台增量清理";
+    m_storageTask->start(m_currentDbPath, StorageMaintenanceWorker::IncrementalVacuum);
+}
+
 bool MainWindow::showAddPinsDialog()
 {
     // 检查是否有打开的数据库
@@ -434,6 +671,11 @@ void MainWindow::setupVectorTableUI()
     connect(m_gotoLineButton, &QPushButton::clicked, this, &MainWindow::gotoLine);
     controlLayout->addWidget(m_gotoLineButton);
 
+    // 跳转到时间按钮
+    QPushButton *gotoTimeButton = new QPushButton(tr("跳转到时间"), this);
+    connect(gotoTimeButton, &QPushButton::clicked, this, &MainWindow::gotoTime);
+    controlLayout->addWidget(gotoTimeButton);
+
     controlLayout->addSpacing(20);
 
     // 创建按钮分组4 - 向量表操作和杂项
@@ -442,6 +684,11 @@ void MainWindow::setupVectorTableUI()
     connect(addTableButton, &QPushButton::clicked, this, &MainWindow::addNewVectorTable);
     controlLayout->addWidget(addTableButton);
 
+    // 复制向量表按钮
+    QPushButton *duplicateTableButton = new QPushButton(tr("复制向量表"), this);
+    connect(duplicateTableButton, &QPushButton::clicked, this, &MainWindow::duplicateCurrentVectorTable);
+    controlLayout->addWidget(duplicateTableButton);
+
     // 删除向量表按钮
     QPushButton *deleteTableButton = new QPushButton(tr("删除向量表"), this);
     connect(deleteTableButton, &QPushButton::clicked, this, &MainWindow::deleteCurrentVectorTable);
@@ -478,11 +725,16 @@ void MainWindow::setupVectorTableUI()
     m_itemDelegate = new VectorTableItemDelegate(this);
     m_vectorTableWidget->setItemDelegate(m_itemDelegate);
 
+    // 创建查找栏，默认隐藏
+    m_findBar = new VectorFindBar(m_vectorTableWidget, this);
+    m_findBar->hide();
+
     // 创建Tab栏
     setupTabBar();
 
     // 将布局添加到容器
     containerLayout->addLayout(controlLayout);
+    containerLayout->addWidget(m_findBar);
     containerLayout->addWidget(m_vectorTableWidget);
     containerLayout->addWidget(m_vectorTabWidget);
 
@@ -550,6 +802,10 @@ void MainWindow::loadVectorTable()
 {
     qDebug() << "MainWindow::loadVectorTable - 开始加载向量表";
 
+    // 填充选择框和Tab页签期间不触发加载，填充完后只加载一次选中的表
+    QSignalBlocker selectorBlocker(m_vectorTableSelector);
+    QSignalBlocker tabBlocker(m_vectorTabWidget);
+
     // 清空当前选择框
     m_vectorTableSelector->clear();
 
@@ -574,10 +830,13 @@ void MainWindow::loadVectorTable()
         qDebug() << "MainWindow::loadVectorTable - 刷新TimeSet选项缓存";
         m_itemDelegate->refreshCache();
     }
+    traceStartupPhase("刷新代理缓存");
 
-    // 查询所有向量表
+    // 查询所有向量表及其行数，行数走(table_id, sort_index)索引计数，不读取行数据
     QSqlQuery tableQuery(db);
-    if (tableQuery.exec("SELECT id, table_name FROM vector_tables ORDER BY table_name"))
+    if (tableQuery.exec("SELECT vt.id, vt.table_name, "
+                        "(SELECT COUNT(*) FROM vector_table_data vtd WHERE vtd.table_id = vt.id) "
+                        "FROM vector_tables vt ORDER BY vt.table_name"))
     {
         qDebug() << "MainWindow::loadVectorTable - 向量表查询执行成功";
         int count = 0;
@@ -592,11 +851,16 @@ void MainWindow::loadVectorTable()
             // 添加到Tab页签
             addVectorTableTab(tableId, tableName);
 
+            QString rowInfo = QString("%1: %2 行").arg(tableName).arg(tableQuery.value(2).toInt());
+            m_vectorTableSelector->setItemData(m_vectorTableSelector->count() - 1, rowInfo, Qt::ToolTipRole);
+            m_vectorTabWidget->setTabToolTip(m_vectorTabWidget->count() - 1, rowInfo);
+
             count++;
             qDebug() << "MainWindow::loadVectorTable - 找到向量表:" << tableName << "ID:" << tableId;
         }
 
         qDebug() << "MainWindow::loadVectorTable - 总共找到" << count << "个向量表";
+        traceStartupPhase(QString("读取%1个向量表的信息").arg(count));
     }
     else
     {
@@ -612,6 +876,10 @@ void MainWindow::loadVectorTable()
 
         // 默认选择第一个表
         m_vectorTableSelector->setCurrentIndex(0);
+        m_vectorTabWidget->setCurrentIndex(0);
+        selectorBlocker.unblock();
+        tabBlocker.unblock();
+        onVectorTableSelectionChanged(0);
     }
     else
     {
@@ -638,12 +906,9 @@ void MainWindow::onVectorTableSelectionChanged(int index)
     // 同步Tab页签选择
     syncTabWithComboBox(index);
 
-    // 使用数据处理器加载数据
-    if (m_dataHandler->loadVectorTableData(tableId, m_vectorTableWidget))
+    // 使用数据处理器加载数据，先加载可见区域的行
+    if (loadVectorTableView(tableId))
     {
-        // 应用表格样式
-        TableStyleManager::applyTableStyle(m_vectorTableWidget);
-
         statusBar()->showMessage(QString("已加载向量表: %1").arg(m_vectorTableSelector->currentText()));
     }
     else
@@ -702,12 +967,9 @@ void MainWindow::onTabChanged(int index)
     {
         qDebug() << "MainWindow::onTabChanged - 加载表ID:" << tableId << "的数据";
 
-        // 使用数据处理器加载数据
-        if (m_dataHandler->loadVectorTableData(tableId, m_vectorTableWidget))
+        // 使用数据处理器加载数据，先加载可见区域的行
+        if (loadVectorTableView(tableId))
         {
-            // 应用表格样式
-            TableStyleManager::applyTableStyle(m_vectorTableWidget);
-
             // 更新状态栏
             statusBar()->showMessage(QString("已加载向量表: %1").arg(m_vectorTabWidget->tabText(index)));
 
@@ -755,6 +1017,146 @@ void MainWindow::addVectorTableTab(int tableId, const QString &tableName)
     m_tabToTableId[index] = tableId;
 }
 
+// 加载向量表到表格：表头、行数和可见区域的行立即加载，其余行在后台分批加载
+// 全部加载之前禁止编辑，依赖完整表格的功能在加载完成后再设置
+bool MainWindow::loadVectorTableView(int tableId)
+{
+    m_rowLoadTimer->stop();
+    m_editJournal->stop();
+    m_pinBusColumns->clear();
+    m_vectorTableWidget->setEditTriggers(m_editTriggers);
+
+    // 查找栏和停靠窗口在加载完成后才切换到新表，加载期间不能再指向上一个表的行
+    m_findBar->setTableId(-1);
+    m_labelDock->setTableId(-1);
+    m_validationDock->setTableId(-1);
+
+    int rowHeight = qMax(1, m_vectorTableWidget->verticalHeader()->defaultSectionSize());
+    int visibleRows = m_vectorTableWidget->viewport()->height() / rowHeight + 1;
+    int initialRows = qMax(visibleRows * 2, int(INITIAL_LOAD_ROWS));
+
+    if (!m_dataHandler->loadVectorTableData(tableId, m_vectorTableWidget, initialRows))
+        return false;
+
+    m_loadingTableId = tableId;
+    traceStartupPhase(QString("加载表头和前%1行").arg(qMin(initialRows, m_vectorTableWidget->rowCount())));
+
+    if (m_dataHandler->hasPendingRows())
+    {
+        m_vectorTableWidget->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        m_rowLoadTimer->start();
+    }
+    else
+    {
+        finishVectorTableLoad();
+    }
+    return true;
+}
+
+void MainWindow::loadPendingVectorRows()
+{
+    m_dataHandler->loadPendingRows(m_vectorTableWidget, VectorDataHandler::LOAD_CHUNK_ROWS);
+    if (m_dataHandler->hasPendingRows())
+    {
+        statusBar()->showMessage(QString("正在加载向量表: %1/%2 行")
+                                     .arg(m_dataHandler->loadedRowCount())
+                                     .arg(m_dataHandler->pendingTotalRows()));
+        return;
+    }
+
+    m_rowLoadTimer->stop();
+    finishVectorTableLoad();
+    statusBar()->showMessage(QString("向量表已全部加载: %1 行").arg(m_vectorTableWidget->rowCount()));
+}
+
+// 需要完整表格的操作之前调用：立即加载剩余的行
+void MainWindow::ensureVectorTableLoaded()
+{
+    if (!m_rowLoadTimer->isActive())
+        return;
+
+    m_rowLoadTimer->stop();
+    m_dataHandler->loadAllPendingRows(m_vectorTableWidget);
+    finishVectorTableLoad();
+}
+
+void MainWindow::finishVectorTableLoad()
+{
+    int tableId = m_loadingTableId;
+    m_vectorTableWidget->setEditTriggers(m_editTriggers);
+    m_pinBusColumns->setTableId(tableId);
+
+    // 应用表格样式
+    TableStyleManager::applyTableStyle(m_vectorTableWidget);
+    m_findBar->setTableId(tableId);
+    m_labelDock->setTableId(tableId);
+    m_validationDock->setTableId(tableId);
+    m_testTimeEstimator->reloadTimeSets();
+    traceStartupPhase(QString("加载全部%1行").arg(m_vectorTableWidget->rowCount()));
+    m_startupTrace.invalidate();
+
+    // 样式设置完后再开始记录编辑
+    startEditJournal(tableId);
+}
+
+void MainWindow::traceStartupPhase(const QString &phase)
+{
+    if (!m_startupTrace.isValid())
+        return;
+
+    qint64 now = m_startupTrace.elapsed();
+    qDebug().noquote() << QString("MainWindow::openExistingProject - [打开项目] %1: %2 毫秒 (累计 %3 毫秒)")
+                              .arg(phase)
+                              .arg(now - m_startupPhaseStart)
+                              .arg(now);
+    m_startupPhaseStart = now;
+}
+
+// 向量表加载后开始记录编辑日志，该表有上次未保存的编辑时提示恢复
+void MainWindow::startEditJournal(int tableId)
+{
+    m_editJournal->start(tableId);
+    if (m_editJournal->recoverableTableId() != tableId)
+        return;
+
+    QMessageBox::StandardButton reply = QMessageBox::question(this, "恢复编辑",
+                                                              "该向量表有上次未保存的编辑(程序异常退出或关闭前未保存)，是否恢复？\n"
+                                                              "选择\"否\"将丢弃这些编辑。",
+                                                              QMessageBox::Yes | QMessageBox::No, QMessageBox::Yes);
+    if (reply != QMessageBox::Yes)
+    {
+        m_editJournal->discardRecovery();
+        return;
+    }
+
+    QString errorMessage;
+    int applied = m_editJournal->replayRecovery(errorMessage);
+    if (applied < 0)
+    {
+        QMessageBox::warning(this, "恢复编辑", errorMessage);
+        return;
+    }
+    statusBar()->showMessage(QString("已恢复 %1 条未保存的编辑，请检查后保存").arg(applied));
+}
+
+bool MainWindow::saveUnsavedEditsBefore(const QString &action)
+{
+    if (!m_editJournal->hasUnsavedEdits())
+        return true;
+
+    QMessageBox::StandardButton reply = QMessageBox::question(this, "未保存的修改",
+                                                              QString("当前向量表有未保存的修改，%1会重新加载表格。\n"
+                                                                      "是否先保存这些修改？")
+                                                                  .arg(action),
+                                                              QMessageBox::Save | QMessageBox::Cancel, QMessageBox::Save);
+    if (reply != QMessageBox::Save)
+        return false;
+
+    // 保存成功后编辑日志被清空
+    saveVectorTableData();
+    return !m_editJournal->hasUnsavedEdits();
+}
+
 // 保存向量表数据
 void MainWindow::saveVectorTableData()
 {
@@ -769,10 +1171,14 @@ void MainWindow::saveVectorTableData()
     // 获取表ID
     int tableId = m_vectorTableSelector->currentData().toInt();
 
+    // 保存会重写整个表，必须先加载全部行
+    ensureVectorTableLoaded();
+
     // 使用数据处理器保存数据
     QString errorMessage;
     if (m_dataHandler->saveVectorTableData(tableId, m_vectorTableWidget, errorMessage))
     {
+        m_editJournal->markSaved();
         QMessageBox::information(this, "保存成功", "向量表数据已成功保存");
         statusBar()->showMessage("向量表数据已成功保存");
     }
@@ -930,6 +1336,72 @@ void MainWindow::addRowToCurrentVectorTable()
     }
 }
 
+// 复制当前选中的向量表，数据在数据库内复制，不经过表格
+void MainWindow::duplicateCurrentVectorTable()
+{
+    // 检查是否有选中的向量表
+    if (m_vectorTableSelector->count() == 0 || m_vectorTableSelector->currentIndex() < 0)
+    {
+        QMessageBox::warning(this, "警告", "请先选择一个向量表");
+        return;
+    }
+
+    int sourceTableId = m_vectorTableSelector->currentData().toInt();
+    QString sourceTableName = m_vectorTableSelector->currentText();
+
+    bool ok;
+    QString tableName = QInputDialog::getText(this, "复制向量表",
+                                              "新向量表名称(复制项目中已保存的数据):",
+                                              QLineEdit::Normal, sourceTableName + "_副本", &ok)
+                            .trimmed();
+    if (!ok)
+    {
+        return;
+    }
+    if (tableName.isEmpty())
+    {
+        QMessageBox::warning(this, "错误", "向量表名称不能为空");
+        return;
+    }
+
+    // 检查名称是否已存在
+    QSqlDatabase db = DatabaseManager::instance()->database();
+    QSqlQuery checkQuery(db);
+    checkQuery.prepare("SELECT COUNT(*) FROM vector_tables WHERE LOWER(table_name) = LOWER(?)");
+    checkQuery.addBindValue(tableName);
+    if (checkQuery.exec() && checkQuery.next() && checkQuery.value(0).toInt() > 0)
+    {
+        QMessageBox::warning(this, "错误", "已存在同名向量表");
+        return;
+    }
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    int newTableId = -1;
+    QString errorMessage;
+    bool success = m_dataHandler->duplicateVectorTable(sourceTableId, tableName, newTableId, errorMessage);
+    QApplication::restoreOverrideCursor();
+
+    if (!success)
+    {
+        QMessageBox::critical(this, "复制失败", errorMessage);
+        statusBar()->showMessage("复制向量表失败: " + errorMessage);
+        return;
+    }
+
+    qDebug() << "MainWindow::duplicateCurrentVectorTable - 已复制向量表" << sourceTableName << "为" << tableName << "，ID:" << newTableId;
+
+    // 添加到下拉框和Tab页签并选中
+    m_vectorTableSelector->addItem(tableName, newTableId);
+    addVectorTableTab(newTableId, tableName);
+    int newIndex = m_vectorTableSelector->findData(newTableId);
+    if (newIndex >= 0)
+    {
+        m_vectorTableSelector->setCurrentIndex(newIndex);
+    }
+
+    statusBar()->showMessage(QString("已将向量表 \"%1\" 复制为 \"%2\"").arg(sourceTableName, tableName));
+}
+
 // 删除当前选中的向量表
 void MainWindow::deleteCurrentVectorTable()
 {
@@ -994,6 +1466,9 @@ void MainWindow::deleteCurrentVectorTable()
 
         // 重新加载向量表列表
         loadVectorTable();
+
+        // 删除的行和管脚值留下的空闲页在后台归还
+        compactStorageInBackground();
     }
     else
     {
@@ -1310,9 +1785,27 @@ void MainWindow::fillTimeSetForVectorTable(int timeSetId, const QList<int> &sele
             throw std::runtime_error(errorText.toStdString());
         }
 
-        // 重新加载表格数据
-        onVectorTableSelectionChanged(currentIndex);
-        qDebug() << "填充TimeSet - 已重新加载表格数据";
+        // 直接更新表格中的TimeSet列，不重新加载整个表，测试时间统计随之增量更新
+        // 数据库已经提交，这些单元格不记入编辑日志
+        QList<int> rowsToUpdate = selectedUiRows;
+        if (rowsToUpdate.isEmpty())
+        {
+            for (int row = 0; row < m_vectorTableWidget->rowCount(); ++row)
+                rowsToUpdate.append(row);
+        }
+        m_editJournal->setPaused(true);
+        for (int row : rowsToUpdate)
+        {
+            if (row < 0 || row >= m_vectorTableWidget->rowCount())
+                continue;
+            QTableWidgetItem *item = m_vectorTableWidget->item(row, 2);
+            if (item)
+                item->setText(timeSetName);
+            else
+                m_vectorTableWidget->setItem(row, 2, new QTableWidgetItem(timeSetName));
+        }
+        m_editJournal->setPaused(false);
+        qDebug() << "填充TimeSet - 已更新表格中的" << rowsToUpdate.size() << "行";
 
         // 显示成功消息
         QMessageBox::information(this, tr("成功"), tr("TimeSet填充完成"));
@@ -1544,9 +2037,28 @@ void MainWindow::replaceTimeSetForVectorTable(int fromTimeSetId, int toTimeSetId
             throw std::runtime_error(errorText.toStdString());
         }
 
-        // 重新加载表格数据
-        onVectorTableSelectionChanged(currentIndex);
-        qDebug() << "替换TimeSet - 已重新加载表格数据";
+        // 直接更新表格中匹配源TimeSet的单元格，不重新加载整个表
+        QList<int> rowsToCheck = selectedUiRows;
+        if (rowsToCheck.isEmpty())
+        {
+            for (int row = 0; row < m_vectorTableWidget->rowCount(); ++row)
+                rowsToCheck.append(row);
+        }
+        int replacedRows = 0;
+        m_editJournal->setPaused(true);
+        for (int row : rowsToCheck)
+        {
+            if (row < 0 || row >= m_vectorTableWidget->rowCount())
+                continue;
+            QTableWidgetItem *item = m_vectorTableWidget->item(row, 2);
+            if (item && item->text() == fromTimeSetName)
+            {
+                item->setText(toTimeSetName);
+                replacedRows++;
+            }
+        }
+        m_editJournal->setPaused(false);
+        qDebug() << "替换TimeSet - 已更新表格中的" << replacedRows << "行";
 
         // 显示成功消息
         QMessageBox::information(this, tr("成功"), tr("TimeSet替换完成"));
@@ -1635,7 +2147,7 @@ void MainWindow::refreshVectorTableData()
     QString tableName = m_vectorTableSelector->currentText();
 
     // 使用数据处理器重新加载数据
-    if (m_dataHandler->loadVectorTableData(tableId, m_vectorTableWidget))
+    if (loadVectorTableView(tableId))
     {
         statusBar()->showMessage(QString("已刷新向量表: %1").arg(tableName));
     }
@@ -1826,6 +2338,7 @@ void MainWindow::deleteVectorRowsInRange()
 
             // 刷新表格
             onVectorTableSelectionChanged(m_vectorTableSelector->currentIndex());
+            compactStorageInBackground();
 
             qDebug() << "MainWindow::deleteVectorRowsInRange - 成功删除指定范围内的行";
         }
@@ -1991,6 +2504,7 @@ void MainWindow::deletePins()
         QListWidgetItem *item = new QListWidgetItem(pinName, pinList);
         item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
         item->setCheckState(Qt::Unchecked);
+        item->setData(Qt::UserRole, pinId);
 
         pinMap[pinList->count() - 1] = pinName;
     }
@@ -2019,13 +2533,13 @@ void MainWindow::deletePins()
     if (dialog.exec() == QDialog::Accepted)
     {
         // 获取选中的管脚
-        QStringList pinsToDelete;
+        QList<int> pinsToDelete;
         for (int i = 0; i < pinList->count(); ++i)
         {
             QListWidgetItem *item = pinList->item(i);
             if (item->checkState() == Qt::Checked)
             {
-                pinsToDelete << item->text();
+                pinsToDelete << item->data(Qt::UserRole).toInt();
             }
         }
 
@@ -2037,76 +2551,32 @@ void MainWindow::deletePins()
             return;
         }
 
-        // 确认删除
-        QMessageBox::StandardButton reply;
-        reply = QMessageBox::question(this, "确认删除",
-                                      "确定要删除选中的 " + QString::number(pinsToDelete.size()) + " 个管脚吗？\n"
-                                                                                                   "此操作将影响所有使用这些管脚的向量表，且不可撤销。",
-                                      QMessageBox::Yes | QMessageBox::No);
-
-        if (reply == QMessageBox::No)
+        // 删除后会重新加载当前表并清空编辑日志，未保存的修改要先保存
+        if (!saveUnsavedEditsBefore("删除管脚"))
         {
-            qDebug() << "MainWindow::deletePins - 用户取消删除操作";
+            qDebug() << "MainWindow::deletePins - 未保存的修改未处理，取消删除";
             return;
         }
 
-        // 执行删除操作
-        db.transaction();
-        bool success = true;
+        // 先统计各表受影响的行数由用户确认，再在一个事务中按集合删除管脚及其所有依赖数据
+        PinDeletionCascade cascade(db);
+        PinDeletionCounts counts;
         QString errorMsg;
-
-        for (const QString &pinName : pinsToDelete)
+        auto confirmDeletion = [this](const PinDeletionCounts &affected)
         {
-            // 首先获取管脚ID
-            QSqlQuery idQuery(db);
-            idQuery.prepare("SELECT id FROM pin_list WHERE pin_name = ?");
-            idQuery.addBindValue(pinName);
-
-            if (idQuery.exec() && idQuery.next())
-            {
-                int pinId = idQuery.value(0).toInt();
+            QMessageBox::StandardButton reply = QMessageBox::question(this, "确认删除",
+                                                                      "将删除以下数据：\n" + affected.summary() +
+                                                                          "\n\n此操作将影响所有使用这些管脚的向量表，且不可撤销。",
+                                                                      QMessageBox::Yes | QMessageBox::No,
+                                                                      QMessageBox::No);
+            return reply == QMessageBox::Yes;
+        };
+        bool success = cascade.deletePins(pinsToDelete, confirmDeletion, counts, errorMsg);
 
-                // 删除向量表与管脚的关联
-                QSqlQuery deleteRelationQuery(db);
-                deleteRelationQuery.prepare("DELETE FROM vector_table_pins WHERE pin_id = ?");
-                deleteRelationQuery.addBindValue(pinId);
-
-                if (!deleteRelationQuery.exec())
-                {
-                    success = false;
-                    errorMsg = deleteRelationQuery.lastError().text();
-                    qDebug() << "MainWindow::deletePins - 删除管脚关联失败:" << errorMsg;
-                    break;
-                }
-
-                // 删除管脚本身
-                QSqlQuery deletePinQuery(db);
-                deletePinQuery.prepare("DELETE FROM pin_list WHERE id = ?");
-                deletePinQuery.addBindValue(pinId);
-
-                if (!deletePinQuery.exec())
-                {
-                    success = false;
-                    errorMsg = deletePinQuery.lastError().text();
-                    qDebug() << "MainWindow::deletePins - 删除管脚失败:" << errorMsg;
-                    break;
-                }
-            }
-            else
-            {
-                success = false;
-                errorMsg = idQuery.lastError().text();
-                qDebug() << "MainWindow::deletePins - 查询管脚ID失败:" << errorMsg;
-                break;
-            }
-        }
-
-        // 提交或回滚事务
         if (success)
         {
-            db.commit();
-            QMessageBox::information(this, "成功", "已成功删除 " + QString::number(pinsToDelete.size()) + " 个管脚");
-            qDebug() << "MainWindow::deletePins - 成功删除" << pinsToDelete.size() << "个管脚";
+            QMessageBox::information(this, "成功", "已成功删除 " + QString::number(counts.pins) + " 个管脚");
+            qDebug() << "MainWindow::deletePins - 成功删除" << counts.pins << "个管脚";
 
             // 刷新当前向量表（如果有）
             if (m_vectorTableSelector->count() > 0 && m_vectorTableSelector->currentIndex() >= 0)
@@ -2114,9 +2584,12 @@ void MainWindow::deletePins()
                 onVectorTableSelectionChanged(m_vectorTableSelector->currentIndex());
             }
         }
+        else if (errorMsg.isEmpty())
+        {
+            qDebug() << "MainWindow::deletePins - 用户取消删除操作";
+        }
         else
         {
-            db.rollback();
             QMessageBox::critical(this, "错误", "删除管脚失败: " + errorMsg);
             qDebug() << "MainWindow::deletePins - 删除失败，已回滚事务";
         }
@@ -2218,6 +2691,290 @@ void MainWindow::gotoLine()
     }
 }
 
+void MainWindow::scrollToVectorRow(int row)
+{
+    if (row < 0 || row >= m_vectorTableWidget->rowCount())
+        return;
+
+    m_vectorTableWidget->clearSelection();
+    m_vectorTableWidget->selectRow(row);
+    m_vectorTableWidget->scrollTo(m_vectorTableWidget->model()->index(row, 0), QAbstractItemView::PositionAtCenter);
+    statusBar()->showMessage(tr("已跳转到第 %1 行").arg(row + 1));
+}
+
+void MainWindow::showWaveformView()
+{
+    qDebug() << "MainWindow::showWaveformView - 显示波形图";
+
+    // 检查是否有打开的数据库
+    if (m_currentDbPath.isEmpty() || !DatabaseManager::instance()->isDatabaseConnected())
+    {
+        QMessageBox::warning(this, "警告", "请先打开或创建一个项目数据库");
+        return;
+    }
+
+    // 检查是否有选中的向量表
+    if (m_vectorTableSelector->count() == 0 || m_vectorTableSelector->currentIndex() < 0)
+    {
+        QMessageBox::warning(this, "警告", "请先选择一个向量表");
+        return;
+    }
+
+    int tableId = m_vectorTableSelector->currentData().toInt();
+    QString tableName = m_vectorTableSelector->currentText();
+
+    // 非模态窗口，便于和向量表对照查看
+    WaveformDialog *dialog = new WaveformDialog(tableId, tableName, this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+
+    // 双击波形时跳转到向量表对应行
+    connect(dialog, &WaveformDialog::rowActivated, this, &MainWindow::scrollToVectorRow);
+
+    // 打开时定位到当前选中的行
+    int currentRow = m_vectorTableWidget->currentRow();
+    dialog->show();
+    if (currentRow >= 0)
+    {
+        dialog->showRow(currentRow);
+    }
+}
+
+void MainWindow::showVectorDiffDialog()
+{
+    qDebug() << "MainWindow::showVectorDiffDialog - 显示向量表比较窗口";
+
+    // 检查是否有打开的数据库
+    if (m_currentDbPath.isEmpty() || !DatabaseManager::instance()->isDatabaseConnected())
+    {
+        QMessageBox::warning(this, "警告", "请先打开或创建一个项目数据库");
+        return;
+    }
+
+    int tableId = m_vectorTableSelector->currentIndex() >= 0 ? m_vectorTableSelector->currentData().toInt() : -1;
+
+    // 非模态窗口，比较在后台线程进行
+    VectorDiffDialog *dialog = new VectorDiffDialog(m_currentDbPath, tableId, this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->show();
+}
+
+void MainWindow::showRepeatAnalyzerDialog()
+{
+    qDebug() << "MainWindow::showRepeatAnalyzerDialog - 显示重复检测窗口";
+
+    // 检查是否有打开的数据库
+    if (m_currentDbPath.isEmpty() || !DatabaseManager::instance()->isDatabaseConnected())
+    {
+        QMessageBox::warning(this, "警告", "请先打开或创建一个项目数据库");
+        return;
+    }
+
+    // 检查是否有选中的向量表
+    if (m_vectorTableSelector->count() == 0 || m_vectorTableSelector->currentIndex() < 0)
+    {
+        QMessageBox::warning(this, "警告", "请先选择一个向量表");
+        return;
+    }
+
+    int tableId = m_vectorTableSelector->currentData().toInt();
+    QString tableName = m_vectorTableSelector->currentText();
+
+    VectorRepeatDialog *dialog = new VectorRepeatDialog(m_currentDbPath, tableId, tableName, this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    connect(dialog, &VectorRepeatDialog::rowActivated, this, &MainWindow::scrollToVectorRow);
+
+    // 折叠当前表之前处理表格中未保存的编辑，否则重新加载时会丢失，之后再保存也会覆盖折叠结果
+    dialog->setBeforeFoldCheck([this, tableId]()
+                               { return m_vectorTableSelector->currentData().toInt() != tableId ||
+                                        saveUnsavedEditsBefore("折叠"); });
+
+    // 折叠后如果仍是当前表则重新加载
+    connect(dialog, &VectorRepeatDialog::tableFolded, this, [this](int foldedTableId)
+            {
+        if (m_vectorTableSelector->currentData().toInt() == foldedTableId)
+            onVectorTableSelectionChanged(m_vectorTableSelector->currentIndex()); });
+    dialog->show();
+}
+
+void MainWindow::validateCurrentVectorTable()
+{
+    // 检查是否有打开的数据库
+    if (m_currentDbPath.isEmpty() || !DatabaseManager::instance()->isDatabaseConnected())
+    {
+        QMessageBox::warning(this, "警告", "请先打开或创建一个项目数据库");
+        return;
+    }
+
+    // 检查是否有选中的向量表
+    if (m_vectorTableSelector->count() == 0 || m_vectorTableSelector->currentIndex() < 0)
+    {
+        QMessageBox::warning(this, "警告", "请先选择一个向量表");
+        return;
+    }
+
+    ensureVectorTableLoaded();
+
+    m_validationDock->show();
+    m_validationDock->raise();
+    m_validationDock->validateAll();
+}
+
+void MainWindow::copyVectorSelection()
+{
+    if (m_vectorTableWidget->rowCount() <= 0)
+        return;
+
+    ensureVectorTableLoaded();
+
+    QString errorMessage;
+    int rows = VectorClipboard::copySelection(m_vectorTableWidget, errorMessage);
+    if (rows < 0)
+    {
+        statusBar()->showMessage(errorMessage, 5000);
+        return;
+    }
+
+    statusBar()->showMessage(QString("已复制 %1 行").arg(rows));
+}
+
+void MainWindow::pasteVectorClipboard()
+{
+    // 检查是否有打开的数据库
+    if (m_currentDbPath.isEmpty() || !DatabaseManager::instance()->isDatabaseConnected())
+    {
+        QMessageBox::warning(this, "警告", "请先打开或创建一个项目数据库");
+        return;
+    }
+
+    // 检查是否有选中的向量表
+    if (m_vectorTableSelector->count() == 0 || m_vectorTableSelector->currentIndex() < 0)
+    {
+        QMessageBox::warning(this, "警告", "请先选择一个向量表");
+        return;
+    }
+
+    ensureVectorTableLoaded();
+
+    QString errorMessage;
+    int rows = VectorClipboard::paste(m_vectorTableWidget, errorMessage);
+    if (rows < 0)
+    {
+        QMessageBox::warning(this, "粘贴失败", errorMessage);
+        return;
+    }
+
+    statusBar()->showMessage(QString("已粘贴 %1 行，保存后写入数据库").arg(rows));
+    qDebug() << "MainWindow::pasteVectorClipboard - 已粘贴" << rows << "行";
+}
+
+void MainWindow::gotoTime()
+{
+    qDebug() << "MainWindow::gotoTime - 开始跳转到指定时间";
+
+    // 检查是否有打开的数据库
+    if (m_currentDbPath.isEmpty() || !DatabaseManager::instance()->isDatabaseConnected())
+    {
+        QMessageBox::warning(this, "警告", "请先打开或创建一个项目数据库");
+        return;
+    }
+
+    // 检查是否有选中的向量表
+    if (m_vectorTableSelector->count() == 0 || m_vectorTableSelector->currentIndex() < 0)
+    {
+        QMessageBox::warning(this, "警告", "请先选择一个向量表");
+        return;
+    }
+
+    if (m_vectorTableWidget->rowCount() <= 0)
+    {
+        QMessageBox::warning(this, "警告", "当前向量表没有数据");
+        return;
+    }
+
+    ensureVectorTableLoaded();
+
+    double totalTime = m_testTimeEstimator->totalTime();
+    bool ok = false;
+    QString text = QInputDialog::getText(this, "跳转到时间",
+                                         QString("请输入时间，可带单位ns/us/ms/s，默认ns (总时间 %1):")
+                                             .arg(TestTimeEstimator::formatTime(totalTime)),
+                                         QLineEdit::Normal, QString(), &ok);
+    if (!ok || text.trimmed().isEmpty())
+    {
+        qDebug() << "MainWindow::gotoTime - 用户取消了跳转";
+        return;
+    }
+
+    double timeNs = TestTimeEstimator::parseTime(text, &ok);
+    if (!ok || timeNs < 0)
+    {
+        QMessageBox::warning(this, "错误", "无效的时间: " + text);
+        return;
+    }
+
+    int row = m_testTimeEstimator->rowAtTime(timeNs);
+    if (row < 0)
+    {
+        QMessageBox::warning(this, "错误", QString("时间 %1 超出测试总时间 %2")
+                                             .arg(TestTimeEstimator::formatTime(timeNs))
+                                             .arg(TestTimeEstimator::formatTime(totalTime)));
+        return;
+    }
+
+    scrollToVectorRow(row);
+    statusBar()->showMessage(QString("时间 %1 位于第 %2 行(该行开始于 %3)")
+                                 .arg(TestTimeEstimator::formatTime(timeNs))
+                                 .arg(row + 1)
+                                 .arg(TestTimeEstimator::formatTime(m_testTimeEstimator->rowStartTime(row))));
+    qDebug() << "MainWindow::gotoTime - 时间" << timeNs << "ns 对应第" << row + 1 << "行";
+}
+
+void MainWindow::updateTestTimeReadout()
+{
+    if (m_currentDbPath.isEmpty() || m_vectorTableSelector->currentIndex() < 0)
+    {
+        m_testTimeLabel->clear();
+        return;
+    }
+
+    QString text = QString("测试时间: %1 (%2 周期)")
+                       .arg(TestTimeEstimator::formatTime(m_testTimeEstimator->totalTime()))
+                       .arg(m_testTimeEstimator->totalCycles());
+
+    // 有选区时同时显示选中部分
+    QList<QTableWidgetSelectionRange> ranges = m_vectorTableWidget->selectedRanges();
+    if (!ranges.isEmpty())
+    {
+        int rows = 0;
+        qint64 cycles = 0;
+        double time = 0.0;
+        m_testTimeEstimator->selectionTotals(ranges, rows, cycles, time);
+        text += QString("  |  选中 %1 行: %2 (%3 周期)").arg(rows).arg(TestTimeEstimator::formatTime(time)).arg(cycles);
+    }
+
+    m_testTimeLabel->setText(text);
+}
+
+void MainWindow::showFindBar()
+{
+    // 检查是否有打开的数据库
+    if (m_currentDbPath.isEmpty() || !DatabaseManager::instance()->isDatabaseConnected())
+    {
+        QMessageBox::warning(this, "警告", "请先打开或创建一个项目数据库");
+        return;
+    }
+
+    // 检查是否有选中的向量表
+    if (m_vectorTableSelector->count() == 0 || m_vectorTableSelector->currentIndex() < 0)
+    {
+        QMessageBox::warning(this, "警告", "请先选择一个向量表");
+        return;
+    }
+
+    m_findBar->setTableId(m_vectorTableSelector->currentData().toInt());
+    m_findBar->activate();
+}
+
 // 字体缩放滑块值改变响应
 void MainWindow::onFontZoomSliderValueChanged(int value)
 {
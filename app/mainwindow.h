@@ -16,12 +16,22 @@
 #include <QTabWidget>
 #include <QListWidget>
 #include <QListWidgetItem>
+#include <QTimer>
+#include <QElapsedTimer>
 #include "../common/tablestylemanager.h"
 
 // 前置声明
 class VectorTableItemDelegate;
 class VectorDataHandler;
 class DialogManager;
+class VectorFindBar;
+class LabelNavigatorDock;
+class VectorValidationDock;
+class TestTimeEstimator;
+class TimeHeaderView;
+class PinBusColumns;
+class EditJournal;
+class StorageMaintenanceTask;
 
 class MainWindow : public QMainWindow
 {
@@ -43,6 +53,9 @@ private slots:
     // 显示数据库视图对话框
     void showDatabaseViewDialog();
 
+    // 显示存储维护面板
+    void showStorageMaintenanceDialog();
+
     // 显示添加管脚对话框
     bool showAddPinsDialog();
 
@@ -85,6 +98,9 @@ private slots:
     // 为当前选中的向量表添加行
     void addRowToCurrentVectorTable();
 
+    // 复制当前选中的向量表
+    void duplicateCurrentVectorTable();
+
     // 删除当前选中的向量表
     void deleteCurrentVectorTable();
 
@@ -117,6 +133,34 @@ private slots:
     // 跳转到指定行
     void gotoLine();
 
+    // 跳转到指定时间所在的行
+    void gotoTime();
+
+    // 复制选中的向量数据/从剪贴板粘贴
+    void copyVectorSelection();
+    void pasteVectorClipboard();
+
+    // 显示当前向量表的波形图
+    void showWaveformView();
+
+    // 显示查找栏
+    void showFindBar();
+
+    // 比较两个向量表
+    void showVectorDiffDialog();
+
+    // 检测并折叠当前向量表中的重复行
+    void showRepeatAnalyzerDialog();
+
+    // 校验当前向量表
+    void validateCurrentVectorTable();
+
+    // 刷新状态栏中的测试时间
+    void updateTestTimeReadout();
+
+    // 后台分批加载向量表的剩余行
+    void loadPendingVectorRows();
+
     void onFontZoomSliderValueChanged(int value);
     void onFontZoomReset();
     void closeTab(int index);
@@ -131,6 +175,28 @@ private:
     void syncTabWithComboBox(int comboBoxIndex);
     void syncComboBoxWithTab(int tabIndex);
 
+    // 选中并滚动到向量表指定行(0-based)
+    void scrollToVectorRow(int row);
+
+    // 加载向量表到表格，可见区域之外的行在后台加载
+    bool loadVectorTableView(int tableId);
+    void finishVectorTableLoad();
+
+    // 立即加载剩余的行，需要完整表格的操作之前调用
+    void ensureVectorTableLoaded();
+
+    // 打开项目时记录一个阶段的耗时
+    void traceStartupPhase(const QString &phase);
+
+    // 向量表加载后开始记录编辑日志，必要时恢复上次未保存的编辑
+    void startEditJournal(int tableId);
+
+    // 当前表格有未保存的编辑时提示先保存，action为即将进行的操作；返回false表示取消或保存失败
+    bool saveUnsavedEditsBefore(const QString &action);
+
+    // 批量删除后在后台分步归还空闲页，仅对增量清理模式的项目文件生效
+    void compactStorageInBackground();
+
     // 当前项目的数据库路径
     QString m_currentDbPath;
 
@@ -151,6 +217,24 @@ private:
     QPushButton *m_deleteRangeButton; // 删除指定范围内的向量行按钮
     QPushButton *m_gotoLineButton;    // 跳转到某行按钮
     QPushButton *m_addGroupButton;    // 添加管脚分组按钮
+    VectorFindBar *m_findBar;         // 查找栏
+    LabelNavigatorDock *m_labelDock;  // 标签导航停靠窗口
+    VectorValidationDock *m_validationDock; // 校验结果停靠窗口
+    TestTimeEstimator *m_testTimeEstimator; // 测试时间估算
+    QLabel *m_testTimeLabel;                // 状态栏中的测试时间
+    QTimer *m_testTimeTimer;                // 合并刷新测试时间显示
+    TimeHeaderView *m_timeHeader;           // 可显示行时间的行表头
+    PinBusColumns *m_pinBusColumns;         // 管脚分组的总线列
+    EditJournal *m_editJournal;             // 未保存编辑的日志
+    StorageMaintenanceTask *m_storageTask;  // 批量删除后的后台增量清理
+
+    // 打开项目时先加载的最少行数，其余行在后台加载
+    static const int INITIAL_LOAD_ROWS = 200;
+    QTimer *m_rowLoadTimer;                          // 后台分批加载剩余行
+    int m_loadingTableId;                            // 正在加载/已加载的向量表
+    QAbstractItemView::EditTriggers m_editTriggers; // 加载完成后恢复的编辑触发方式
+    QElapsedTimer m_startupTrace;                    // 打开项目的阶段耗时
+    qint64 m_startupPhaseStart;
 
     // Tab页签组件
     QTabWidget *m_vectorTabWidget;
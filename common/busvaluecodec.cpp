@@ -0,0 +1,184 @@
+#include "busvaluecodec.h"
+
+#include <QVarLengthArray>
+
+namespace
+{
+    // 每64位一个字：value为1的位，unknown为不确定的位；第i个成员(共n个)对应第n-1-i位
+    typedef QVarLengthArray<quint64, 2> BitWords;
+
+    inline void setBit(BitWords &words, int bit)
+    {
+        words[bit / 64] |= quint64(1) << (bit % 64);
+    }
+
+    inline bool testBit(const BitWords &words, int bit)
+    {
+        return (words[bit / 64] >> (bit % 64)) & 1;
+    }
+
+    void clearWords(BitWords &words, int bits)
+    {
+        int count = (bits + 63) / 64;
+        words.resize(count);
+        for (int w = 0; w < count; ++w)
+        {
+            words[w] = 0;
+        }
+    }
+
+    void pack(const QString &states, BitWords &value, BitWords &unknown)
+    {
+        int bits = states.size();
+        clearWords(value, bits);
+        clearWords(unknown, bits);
+
+        for (int i = 0; i < bits; ++i)
+        {
+            QChar state = states.at(i).toUpper();
+            int bit = bits - 1 - i;
+            if (state == '1' || state == 'H')
+                setBit(value, bit);
+            else if (state != '0' && state != 'L')
+                setBit(unknown, bit);
+        }
+    }
+
+    // 去掉前缀和分隔符，前缀决定进制
+    QString normalize(const QString &text, bool &binary)
+    {
+        QString result = text.trimmed().toUpper();
+        result.remove('_');
+        if (result.startsWith("0X"))
+        {
+            binary = false;
+            result = result.mid(2);
+        }
+        else if (result.startsWith("0B"))
+        {
+            binary = true;
+            result = result.mid(2);
+        }
+        return result;
+    }
+}
+
+QString BusValueCodec::format(const QString &states, bool binary)
+{
+    int bits = states.size();
+    if (bits == 0)
+        return QString();
+
+    BitWords value;
+    BitWords unknown;
+    pack(states, value, unknown);
+
+    if (binary)
+    {
+        QString text(bits, QChar('0'));
+        for (int bit = 0; bit < bits; ++bit)
+        {
+            QChar c = testBit(unknown, bit) ? QChar('X') : (testBit(value, bit) ? QChar('1') : QChar('0'));
+            text[bits - 1 - bit] = c;
+        }
+        return text;
+    }
+
+    // 每次从字中取4位组成一个十六进制数字(4整除64，一个数字不会跨字)
+    static const char digits[] = "0123456789ABCDEF";
+    int nibbles = (bits + 3) / 4;
+    QString text(nibbles, QChar('0'));
+    for (int n = 0; n < nibbles; ++n)
+    {
+        int word = (n * 4) / 64;
+        int shift = (n * 4) % 64;
+        int nibble = int((value[word] >> shift) & 0xF);
+        bool isUnknown = ((unknown[word] >> shift) & 0xF) != 0;
+        text[nibbles - 1 - n] = isUnknown ? QChar('X') : QChar(digits[nibble]);
+    }
+    return text;
+}
+
+bool BusValueCodec::parse(const QString &text, int bits, bool binary, QString &states, QString &errorMessage)
+{
+    QString digitsText = normalize(text, binary);
+    if (digitsText.isEmpty())
+    {
+        errorMessage = "总线值不能为空";
+        return false;
+    }
+
+    BitWords value;
+    BitWords unknown;
+    clearWords(value, bits);
+    clearWords(unknown, bits);
+
+    int bitsPerDigit = binary ? 1 : 4;
+    for (int d = 0; d < digitsText.size(); ++d)
+    {
+        QChar c = digitsText.at(digitsText.size() - 1 - d);
+        bool isUnknown = (c == 'X');
+        int digit = 0;
+        if (!isUnknown)
+        {
+            bool ok = false;
+            digit = QString(c).toInt(&ok, binary ? 2 : 16);
+            if (!ok)
+            {
+                errorMessage = QString("无效的%1字符: %2").arg(binary ? "二进制" : "十六进制").arg(c);
+                return false;
+            }
+        }
+
+        for (int t = 0; t < bitsPerDigit; ++t)
+        {
+            int bit = d * bitsPerDigit + t;
+            bool isSet = (digit >> t) & 1;
+            if (bit >= bits)
+            {
+                // 超出宽度的位只允许为0(最高位数字不满4位时的X也忽略)
+                if (isSet)
+                {
+                    errorMessage = QString("总线值超出 %1 位宽度").arg(bits);
+                    return false;
+                }
+                continue;
+            }
+            if (isUnknown)
+                setBit(unknown, bit);
+            else if (isSet)
+                setBit(value, bit);
+        }
+    }
+
+    states = QString(bits, QChar('0'));
+    for (int bit = 0; bit < bits; ++bit)
+    {
+        if (testBit(unknown, bit))
+            states[bits - 1 - bit] = QChar('X');
+        else if (testBit(value, bit))
+            states[bits - 1 - bit] = QChar('1');
+    }
+    return true;
+}
+
+bool BusValueCodec::matches(const QString &groupLevel, const QString &states)
+{
+    QString upper = groupLevel.trimmed().toUpper();
+    bool hexPrefix = upper.startsWith("0X");
+    bool binaryPrefix = upper.startsWith("0B");
+
+    bool binary = false;
+    QString text = normalize(groupLevel, binary);
+    if (text.isEmpty() || states.isEmpty())
+        return false;
+
+    // 不带前缀时两种进制都比较，高位补0后比较
+    int bits = states.size();
+    int nibbles = (bits + 3) / 4;
+    if (!binaryPrefix && text.size() <= nibbles && format(states, false) == text.rightJustified(nibbles, '0'))
+        return true;
+    if (!hexPrefix && text.size() <= bits && format(states, true) == text.rightJustified(bits, '0'))
+        return true;
+    return false;
+}
@@ -0,0 +1,21 @@
+#ifndef BUSVALUECODEC_H
+#define BUSVALUECODEC_H
+
+#include <QString>
+
+// 管脚分组(总线)值的编解码：成员管脚状态按位打包后格式化为十六进制/二进制，或从总线值解析出每个成员的状态
+// 成员状态字符串每个字符对应一个成员管脚，第一个字符为最高位；1/H为1，0/L为0，其他(X/Z等)为不确定
+class BusValueCodec
+{
+public:
+    // 把成员状态格式化为总线值，有不确定位的十六进制数字或二进制位显示为X
+    static QString format(const QString &states, bool binary);
+
+    // 解析总线值为bits个成员状态(0/1/X)，支持0x/0b前缀和_分隔，位数不足时高位补0
+    static bool parse(const QString &text, int bits, bool binary, QString &states, QString &errorMessage);
+
+    // 分组值是否与成员状态推导出的值相同(十六进制或二进制均可)
+    static bool matches(const QString &groupLevel, const QString &states);
+};
+
+#endif // BUSVALUECODEC_H
@@ -1,4 +1,7 @@
 #include "databasemanager.h"
+#include "common/busvaluecodec.h"
+#include <QRegularExpression>
+#include <QSet>
 
 // 静态实例初始化为nullptr
 DatabaseManager *DatabaseManager::m_instance = nullptr;
@@ -39,13 +42,6 @@ bool DatabaseManager::initializeNewDatabase(const QString &dbFilePath, const QSt
         return false;
     }
 
-    // 读取schema文件
-    QString schemaContent = readSqlScriptFromFile(schemaFilePath);
-    if (schemaContent.isEmpty())
-    {
-        return false; // 错误信息已在readSqlScriptFromFile中设置
-    }
-
     // 确保数据库文件所在的目录存在
     QDir dir = QFileInfo(dbFilePath).dir();
     if (!dir.exists())
@@ -58,6 +54,21 @@ bool DatabaseManager::initializeNewDatabase(const QString &dbFilePath, const QSt
         }
     }
 
+    // 优先复制内嵌的模板数据库，表结构、默认数据和版本都已建好
+    if (createFromTemplate(dbFilePath))
+    {
+        m_currentVersion = LATEST_VERSION;
+        qInfo() << "数据库已从模板创建: " << dbFilePath;
+        return true;
+    }
+
+    // 模板不可用时按schema.sql逐条创建
+    QString schemaContent = readSqlScriptFromFile(schemaFilePath);
+    if (schemaContent.isEmpty())
+    {
+        return false; // 错误信息已在readSqlScriptFromFile中设置
+    }
+
     // 创建数据库连接
     m_db = QSqlDatabase::addDatabase("QSQLITE");
     m_db.setDatabaseName(dbFilePath);
@@ -70,6 +81,13 @@ bool DatabaseManager::initializeNewDatabase(const QString &dbFilePath, const QSt
         return false;
     }
 
+    // 增量清理模式只能在建表之前设置，之后删除数据留下的空闲页可以在后台分步归还
+    QSqlQuery vacuumQuery(m_db);
+    if (!vacuumQuery.exec("PRAGMA auto_vacuum = INCREMENTAL"))
+    {
+        qWarning() << "DatabaseManager::initializeNewDatabase - 设置增量清理模式失败:" << vacuumQuery.lastError().text();
+    }
+
     // 执行schema脚本
     if (!executeSqlScript(schemaContent))
     {
@@ -87,9 +105,9 @@ bool DatabaseManager::initializeNewDatabase(const QString &dbFilePath, const QSt
         return false;
     }
 
-    // 设置初始版本
+    // 设置初始版本，新建的数据库直接是最新版本
     QSqlQuery query(m_db);
-    if (!query.exec("INSERT INTO " + VERSION_TABLE + " (version) VALUES (1)"))
+    if (!query.exec(QString("INSERT INTO %1 (version) VALUES (%2)").arg(VERSION_TABLE).arg(LATEST_VERSION)))
     {
         m_lastError = QString("无法设置初始数据库版本: %1").arg(query.lastError().text());
         qCritical() << m_lastError;
@@ -108,11 +126,60 @@ bool DatabaseManager::initializeNewDatabase(const QString &dbFilePath, const QSt
         return false;
     }
 
-    m_currentVersion = 1;
+    m_currentVersion = LATEST_VERSION;
     qInfo() << "数据库已成功初始化: " << dbFilePath;
     return true;
 }
 
+bool DatabaseManager::createFromTemplate(const QString &dbFilePath)
+{
+    if (!QFile::copy(TEMPLATE_RESOURCE, dbFilePath))
+    {
+        qWarning() << "DatabaseManager::createFromTemplate - 无法复制模板数据库:" << TEMPLATE_RESOURCE;
+        return false;
+    }
+
+    // 从资源复制出来的文件是只读的
+    QFile::setPermissions(dbFilePath, QFile::ReadOwner | QFile::WriteOwner | QFile::ReadGroup | QFile::ReadOther);
+
+    m_db = QSqlDatabase::addDatabase("QSQLITE");
+    m_db.setDatabaseName(dbFilePath);
+    if (!m_db.open())
+    {
+        qWarning() << "DatabaseManager::createFromTemplate - 无法打开模板副本:" << m_db.lastError().text();
+        closeDatabase();
+        QFile::remove(dbFilePath);
+        return false;
+    }
+
+    // 模板与程序版本不一致(修改了表结构但没有重新生成模板)时不使用
+    int templateVersion = 0;
+    {
+        QSqlQuery versionQuery(m_db);
+        if (versionQuery.exec("SELECT MAX(version) FROM " + VERSION_TABLE) && versionQuery.next())
+        {
+            templateVersion = versionQuery.value(0).toInt();
+        }
+    }
+    if (templateVersion != LATEST_VERSION)
+    {
+        qWarning() << "DatabaseManager::createFromTemplate - 模板版本" << templateVersion
+                   << "与程序版本" << LATEST_VERSION << "不一致，改用schema.sql创建";
+        closeDatabase();
+        QFile::remove(dbFilePath);
+        return false;
+    }
+
+    // 版本记录的时间改为项目的创建时间
+    QSqlQuery query(m_db);
+    if (!query.exec("UPDATE " + VERSION_TABLE + " SET updated_at = CURRENT_TIMESTAMP"))
+    {
+        qWarning() << "DatabaseManager::createFromTemplate - 更新版本时间失败:" << query.lastError().text();
+    }
+
+    return true;
+}
+
 bool DatabaseManager::openExistingDatabase(const QString &dbFilePath)
 {
     // 检查文件是否存在
@@ -184,6 +251,30 @@ bool DatabaseManager::openExistingDatabase(const QString &dbFilePath)
         }
     }
 
+    // 补建索引失败不影响打开，只是查找等操作会变慢
+    if (!createIndexesIfNotExists())
+    {
+        qWarning() << "DatabaseManager::openExistingDatabase - 补建索引失败:" << m_lastError;
+    }
+
+    // 版本2起分组值由成员管脚推导，清理旧版本逐行保存的分组值；失败不影响打开，下次打开时重试
+    if (m_currentVersion < 2 && !migrateGroupValues())
+    {
+        qWarning() << "DatabaseManager::openExistingDatabase - 迁移分组值失败:" << m_lastError;
+    }
+
+    // 版本3起TimeSet使用计数由触发器维护，旧项目需要建表并统计一次现有的行
+    if (m_currentVersion == 2 && !migrateTimeSetUsage())
+    {
+        qWarning() << "DatabaseManager::openExistingDatabase - 建立TimeSet使用计数失败:" << m_lastError;
+    }
+
+    // 版本4起不再有vector_data/timeset_pins表，旧数据一次性转换到当前的表
+    if (m_currentVersion == 3 && !migrateLegacyTables())
+    {
+        qWarning() << "DatabaseManager::openExistingDatabase - 转换旧版本数据失败:" << m_lastError;
+    }
+
     qInfo() << "数据库已成功打开: " << dbFilePath << "，当前版本: " << m_currentVersion;
     return true;
 }
@@ -320,18 +411,44 @@ bool DatabaseManager::executeSqlScript(const QString &scriptContent)
     // 将脚本分割成单独的SQL语句
     QStringList statements = scriptContent.split(';', Qt::SkipEmptyParts);
 
+    // 触发器体内的语句也以分号结尾，拼接到END为止再整体执行
+    QString pendingTrigger;
     for (const QString &statement : statements)
     {
         QString trimmedStatement = statement.trimmed();
-        if (!trimmedStatement.isEmpty())
+        if (trimmedStatement.isEmpty())
+        {
+            continue;
+        }
+
+        if (pendingTrigger.isEmpty() && !trimmedStatement.contains(QRegularExpression("\\bCREATE\\s+TRIGGER\\b", QRegularExpression::CaseInsensitiveOption)))
         {
             if (!executeQuery(trimmedStatement))
             {
                 return false; // 错误信息已在executeQuery中设置
             }
+            continue;
+        }
+
+        pendingTrigger += trimmedStatement + ";\n";
+        if (trimmedStatement.compare("END", Qt::CaseInsensitive) == 0)
+        {
+            pendingTrigger.chop(2);
+            if (!executeQuery(pendingTrigger))
+            {
+                return false;
+            }
+            pendingTrigger.clear();
         }
     }
 
+    if (!pendingTrigger.isEmpty())
+    {
+        m_lastError = "SQL脚本中的触发器缺少END";
+        qWarning() << m_lastError;
+        return false;
+    }
+
     return true;
 }
 
@@ -400,6 +517,324 @@ bool DatabaseManager::createVersionTableIfNotExists()
     return true;
 }
 
+bool DatabaseManager::createIndexesIfNotExists()
+{
+    if (!isDatabaseConnected())
+    {
+        m_lastError = "数据库未连接";
+        qWarning() << m_lastError;
+        return false;
+    }
+
+    // 与schema.sql中的索引定义保持一致
+    const QStringList statements = {
+        "CREATE INDEX IF NOT EXISTS idx_vector_table_data_sort ON vector_table_data(table_id, sort_index)",
+        "CREATE INDEX IF NOT EXISTS idx_vector_table_data_label ON vector_table_data(table_id, label, sort_index) WHERE label <> ''",
+        "CREATE INDEX IF NOT EXISTS idx_vector_table_data_comment ON vector_table_data(table_id, comment, sort_index) WHERE comment <> ''",
+        "CREATE INDEX IF NOT EXISTS idx_timeset_settings_timeset ON timeset_settings(timeset_id, pin_id)"};
+
+    for (const QString &statement : statements)
+    {
+        if (!executeQuery(statement))
+        {
+            return false; // 错误信息已在executeQuery中设置
+        }
+    }
+
+    return true;
+}
+
+bool DatabaseManager::migrateGroupValues()
+{
+    QSqlQuery query(m_db);
+    int removedRows = 0;
+
+    m_db.transaction();
+    try
+    {
+        // 1. 向量行已删除的孤立分组值
+        if (!query.exec("DELETE FROM vector_table_group_values "
+                        "WHERE vector_data_id NOT IN (SELECT id FROM vector_table_data)"))
+        {
+            throw QString("删除孤立的分组值失败: %1").arg(query.lastError().text());
+        }
+        removedRows += query.numRowsAffected();
+
+        // 2. 与成员管脚推导出的值相同的分组值，只保留无法推导的分组级覆盖值
+        if (!query.exec("SELECT gv.id, gv.group_level, po.pin_value "
+                        "FROM vector_table_group_values gv "
+                        "JOIN pin_groups pg ON pg.group_id = gv.group_id "
+                        "JOIN pin_group_members pgm ON pgm.group_id = gv.group_id "
+                        "JOIN vector_table_pins vtp ON vtp.table_id = pg.table_id AND vtp.pin_id = pgm.pin_id "
+                        "LEFT JOIN vector_table_pin_values vtpv "
+                        "ON vtpv.vector_data_id = +gv.vector_data_id AND vtpv.vector_pin_id = +vtp.id "
+                        "LEFT JOIN pin_options po ON po.id = vtpv.pin_level "
+                        "ORDER BY gv.id, pgm.sort_index, pgm.id"))
+        {
+            throw QString("查询分组值失败: %1").arg(query.lastError().text());
+        }
+
+        QList<int> redundantIds;
+        int currentId = -1;
+        QString currentLevel;
+        QString states; // 成员管脚状态，第一个成员为最高位
+        while (query.next())
+        {
+            int id = query.value(0).toInt();
+            if (id != currentId)
+            {
+                if (currentId >= 0 && BusValueCodec::matches(currentLevel, states))
+                    redundantIds.append(currentId);
+                currentId = id;
+                currentLevel = query.value(1).toString();
+                states.clear();
+            }
+
+            QString pinValue = query.value(2).toString();
+            states += pinValue.isEmpty() ? QChar('X') : pinValue.at(0);
+        }
+        if (currentId >= 0 && BusValueCodec::matches(currentLevel, states))
+            redundantIds.append(currentId);
+
+        // 分批删除，避免单条语句的参数过多
+        const int batchSize = 500;
+        for (int i = 0; i < redundantIds.size(); i += batchSize)
+        {
+            QStringList ids;
+            for (int j = i; j < qMin(i + batchSize, redundantIds.size()); ++j)
+            {
+                ids << QString::number(redundantIds[j]);
+            }
+            if (!query.exec(QString("DELETE FROM vector_table_group_values WHERE id IN (%1)").arg(ids.join(","))))
+            {
+                throw QString("删除冗余的分组值失败: %1").arg(query.lastError().text());
+            }
+        }
+        removedRows += redundantIds.size();
+
+        if (!query.exec(QString("INSERT INTO %1 (version) VALUES (2)").arg(VERSION_TABLE)))
+        {
+            throw QString("无法更新数据库版本: %1").arg(query.lastError().text());
+        }
+
+        m_db.commit();
+    }
+    catch (const QString &error)
+    {
+        m_db.rollback();
+        m_lastError = error;
+        qCritical() << "DatabaseManager::migrateGroupValues -" << m_lastError;
+        return false;
+    }
+
+    m_currentVersion = 2;
+
+    // 删除的行留下的空闲页不在这里整库VACUUM(会阻塞打开项目)，
+    // 增量清理模式的项目在打开后由后台分步归还，其余项目可在存储维护面板中压缩
+    qInfo() << "DatabaseManager::migrateGroupValues - 已升级到版本2，删除分组值行数:" << removedRows;
+    return true;
+}
+
+bool DatabaseManager::migrateTimeSetUsage()
+{
+    QSqlQuery query(m_db);
+
+    // 与schema.sql中的timeset_usage表和触发器定义保持一致
+    const QStringList statements = {
+        "CREATE TABLE IF NOT EXISTS timeset_usage("
+        "timeset_id INTEGER NOT NULL, table_id INTEGER NOT NULL, row_count INTEGER NOT NULL DEFAULT 0, "
+        "PRIMARY KEY (timeset_id, table_id)) WITHOUT ROWID",
+        "CREATE TRIGGER IF NOT EXISTS trg_timeset_usage_insert AFTER INSERT ON vector_table_data "
+        "BEGIN "
+        "INSERT OR IGNORE INTO timeset_usage (timeset_id, table_id, row_count) VALUES (NEW.timeset_id, NEW.table_id, 0); "
+        "UPDATE timeset_usage SET row_count = row_count + 1 WHERE timeset_id = NEW.timeset_id AND table_id = NEW.table_id; "
+        "END",
+        "CREATE TRIGGER IF NOT EXISTS trg_timeset_usage_delete AFTER DELETE ON vector_table_data "
+        "BEGIN "
+        "UPDATE timeset_usage SET row_count = row_count - 1 WHERE timeset_id = OLD.timeset_id AND table_id = OLD.table_id; "
+        "DELETE FROM timeset_usage WHERE timeset_id = OLD.timeset_id AND table_id = OLD.table_id AND row_count <= 0; "
+        "END",
+        "CREATE TRIGGER IF NOT EXISTS trg_timeset_usage_update AFTER UPDATE OF timeset_id, table_id ON vector_table_data "
+        "WHEN OLD.timeset_id IS NOT NEW.timeset_id OR OLD.table_id IS NOT NEW.table_id "
+        "BEGIN "
+        "UPDATE timeset_usage SET row_count = row_count - 1 WHERE timeset_id = OLD.timeset_id AND table_id = OLD.table_id; "
+        "DELETE FROM timeset_usage WHERE timeset_id = OLD.timeset_id AND table_id = OLD.table_id AND row_count <= 0; "
+        "INSERT OR IGNORE INTO timeset_usage (timeset_id, table_id, row_count) VALUES (NEW.timeset_id, NEW.table_id, 0); "
+        "UPDATE timeset_usage SET row_count = row_count + 1 WHERE timeset_id = NEW.timeset_id AND table_id = NEW.table_id; "
+        "END"};
+
+    m_db.transaction();
+    try
+    {
+        for (const QString &statement : statements)
+        {
+            if (!query.exec(statement))
+            {
+                throw QString("创建TimeSet使用计数表失败: %1").arg(query.lastError().text());
+            }
+        }
+
+        // 触发器和全量统计在同一事务中，统计期间不会漏掉或重复计算行
+        if (!query.exec("DELETE FROM timeset_usage") ||
+            !query.exec("INSERT INTO timeset_usage (timeset_id, table_id, row_count) "
+                        "SELECT timeset_id, table_id, COUNT(*) FROM vector_table_data GROUP BY timeset_id, table_id"))
+        {
+            throw QString("统计TimeSet使用次数失败: %1").arg(query.lastError().text());
+        }
+
+        if (!query.exec(QString("INSERT INTO %1 (version) VALUES (3)").arg(VERSION_TABLE)))
+        {
+            throw QString("无法更新数据库版本: %1").arg(query.lastError().text());
+        }
+
+        m_db.commit();
+    }
+    catch (const QString &error)
+    {
+        m_db.rollback();
+        m_lastError = error;
+        qCritical() << "DatabaseManager::migrateTimeSetUsage -" << m_lastError;
+        return false;
+    }
+
+    m_currentVersion = 3;
+    qInfo() << "DatabaseManager::migrateTimeSetUsage - 已升级到版本3";
+    return true;
+}
+
+bool DatabaseManager::migrateLegacyTables()
+{
+    QSqlQuery query(m_db);
+    QSet<QString> legacyTables;
+    if (query.exec("SELECT name FROM sqlite_master WHERE type = 'table' AND name IN ('vector_data', 'timeset_pins')"))
+    {
+        while (query.next())
+            legacyTables.insert(query.value(0).toString());
+    }
+
+    int migratedRows = 0;
+    m_db.transaction();
+    try
+    {
+        if (legacyTables.contains("vector_data"))
+        {
+            // 新行的指令和缺省管脚值按名称查找ID，不依赖选项表中的ID顺序
+            QSqlQuery lookupQuery(m_db);
+            lookupQuery.prepare("SELECT id FROM instruction_options WHERE instruction_value = ?");
+            lookupQuery.addBindValue("INC");
+            if (!lookupQuery.exec() || !lookupQuery.next())
+            {
+                throw QString("指令表中缺少INC，无法转换vector_data");
+            }
+            const int incInstructionId = lookupQuery.value(0).toInt();
+
+            lookupQuery.prepare("SELECT id FROM pin_options WHERE pin_value = ?");
+            lookupQuery.addBindValue("X");
+            if (!lookupQuery.exec() || !lookupQuery.next())
+            {
+                throw QString("管脚状态表中缺少X，无法转换vector_data");
+            }
+            const int xPinOptionId = lookupQuery.value(0).toInt();
+            lookupQuery.finish();
+
+            // 旧表按(table_id, row_id, pin_id)逐格保存；整体转换，不逐行处理
+            // 1. 每个旧行对应一个新行，排在该向量表现有行之后；seq按(table_id, row_id)顺序递增，
+            //    减去该表的最小seq得到从0开始的连续序号，旧row_id不从0开始或不连续时sort_index也没有空隙
+            // 新行的Capture与保存向量表时一样写0(未捕获)
+            const QStringList statements = {
+                "CREATE TEMP TABLE legacy_rows (seq INTEGER PRIMARY KEY, table_id INTEGER, row_id INTEGER, "
+                "sort_index INTEGER, data_id INTEGER)",
+                "INSERT INTO legacy_rows (table_id, row_id) "
+                "SELECT DISTINCT table_id, row_id FROM vector_data "
+                "WHERE table_id IN (SELECT id FROM vector_tables) "
+                "ORDER BY table_id, row_id",
+                "CREATE INDEX temp.idx_legacy_rows ON legacy_rows(table_id, row_id)",
+                "CREATE INDEX temp.idx_legacy_rows_seq ON legacy_rows(table_id, seq)",
+                "UPDATE legacy_rows SET sort_index = "
+                "(SELECT COALESCE(MAX(v.sort_index) + 1, 0) FROM vector_table_data v WHERE v.table_id = legacy_rows.table_id) + "
+                "seq - (SELECT MIN(l.seq) FROM legacy_rows l WHERE l.table_id = legacy_rows.table_id)",
+
+                // 旧数据没有TimeSet，使用第一个TimeSet；没有TimeSet时建一个
+                "INSERT INTO timeset_list (timeset_name, period) "
+                "SELECT 'TS_LEGACY', 100 WHERE EXISTS (SELECT 1 FROM legacy_rows) "
+                "AND NOT EXISTS (SELECT 1 FROM timeset_list)",
+
+                QString("INSERT INTO vector_table_data (table_id, label, instruction_id, timeset_id, capture, ext, comment, sort_index) "
+                        "SELECT table_id, '', %1, (SELECT MIN(id) FROM timeset_list), 0, '', '', sort_index "
+                        "FROM legacy_rows ORDER BY seq")
+                    .arg(incInstructionId),
+                "UPDATE legacy_rows SET data_id = (SELECT v.id FROM vector_table_data v "
+                "WHERE v.table_id = legacy_rows.table_id AND v.sort_index = legacy_rows.sort_index)",
+
+                // 2. 旧数据中用到但向量表还没有引用的管脚
+                "INSERT OR IGNORE INTO vector_table_pins (table_id, pin_id) "
+                "SELECT DISTINCT vd.table_id, vd.pin_id FROM vector_data vd "
+                "WHERE vd.table_id IN (SELECT id FROM vector_tables) AND vd.pin_id IN (SELECT id FROM pin_list)",
+
+                // 3. 管脚值：旧值转换为pin_options ID，无效值和缺少的管脚为X
+                QString("INSERT OR REPLACE INTO vector_table_pin_values (vector_data_id, vector_pin_id, pin_level) "
+                        "SELECT lr.data_id, vtp.id, COALESCE(po.id, %1) FROM vector_data vd "
+                        "JOIN legacy_rows lr ON lr.table_id = vd.table_id AND lr.row_id = vd.row_id "
+                        "JOIN vector_table_pins vtp ON vtp.table_id = vd.table_id AND vtp.pin_id = vd.pin_id "
+                        "LEFT JOIN pin_options po ON po.pin_value = vd.pin_value")
+                    .arg(xPinOptionId),
+                QString("INSERT OR IGNORE INTO vector_table_pin_values (vector_data_id, vector_pin_id, pin_level) "
+                        "SELECT lr.data_id, vtp.id, %1 FROM legacy_rows lr "
+                        "JOIN vector_table_pins vtp ON vtp.table_id = lr.table_id")
+                    .arg(xPinOptionId)};
+
+            for (const QString &statement : statements)
+            {
+                if (!query.exec(statement))
+                {
+                    throw QString("转换vector_data失败: %1").arg(query.lastError().text());
+                }
+            }
+
+            if (query.exec("SELECT COUNT(*) FROM legacy_rows") && query.next())
+                migratedRows = query.value(0).toInt();
+
+            if (!query.exec("DROP TABLE legacy_rows") || !query.exec("DROP TABLE vector_data"))
+            {
+                throw QString("删除旧的vector_data表失败: %1").arg(query.lastError().text());
+            }
+        }
+
+        if (legacyTables.contains("timeset_pins"))
+        {
+            // 旧的管脚关联转换为默认边沿参数，已有边沿的管脚保持不变
+            if (!query.exec("INSERT INTO timeset_settings (timeset_id, pin_id, T1R, T1F, STBR, wave_id) "
+                            "SELECT DISTINCT tp.timeset_id, tp.pin_id, 250, 750, 500, 1 FROM timeset_pins tp "
+                            "WHERE tp.timeset_id IN (SELECT id FROM timeset_list) AND tp.pin_id IN (SELECT id FROM pin_list) "
+                            "AND NOT EXISTS (SELECT 1 FROM timeset_settings ts "
+                            "WHERE ts.timeset_id = tp.timeset_id AND ts.pin_id = tp.pin_id)") ||
+                !query.exec("DROP TABLE timeset_pins"))
+            {
+                throw QString("转换timeset_pins失败: %1").arg(query.lastError().text());
+            }
+        }
+
+        if (!query.exec(QString("INSERT INTO %1 (version) VALUES (4)").arg(VERSION_TABLE)))
+        {
+            throw QString("无法更新数据库版本: %1").arg(query.lastError().text());
+        }
+
+        m_db.commit();
+    }
+    catch (const QString &error)
+    {
+        m_db.rollback();
+        query.exec("DROP TABLE IF EXISTS temp.legacy_rows");
+        m_lastError = error;
+        qCritical() << "DatabaseManager::migrateLegacyTables -" << m_lastError;
+        return false;
+    }
+
+    m_currentVersion = 4;
+    qInfo() << "DatabaseManager::migrateLegacyTables - 已升级到版本4，转换的旧向量行数:" << migratedRows;
+    return true;
+}
+
 bool DatabaseManager::initializeDefaultData()
 {
     if (!isDatabaseConnected())
@@ -20,7 +20,7 @@ public:
     static DatabaseManager *instance();
     ~DatabaseManager();
 
-    // 初始化新数据库（从schema.sql创建）
+    // 初始化新数据库（复制内嵌模板，模板不可用时从schema.sql创建）
     bool initializeNewDatabase(const QString &dbFilePath, const QString &schemaFilePath);
 
     // 打开现有数据库连接
@@ -53,6 +53,10 @@ public:
     // 初始化固定表的默认数据
     bool initializeDefaultData();
 
+signals:
+    // TimeSet周期已修改，供测试时间等统计更新
+    void timeSetPeriodChanged(int timeSetId, double period);
+
 private:
     // 私有构造函数（单例模式的一部分）
     explicit DatabaseManager(QObject *parent = nullptr);
@@ -67,6 +71,21 @@ private:
     // 创建版本表如果不存在
     bool createVersionTableIfNotExists();
 
+    // 复制内嵌的模板数据库创建新项目，模板版本不是最新时返回false
+    bool createFromTemplate(const QString &dbFilePath);
+
+    // 为旧版本创建的数据库补建索引
+    bool createIndexesIfNotExists();
+
+    // 升级到版本2：删除可由成员管脚推导的分组值，只保留分组级覆盖值
+    bool migrateGroupValues();
+
+    // 升级到版本3：建立由触发器维护的TimeSet使用计数表
+    bool migrateTimeSetUsage();
+
+    // 升级到版本4：把旧版本的vector_data/timeset_pins表转换到当前的存储后删除
+    bool migrateLegacyTables();
+
     // 初始化特定表的固定数据
     bool initializeInstructionOptions();
     bool initializePinOptions();
@@ -87,6 +106,12 @@ private:
 
     // 数据库版本表名
     QString VERSION_TABLE = "db_version";
+
+    // 程序使用的最新数据库版本
+    static const int LATEST_VERSION = 4;
+
+    // 内嵌的模板数据库(由schema.sql和默认数据生成，版本为LATEST_VERSION)
+    const QString TEMPLATE_RESOURCE = ":/resources/db/template.db";
 };
 
 #endif // DATABASEMANAGER_H
\ No newline at end of file
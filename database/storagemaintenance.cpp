@@ -0,0 +1,306 @@
+#include "storagemaintenance.h"
+
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QThread>
+#include <QHash>
+#include <QStringList>
+#include <QFileInfo>
+#include <QDebug>
+
+namespace
+{
+    qint64 pragmaValue(QSqlDatabase &db, const QString &pragma)
+    {
+        QSqlQuery query(db);
+        if (query.exec("PRAGMA " + pragma) && query.next())
+            return query.value(0).toLongLong();
+        return -1;
+    }
+}
+
+// ---------------- StorageMaintenanceWorker ----------------
+
+StorageMaintenanceWorker::StorageMaintenanceWorker(const QString &dbPath, Operation operation)
+    : m_dbPath(dbPath), m_operation(operation), m_cancelled(false)
+{
+    qRegisterMetaType<StorageStats>("StorageStats");
+}
+
+void StorageMaintenanceWorker::cancel()
+{
+    m_cancelled = true;
+}
+
+bool StorageMaintenanceWorker::collectStats(QSqlDatabase &db, StorageStats &stats, QString &errorMessage)
+{
+    stats = StorageStats();
+    stats.pageSize = pragmaValue(db, "page_size");
+    stats.pageCount = pragmaValue(db, "page_count");
+    stats.freelistCount = pragmaValue(db, "freelist_count");
+    stats.autoVacuum = int(pragmaValue(db, "auto_vacuum"));
+    if (stats.pageSize < 0 || stats.pageCount < 0 || stats.freelistCount < 0)
+    {
+        errorMessage = "读取数据库页信息失败: " + db.lastError().text();
+        return false;
+    }
+
+    // 表和索引的类型及所属表
+    QHash<QString, QPair<bool, QString>> objectInfo;
+    QSqlQuery masterQuery(db);
+    if (masterQuery.exec("SELECT name, type, tbl_name FROM sqlite_master WHERE type IN ('table', 'index')"))
+    {
+        while (masterQuery.next())
+        {
+            objectInfo[masterQuery.value(0).toString()] =
+                qMakePair(masterQuery.value(1).toString() == "index", masterQuery.value(2).toString());
+        }
+    }
+
+    // dbstat需要SQLite以SQLITE_ENABLE_DBSTAT_VTAB编译，不支持时只有整体统计
+    QSqlQuery statQuery(db);
+    statQuery.setForwardOnly(true);
+    if (!statQuery.exec("SELECT name, COUNT(*), SUM(pgsize), SUM(unused) FROM dbstat GROUP BY name ORDER BY SUM(pgsize) DESC"))
+    {
+        qDebug() << "StorageMaintenanceWorker::collectStats - dbstat不可用:" << statQuery.lastError().text();
+        return true;
+    }
+
+    stats.perObjectAvailable = true;
+    while (statQuery.next())
+    {
+        StorageObjectStats object;
+        object.name = statQuery.value(0).toString();
+        QPair<bool, QString> info = objectInfo.value(object.name, qMakePair(false, object.name));
+        object.isIndex = info.first;
+        object.tableName = info.second;
+        object.pages = statQuery.value(1).toLongLong();
+        object.bytes = statQuery.value(2).toLongLong();
+        object.unusedBytes = statQuery.value(3).toLongLong();
+        stats.objects.append(object);
+    }
+    return true;
+}
+
+void StorageMaintenanceWorker::run()
+{
+    QString connectionName = QString("storage_maintenance_%1").arg(reinterpret_cast<quintptr>(this));
+    bool success = false;
+    QString message;
+
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        db.setDatabaseName(m_dbPath);
+        // 主连接保存时等待写锁，而不是立即失败
+        db.setConnectOptions("QSQLITE_BUSY_TIMEOUT=10000");
+        if (!db.open())
+        {
+            message = QString("无法打开数据库 %1: %2").arg(m_dbPath).arg(db.lastError().text());
+        }
+        else
+        {
+            switch (m_operation)
+            {
+            case CollectStats:
+            {
+                emit progress("正在统计存储...");
+                StorageStats stats;
+                success = collectStats(db, stats, message);
+                if (success)
+                {
+                    emit statsReady(stats);
+                }
+                break;
+            }
+            case IncrementalVacuum:
+                success = incrementalVacuum(db, message);
+                break;
+            case Analyze:
+                success = analyze(db, message);
+                break;
+            case EnableIncrementalVacuum:
+                success = enableIncrementalVacuum(db, message);
+                break;
+            }
+        }
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+
+    emit finished(success, message);
+}
+
+bool StorageMaintenanceWorker::incrementalVacuum(QSqlDatabase &db, QString &message)
+{
+    if (pragmaValue(db, "auto_vacuum") != 2)
+    {
+        message = "项目文件未启用增量清理模式，请先启用";
+        return false;
+    }
+
+    qint64 startPages = pragmaValue(db, "page_count");
+    qint64 freePages = pragmaValue(db, "freelist_count");
+    qint64 totalFree = freePages;
+
+    // 每一步是一个独立的短事务，步与步之间主连接可以写入
+    while (freePages > 0)
+    {
+        if (m_cancelled)
+        {
+            message = QString("增量清理已停止，释放了 %1 页").arg(startPages - pragmaValue(db, "page_count"));
+            return true;
+        }
+
+        QSqlQuery query(db);
+        if (!query.exec(QString("PRAGMA incremental_vacuum(%1)").arg(VACUUM_STEP_PAGES)))
+        {
+            message = "增量清理失败: " + query.lastError().text();
+            return false;
+        }
+        // 每次step释放一页，读完结果才算执行完整
+        while (query.next())
+        {
+        }
+        query.finish();
+
+        qint64 remaining = pragmaValue(db, "freelist_count");
+        if (remaining >= freePages)
+            break;
+        freePages = remaining;
+
+        emit progress(QString("正在增量清理: 已释放 %1/%2 页").arg(totalFree - freePages).arg(totalFree));
+        QThread::msleep(STEP_PAUSE_MS);
+    }
+
+    qint64 releasedPages = startPages - pragmaValue(db, "page_count");
+    message = QString("增量清理完成，释放了 %1 页(%2 KB)")
+                  .arg(releasedPages)
+                  .arg(releasedPages * pragmaValue(db, "page_size") / 1024);
+    return true;
+}
+
+bool StorageMaintenanceWorker::analyze(QSqlDatabase &db, QString &message)
+{
+    // 限制每个索引的抽样行数，单个表的ANALYZE耗时不随行数增长(旧版SQLite忽略该设置)
+    QSqlQuery limitQuery(db);
+    limitQuery.exec(QString("PRAGMA analysis_limit = %1").arg(ANALYSIS_LIMIT));
+
+    QStringList tables;
+    QSqlQuery tableQuery(db);
+    if (!tableQuery.exec("SELECT name FROM sqlite_master WHERE type = 'table' AND name NOT LIKE 'sqlite_%' ORDER BY name"))
+    {
+        message = "查询表失败: " + tableQuery.lastError().text();
+        return false;
+    }
+    while (tableQuery.next())
+    {
+        tables << tableQuery.value(0).toString();
+    }
+    tableQuery.finish();
+
+    // 逐个表分析，每个表是一步
+    for (int i = 0; i < tables.size(); ++i)
+    {
+        if (m_cancelled)
+        {
+            message = QString("更新统计信息已停止，已分析 %1/%2 个表").arg(i).arg(tables.size());
+            return true;
+        }
+
+        emit progress(QString("正在更新统计信息: %1 (%2/%3)").arg(tables[i]).arg(i + 1).arg(tables.size()));
+        QSqlQuery query(db);
+        if (!query.exec(QString("ANALYZE \"%1\"").arg(tables[i])))
+        {
+            message = QString("分析表%1失败: %2").arg(tables[i]).arg(query.lastError().text());
+            return false;
+        }
+        QThread::msleep(STEP_PAUSE_MS);
+    }
+
+    message = QString("统计信息已更新，共分析 %1 个表").arg(tables.size());
+    return true;
+}
+
+bool StorageMaintenanceWorker::enableIncrementalVacuum(QSqlDatabase &db, QString &message)
+{
+    if (pragmaValue(db, "auto_vacuum") == 2)
+    {
+        message = "项目文件已经是增量清理模式";
+        return true;
+    }
+
+    // 切换模式必须完整重建一次文件，VACUUM全程持有写锁，可能远超主连接的忙等待时间，
+    // 所以调用方要在重建期间禁止编辑和保存(存储维护面板用模态进度框挡住主窗口)
+    emit progress("正在重建项目文件以启用增量清理，请稍候...");
+    qint64 sizeBefore = QFileInfo(m_dbPath).size();
+
+    QSqlQuery query(db);
+    if (!query.exec("PRAGMA auto_vacuum = INCREMENTAL") || !query.exec("VACUUM"))
+    {
+        message = "启用增量清理失败: " + query.lastError().text();
+        return false;
+    }
+
+    qint64 sizeAfter = QFileInfo(m_dbPath).size();
+    message = QString("已启用增量清理，项目文件从 %1 KB 变为 %2 KB").arg(sizeBefore / 1024).arg(sizeAfter / 1024);
+    return true;
+}
+
+// ---------------- StorageMaintenanceTask ----------------
+
+StorageMaintenanceTask::StorageMaintenanceTask(QObject *parent)
+    : QObject(parent), m_thread(nullptr), m_worker(nullptr)
+{
+}
+
+StorageMaintenanceTask::~StorageMaintenanceTask()
+{
+    stop();
+}
+
+bool StorageMaintenanceTask::start(const QString &dbPath, StorageMaintenanceWorker::Operation operation)
+{
+    if (m_thread)
+        return false;
+
+    m_thread = new QThread(this);
+    m_worker = new StorageMaintenanceWorker(dbPath, operation);
+    m_worker->moveToThread(m_thread);
+
+    connect(m_thread, &QThread::started, m_worker, &StorageMaintenanceWorker::run);
+    connect(m_worker, &StorageMaintenanceWorker::progress, this, &StorageMaintenanceTask::progress);
+    connect(m_worker, &StorageMaintenanceWorker::statsReady, this, &StorageMaintenanceTask::statsReady);
+    connect(m_worker, &StorageMaintenanceWorker::finished, this, &StorageMaintenanceTask::onWorkerFinished);
+
+    m_thread->start(QThread::LowPriority);
+    return true;
+}
+
+void StorageMaintenanceTask::stop()
+{
+    if (!m_worker)
+        return;
+
+    m_worker->cancel();
+    cleanupWorker();
+}
+
+void StorageMaintenanceTask::onWorkerFinished(bool success, const QString &message)
+{
+    cleanupWorker();
+    emit finished(success, message);
+}
+
+void StorageMaintenanceTask::cleanupWorker()
+{
+    if (!m_thread)
+        return;
+
+    disconnect(m_worker, nullptr, this, nullptr);
+    m_thread->quit();
+    m_thread->wait();
+    delete m_worker;
+    delete m_thread;
+    m_worker = nullptr;
+    m_thread = nullptr;
+}
@@ -0,0 +1,114 @@
+#ifndef STORAGEMAINTENANCE_H
+#define STORAGEMAINTENANCE_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QSqlDatabase>
+#include <QMetaType>
+#include <atomic>
+
+class QThread;
+
+// 一个表或索引占用的存储
+struct StorageObjectStats
+{
+    QString name;
+    QString tableName; // 索引所属的表
+    bool isIndex;
+    qint64 pages;
+    qint64 bytes;
+    qint64 unusedBytes; // 页内未使用的字节
+};
+
+// 项目文件的存储统计
+struct StorageStats
+{
+    qint64 pageSize = 0;
+    qint64 pageCount = 0;
+    qint64 freelistCount = 0; // 空闲页，增量清理可以归还给文件系统
+    int autoVacuum = 0;       // 0: 无，1: 完全，2: 增量
+    bool perObjectAvailable = false; // SQLite是否支持dbstat，不支持时没有每个表的统计
+    QVector<StorageObjectStats> objects;
+};
+Q_DECLARE_METATYPE(StorageStats)
+
+// 在后台线程中用独立连接维护项目文件，每一步只短暂持有写锁，不影响编辑和保存
+// EnableIncrementalVacuum例外：完整重建期间一直持有写锁，调用方需禁止保存
+class StorageMaintenanceWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Operation
+    {
+        CollectStats,           // 统计页数、空闲页和每个表/索引的大小
+        IncrementalVacuum,      // 分步释放空闲页，文件随之缩小
+        Analyze,                // 逐个表更新查询优化器的统计信息
+        EnableIncrementalVacuum // 切换为增量清理模式，需要完整重建一次文件，期间数据库被锁住
+    };
+
+    StorageMaintenanceWorker(const QString &dbPath, Operation operation);
+
+    void cancel();
+
+    // 增量清理每一步释放的页数，以及两步之间让出数据库的时间
+    static const int VACUUM_STEP_PAGES = 512;
+    static const int STEP_PAUSE_MS = 20;
+
+    // ANALYZE每个索引最多抽样的行数
+    static const int ANALYSIS_LIMIT = 1000;
+
+    static bool collectStats(QSqlDatabase &db, StorageStats &stats, QString &errorMessage);
+
+public slots:
+    void run();
+
+signals:
+    void progress(const QString &message);
+    void statsReady(const StorageStats &stats);
+    void finished(bool success, const QString &message);
+
+private:
+    bool incrementalVacuum(QSqlDatabase &db, QString &message);
+    bool analyze(QSqlDatabase &db, QString &message);
+    bool enableIncrementalVacuum(QSqlDatabase &db, QString &message);
+
+    QString m_dbPath;
+    Operation m_operation;
+    std::atomic<bool> m_cancelled;
+};
+
+// 管理一个后台维护线程，同一时间只运行一个操作
+class StorageMaintenanceTask : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StorageMaintenanceTask(QObject *parent = nullptr);
+    ~StorageMaintenanceTask();
+
+    // 已有操作在运行时返回false
+    bool start(const QString &dbPath, StorageMaintenanceWorker::Operation operation);
+
+    bool isRunning() const { return m_thread != nullptr; }
+
+    // 停止当前操作并等待线程结束
+    void stop();
+
+signals:
+    void progress(const QString &message);
+    void statsReady(const StorageStats &stats);
+    void finished(bool success, const QString &message);
+
+private slots:
+    void onWorkerFinished(bool success, const QString &message);
+
+private:
+    void cleanupWorker();
+
+    QThread *m_thread;
+    StorageMaintenanceWorker *m_worker;
+};
+
+#endif // STORAGEMAINTENANCE_H
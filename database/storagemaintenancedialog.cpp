@@ -0,0 +1,284 @@
+#include "storagemaintenancedialog.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QFileInfo>
+#include <QCloseEvent>
+#include <QDebug>
+
+namespace
+{
+    // 按数值排序的表格项
+    class NumberItem : public QTableWidgetItem
+    {
+    public:
+        NumberItem(const QString &text, qint64 value) : QTableWidgetItem(text)
+        {
+            setData(Qt::UserRole, value);
+            setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        }
+
+        bool operator<(const QTableWidgetItem &other) const override
+        {
+            return data(Qt::UserRole).toLongLong() < other.data(Qt::UserRole).toLongLong();
+        }
+    };
+
+    // 重建文件无法中途取消，进度框不响应Esc和关闭按钮
+    class RebuildProgressDialog : public QProgressDialog
+    {
+    public:
+        RebuildProgressDialog(const QString &label, QWidget *parent)
+            : QProgressDialog(label, QString(), 0, 0, parent)
+        {
+            setWindowTitle("启用增量清理");
+            setWindowFlags(windowFlags() & ~Qt::WindowCloseButtonHint);
+            setWindowModality(Qt::ApplicationModal);
+            setMinimumDuration(0);
+            setAutoClose(false);
+            setAutoReset(false);
+        }
+
+        void reject() override {}
+
+    protected:
+        void closeEvent(QCloseEvent *event) override { event->ignore(); }
+    };
+}
+
+StorageMaintenanceDialog::StorageMaintenanceDialog(const QString &dbPath, QWidget *parent)
+    : QDialog(parent), m_dbPath(dbPath), m_refreshAfterFinish(false), m_rebuildProgress(nullptr)
+{
+    setWindowTitle("存储维护");
+    resize(760, 560);
+
+    m_task = new StorageMaintenanceTask(this);
+    connect(m_task, &StorageMaintenanceTask::progress, this, [this](const QString &message)
+            { m_statusLabel->setText(message); });
+    connect(m_task, &StorageMaintenanceTask::statsReady, this, &StorageMaintenanceDialog::onStatsReady);
+    connect(m_task, &StorageMaintenanceTask::finished, this, &StorageMaintenanceDialog::onFinished);
+
+    setupUI();
+    refreshStats();
+}
+
+StorageMaintenanceDialog::~StorageMaintenanceDialog()
+{
+    m_task->stop();
+}
+
+void StorageMaintenanceDialog::setupUI()
+{
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+
+    m_summaryLabel = new QLabel(this);
+    m_summaryLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    mainLayout->addWidget(m_summaryLabel);
+
+    m_objectTable = new QTableWidget(0, 6, this);
+    m_objectTable->setHorizontalHeaderLabels(QStringList() << "名称" << "类型" << "所属表" << "页数" << "大小" << "页内空闲");
+    m_objectTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_objectTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_objectTable->verticalHeader()->setVisible(false);
+    m_objectTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    mainLayout->addWidget(m_objectTable, 1);
+
+    m_statusLabel = new QLabel(this);
+    mainLayout->addWidget(m_statusLabel);
+
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    m_refreshButton = new QPushButton("刷新统计", this);
+    m_vacuumButton = new QPushButton("增量清理", this);
+    m_vacuumButton->setToolTip("分步释放空闲页，缩小项目文件，不影响编辑");
+    m_analyzeButton = new QPushButton("更新统计信息", this);
+    m_analyzeButton->setToolTip("逐个表执行ANALYZE，让查询使用合适的索引");
+    m_enableButton = new QPushButton("启用增量清理...", this);
+    m_enableButton->setToolTip("旧项目文件需要完整重建一次才能使用增量清理");
+    m_stopButton = new QPushButton("停止", this);
+    QPushButton *closeButton = new QPushButton("关闭", this);
+
+    buttonLayout->addWidget(m_refreshButton);
+    buttonLayout->addWidget(m_vacuumButton);
+    buttonLayout->addWidget(m_analyzeButton);
+    buttonLayout->addWidget(m_enableButton);
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(m_stopButton);
+    buttonLayout->addWidget(closeButton);
+    mainLayout->addLayout(buttonLayout);
+
+    connect(m_refreshButton, &QPushButton::clicked, this, &StorageMaintenanceDialog::refreshStats);
+    connect(m_vacuumButton, &QPushButton::clicked, this, &StorageMaintenanceDialog::runIncrementalVacuum);
+    connect(m_analyzeButton, &QPushButton::clicked, this, &StorageMaintenanceDialog::runAnalyze);
+    connect(m_enableButton, &QPushButton::clicked, this, &StorageMaintenanceDialog::enableIncrementalVacuum);
+    connect(m_stopButton, &QPushButton::clicked, this, &StorageMaintenanceDialog::stopOperation);
+    connect(closeButton, &QPushButton::clicked, this, &QDialog::close);
+
+    m_enableButton->setVisible(false);
+    setRunning(false);
+}
+
+void StorageMaintenanceDialog::refreshStats()
+{
+    m_refreshAfterFinish = false;
+    startOperation(StorageMaintenanceWorker::CollectStats);
+}
+
+void StorageMaintenanceDialog::runIncrementalVacuum()
+{
+    m_refreshAfterFinish = true;
+    startOperation(StorageMaintenanceWorker::IncrementalVacuum);
+}
+
+void StorageMaintenanceDialog::runAnalyze()
+{
+    m_refreshAfterFinish = true;
+    startOperation(StorageMaintenanceWorker::Analyze);
+}
+
+void StorageMaintenanceDialog::enableIncrementalVacuum()
+{
+    if (QMessageBox::question(this, "启用增量清理",
+                              "启用增量清理需要完整重建一次项目文件，大项目可能需要较长时间，期间无法编辑和保存。\n是否继续？",
+                              QMessageBox::Yes | QMessageBox::No, QMessageBox::No) != QMessageBox::Yes)
+    {
+        return;
+    }
+
+    // 重建期间VACUUM一直持有写锁，主连接的保存等不到锁会失败，用应用模态进度框挡住编辑和保存
+    m_rebuildProgress = new RebuildProgressDialog("正在重建项目文件以启用增量清理，请稍候...", this);
+    m_rebuildProgress->show();
+
+    m_refreshAfterFinish = true;
+    startOperation(StorageMaintenanceWorker::EnableIncrementalVacuum);
+    if (!m_task->isRunning())
+    {
+        delete m_rebuildProgress;
+        m_rebuildProgress = nullptr;
+    }
+}
+
+void StorageMaintenanceDialog::stopOperation()
+{
+    m_task->stop();
+    m_statusLabel->setText("操作已停止");
+    setRunning(false);
+}
+
+void StorageMaintenanceDialog::startOperation(StorageMaintenanceWorker::Operation operation)
+{
+    if (!m_task->start(m_dbPath, operation))
+    {
+        m_statusLabel->setText("已有维护操作正在进行");
+        return;
+    }
+    setRunning(true);
+}
+
+void StorageMaintenanceDialog::setRunning(bool running)
+{
+    m_refreshButton->setEnabled(!running);
+    m_vacuumButton->setEnabled(!running);
+    m_analyzeButton->setEnabled(!running);
+    m_enableButton->setEnabled(!running);
+    m_stopButton->setEnabled(running);
+}
+
+void StorageMaintenanceDialog::onStatsReady(const StorageStats &stats)
+{
+    qint64 fileBytes = QFileInfo(m_dbPath).size();
+    double freeRatio = stats.pageCount > 0 ? 100.0 * stats.freelistCount / stats.pageCount : 0.0;
+
+    QString mode;
+    switch (stats.autoVacuum)
+    {
+    case 1:
+        mode = "完全(删除时自动收缩)";
+        break;
+    case 2:
+        mode = "增量";
+        break;
+    default:
+        mode = "未启用";
+        break;
+    }
+
+    QString summary = QString("项目文件: %1\n文件大小: %2    页大小: %3 字节    总页数: %4\n"
+                              "空闲页: %5 (%6%，%7)    自动清理模式: %8")
+                          .arg(m_dbPath)
+                          .arg(formatBytes(fileBytes))
+                          .arg(stats.pageSize)
+                          .arg(stats.pageCount)
+                          .arg(stats.freelistCount)
+                          .arg(freeRatio, 0, 'f', 1)
+                          .arg(formatBytes(stats.freelistCount * stats.pageSize))
+                          .arg(mode);
+    if (!stats.perObjectAvailable)
+    {
+        summary += "\n当前SQLite不支持dbstat，无法统计每个表和索引的大小";
+    }
+    m_summaryLabel->setText(summary);
+
+    // 只有增量模式才能分步清理；其他模式提供一次性切换
+    m_vacuumButton->setVisible(stats.autoVacuum == 2);
+    m_enableButton->setVisible(stats.autoVacuum != 2);
+
+    m_objectTable->setSortingEnabled(false);
+    m_objectTable->setRowCount(stats.objects.size());
+    for (int row = 0; row < stats.objects.size(); ++row)
+    {
+        const StorageObjectStats &object = stats.objects[row];
+        double unusedRatio = object.bytes > 0 ? 100.0 * object.unusedBytes / object.bytes : 0.0;
+
+        m_objectTable->setItem(row, 0, new QTableWidgetItem(object.name));
+        m_objectTable->setItem(row, 1, new QTableWidgetItem(object.isIndex ? "索引" : "表"));
+        m_objectTable->setItem(row, 2, new QTableWidgetItem(object.tableName));
+        m_objectTable->setItem(row, 3, new NumberItem(QString::number(object.pages), object.pages));
+        m_objectTable->setItem(row, 4, new NumberItem(formatBytes(object.bytes), object.bytes));
+        m_objectTable->setItem(row, 5, new NumberItem(QString::number(unusedRatio, 'f', 1) + "%", qint64(unusedRatio * 10)));
+    }
+    m_objectTable->setSortingEnabled(true);
+    m_objectTable->resizeColumnsToContents();
+    m_objectTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+}
+
+void StorageMaintenanceDialog::onFinished(bool success, const QString &message)
+{
+    setRunning(false);
+    if (m_rebuildProgress)
+    {
+        delete m_rebuildProgress;
+        m_rebuildProgress = nullptr;
+    }
+    if (!success)
+    {
+        m_refreshAfterFinish = false;
+        m_resultMessage.clear();
+        m_statusLabel->setText(message);
+        return;
+    }
+
+    if (m_refreshAfterFinish)
+    {
+        // 操作结果保留到重新统计完成后再显示
+        m_refreshAfterFinish = false;
+        m_resultMessage = message;
+        startOperation(StorageMaintenanceWorker::CollectStats);
+        return;
+    }
+
+    m_statusLabel->setText(m_resultMessage.isEmpty() ? QString("统计完成") : m_resultMessage);
+    m_resultMessage.clear();
+}
+
+QString StorageMaintenanceDialog::formatBytes(qint64 bytes)
+{
+    if (bytes >= 1024LL * 1024 * 1024)
+        return QString::number(bytes / (1024.0 * 1024 * 1024), 'f', 2) + " GB";
+    if (bytes >= 1024 * 1024)
+        return QString::number(bytes / (1024.0 * 1024), 'f', 2) + " MB";
+    if (bytes >= 1024)
+        return QString::number(bytes / 1024.0, 'f', 1) + " KB";
+    return QString::number(bytes) + " B";
+}
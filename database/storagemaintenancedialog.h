@@ -0,0 +1,53 @@
+#ifndef STORAGEMAINTENANCEDIALOG_H
+#define STORAGEMAINTENANCEDIALOG_H
+
+#include <QDialog>
+#include <QTableWidget>
+#include <QLabel>
+#include <QPushButton>
+#include <QProgressDialog>
+#include "storagemaintenance.h"
+
+// 存储维护面板：显示项目文件的页数、空闲页和每个表/索引的大小
+// 增量清理和ANALYZE在后台线程中分步执行，窗口非模态，维护期间可以继续编辑
+// 启用增量清理要完整重建文件，期间显示应用模态的进度框，禁止编辑和保存
+class StorageMaintenanceDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    StorageMaintenanceDialog(const QString &dbPath, QWidget *parent = nullptr);
+    ~StorageMaintenanceDialog();
+
+private slots:
+    void refreshStats();
+    void runIncrementalVacuum();
+    void runAnalyze();
+    void enableIncrementalVacuum();
+    void stopOperation();
+    void onStatsReady(const StorageStats &stats);
+    void onFinished(bool success, const QString &message);
+
+private:
+    void setupUI();
+    void startOperation(StorageMaintenanceWorker::Operation operation);
+    void setRunning(bool running);
+    static QString formatBytes(qint64 bytes);
+
+    QString m_dbPath;
+    StorageMaintenanceTask *m_task;
+    bool m_refreshAfterFinish; // 清理或分析完成后重新统计
+    QString m_resultMessage;
+    QProgressDialog *m_rebuildProgress; // 重建文件期间的模态进度框
+
+    QLabel *m_summaryLabel;
+    QTableWidget *m_objectTable;
+    QLabel *m_statusLabel;
+    QPushButton *m_refreshButton;
+    QPushButton *m_vacuumButton;
+    QPushButton *m_analyzeButton;
+    QPushButton *m_enableButton;
+    QPushButton *m_stopButton;
+};
+
+#endif // STORAGEMAINTENANCEDIALOG_H
@@ -0,0 +1,274 @@
+#include "channelmap.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <QtAlgorithms>
+#include <QDebug>
+
+ChannelMap::ChannelMap()
+    : m_scope(PerSite), m_siteCount(0)
+{
+}
+
+void ChannelMap::reset(int pinCount, int siteCount, Scope scope)
+{
+    m_scope = scope;
+    m_siteCount = siteCount;
+    m_pinNames.clear();
+    m_pinNames.reserve(pinCount);
+    for (int row = 0; row < pinCount; ++row)
+        m_pinNames.append(QString());
+    m_channelCounts.fill(1, pinCount);
+    m_firstChannels.fill(int(NoChannel), pinCount * siteCount);
+    m_conflictCells.fill(0, pinCount * siteCount);
+    m_conflicts.clear();
+    m_bits.clear();
+    m_owners.clear();
+}
+
+void ChannelMap::setPin(int row, const QString &pinName, int channelCount)
+{
+    m_pinNames[row] = pinName;
+    m_channelCounts[row] = qMax(1, channelCount);
+}
+
+void ChannelMap::setFirstChannel(int row, int site, int channel)
+{
+    m_firstChannels[row * m_siteCount + site] = channel;
+}
+
+void ChannelMap::ensureCapacity(QVector<quint64> &bits, int channelEnd)
+{
+    int words = (channelEnd + 63) / 64;
+    if (bits.size() < words)
+        bits.resize(words); // 新增的字为0，即空闲
+}
+
+bool ChannelMap::testRange(const QVector<quint64> &bits, int first, int count)
+{
+    int end = qMin(first + count, int(bits.size()) * 64);
+    if (first >= end)
+        return false;
+
+    const int firstWord = first >> 6;
+    const int lastWord = (end - 1) >> 6;
+    for (int word = firstWord; word <= lastWord; ++word)
+    {
+        quint64 mask = ~quint64(0);
+        if (word == firstWord)
+            mask &= ~quint64(0) << (first & 63);
+        if (word == lastWord)
+            mask &= ~quint64(0) >> (63 - ((end - 1) & 63));
+        if (bits[word] & mask)
+            return true;
+    }
+    return false;
+}
+
+void ChannelMap::setRange(QVector<quint64> &bits, int first, int count)
+{
+    const int end = first + count;
+    ensureCapacity(bits, end);
+
+    const int firstWord = first >> 6;
+    const int lastWord = (end - 1) >> 6;
+    for (int word = firstWord; word <= lastWord; ++word)
+    {
+        quint64 mask = ~quint64(0);
+        if (word == firstWord)
+            mask &= ~quint64(0) << (first & 63);
+        if (word == lastWord)
+            mask &= ~quint64(0) >> (63 - ((end - 1) & 63));
+        bits[word] |= mask;
+    }
+}
+
+int ChannelMap::nextSetBit(const QVector<quint64> &bits, int pos)
+{
+    const int total = bits.size() * 64;
+    if (pos >= total)
+        return total;
+
+    int word = pos >> 6;
+    quint64 value = bits[word] & (~quint64(0) << (pos & 63));
+    while (value == 0)
+    {
+        if (++word >= bits.size())
+            return total;
+        value = bits[word];
+    }
+    return word * 64 + int(qCountTrailingZeroBits(value));
+}
+
+int ChannelMap::nextClearBit(const QVector<quint64> &bits, int pos)
+{
+    const int total = bits.size() * 64;
+    if (pos >= total)
+        return pos;
+
+    int word = pos >> 6;
+    quint64 value = ~bits[word] & (~quint64(0) << (pos & 63));
+    while (value == 0)
+    {
+        if (++word >= bits.size())
+            return total;
+        value = ~bits[word];
+    }
+    return word * 64 + int(qCountTrailingZeroBits(value));
+}
+
+int ChannelMap::findFreeRange(const QVector<quint64> &bits, int count, int hint)
+{
+    const int total = bits.size() * 64;
+    int pos = hint;
+    while (true)
+    {
+        // 跳过已占用的整段，再看到下一个占用通道之前的空闲长度
+        pos = nextClearBit(bits, pos);
+        int next = nextSetBit(bits, pos);
+        if (next >= total || next - pos >= count)
+            return pos;
+        pos = next;
+    }
+}
+
+void ChannelMap::occupy(int row, int site, int first, int count)
+{
+    const int cell = row * m_siteCount + site;
+    if (first < 0 || first + count > MAX_CHANNEL)
+    {
+        m_conflictCells[cell] = ConflictLoser;
+        m_conflicts.append(ChannelConflict{row, site, -1, -1, first});
+        return;
+    }
+
+    const int bitmap = bitmapIndex(site);
+    QVector<quint64> &bits = m_bits[bitmap];
+    QVector<int> &owners = m_owners[bitmap];
+
+    if (testRange(bits, first, count))
+    {
+        // 冲突的单元格不占用通道，重新分配时只移动后出现的一方
+        int channel = nextSetBit(bits, first);
+        int owner = owners[channel];
+        m_conflictCells[cell] = ConflictLoser;
+        if (m_conflictCells[owner] == 0)
+            m_conflictCells[owner] = ConflictOwner;
+        m_conflicts.append(ChannelConflict{row, site, owner / m_siteCount, owner % m_siteCount, channel});
+        return;
+    }
+
+    setRange(bits, first, count);
+    if (owners.size() < first + count)
+        owners.resize(first + count);
+    for (int channel = first; channel < first + count; ++channel)
+        owners[channel] = cell;
+}
+
+int ChannelMap::build()
+{
+    const int bitmapCount = (m_scope == SharedAcrossSites) ? qMin(1, m_siteCount) : m_siteCount;
+    m_bits = QVector<QVector<quint64>>(bitmapCount);
+    m_owners = QVector<QVector<int>>(bitmapCount);
+    m_conflictCells.fill(0, m_firstChannels.size());
+    m_conflicts.clear();
+
+    // 按工位、管脚顺序占用，先出现的单元格保留通道
+    const int pinCount = m_channelCounts.size();
+    for (int site = 0; site < m_siteCount; ++site)
+    {
+        for (int row = 0; row < pinCount; ++row)
+        {
+            int first = m_firstChannels[row * m_siteCount + site];
+            if (first != NoChannel)
+                occupy(row, site, first, m_channelCounts[row]);
+        }
+    }
+
+    return m_conflicts.size();
+}
+
+int ChannelMap::autoAssign(bool reassignConflicts)
+{
+    build();
+
+    // 每张位图最低的空闲通道只会向后移动，作为查找的起点
+    QVector<int> hints(m_bits.size(), 0);
+    const int pinCount = m_channelCounts.size();
+    int assigned = 0;
+
+    for (int site = 0; site < m_siteCount; ++site)
+    {
+        const int bitmap = bitmapIndex(site);
+        QVector<quint64> &bits = m_bits[bitmap];
+        for (int row = 0; row < pinCount; ++row)
+        {
+            const int cell = row * m_siteCount + site;
+            bool needsChannel = m_firstChannels[cell] == NoChannel ||
+                                (reassignConflicts && m_conflictCells[cell] == ConflictLoser);
+            if (!needsChannel)
+                continue;
+
+            const int count = m_channelCounts[row];
+            hints[bitmap] = nextClearBit(bits, hints[bitmap]);
+            int first = findFreeRange(bits, count, hints[bitmap]);
+            if (first + count > MAX_CHANNEL)
+                continue;
+
+            setRange(bits, first, count);
+            m_firstChannels[cell] = first;
+            ++assigned;
+        }
+    }
+
+    build();
+    qDebug() << "ChannelMap::autoAssign - 新分配单元格数:" << assigned << "，剩余冲突数:" << m_conflicts.size();
+    return assigned;
+}
+
+bool ChannelMap::exportCsv(const QString &filePath, QString &errorMessage) const
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        errorMessage = QString("无法打开文件进行写入: %1").arg(file.errorString());
+        return false;
+    }
+
+    QTextStream out(&file);
+
+    // 表头
+    QStringList headers;
+    headers << "管脚" << "通道个数";
+    for (int site = 0; site < m_siteCount; ++site)
+        headers << QString("工位%1").arg(site + 1);
+    out << headers.join(",") << "\n";
+
+    // 每个管脚一行，单通道写通道号，多通道写首尾范围
+    for (int row = 0; row < m_channelCounts.size(); ++row)
+    {
+        QString pinName = m_pinNames[row];
+        if (pinName.contains(",") || pinName.contains("\"") || pinName.contains("\n"))
+        {
+            pinName.replace("\"", "\"\"");
+            pinName = "\"" + pinName + "\"";
+        }
+
+        QStringList rowData;
+        rowData << pinName << QString::number(m_channelCounts[row]);
+        for (int site = 0; site < m_siteCount; ++site)
+        {
+            int first = firstChannel(row, site);
+            if (first == NoChannel)
+                rowData << QString();
+            else if (m_channelCounts[row] == 1)
+                rowData << QString::number(first);
+            else
+                rowData << QString("%1-%2").arg(first).arg(first + m_channelCounts[row] - 1);
+        }
+        out << rowData.join(",") << "\n";
+    }
+
+    file.close();
+    return true;
+}
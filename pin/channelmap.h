@@ -0,0 +1,91 @@
+#ifndef CHANNELMAP_H
+#define CHANNELMAP_H
+
+#include <QVector>
+#include <QStringList>
+#include <QString>
+
+// 一处通道冲突：(row, site)为后出现的单元格，channel已被(otherRow, otherSite)占用
+// otherRow为-1表示通道号超出范围
+struct ChannelConflict
+{
+    int row;
+    int site;
+    int otherRow;
+    int otherSite;
+    int channel;
+};
+
+// 工位 × 管脚 → 测试机通道的映射
+// 每个管脚在每个工位从首通道开始占用其通道个数个连续通道，占用情况用位图记录，
+// 区间检查和空闲区间查找按64位整字进行，几千个管脚×几十个工位也可以在编辑时实时重建
+class ChannelMap
+{
+public:
+    // PerSite：每个工位的通道独立编号；SharedAcrossSites：所有工位共用同一组测试机通道
+    enum Scope
+    {
+        PerSite = 0,
+        SharedAcrossSites
+    };
+
+    static const int NoChannel = -1;
+    // 允许的最大通道号，超出的单元格按冲突报告
+    static const int MAX_CHANNEL = 1 << 20;
+
+    ChannelMap();
+
+    // 清空映射，所有单元格为未分配
+    void reset(int pinCount, int siteCount, Scope scope);
+    void setPin(int row, const QString &pinName, int channelCount);
+    void setFirstChannel(int row, int site, int channel);
+
+    int pinCount() const { return m_channelCounts.size(); }
+    int siteCount() const { return m_siteCount; }
+    Scope scope() const { return m_scope; }
+    int firstChannel(int row, int site) const { return m_firstChannels[row * m_siteCount + site]; }
+    int channelCount(int row) const { return m_channelCounts[row]; }
+
+    // 按行、工位顺序重建占用位图，先出现的单元格占有通道，后出现的重叠单元格记为冲突
+    int build();
+    const QVector<ChannelConflict> &conflicts() const { return m_conflicts; }
+    bool hasConflict(int row, int site) const { return m_conflictCells[row * m_siteCount + site] != 0; }
+
+    // 为未分配的单元格(以及reassignConflicts时的冲突单元格)分配不重叠的通道，已有的分配保持不变
+    // 每个单元格取首个足够长的空闲区间，返回新分配的单元格数；完成后映射重新构建
+    int autoAssign(bool reassignConflicts);
+
+    // 导出为CSV：每行一个管脚，每个工位一列，内容为通道号或通道范围
+    bool exportCsv(const QString &filePath, QString &errorMessage) const;
+
+private:
+    // 位图操作，bits按通道号下标，容量不足时自动扩展
+    static void ensureCapacity(QVector<quint64> &bits, int channelEnd);
+    static bool testRange(const QVector<quint64> &bits, int first, int count);
+    static void setRange(QVector<quint64> &bits, int first, int count);
+    // 从hint开始查找count个连续空闲通道，返回首通道
+    static int findFreeRange(const QVector<quint64> &bits, int count, int hint);
+    // 从pos开始的第一个已占用/空闲通道，位图之后的通道都是空闲的
+    static int nextSetBit(const QVector<quint64> &bits, int pos);
+    static int nextClearBit(const QVector<quint64> &bits, int pos);
+
+    // m_conflictCells的取值：冲突中先占有通道的一方保留分配，后出现的一方可以被重新分配
+    static const quint8 ConflictOwner = 1;
+    static const quint8 ConflictLoser = 2;
+
+    int bitmapIndex(int site) const { return m_scope == SharedAcrossSites ? 0 : site; }
+    // 占用first起count个通道，与已有占用重叠时记录冲突
+    void occupy(int row, int site, int first, int count);
+
+    Scope m_scope;
+    int m_siteCount;
+    QStringList m_pinNames;
+    QVector<int> m_channelCounts;
+    QVector<int> m_firstChannels;     // row * m_siteCount + site
+    QVector<QVector<quint64>> m_bits; // 每个工位一张位图，共用通道时只有一张
+    QVector<QVector<int>> m_owners;   // 与位图对应的占用者(单元格下标)，仅用于报告冲突
+    QVector<quint8> m_conflictCells;
+    QVector<ChannelConflict> m_conflicts;
+};
+
+#endif // CHANNELMAP_H
@@ -0,0 +1,167 @@
+#include "pindeletioncascade.h"
+
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QStringList>
+#include <QSet>
+#include <QDebug>
+
+namespace
+{
+    // 有成员在pinSet中、且没有其他成员的分组，删除管脚后成为空分组
+    QString emptiedGroupsSql(const QString &pinSet)
+    {
+        return QString("SELECT pg.group_id FROM pin_groups pg "
+                       "WHERE EXISTS (SELECT 1 FROM pin_group_members m WHERE m.group_id = pg.group_id AND m.pin_id IN %1) "
+                       "AND NOT EXISTS (SELECT 1 FROM pin_group_members m WHERE m.group_id = pg.group_id AND m.pin_id NOT IN %1)")
+            .arg(pinSet);
+    }
+
+    // 有任一成员在pinSet中的分组，分组值按成员管脚的电平组合而成，成员变化后全部失效
+    QString touchedGroupsSql(const QString &pinSet)
+    {
+        return "SELECT group_id FROM pin_group_members WHERE pin_id IN " + pinSet;
+    }
+}
+
+QString PinDeletionCounts::summary() const
+{
+    QStringList lines;
+    lines << QString("管脚: %1 个").arg(pins);
+    lines << QString("向量表中的管脚列: %1 个").arg(tablePins);
+    lines << QString("向量行管脚值: %1 条").arg(pinValues);
+    lines << QString("TimeSet边沿设置: %1 条").arg(timeSetEdges);
+    lines << QString("工位通道设置: %1 条").arg(pinSettings);
+    lines << QString("管脚分组成员: %1 条").arg(groupMembers);
+    lines << QString("包含被删除管脚的分组值: %1 条").arg(groupValues);
+    lines << QString("成员全部被删除的管脚分组: %1 个").arg(groups);
+    return lines.join("\n");
+}
+
+PinDeletionCascade::PinDeletionCascade(QSqlDatabase db)
+    : m_db(db)
+{
+}
+
+int PinDeletionCascade::execCount(const QString &sql, const QString &what)
+{
+    QSqlQuery query(m_db);
+    if (!query.exec(sql) || !query.next())
+    {
+        throw QString("统计%1失败: %2").arg(what, query.lastError().text());
+    }
+    return query.value(0).toInt();
+}
+
+int PinDeletionCascade::execDelete(const QString &sql, const QString &what)
+{
+    QSqlQuery query(m_db);
+    if (!query.exec(sql))
+    {
+        throw QString("删除%1失败: %2").arg(what, query.lastError().text());
+    }
+    return query.numRowsAffected();
+}
+
+PinDeletionCounts PinDeletionCascade::countAffected(const QString &pinSet)
+{
+    const QString groups = emptiedGroupsSql(pinSet);
+
+    PinDeletionCounts counts;
+    counts.pinValues = execCount("SELECT COUNT(*) FROM vector_table_pin_values WHERE vector_pin_id IN "
+                                 "(SELECT id FROM vector_table_pins WHERE pin_id IN " +
+                                     pinSet + ")",
+                                 "向量行管脚值");
+    counts.tablePins = execCount("SELECT COUNT(*) FROM vector_table_pins WHERE pin_id IN " + pinSet, "向量表管脚列");
+    counts.timeSetEdges = execCount("SELECT COUNT(*) FROM timeset_settings WHERE pin_id IN " + pinSet, "TimeSet边沿设置");
+    counts.pinSettings = execCount("SELECT COUNT(*) FROM pin_settings WHERE pin_id IN " + pinSet, "工位通道设置");
+    counts.groupMembers = execCount("SELECT COUNT(*) FROM pin_group_members WHERE pin_id IN " + pinSet, "管脚分组成员");
+    counts.groups = execCount("SELECT COUNT(*) FROM (" + groups + ")", "管脚分组");
+    counts.groupValues = execCount("SELECT COUNT(*) FROM vector_table_group_values WHERE group_id IN (" +
+                                       touchedGroupsSql(pinSet) + ")",
+                                   "分组值");
+    counts.pins = execCount("SELECT COUNT(*) FROM pin_list WHERE id IN " + pinSet, "管脚");
+    return counts;
+}
+
+bool PinDeletionCascade::deletePins(const QList<int> &pinIds, const ConfirmCallback &confirm,
+                                    PinDeletionCounts &counts, QString &errorMessage)
+{
+    counts = PinDeletionCounts();
+    errorMessage.clear();
+
+    if (pinIds.isEmpty())
+        return true;
+
+    // 管脚ID都是整数，直接写成IN列表，同一个集合用于所有语句
+    QStringList idList;
+    const QSet<int> uniqueIds(pinIds.begin(), pinIds.end());
+    for (int pinId : uniqueIds)
+        idList << QString::number(pinId);
+    const QString pinSet = "(" + idList.join(",") + ")";
+
+    // 确认对话框显示期间不持有写事务，数据库不被锁住
+    try
+    {
+        counts = countAffected(pinSet);
+    }
+    catch (const QString &error)
+    {
+        errorMessage = error;
+        counts = PinDeletionCounts();
+        qWarning() << "PinDeletionCascade::deletePins - 统计失败:" << error;
+        return false;
+    }
+
+    qDebug() << "PinDeletionCascade::deletePins - 待删除:" << counts.summary().replace("\n", "，");
+    if (confirm && !confirm(counts))
+    {
+        qDebug() << "PinDeletionCascade::deletePins - 用户取消";
+        counts = PinDeletionCounts();
+        return false;
+    }
+
+    if (!m_db.transaction())
+    {
+        errorMessage = QString("无法开始事务: %1").arg(m_db.lastError().text());
+        counts = PinDeletionCounts();
+        return false;
+    }
+
+    try
+    {
+        // 先删除依赖管脚列的管脚值，再删除管脚列本身
+        counts.pinValues = execDelete("DELETE FROM vector_table_pin_values WHERE vector_pin_id IN "
+                                      "(SELECT id FROM vector_table_pins WHERE pin_id IN " +
+                                          pinSet + ")",
+                                      "向量行管脚值");
+        counts.tablePins = execDelete("DELETE FROM vector_table_pins WHERE pin_id IN " + pinSet, "向量表管脚列");
+        counts.timeSetEdges = execDelete("DELETE FROM timeset_settings WHERE pin_id IN " + pinSet, "TimeSet边沿设置");
+        counts.pinSettings = execDelete("DELETE FROM pin_settings WHERE pin_id IN " + pinSet, "工位通道设置");
+
+        // 受影响的分组和将变为空的分组都要在删除成员之前按成员识别出来
+        counts.groupValues = execDelete("DELETE FROM vector_table_group_values WHERE group_id IN (" +
+                                            touchedGroupsSql(pinSet) + ")",
+                                        "分组值");
+        counts.groups = execDelete("DELETE FROM pin_groups WHERE group_id IN (" + emptiedGroupsSql(pinSet) + ")", "管脚分组");
+
+        counts.groupMembers = execDelete("DELETE FROM pin_group_members WHERE pin_id IN " + pinSet, "管脚分组成员");
+        counts.pins = execDelete("DELETE FROM pin_list WHERE id IN " + pinSet, "管脚");
+
+        if (!m_db.commit())
+        {
+            throw QString("提交事务失败: %1").arg(m_db.lastError().text());
+        }
+
+        qDebug() << "PinDeletionCascade::deletePins - 已删除:" << counts.summary().replace("\n", "，");
+        return true;
+    }
+    catch (const QString &error)
+    {
+        m_db.rollback();
+        errorMessage = error;
+        counts = PinDeletionCounts();
+        qWarning() << "PinDeletionCascade::deletePins - 删除失败，已回滚:" << error;
+        return false;
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef PINDELETIONCASCADE_H
+#define PINDELETIONCASCADE_H
+
+#include <QSqlDatabase>
+#include <QString>
+#include <QList>
+#include <functional>
+
+// 一次删除在各表中删除的行数
+struct PinDeletionCounts
+{
+    int pinValues = 0;    // vector_table_pin_values
+    int tablePins = 0;    // vector_table_pins
+    int timeSetEdges = 0; // timeset_settings
+    int pinSettings = 0;  // pin_settings
+    int groupMembers = 0; // pin_group_members
+    int groups = 0;       // pin_groups，成员全部被删除的分组
+    int groupValues = 0;  // vector_table_group_values，分组中有任一成员被删除
+    int pins = 0;         // pin_list
+
+    // 多行文字说明，用于提交前的确认
+    QString summary() const;
+};
+
+// 按管脚集合级联删除：数据库没有启用外键约束，依赖表由这里显式清理
+// 先用只读查询统计各表受影响的行数并确认，确认后才开始写事务，每张表一条按集合删除的语句
+// 成员全部被删除的管脚分组及其分组值一并删除
+class PinDeletionCascade
+{
+public:
+    // 统计完成、开始删除之前调用，返回false时不做任何修改
+    typedef std::function<bool(const PinDeletionCounts &)> ConfirmCallback;
+
+    explicit PinDeletionCascade(QSqlDatabase db);
+
+    // 删除pinIds及其所有依赖行；confirm为空时直接删除
+    // 返回false且errorMessage为空表示在确认时被取消；成功时counts为实际删除的行数
+    bool deletePins(const QList<int> &pinIds, const ConfirmCallback &confirm,
+                    PinDeletionCounts &counts, QString &errorMessage);
+
+private:
+    // 只读统计各表将被删除的行数
+    PinDeletionCounts countAffected(const QString &pinSet);
+    // 执行一条统计语句，返回计数
+    int execCount(const QString &sql, const QString &what);
+    // 执行一条删除语句，返回删除的行数
+    int execDelete(const QString &sql, const QString &what);
+
+    QSqlDatabase m_db;
+};
+
+#endif // PINDELETIONCASCADE_H
@@ -1,29 +1,36 @@
 #include "pinsettingsdialog.h"
 #include "../common/tablestylemanager.h"
 #include "../database/databasemanager.h"
+#include "pindeletioncascade.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
+#include <QFormLayout>
 #include <QLabel>
 #include <QMessageBox>
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QDebug>
 #include <QHeaderView>
-#include <QTableWidgetItem>
+#include <QItemSelectionModel>
 #include <QSqlDatabase>
 #include <QToolTip>
 #include <QInputDialog>
 #include <QCheckBox>
+#include <QComboBox>
+#include <QDialogButtonBox>
 #include <QScrollArea>
+#include <QFileDialog>
+#include <QDir>
+#include <QHash>
+#include <algorithm>
 
 PinSettingsDialog::PinSettingsDialog(QWidget *parent)
-    : QDialog(parent), m_currentStationCount(1)
+    : QDialog(parent)
 {
     qDebug() << "PinSettingsDialog::PinSettingsDialog - 初始化管脚设置对话框";
     setupUI();
     loadPinsData();
-    updateTable();
 }
 
 PinSettingsDialog::~PinSettingsDialog()
@@ -47,8 +54,8 @@ void PinSettingsDialog::setupUI()
     QLabel *stationLabel = new QLabel("工位数：", this);
     m_stationCountSpinBox = new QSpinBox(this);
     m_stationCountSpinBox->setMinimum(1);
-    m_stationCountSpinBox->setMaximum(10); // 设置合理的最大工位数
-    m_stationCountSpinBox->setValue(m_currentStationCount);
+    m_stationCountSpinBox->setMaximum(MAX_STATION_COUNT);
+    m_stationCountSpinBox->setValue(1);
     m_stationCountSpinBox->setToolTip("设置需要配置的工位数量");
 
     topLayout->addWidget(stationLabel);
@@ -59,6 +66,11 @@ void PinSettingsDialog::setupUI()
     infoLabel->setStyleSheet("color: #666; font-style: italic;");
     topLayout->addWidget(infoLabel);
 
+    // 添加"批量分配"按钮
+    m_assignButton = new QPushButton("批量分配位索引...", this);
+    m_assignButton->setToolTip("按管脚顺序为所有工位一次性分配位索引");
+    topLayout->addWidget(m_assignButton);
+
     // 添加"添加管脚"按钮
     m_addPinButton = new QPushButton("添加管脚", this);
     m_addPinButton->setToolTip("添加新的管脚到系统中");
@@ -73,14 +85,43 @@ void PinSettingsDialog::setupUI()
 
     mainLayout->addLayout(topLayout);
 
-    // 创建表格
-    m_pinSettingsTable = new QTableWidget(this);
-    m_pinSettingsTable->setAlternatingRowColors(true);
+    // 通道映射：冲突统计、自动分配和导出
+    QHBoxLayout *channelLayout = new QHBoxLayout();
+    m_sharedChannelsCheckBox = new QCheckBox("各工位通道统一编号", this);
+    m_sharedChannelsCheckBox->setToolTip("勾选后不同工位之间的通道也不能重叠，否则只检查同一工位内的通道");
+    channelLayout->addWidget(m_sharedChannelsCheckBox);
+
+    m_channelStatusLabel = new QLabel(this);
+    channelLayout->addWidget(m_channelStatusLabel);
+    channelLayout->addStretch();
+
+    m_autoChannelButton = new QPushButton("自动分配通道", this);
+    m_autoChannelButton->setToolTip("为未设置位索引的工位分配不重叠的通道，并重新分配有冲突的单元格");
+    channelLayout->addWidget(m_autoChannelButton);
+
+    m_exportChannelButton = new QPushButton("导出通道表...", this);
+    m_exportChannelButton->setToolTip("将各工位各管脚的通道导出为CSV文件");
+    channelLayout->addWidget(m_exportChannelButton);
+
+    mainLayout->addLayout(channelLayout);
+
+    // 创建表格，行列由模型按管脚数和工位数给出
+    m_model = new PinSettingsModel(this);
+    m_pinSettingsView = new QTableView(this);
+    m_pinSettingsView->setModel(m_model);
 
     // 应用表格样式
-    TableStyleManager::applyTableStyle(m_pinSettingsTable);
+    TableStyleManager::applyTableStyle(m_pinSettingsView);
+
+    // 列宽模式只设置一次，工位列使用默认宽度，增删工位时不再逐列调整
+    QHeaderView *header = m_pinSettingsView->horizontalHeader();
+    header->setSectionResizeMode(QHeaderView::Interactive);
+    header->setDefaultSectionSize(90);
+    m_pinSettingsView->setColumnWidth(PinSettingsModel::PinColumn, 120);         // 管脚名称
+    m_pinSettingsView->setColumnWidth(PinSettingsModel::ChannelCountColumn, 80); // 通道个数
+    m_pinSettingsView->setColumnWidth(PinSettingsModel::NoteColumn, 200);        // 注释
 
-    mainLayout->addWidget(m_pinSettingsTable);
+    mainLayout->addWidget(m_pinSettingsView);
 
     // 创建按钮布局
     QHBoxLayout *buttonLayout = new QHBoxLayout();
@@ -100,6 +141,12 @@ void PinSettingsDialog::setupUI()
     connect(m_cancelButton, &QPushButton::clicked, this, &PinSettingsDialog::onRejected);
     connect(m_addPinButton, &QPushButton::clicked, this, &PinSettingsDialog::onAddPin);
     connect(m_deletePinButton, &QPushButton::clicked, this, &PinSettingsDialog::onDeletePin);
+    connect(m_assignButton, &QPushButton::clicked, this, &PinSettingsDialog::onAssignBitIndexes);
+    connect(m_autoChannelButton, &QPushButton::clicked, this, &PinSettingsDialog::onAutoAssignChannels);
+    connect(m_exportChannelButton, &QPushButton::clicked, this, &PinSettingsDialog::onExportChannelMap);
+    connect(m_sharedChannelsCheckBox, &QCheckBox::toggled, this, [this](bool checked)
+            { m_model->setChannelScope(checked ? ChannelMap::SharedAcrossSites : ChannelMap::PerSite); });
+    connect(m_model, &PinSettingsModel::channelMapChanged, this, &PinSettingsDialog::onChannelMapChanged);
 }
 
 void PinSettingsDialog::loadPinsData()
@@ -114,21 +161,24 @@ void PinSettingsDialog::loadPinsData()
         return;
     }
 
-    // 加载所有管脚及其注释
-    QSqlQuery pinQuery("SELECT id, pin_name, pin_note FROM pin_list ORDER BY pin_name");
-    if (pinQuery.exec())
+    // 加载所有管脚及其注释，按名称排序
+    QList<int> pinIds;
+    QList<QString> pinNames;
+    QList<QString> pinNotes;
+    m_allPins.clear();
+
+    QSqlQuery pinQuery(db);
+    if (pinQuery.exec("SELECT id, pin_name, pin_note FROM pin_list ORDER BY pin_name"))
     {
         while (pinQuery.next())
         {
             int pinId = pinQuery.value(0).toInt();
             QString pinName = pinQuery.value(1).toString();
-            QString pinNote = pinQuery.value(2).toString();
 
+            pinIds.append(pinId);
+            pinNames.append(pinName);
+            pinNotes.append(pinQuery.value(2).toString());
             m_allPins[pinId] = pinName;
-            m_pinNotes[pinId] = pinNote;
-            m_channelCounts[pinId] = 1; // 默认通道数为1
-
-            qDebug() << "  加载管脚: ID=" << pinId << ", 名称=" << pinName << ", 注释=" << pinNote;
         }
     }
     else
@@ -137,28 +187,22 @@ void PinSettingsDialog::loadPinsData()
     }
 
     // 加载现有的管脚设置
-    QSqlQuery settingsQuery("SELECT pin_id, station_number, station_bit_index, channel_count FROM pin_settings");
-    if (settingsQuery.exec())
+    // 格式: <pin_id, <station_number, station_bit_index>>
+    QMap<int, QMap<int, int>> existingSettings;
+    QHash<int, int> channelCountByPin;
+    int stationCount = 1;
+
+    QSqlQuery settingsQuery(db);
+    if (settingsQuery.exec("SELECT pin_id, station_number, station_bit_index, channel_count FROM pin_settings"))
     {
         while (settingsQuery.next())
         {
             int pinId = settingsQuery.value(0).toInt();
             int stationNumber = settingsQuery.value(1).toInt();
-            int stationBitIndex = settingsQuery.value(2).toInt();
-            int channelCount = settingsQuery.value(3).toInt();
-
-            // 保存现有设置
-            m_existingSettings[pinId][stationNumber] = stationBitIndex;
 
-            // 保存通道数
-            m_channelCounts[pinId] = channelCount;
-
-            // 更新工位数
-            m_currentStationCount = qMax(m_currentStationCount, stationNumber + 1);
-            qDebug() << "  已有设置: 管脚ID=" << pinId
-                     << ", 工位=" << stationNumber
-                     << ", 位索引=" << stationBitIndex
-                     << ", 通道数=" << channelCount;
+            existingSettings[pinId][stationNumber] = settingsQuery.value(2).toInt();
+            channelCountByPin[pinId] = settingsQuery.value(3).toInt();
+            stationCount = qMax(stationCount, stationNumber + 1);
         }
     }
     else
@@ -166,177 +210,194 @@ void PinSettingsDialog::loadPinsData()
         qWarning() << "PinSettingsDialog::loadPinsData - 查询管脚设置数据失败:" << settingsQuery.lastError().text();
     }
 
-    // 更新工位数SpinBox的值
-    m_stationCountSpinBox->setValue(m_currentStationCount);
+    // 没有设置的管脚默认通道数为1
+    QList<int> channelCounts;
+    channelCounts.reserve(pinIds.size());
+    for (int pinId : pinIds)
+        channelCounts.append(channelCountByPin.value(pinId, 1));
+
+    stationCount = qMin(stationCount, int(MAX_STATION_COUNT));
+    m_model->setPins(pinIds, pinNames, pinNotes, channelCounts, existingSettings);
+    m_model->setStationCount(stationCount);
+    m_model->markSaved();
+
+    // 更新工位数SpinBox的值，模型已经是该工位数，不会再次增删列
+    m_stationCountSpinBox->setValue(stationCount);
+
+    qDebug() << "PinSettingsDialog::loadPinsData - 管脚数:" << pinIds.size()
+             << "，已设置管脚数:" << existingSettings.size() << "，工位数:" << stationCount;
 }
 
-void PinSettingsDialog::updateTable()
+void PinSettingsDialog::onStationCountChanged(int value)
 {
-    qDebug() << "PinSettingsDialog::updateTable - 更新表格，工位数=" << m_currentStationCount;
-
-    // 保存当前的垂直滚动条位置
-    int scrollPosition = m_pinSettingsTable->verticalScrollBar() ? m_pinSettingsTable->verticalScrollBar()->value() : 0;
+    qDebug() << "PinSettingsDialog::onStationCountChanged - 工位数变更为" << value;
 
-    // 清空表格
-    m_pinSettingsTable->clear();
+    // 只增删工位列
+    m_model->setStationCount(value);
+}
 
-    // 设置列数：管脚列、通道个数列、注释列，然后每个工位一列
-    int stationColumnsStart = 3; // 前三列是固定的：管脚、通道个数、注释
-    int columnCount = stationColumnsStart + m_currentStationCount;
-    m_pinSettingsTable->setColumnCount(columnCount);
+void PinSettingsDialog::onAssignBitIndexes()
+{
+    qDebug() << "PinSettingsDialog::onAssignBitIndexes - 用户点击批量分配位索引按钮";
 
-    // 设置表头
-    QStringList headers;
-    headers << "管脚"
-            << "通道-个数"
-            << "注释";
-    for (int i = 0; i < m_currentStationCount; ++i)
+    if (m_model->rowCount() == 0)
     {
-        // 将工位编号从0开始改为从1开始显示
-        headers << QString("通道-工位%1").arg(i + 1);
+        QMessageBox::information(this, "提示", "没有可分配的管脚");
+        return;
     }
-    m_pinSettingsTable->setHorizontalHeaderLabels(headers);
 
-    // 设置工具提示
-    for (int i = 0; i < m_pinSettingsTable->columnCount(); ++i)
+    // 选中的管脚行，按表格顺序
+    QList<int> selectedRows;
+    for (const QModelIndex &index : m_pinSettingsView->selectionModel()->selectedRows())
+        selectedRows.append(index.row());
+    if (selectedRows.isEmpty())
     {
-        if (i == 0)
-        {
-            m_pinSettingsTable->horizontalHeaderItem(i)->setToolTip("管脚名称");
-        }
-        else if (i == 1)
-        {
-            m_pinSettingsTable->horizontalHeaderItem(i)->setToolTip("设置通道个数");
-        }
-        else if (i == 2)
-        {
-            m_pinSettingsTable->horizontalHeaderItem(i)->setToolTip("管脚相关说明");
-        }
-        else
+        // 只选中了单元格时按单元格所在的行
+        for (const QModelIndex &index : m_pinSettingsView->selectionModel()->selectedIndexes())
         {
-            int stationNumber = i - stationColumnsStart + 1; // 计算工位号（从1开始）
-            m_pinSettingsTable->horizontalHeaderItem(i)->setToolTip(
-                QString("设置通道在工位%1的位索引值").arg(stationNumber));
+            if (!selectedRows.contains(index.row()))
+                selectedRows.append(index.row());
         }
     }
-
-    // 设置列宽
-    m_pinSettingsTable->setColumnWidth(0, 120); // 管脚名称
-    m_pinSettingsTable->setColumnWidth(1, 80);  // 通道个数
-    m_pinSettingsTable->setColumnWidth(2, 200); // 注释
-
-    // 设置其余列弹性拉伸
-    m_pinSettingsTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Interactive);
-    m_pinSettingsTable->horizontalHeader()->setSectionResizeMode(1, QHeaderView::Interactive);
-    m_pinSettingsTable->horizontalHeader()->setSectionResizeMode(2, QHeaderView::Interactive);
-    for (int i = stationColumnsStart; i < columnCount; ++i)
-    {
-        m_pinSettingsTable->horizontalHeader()->setSectionResizeMode(i, QHeaderView::Stretch);
+    std::sort(selectedRows.begin(), selectedRows.end());
+
+    // 创建分配对话框
+    QDialog assignDialog(this);
+    assignDialog.setWindowTitle("批量分配位索引");
+
+    QFormLayout *formLayout = new QFormLayout(&assignDialog);
+
+    QComboBox *modeComboBox = new QComboBox(&assignDialog);
+    modeComboBox->addItem("自动递增（各工位依次接续）");
+    modeComboBox->addItem("按工位偏移");
+    formLayout->addRow("分配方式：", modeComboBox);
+
+    QSpinBox *startSpinBox = new QSpinBox(&assignDialog);
+    startSpinBox->setRange(0, 1000000);
+    startSpinBox->setToolTip("工位1第一个管脚的位索引");
+    formLayout->addRow("起始位索引：", startSpinBox);
+
+    QSpinBox *offsetSpinBox = new QSpinBox(&assignDialog);
+    offsetSpinBox->setRange(0, 1000000);
+    offsetSpinBox->setToolTip("相邻工位起始位索引之间的差值");
+    offsetSpinBox->setEnabled(false);
+    formLayout->addRow("工位偏移：", offsetSpinBox);
+
+    QCheckBox *selectedOnlyCheckBox = new QCheckBox(QString("仅分配选中的 %1 个管脚").arg(selectedRows.size()), &assignDialog);
+    selectedOnlyCheckBox->setEnabled(!selectedRows.isEmpty());
+    selectedOnlyCheckBox->setChecked(!selectedRows.isEmpty());
+    formLayout->addRow(selectedOnlyCheckBox);
+
+    QLabel *hintLabel = new QLabel(QString("将覆盖全部 %1 个工位的位索引，每个管脚占用其通道个数个位")
+                                       .arg(m_model->stationCount()),
+                                   &assignDialog);
+    hintLabel->setStyleSheet("color: #666; font-style: italic;");
+    formLayout->addRow(hintLabel);
+
+    QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &assignDialog);
+    formLayout->addRow(buttonBox);
+
+    QList<int> allRows;
+    allRows.reserve(m_model->rowCount());
+    for (int row = 0; row < m_model->rowCount(); ++row)
+        allRows.append(row);
+
+    // 自动递增时工位偏移等于参与分配的管脚通道总数，只显示不可编辑
+    auto updateOffset = [&]()
+    {
+        bool autoIncrement = modeComboBox->currentIndex() == 0;
+        offsetSpinBox->setEnabled(!autoIncrement);
+        if (autoIncrement)
+            offsetSpinBox->setValue(m_model->channelSpan(selectedOnlyCheckBox->isChecked() ? selectedRows : allRows));
+    };
+    updateOffset();
+    connect(modeComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), &assignDialog, updateOffset);
+    connect(selectedOnlyCheckBox, &QCheckBox::toggled, &assignDialog, updateOffset);
+    connect(buttonBox, &QDialogButtonBox::accepted, &assignDialog, &QDialog::accept);
+    connect(buttonBox, &QDialogButtonBox::rejected, &assignDialog, &QDialog::reject);
+
+    if (assignDialog.exec() != QDialog::Accepted)
+    {
+        qDebug() << "PinSettingsDialog::onAssignBitIndexes - 用户取消分配";
+        return;
     }
 
-    // 设置行数
-    m_pinSettingsTable->setRowCount(m_allPins.size());
+    const QList<int> &rows = selectedOnlyCheckBox->isChecked() ? selectedRows : allRows;
+    m_model->assignBitIndexes(rows, startSpinBox->value(), offsetSpinBox->value());
+}
 
-    // 填充数据
-    int row = 0;
-    for (auto it = m_allPins.begin(); it != m_allPins.end(); ++it, ++row)
-    {
-        int pinId = it.key();
-        QString pinName = it.value();
+void PinSettingsDialog::onAutoAssignChannels()
+{
+    qDebug() << "PinSettingsDialog::onAutoAssignChannels - 用户点击自动分配通道按钮";
 
-        // 设置管脚名称
-        QTableWidgetItem *nameItem = new QTableWidgetItem(pinName);
-        nameItem->setFlags(nameItem->flags() & ~Qt::ItemIsEditable); // 不可编辑
-        nameItem->setData(Qt::UserRole, pinId);                      // 存储管脚ID
-        m_pinSettingsTable->setItem(row, 0, nameItem);
+    if (m_model->rowCount() == 0)
+    {
+        QMessageBox::information(this, "提示", "没有可分配的管脚");
+        return;
+    }
 
-        // 设置通道个数
-        QTableWidgetItem *channelCountItem = new QTableWidgetItem(QString::number(m_channelCounts[pinId]));
-        channelCountItem->setTextAlignment(Qt::AlignCenter);
-        m_pinSettingsTable->setItem(row, 1, channelCountItem);
+    int assigned = m_model->autoAssignChannels(true);
+    QMessageBox::information(this, "自动分配通道",
+                             QString("已为 %1 个单元格分配通道，剩余冲突 %2 处")
+                                 .arg(assigned)
+                                 .arg(m_model->channelMap().conflicts().size()));
+}
 
-        // 设置注释
-        QTableWidgetItem *noteItem = new QTableWidgetItem(m_pinNotes[pinId]);
-        m_pinSettingsTable->setItem(row, 2, noteItem);
+void PinSettingsDialog::onExportChannelMap()
+{
+    qDebug() << "PinSettingsDialog::onExportChannelMap - 用户点击导出通道表按钮";
 
-        // 设置每个工位的管脚位索引
-        for (int stationNumber = 0; stationNumber < m_currentStationCount; ++stationNumber)
+    if (m_model->channelMap().conflicts().size() > 0)
+    {
+        QMessageBox::StandardButton reply = QMessageBox::question(this, "通道冲突",
+                                                                  QString("当前有 %1 处通道冲突，仍要导出吗？")
+                                                                      .arg(m_model->channelMap().conflicts().size()),
+                                                                  QMessageBox::Yes | QMessageBox::No,
+                                                                  QMessageBox::No);
+        if (reply == QMessageBox::No)
         {
-            QTableWidgetItem *stationItem = new QTableWidgetItem();
-            stationItem->setTextAlignment(Qt::AlignCenter);
-
-            // 如果有现有设置，则使用它
-            if (m_existingSettings.contains(pinId) && m_existingSettings[pinId].contains(stationNumber))
-            {
-                int bitIndex = m_existingSettings[pinId][stationNumber];
-                stationItem->setText(QString::number(bitIndex));
-            }
-            m_pinSettingsTable->setItem(row, stationNumber + stationColumnsStart, stationItem);
+            return;
         }
     }
 
-    // 恢复滚动条位置
-    if (m_pinSettingsTable->verticalScrollBar())
+    QString fileName = QFileDialog::getSaveFileName(this, "导出通道表",
+                                                    QDir::homePath() + "/通道表.csv",
+                                                    "CSV文件 (*.csv);;所有文件 (*)");
+    if (fileName.isEmpty())
     {
-        m_pinSettingsTable->verticalScrollBar()->setValue(scrollPosition);
+        return;
     }
-}
 
-void PinSettingsDialog::onStationCountChanged(int value)
-{
-    qDebug() << "PinSettingsDialog::onStationCountChanged - 工位数变更为" << value;
+    QString errorMessage;
+    if (!m_model->channelMap().exportCsv(fileName, errorMessage))
+    {
+        qWarning() << "PinSettingsDialog::onExportChannelMap - 导出失败:" << errorMessage;
+        QMessageBox::critical(this, "错误", errorMessage);
+        return;
+    }
 
-    // 更新当前工位数
-    m_currentStationCount = value;
+    QMessageBox::information(this, "导出成功", QString("通道表已导出到 %1").arg(fileName));
+}
 
-    // 更新表格
-    updateTable();
+void PinSettingsDialog::onChannelMapChanged(int conflictCount)
+{
+    if (conflictCount > 0)
+    {
+        m_channelStatusLabel->setText(QString("通道冲突：%1 处").arg(conflictCount));
+        m_channelStatusLabel->setStyleSheet("color: #c00000;");
+    }
+    else
+    {
+        m_channelStatusLabel->setText("通道无冲突");
+        m_channelStatusLabel->setStyleSheet("color: #666;");
+    }
 }
 
 void PinSettingsDialog::onAccepted()
 {
     qDebug() << "PinSettingsDialog::onAccepted - 用户点击确定按钮";
 
-    // 验证输入数据
-    for (int row = 0; row < m_pinSettingsTable->rowCount(); ++row)
-    {
-        // 验证通道个数
-        QTableWidgetItem *channelCountItem = m_pinSettingsTable->item(row, 1);
-        if (channelCountItem)
-        {
-            bool ok;
-            int channelCount = channelCountItem->text().toInt(&ok);
-            if (!ok || channelCount <= 0)
-            {
-                QMessageBox::warning(this, "输入错误",
-                                     QString("第 %1 行的通道个数必须是大于0的数字").arg(row + 1));
-                return;
-            }
-        }
-
-        // 验证工位位索引
-        int stationColumnsStart = 3;
-        for (int col = stationColumnsStart; col < m_pinSettingsTable->columnCount(); ++col)
-        {
-            QTableWidgetItem *stationItem = m_pinSettingsTable->item(row, col);
-            if (stationItem && !stationItem->text().isEmpty())
-            {
-                bool ok;
-                stationItem->text().toInt(&ok);
-                if (!ok)
-                {
-                    int stationNumber = col - stationColumnsStart + 1;
-                    QMessageBox::warning(this, "输入错误",
-                                         QString("第 %1 行工位 %2 的位索引必须是数字")
-                                             .arg(row + 1)
-                                             .arg(stationNumber));
-                    return;
-                }
-            }
-        }
-    }
-
-    // 检查位索引值的唯一性
+    // 通道个数和位索引的格式已由模型在编辑时校验，这里只检查通道是否重叠
     if (!checkBitIndexUniqueness())
     {
         return;
@@ -356,76 +417,58 @@ void PinSettingsDialog::onAccepted()
 
 bool PinSettingsDialog::checkBitIndexUniqueness()
 {
-    qDebug() << "PinSettingsDialog::checkBitIndexUniqueness - 检查位索引值唯一性";
-
-    // 用于存储每个工位的位索引使用情况
-    // 结构: <工位号, <位索引值, <管脚ID, 管脚名称>>>
-    QMap<int, QMap<int, QPair<int, QString>>> usedBitIndices;
-
-    int stationColumnsStart = 3;
+    qDebug() << "PinSettingsDialog::checkBitIndexUniqueness - 检查通道是否重叠";
 
-    // 收集所有使用的位索引值
-    for (int row = 0; row < m_pinSettingsTable->rowCount(); ++row)
+    // 通道映射随编辑实时维护，这里只报告第一处冲突
+    const QVector<ChannelConflict> &conflicts = m_model->channelMap().conflicts();
+    if (conflicts.isEmpty())
     {
-        QTableWidgetItem *nameItem = m_pinSettingsTable->item(row, 0);
-        if (!nameItem)
-            continue;
-
-        int pinId = nameItem->data(Qt::UserRole).toInt();
-        QString pinName = nameItem->text();
-
-        for (int stationNumber = 0; stationNumber < m_currentStationCount; ++stationNumber)
-        {
-            QTableWidgetItem *stationItem = m_pinSettingsTable->item(row, stationNumber + stationColumnsStart);
-            if (!stationItem || stationItem->text().isEmpty())
-                continue;
+        qDebug() << "PinSettingsDialog::checkBitIndexUniqueness - 未发现通道冲突";
+        return true;
+    }
 
-            bool ok;
-            int bitIndex = stationItem->text().toInt(&ok);
-            if (!ok)
-                continue; // 跳过非数字值（前面已验证过）
+    const ChannelConflict &conflict = conflicts.first();
+    QString pinName = m_model->pinName(conflict.row);
 
-            // 检查该工位的该位索引是否已被使用
-            if (usedBitIndices[stationNumber].contains(bitIndex))
-            {
-                // 已被使用，记录冲突信息
-                QPair<int, QString> existingPin = usedBitIndices[stationNumber][bitIndex];
-
-                // 显示错误消息，告知冲突详情
-                QString errorMsg = QString("%1 管脚在%2工位硬编码与分配重复").arg(pinName).arg(stationNumber + 1);
-                QString detailMsg = QString("管脚 %1 和管脚 %2 在工位 %3 使用了相同的位索引值 %4。\n\n"
-                                            "每个工位的位索引值必须唯一。请修改其中一个管脚的位索引值。")
-                                        .arg(pinName)
-                                        .arg(existingPin.second)
-                                        .arg(stationNumber + 1)
-                                        .arg(bitIndex);
-
-                QMessageBox msgBox(this);
-                msgBox.setIcon(QMessageBox::Warning);
-                msgBox.setWindowTitle("位索引冲突");
-                msgBox.setText(errorMsg);
-                msgBox.setInformativeText(detailMsg);
-                msgBox.setStandardButtons(QMessageBox::Ok);
-                msgBox.exec();
-
-                // 选中冲突的单元格以便用户修改
-                m_pinSettingsTable->setCurrentItem(stationItem);
-                stationItem->setSelected(true);
-
-                qDebug() << "PinSettingsDialog::checkBitIndexUniqueness - 发现冲突:"
-                         << "管脚" << pinName << "和管脚" << existingPin.second
-                         << "在工位" << (stationNumber + 1) << "使用了相同的位索引" << bitIndex;
-
-                return false;
-            }
-
-            // 记录该位索引已被使用
-            usedBitIndices[stationNumber][bitIndex] = qMakePair(pinId, pinName);
-        }
+    QString errorMsg;
+    QString detailMsg;
+    if (conflict.otherRow < 0)
+    {
+        errorMsg = QString("%1 管脚在%2工位的位索引超出范围").arg(pinName).arg(conflict.site + 1);
+        detailMsg = QString("位索引 %1 超出了允许的通道范围(0~%2)。")
+                        .arg(conflict.channel)
+                        .arg(ChannelMap::MAX_CHANNEL - 1);
     }
-
-    qDebug() << "PinSettingsDialog::checkBitIndexUniqueness - 未发现位索引冲突";
-    return true;
+    else
+    {
+        QString existingPinName = m_model->pinName(conflict.otherRow);
+        errorMsg = QString("%1 管脚在%2工位硬编码与分配重复").arg(pinName).arg(conflict.site + 1);
+        detailMsg = QString("管脚 %1(工位 %2) 和管脚 %3(工位 %4) 都占用了通道 %5。\n\n"
+                            "每个管脚从位索引开始占用其通道个数个通道，通道不能重叠。"
+                            "请修改其中一个管脚的位索引值，或使用\"自动分配通道\"。")
+                        .arg(pinName)
+                        .arg(conflict.site + 1)
+                        .arg(existingPinName)
+                        .arg(conflict.otherSite + 1)
+                        .arg(conflict.channel);
+    }
+
+    QMessageBox msgBox(this);
+    msgBox.setIcon(QMessageBox::Warning);
+    msgBox.setWindowTitle("位索引冲突");
+    msgBox.setText(errorMsg);
+    msgBox.setInformativeText(detailMsg);
+    msgBox.setStandardButtons(QMessageBox::Ok);
+    msgBox.exec();
+
+    // 选中冲突的单元格以便用户修改
+    QModelIndex conflictIndex = m_model->index(conflict.row, PinSettingsModel::FirstStationColumn + conflict.site);
+    m_pinSettingsView->setCurrentIndex(conflictIndex);
+    m_pinSettingsView->scrollTo(conflictIndex);
+
+    qDebug() << "PinSettingsDialog::checkBitIndexUniqueness - 冲突数:" << conflicts.size()
+             << "，首个冲突: 管脚" << pinName << "工位" << (conflict.site + 1) << "通道" << conflict.channel;
+    return false;
 }
 
 void PinSettingsDialog::onRejected()
@@ -450,68 +493,18 @@ void PinSettingsDialog::onRejected()
 
 bool PinSettingsDialog::isDataModified()
 {
-    // 检查是否有未保存的修改
-    for (int row = 0; row < m_pinSettingsTable->rowCount(); ++row)
-    {
-        QTableWidgetItem *nameItem = m_pinSettingsTable->item(row, 0);
-        if (!nameItem)
-            continue;
-
-        int pinId = nameItem->data(Qt::UserRole).toInt();
-
-        // 检查通道个数是否修改
-        QTableWidgetItem *channelCountItem = m_pinSettingsTable->item(row, 1);
-        if (channelCountItem)
-        {
-            bool ok;
-            int channelCount = channelCountItem->text().toInt(&ok);
-            if (ok && channelCount != m_channelCounts[pinId])
-            {
-                return true;
-            }
-        }
-
-        // 检查注释是否修改
-        QTableWidgetItem *noteItem = m_pinSettingsTable->item(row, 2);
-        if (noteItem && noteItem->text() != m_pinNotes[pinId])
-        {
-            return true;
-        }
-
-        // 检查工位设置是否修改
-        int stationColumnsStart = 3;
-        for (int stationNumber = 0; stationNumber < m_currentStationCount; ++stationNumber)
-        {
-            QTableWidgetItem *stationItem = m_pinSettingsTable->item(row, stationNumber + stationColumnsStart);
-            if (!stationItem)
-                continue;
-
-            bool hasOriginalValue = m_existingSettings.contains(pinId) &&
-                                    m_existingSettings[pinId].contains(stationNumber);
+    // 与加载时的内容比较，由模型完成
+    return m_model->isModified();
+}
 
-            if (stationItem->text().isEmpty())
-            {
-                if (hasOriginalValue)
-                {
-                    return true;
-                }
-            }
-            else
-            {
-                bool ok;
-                int bitIndex = stationItem->text().toInt(&ok);
-                if (ok)
-                {
-                    if (!hasOriginalValue || bitIndex != m_existingSettings[pinId][stationNumber])
-                    {
-                        return true;
-                    }
-                }
-            }
-        }
+QString PinSettingsDialog::settingsInsertSql(int count)
+{
+    QStringList values;
+    for (int i = 0; i < count; ++i)
+    {
+        values << "(?, ?, ?, ?)";
     }
-
-    return false;
+    return "INSERT INTO pin_settings (pin_id, channel_count, station_bit_index, station_number) VALUES " + values.join(", ");
 }
 
 bool PinSettingsDialog::saveSettings()
@@ -527,144 +520,94 @@ bool PinSettingsDialog::saveSettings()
         return false;
     }
 
+    // 收集要写入的记录，每条4个值：管脚ID、通道个数、位索引、工位号
+    const int stationCount = m_model->stationCount();
+    QVector<int> records;
+    records.reserve(m_model->rowCount() * stationCount * 4);
+    for (int row = 0; row < m_model->rowCount(); ++row)
+    {
+        for (int stationNumber = 0; stationNumber < stationCount; ++stationNumber)
+        {
+            int bitIndex = m_model->bitIndex(row, stationNumber);
+            if (bitIndex == PinSettingsModel::NoBitIndex)
+                continue; // 跳过空值
+            records << m_model->pinId(row) << m_model->channelCount(row) << bitIndex << stationNumber;
+        }
+    }
+    const int recordCount = records.size() / 4;
+
     // 开始事务
     db.transaction();
 
     try
     {
-        // 首先从表格中收集最新的数据
-        QMap<int, QString> updatedNotes;     // 存储更新后的注释
-        QMap<int, int> updatedChannelCounts; // 存储更新后的通道个数
-
-        for (int row = 0; row < m_pinSettingsTable->rowCount(); ++row)
-        {
-            // 获取管脚ID
-            QTableWidgetItem *nameItem = m_pinSettingsTable->item(row, 0);
-            if (!nameItem)
-                continue;
-            int pinId = nameItem->data(Qt::UserRole).toInt();
-
-            // 获取通道个数
-            QTableWidgetItem *channelCountItem = m_pinSettingsTable->item(row, 1);
-            if (channelCountItem)
-            {
-                bool ok;
-                int channelCount = channelCountItem->text().toInt(&ok);
-                if (ok && channelCount > 0)
-                {
-                    updatedChannelCounts[pinId] = channelCount;
-                }
-                else
-                {
-                    updatedChannelCounts[pinId] = 1; // 默认值为1
-                }
-            }
-            else
-            {
-                updatedChannelCounts[pinId] = 1; // 默认值为1
-            }
-
-            // 获取注释
-            QTableWidgetItem *noteItem = m_pinSettingsTable->item(row, 2);
-            if (noteItem)
-            {
-                updatedNotes[pinId] = noteItem->text();
-            }
-            else
-            {
-                updatedNotes[pinId] = "";
-            }
-        }
-
-        // 更新pin_list表中的注释
-        QSqlQuery updateNoteQuery;
+        // 只更新修改过的注释
+        QSqlQuery updateNoteQuery(db);
         updateNoteQuery.prepare("UPDATE pin_list SET pin_note = ? WHERE id = ?");
-
-        for (auto it = updatedNotes.begin(); it != updatedNotes.end(); ++it)
+        for (int row = 0; row < m_model->rowCount(); ++row)
         {
-            int pinId = it.key();
-            QString note = it.value();
-
-            updateNoteQuery.bindValue(0, note);
-            updateNoteQuery.bindValue(1, pinId);
+            if (!m_model->noteModified(row))
+                continue;
 
+            updateNoteQuery.bindValue(0, m_model->note(row));
+            updateNoteQuery.bindValue(1, m_model->pinId(row));
             if (!updateNoteQuery.exec())
             {
-                throw std::runtime_error(updateNoteQuery.lastError().text().toStdString());
+                throw QString("更新管脚注释失败: %1").arg(updateNoteQuery.lastError().text());
             }
-
-            qDebug() << "  更新注释: 管脚ID=" << pinId << ", 注释=" << note;
         }
 
-        // 清空pin_settings表
-        QSqlQuery clearQuery("DELETE FROM pin_settings");
-        if (!clearQuery.exec())
+        // 清空pin_settings表后整体重写
+        QSqlQuery clearQuery(db);
+        if (!clearQuery.exec("DELETE FROM pin_settings"))
         {
-            throw std::runtime_error(clearQuery.lastError().text().toStdString());
+            throw QString("清空管脚设置失败: %1").arg(clearQuery.lastError().text());
         }
 
-        // 插入新的pin_settings数据
-        QSqlQuery insertQuery;
-        insertQuery.prepare("INSERT INTO pin_settings (pin_id, channel_count, station_bit_index, station_number) "
-                            "VALUES (?, ?, ?, ?)");
-
-        // 遍历表格中的每个管脚
-        int stationColumnsStart = 3; // 前三列是固定的：管脚、通道个数、注释
-        for (int row = 0; row < m_pinSettingsTable->rowCount(); ++row)
+        // 多行INSERT批量写入，整批语句只准备两次(整批和最后不足一批的部分)
+        if (recordCount > 0)
         {
-            // 获取管脚ID
-            QTableWidgetItem *nameItem = m_pinSettingsTable->item(row, 0);
-            if (!nameItem)
-                continue;
-
-            int pinId = nameItem->data(Qt::UserRole).toInt();
-            int channelCount = updatedChannelCounts[pinId];
-
-            // 遍历每个工位
-            for (int stationNumber = 0; stationNumber < m_currentStationCount; ++stationNumber)
+            int recordsPerStatement = qMin(recordCount, int(SETTINGS_PER_INSERT));
+            int remainderRecords = recordCount % recordsPerStatement;
+            QSqlQuery insertQuery(db);
+            insertQuery.prepare(settingsInsertSql(recordsPerStatement));
+            QSqlQuery remainderInsertQuery(db);
+            if (remainderRecords > 0)
+                remainderInsertQuery.prepare(settingsInsertSql(remainderRecords));
+
+            for (int first = 0; first < recordCount; first += recordsPerStatement)
             {
-                QTableWidgetItem *stationItem = m_pinSettingsTable->item(row, stationNumber + stationColumnsStart);
-                if (!stationItem)
-                    continue;
-
-                QString bitIndexText = stationItem->text().trimmed();
-                if (bitIndexText.isEmpty())
-                    continue; // 跳过空值
-
-                bool ok;
-                int bitIndex = bitIndexText.toInt(&ok);
-                if (!ok)
-                    continue; // 跳过非数字值
-
-                // 插入数据
-                insertQuery.bindValue(0, pinId);
-                insertQuery.bindValue(1, channelCount);
-                insertQuery.bindValue(2, bitIndex);
-                insertQuery.bindValue(3, stationNumber);
-
-                if (!insertQuery.exec())
+                int count = qMin(recordsPerStatement, recordCount - first);
+                QSqlQuery &query = (count == recordsPerStatement) ? insertQuery : remainderInsertQuery;
+                const int *values = records.constData() + first * 4;
+                for (int j = 0; j < count * 4; ++j)
                 {
-                    throw std::runtime_error(insertQuery.lastError().text().toStdString());
+                    query.bindValue(j, values[j]);
+                }
+                if (!query.exec())
+                {
+                    throw QString("保存管脚设置失败: %1").arg(query.lastError().text());
                 }
-
-                qDebug() << "  保存设置: 管脚ID=" << pinId
-                         << ", 通道数=" << channelCount
-                         << ", 工位=" << stationNumber
-                         << ", 位索引=" << bitIndex;
             }
         }
 
         // 提交事务
-        db.commit();
+        if (!db.commit())
+        {
+            throw QString("提交事务失败: %1").arg(db.lastError().text());
+        }
+        m_model->markSaved();
+
+        qDebug() << "PinSettingsDialog::saveSettings - 保存记录数:" << recordCount << "，工位数:" << stationCount;
         QMessageBox::information(this, "成功", "管脚设置已保存");
         return true;
     }
-    catch (const std::exception &e)
+    catch (const QString &errorMessage)
     {
         // 回滚事务
         db.rollback();
-        qWarning() << "PinSettingsDialog::saveSettings - 保存失败:" << e.what();
-        QMessageBox::critical(this, "错误", QString("保存管脚设置失败: %1").arg(e.what()));
+        qWarning() << "PinSettingsDialog::saveSettings - 保存失败:" << errorMessage;
+        QMessageBox::critical(this, "错误", QString("保存管脚设置失败: %1").arg(errorMessage));
         return false;
     }
 }
@@ -723,13 +666,10 @@ void PinSettingsDialog::onAddPin()
     int newPinId = insertQuery.lastInsertId().toInt();
     qDebug() << "PinSettingsDialog::onAddPin - 成功添加新管脚，ID=" << newPinId << "，名称=" << pinName;
 
-    // 将新管脚添加到内存中
+    // 将新管脚追加到表格末尾，默认通道数为1
     m_allPins[newPinId] = pinName;
-    m_pinNotes[newPinId] = "";
-    m_channelCounts[newPinId] = 1; // 默认通道数为1
-
-    // 更新表格显示
-    updateTable();
+    m_model->appendPin(newPinId, pinName);
+    m_pinSettingsView->scrollToBottom();
 
     QMessageBox::information(this, "添加成功",
                              QString("成功添加管脚 '%1'，默认通道个数为1").arg(pinName));
@@ -739,8 +679,7 @@ void PinSettingsDialog::showDeletePinDialog()
 {
     qDebug() << "PinSettingsDialog::showDeletePinDialog - 显示删除管脚对话框";
 
-    // 确保数据已加载
-    loadPinsData();
+    // 管脚列表已在构造时加载，这里不再重新加载，以免丢弃表格中未保存的修改
 
     // 创建删除管脚对话框
     QDialog deleteDialog(this);
@@ -815,19 +754,6 @@ void PinSettingsDialog::showDeletePinDialog()
         return;
     }
 
-    // 二次确认删除
-    QString confirmMessage = QString("您确定要删除以下管脚吗？\n%1\n\n注意：这将同时删除所有关联的向量表数据！").arg(selectedPinNames.join("\n"));
-    QMessageBox::StandardButton reply = QMessageBox::question(this, "确认删除",
-                                                              confirmMessage,
-                                                              QMessageBox::Yes | QMessageBox::No,
-                                                              QMessageBox::No);
-
-    if (reply == QMessageBox::No)
-    {
-        qDebug() << "PinSettingsDialog::showDeletePinDialog - 用户取消二次确认";
-        return;
-    }
-
     // 从数据库中删除管脚
     QSqlDatabase db = DatabaseManager::instance()->database();
     if (!db.isOpen())
@@ -837,92 +763,44 @@ void PinSettingsDialog::showDeletePinDialog()
         return;
     }
 
-    // 开始事务
-    db.transaction();
-
-    try
+    // 按集合一次删除所有依赖数据，删除前二次确认，确认信息中包含各表将被删除的行数
+    PinDeletionCascade cascade(db);
+    PinDeletionCounts counts;
+    QString errorMessage;
+    auto confirmDeletion = [this, &selectedPinNames](const PinDeletionCounts &affected)
     {
-        QSqlQuery query(db);
+        QString confirmMessage = QString("您确定要删除以下管脚吗？\n%1\n\n将同时删除以下关联数据：\n%2")
+                                     .arg(selectedPinNames.join("\n"), affected.summary());
+        QMessageBox::StandardButton reply = QMessageBox::question(this, "确认删除",
+                                                                  confirmMessage,
+                                                                  QMessageBox::Yes | QMessageBox::No,
+                                                                  QMessageBox::No);
+        return reply == QMessageBox::Yes;
+    };
 
-        // 处理每个选中的管脚
-        foreach (int pinId, selectedPinIds)
+    if (!cascade.deletePins(selectedPinIds, confirmDeletion, counts, errorMessage))
+    {
+        if (errorMessage.isEmpty())
         {
-            qDebug() << "PinSettingsDialog::showDeletePinDialog - 处理管脚ID:" << pinId;
-
-            // 1. 先删除vector_table_pin_values表中的相关数据
-            query.prepare("DELETE FROM vector_table_pin_values WHERE vector_pin_id IN "
-                          "(SELECT id FROM vector_table_pins WHERE pin_id = ?)");
-            query.addBindValue(pinId);
-            if (!query.exec())
-            {
-                throw QString("删除管脚值数据失败: %1").arg(query.lastError().text());
-            }
-
-            // 2. 删除vector_table_pins表中的记录
-            query.prepare("DELETE FROM vector_table_pins WHERE pin_id = ?");
-            query.addBindValue(pinId);
-            if (!query.exec())
-            {
-                throw QString("删除管脚关联失败: %1").arg(query.lastError().text());
-            }
-
-            // 3. 删除pin_settings表中的记录
-            query.prepare("DELETE FROM pin_settings WHERE pin_id = ?");
-            query.addBindValue(pinId);
-            if (!query.exec())
-            {
-                throw QString("删除管脚设置失败: %1").arg(query.lastError().text());
-            }
-
-            // 4. 删除pin_group_members表中的记录
-            query.prepare("DELETE FROM pin_group_members WHERE pin_id = ?");
-            query.addBindValue(pinId);
-            if (!query.exec())
-            {
-                throw QString("删除管脚组成员失败: %1").arg(query.lastError().text());
-            }
-
-            // 5. 删除timeset_settings表中的记录
-            query.prepare("DELETE FROM timeset_settings WHERE pin_id = ?");
-            query.addBindValue(pinId);
-            if (!query.exec())
-            {
-                throw QString("删除时序设置失败: %1").arg(query.lastError().text());
-            }
-
-            // 6. 最后删除pin_list表中的记录
-            query.prepare("DELETE FROM pin_list WHERE id = ?");
-            query.addBindValue(pinId);
-            if (!query.exec())
-            {
-                throw QString("删除管脚记录失败: %1").arg(query.lastError().text());
-            }
-
-            // 从内存中删除管脚
-            m_allPins.remove(pinId);
-            m_pinNotes.remove(pinId);
-            m_channelCounts.remove(pinId);
-            m_existingSettings.remove(pinId);
-
-            qDebug() << "PinSettingsDialog::showDeletePinDialog - 成功删除管脚ID:" << pinId;
+            qDebug() << "PinSettingsDialog::showDeletePinDialog - 用户取消二次确认";
+            return;
         }
-
-        // 提交事务
-        db.commit();
-
-        QMessageBox::information(this, "删除成功",
-                                 QString("成功删除 %1 个管脚").arg(selectedPinIds.size()));
-
-        // 发出信号通知其他组件刷新
-        emit accepted();
-    }
-    catch (const QString &errorMessage)
-    {
-        // 回滚事务
-        db.rollback();
         qWarning() << "PinSettingsDialog::showDeletePinDialog - 删除操作失败:" << errorMessage;
         QMessageBox::critical(this, "错误", QString("删除管脚失败: %1").arg(errorMessage));
+        return;
     }
+
+    // 从内存中删除管脚
+    for (int pinId : selectedPinIds)
+        m_allPins.remove(pinId);
+    m_model->removePins(selectedPinIds);
+
+    qDebug() << "PinSettingsDialog::showDeletePinDialog - 成功删除管脚数:" << counts.pins;
+    QMessageBox::information(this, "删除成功",
+                             QString("成功删除 %1 个管脚").arg(counts.pins));
+
+    // 发出信号通知其他组件刷新
+    emit accepted();
 }
 
 // 删除管脚按钮点击处理
@@ -5,11 +5,12 @@
 #include <QMap>
 #include <QList>
 #include <QPair>
-#include <QTableWidget>
+#include <QTableView>
 #include <QSpinBox>
 #include <QLabel>
 #include <QPushButton>
-#include <QScrollBar>
+#include <QCheckBox>
+#include "pinsettingsmodel.h"
 
 // 管脚设置对话框类，用于设置管脚的工位和通道
 class PinSettingsDialog : public QDialog
@@ -27,41 +28,44 @@ private slots:
     void onStationCountChanged(int value);
     void onAccepted();
     void onRejected();
-    void onAddPin();    // 添加管脚功能
-    void onDeletePin(); // 删除管脚功能
+    void onAddPin();             // 添加管脚功能
+    void onDeletePin();          // 删除管脚功能
+    void onAssignBitIndexes();   // 批量分配位索引
+    void onAutoAssignChannels(); // 自动分配不重叠的通道
+    void onExportChannelMap();   // 导出通道表
+    void onChannelMapChanged(int conflictCount); // 刷新通道冲突数
 
 private:
     void setupUI();
     void loadPinsData();
-    void updateTable();
     bool saveSettings();
     bool isDataModified();          // 检查数据是否有修改
-    bool checkBitIndexUniqueness(); // 检查位索引值是否在每个工位上唯一
+    bool checkBitIndexUniqueness(); // 检查各管脚占用的通道是否重叠
+
+    // 生成一次插入count条pin_settings记录的语句
+    static QString settingsInsertSql(int count);
+
+    // 工位数上限
+    static const int MAX_STATION_COUNT = 64;
+    // 保存时每条INSERT语句插入的记录数(每条4个参数，低于SQLite的999个参数限制)
+    static const int SETTINGS_PER_INSERT = 200;
 
     QSpinBox *m_stationCountSpinBox;
-    QTableWidget *m_pinSettingsTable;
+    QTableView *m_pinSettingsView;
+    PinSettingsModel *m_model;
     QPushButton *m_okButton;
     QPushButton *m_cancelButton;
-    QPushButton *m_addPinButton;    // 添加管脚按钮
-    QPushButton *m_deletePinButton; // 删除管脚按钮
-
-    int m_currentStationCount; // 当前工位数
-
-    // 保存数据库中已有的管脚设置
-    // 格式: <pin_id, <station_number, station_bit_index>>
-    QMap<int, QMap<int, int>> m_existingSettings;
+    QPushButton *m_addPinButton;         // 添加管脚按钮
+    QPushButton *m_deletePinButton;      // 删除管脚按钮
+    QPushButton *m_assignButton;         // 批量分配位索引按钮
+    QPushButton *m_autoChannelButton;    // 自动分配通道按钮
+    QPushButton *m_exportChannelButton;  // 导出通道表按钮
+    QCheckBox *m_sharedChannelsCheckBox; // 各工位通道统一编号
+    QLabel *m_channelStatusLabel;        // 通道冲突数
 
     // 保存所有管脚信息
     // 格式: <pin_id, pin_name>
     QMap<int, QString> m_allPins;
-
-    // 保存管脚通道数
-    // 格式: <pin_id, channel_count>
-    QMap<int, int> m_channelCounts;
-
-    // 保存管脚注释
-    // 格式: <pin_id, pin_note>
-    QMap<int, QString> m_pinNotes;
 };
 
-#endif // PINSETTINGSDIALOG_H
\ No newline at end of file
+#endif // PINSETTINGSDIALOG_H
@@ -0,0 +1,410 @@
+#include "pinsettingsmodel.h"
+#include <QSet>
+#include <QBrush>
+#include <QColor>
+#include <QDebug>
+
+PinSettingsModel::PinSettingsModel(QObject *parent)
+    : QAbstractTableModel(parent), m_stationCount(1), m_savedStationCount(1), m_channelScope(ChannelMap::PerSite)
+{
+}
+
+void PinSettingsModel::setPins(const QList<int> &pinIds, const QList<QString> &pinNames, const QList<QString> &pinNotes,
+                               const QList<int> &channelCounts, const QMap<int, QMap<int, int>> &settings)
+{
+    beginResetModel();
+    m_rows.clear();
+    m_rows.reserve(pinIds.size());
+    for (int i = 0; i < pinIds.size(); ++i)
+    {
+        PinRow row;
+        row.pinId = pinIds[i];
+        row.pinName = pinNames.value(i);
+        row.note = pinNotes.value(i);
+        row.channelCount = channelCounts.value(i, 1);
+
+        const QMap<int, int> stations = settings.value(row.pinId);
+        if (!stations.isEmpty())
+        {
+            row.bitIndexes.fill(int(NoBitIndex), stations.lastKey() + 1);
+            for (auto it = stations.constBegin(); it != stations.constEnd(); ++it)
+            {
+                if (it.key() >= 0)
+                    row.bitIndexes[it.key()] = it.value();
+            }
+        }
+
+        row.savedNote = row.note;
+        row.savedChannelCount = row.channelCount;
+        row.savedBitIndexes = row.bitIndexes;
+        m_rows.append(row);
+    }
+    endResetModel();
+    rebuildChannelMap();
+}
+
+void PinSettingsModel::appendPin(int pinId, const QString &pinName)
+{
+    PinRow row;
+    row.pinId = pinId;
+    row.pinName = pinName;
+    row.channelCount = 1;
+    row.savedChannelCount = 1;
+
+    beginInsertRows(QModelIndex(), m_rows.size(), m_rows.size());
+    m_rows.append(row);
+    endInsertRows();
+    rebuildChannelMap();
+}
+
+void PinSettingsModel::removePins(const QList<int> &pinIds)
+{
+    const QSet<int> removed(pinIds.begin(), pinIds.end());
+
+    // 从后往前删除，前面的行号不受影响
+    for (int row = m_rows.size() - 1; row >= 0; --row)
+    {
+        if (!removed.contains(m_rows[row].pinId))
+            continue;
+        beginRemoveRows(QModelIndex(), row, row);
+        m_rows.remove(row);
+        endRemoveRows();
+    }
+    rebuildChannelMap();
+}
+
+void PinSettingsModel::setStationCount(int count)
+{
+    count = qMax(1, count);
+    if (count == m_stationCount)
+        return;
+
+    // 只增删工位列，已输入的位索引保留在各行的数组中
+    if (count > m_stationCount)
+    {
+        beginInsertColumns(QModelIndex(), FirstStationColumn + m_stationCount, FirstStationColumn + count - 1);
+        m_stationCount = count;
+        endInsertColumns();
+    }
+    else
+    {
+        beginRemoveColumns(QModelIndex(), FirstStationColumn + count, FirstStationColumn + m_stationCount - 1);
+        m_stationCount = count;
+        endRemoveColumns();
+    }
+    rebuildChannelMap();
+}
+
+int PinSettingsModel::valueAt(const QVector<int> &values, int station)
+{
+    return station < values.size() ? values[station] : NoBitIndex;
+}
+
+void PinSettingsModel::ensureStations(QVector<int> &values, int stationCount)
+{
+    // 新增的工位都是未设置状态
+    while (values.size() < stationCount)
+        values.append(int(NoBitIndex));
+}
+
+int PinSettingsModel::bitIndex(int row, int station) const
+{
+    return valueAt(m_rows[row].bitIndexes, station);
+}
+
+int PinSettingsModel::channelSpan(const QList<int> &rows) const
+{
+    int span = 0;
+    for (int row : rows)
+        span += m_rows[row].channelCount;
+    return span;
+}
+
+void PinSettingsModel::assignBitIndexes(const QList<int> &rows, int startIndex, int siteOffset)
+{
+    if (rows.isEmpty())
+        return;
+
+    for (int station = 0; station < m_stationCount; ++station)
+    {
+        int next = startIndex + station * siteOffset;
+        for (int row : rows)
+        {
+            PinRow &pin = m_rows[row];
+            ensureStations(pin.bitIndexes, m_stationCount);
+            pin.bitIndexes[station] = next;
+            next += pin.channelCount;
+        }
+    }
+    // 重建通道映射后整块工位区域只通知一次
+    rebuildChannelMap();
+    qDebug() << "PinSettingsModel::assignBitIndexes - 分配管脚数:" << rows.size()
+             << "，工位数:" << m_stationCount << "，起始:" << startIndex << "，工位偏移:" << siteOffset;
+}
+
+void PinSettingsModel::setChannelScope(ChannelMap::Scope scope)
+{
+    if (scope == m_channelScope)
+        return;
+    m_channelScope = scope;
+    rebuildChannelMap();
+}
+
+int PinSettingsModel::autoAssignChannels(bool reassignConflicts)
+{
+    fillChannelMap();
+    int assigned = m_channelMap.autoAssign(reassignConflicts);
+
+    // 把分配结果写回各行
+    for (int row = 0; row < m_rows.size(); ++row)
+    {
+        PinRow &pin = m_rows[row];
+        ensureStations(pin.bitIndexes, m_stationCount);
+        for (int station = 0; station < m_stationCount; ++station)
+        {
+            int first = m_channelMap.firstChannel(row, station);
+            if (first != ChannelMap::NoChannel)
+                pin.bitIndexes[station] = first;
+        }
+    }
+
+    notifyStationsChanged();
+    return assigned;
+}
+
+void PinSettingsModel::fillChannelMap()
+{
+    m_channelMap.reset(m_rows.size(), m_stationCount, m_channelScope);
+    for (int row = 0; row < m_rows.size(); ++row)
+    {
+        const PinRow &pin = m_rows[row];
+        m_channelMap.setPin(row, pin.pinName, pin.channelCount);
+        for (int station = 0; station < m_stationCount; ++station)
+        {
+            int bitIndex = valueAt(pin.bitIndexes, station);
+            if (bitIndex != NoBitIndex)
+                m_channelMap.setFirstChannel(row, station, bitIndex);
+        }
+    }
+    m_channelMap.build();
+}
+
+void PinSettingsModel::notifyStationsChanged()
+{
+    if (!m_rows.isEmpty())
+        emit dataChanged(index(0, FirstStationColumn), index(m_rows.size() - 1, FirstStationColumn + m_stationCount - 1));
+    emit channelMapChanged(m_channelMap.conflicts().size());
+}
+
+void PinSettingsModel::rebuildChannelMap()
+{
+    fillChannelMap();
+    notifyStationsChanged();
+}
+
+QString PinSettingsModel::conflictDescription(int row, int station) const
+{
+    QStringList lines;
+    for (const ChannelConflict &conflict : m_channelMap.conflicts())
+    {
+        if (conflict.row == row && conflict.site == station)
+        {
+            if (conflict.otherRow < 0)
+                lines << QString("通道号 %1 超出范围").arg(conflict.channel);
+            else
+                lines << QString("通道 %1 已被管脚 %2 在工位%3占用")
+                             .arg(conflict.channel)
+                             .arg(m_rows[conflict.otherRow].pinName)
+                             .arg(conflict.otherSite + 1);
+        }
+        else if (conflict.otherRow == row && conflict.otherSite == station)
+        {
+            lines << QString("通道 %1 与管脚 %2 在工位%3的通道重叠")
+                         .arg(conflict.channel)
+                         .arg(m_rows[conflict.row].pinName)
+                         .arg(conflict.site + 1);
+        }
+    }
+    return lines.join("\n");
+}
+
+bool PinSettingsModel::isModified() const
+{
+    if (m_stationCount != m_savedStationCount)
+        return true;
+
+    for (const PinRow &pin : m_rows)
+    {
+        if (pin.note != pin.savedNote || pin.channelCount != pin.savedChannelCount)
+            return true;
+        for (int station = 0; station < m_stationCount; ++station)
+        {
+            if (valueAt(pin.bitIndexes, station) != valueAt(pin.savedBitIndexes, station))
+                return true;
+        }
+    }
+    return false;
+}
+
+void PinSettingsModel::markSaved()
+{
+    m_savedStationCount = m_stationCount;
+    for (PinRow &pin : m_rows)
+    {
+        // 超出工位数的位索引不会保存到数据库
+        if (pin.bitIndexes.size() > m_stationCount)
+            pin.bitIndexes.resize(m_stationCount);
+        pin.savedNote = pin.note;
+        pin.savedChannelCount = pin.channelCount;
+        pin.savedBitIndexes = pin.bitIndexes;
+    }
+}
+
+int PinSettingsModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+int PinSettingsModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : FirstStationColumn + m_stationCount;
+}
+
+QVariant PinSettingsModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.size())
+        return QVariant();
+
+    const PinRow &pin = m_rows[index.row()];
+    const int column = index.column();
+
+    if (role == Qt::TextAlignmentRole && column != PinColumn && column != NoteColumn)
+        return int(Qt::AlignCenter);
+
+    // 通道冲突标记，映射与模型的行列始终一致
+    if (column >= FirstStationColumn && (role == Qt::BackgroundRole || role == Qt::ToolTipRole))
+    {
+        int station = column - FirstStationColumn;
+        if (station >= m_channelMap.siteCount() || index.row() >= m_channelMap.pinCount() ||
+            !m_channelMap.hasConflict(index.row(), station))
+            return QVariant();
+        if (role == Qt::BackgroundRole)
+            return QBrush(QColor(255, 200, 200));
+        return conflictDescription(index.row(), station);
+    }
+
+    if (role != Qt::DisplayRole && role != Qt::EditRole)
+        return QVariant();
+
+    switch (column)
+    {
+    case PinColumn:
+        return pin.pinName;
+    case ChannelCountColumn:
+        return pin.channelCount;
+    case NoteColumn:
+        return pin.note;
+    default:
+    {
+        // 位索引按文本编辑，清空表示该工位不设置
+        int bitIndex = valueAt(pin.bitIndexes, column - FirstStationColumn);
+        return bitIndex == NoBitIndex ? QString() : QString::number(bitIndex);
+    }
+    }
+}
+
+bool PinSettingsModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (!index.isValid() || role != Qt::EditRole || index.row() >= m_rows.size())
+        return false;
+
+    PinRow &pin = m_rows[index.row()];
+    const int column = index.column();
+
+    if (column == ChannelCountColumn)
+    {
+        bool ok;
+        int channelCount = value.toInt(&ok);
+        if (!ok || channelCount <= 0)
+            return false;
+        pin.channelCount = channelCount;
+    }
+    else if (column == NoteColumn)
+    {
+        pin.note = value.toString();
+    }
+    else if (column >= FirstStationColumn)
+    {
+        int station = column - FirstStationColumn;
+        QString text = value.toString().trimmed();
+        int bitIndex = NoBitIndex;
+        if (!text.isEmpty())
+        {
+            bool ok;
+            bitIndex = text.toInt(&ok);
+            if (!ok || bitIndex < 0)
+                return false;
+        }
+        ensureStations(pin.bitIndexes, station + 1);
+        pin.bitIndexes[station] = bitIndex;
+    }
+    else
+    {
+        return false;
+    }
+
+    emit dataChanged(index, index);
+    if (column != NoteColumn)
+        rebuildChannelMap();
+    return true;
+}
+
+QVariant PinSettingsModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal)
+        return QAbstractTableModel::headerData(section, orientation, role);
+
+    if (role == Qt::DisplayRole)
+    {
+        switch (section)
+        {
+        case PinColumn:
+            return "管脚";
+        case ChannelCountColumn:
+            return "通道-个数";
+        case NoteColumn:
+            return "注释";
+        default:
+            // 工位编号从1开始显示
+            return QString("通道-工位%1").arg(section - FirstStationColumn + 1);
+        }
+    }
+
+    if (role == Qt::ToolTipRole)
+    {
+        switch (section)
+        {
+        case PinColumn:
+            return "管脚名称";
+        case ChannelCountColumn:
+            return "设置通道个数";
+        case NoteColumn:
+            return "管脚相关说明";
+        default:
+            return QString("设置通道在工位%1的位索引值").arg(section - FirstStationColumn + 1);
+        }
+    }
+
+    return QVariant();
+}
+
+Qt::ItemFlags PinSettingsModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid())
+        return Qt::NoItemFlags;
+
+    Qt::ItemFlags itemFlags = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+    if (index.column() != PinColumn)
+        itemFlags |= Qt::ItemIsEditable;
+    return itemFlags;
+}
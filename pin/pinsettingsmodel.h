@@ -0,0 +1,104 @@
+#ifndef PINSETTINGSMODEL_H
+#define PINSETTINGSMODEL_H
+
+#include <QAbstractTableModel>
+#include <QVector>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include "channelmap.h"
+
+// 管脚设置表格模型：每行一个管脚，前三列为管脚、通道个数、注释，之后每个工位一列位索引
+// 行列数直接由管脚数和工位数给出，修改工位数只增删列，不重建已有单元格
+class PinSettingsModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column
+    {
+        PinColumn = 0,
+        ChannelCountColumn,
+        NoteColumn,
+        FirstStationColumn
+    };
+
+    // 没有设置位索引的工位
+    static const int NoBitIndex = -1;
+
+    explicit PinSettingsModel(QObject *parent = nullptr);
+
+    // 重新加载管脚，settings为数据库中的位索引 <pin_id, <station_number, station_bit_index>>
+    void setPins(const QList<int> &pinIds, const QList<QString> &pinNames, const QList<QString> &pinNotes,
+                 const QList<int> &channelCounts, const QMap<int, QMap<int, int>> &settings);
+    void appendPin(int pinId, const QString &pinName);
+    void removePins(const QList<int> &pinIds);
+
+    int stationCount() const { return m_stationCount; }
+    void setStationCount(int count);
+
+    int pinId(int row) const { return m_rows[row].pinId; }
+    QString pinName(int row) const { return m_rows[row].pinName; }
+    QString note(int row) const { return m_rows[row].note; }
+    int channelCount(int row) const { return m_rows[row].channelCount; }
+    int bitIndex(int row, int station) const;
+    bool noteModified(int row) const { return m_rows[row].note != m_rows[row].savedNote; }
+
+    // 批量分配位索引：按rows的顺序依次分配，每个管脚占用其通道个数个位
+    // 工位station的起始位索引为 startIndex + station * siteOffset
+    void assignBitIndexes(const QList<int> &rows, int startIndex, int siteOffset);
+    // rows中各管脚通道个数之和，自动递增时作为相邻工位的偏移
+    int channelSpan(const QList<int> &rows) const;
+
+    // 通道映射随位索引和通道个数的修改实时重建，冲突的单元格标红
+    ChannelMap::Scope channelScope() const { return m_channelScope; }
+    void setChannelScope(ChannelMap::Scope scope);
+    const ChannelMap &channelMap() const { return m_channelMap; }
+    // 为未设置位索引(以及reassignConflicts时冲突)的单元格自动分配不重叠的通道，返回分配的单元格数
+    int autoAssignChannels(bool reassignConflicts);
+
+    // 与最近一次加载/保存的内容比较
+    bool isModified() const;
+    void markSaved();
+
+    // QAbstractItemModel
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+signals:
+    // 通道映射重建完成
+    void channelMapChanged(int conflictCount);
+
+private:
+    struct PinRow
+    {
+        int pinId;
+        QString pinName;
+        QString note;
+        int channelCount;
+        QVector<int> bitIndexes; // 以工位号为下标，超出工位数的部分保留，减少工位后再增加时可以恢复
+        QString savedNote;
+        int savedChannelCount;
+        QVector<int> savedBitIndexes;
+    };
+
+    static int valueAt(const QVector<int> &values, int station);
+    static void ensureStations(QVector<int> &values, int stationCount);
+    // 按当前内容重建通道映射，并通知工位列刷新冲突标记
+    void rebuildChannelMap();
+    void fillChannelMap();
+    void notifyStationsChanged();
+    QString conflictDescription(int row, int station) const;
+
+    QVector<PinRow> m_rows;
+    int m_stationCount;
+    int m_savedStationCount;
+    ChannelMap::Scope m_channelScope;
+    ChannelMap m_channelMap;
+};
+
+#endif // PINSETTINGSMODEL_H
@@ -1,3 +1,5 @@
+-- 新建项目时直接复制由本文件生成的 resources/db/template.db；修改表结构或默认数据后
+-- 需要提高 DatabaseManager::LATEST_VERSION 并重新生成模板(删除模板后新建一个项目即可得到)
 CREATE TABLE "type_options" (
     id INTEGER PRIMARY KEY AUTOINCREMENT,
     type_name TEXT NOT NULL UNIQUE    -- 如 'In', 'Out', 'InOut'
@@ -22,6 +24,7 @@ CREATE TABLE "pin_settings" (
     station_number INTEGER NOT NULL
 );
 
+-- 分组值由成员管脚推导，这里只保存无法推导的分组级覆盖值
 CREATE TABLE vector_table_group_values(
     id INTEGER PRIMARY KEY AUTOINCREMENT, 
     vector_data_id INTEGER NOT NULL REFERENCES vector_table_data(id), 
@@ -68,6 +71,41 @@ CREATE TABLE vector_table_data(
     sort_index INTEGER
 );
 
+-- 按表顺序读取和行号计算
+CREATE INDEX IF NOT EXISTS idx_vector_table_data_sort ON vector_table_data(table_id, sort_index);
+-- 查找和标签导航用的部分索引，只包含非空标签/注释
+CREATE INDEX IF NOT EXISTS idx_vector_table_data_label ON vector_table_data(table_id, label, sort_index) WHERE label <> '';
+CREATE INDEX IF NOT EXISTS idx_vector_table_data_comment ON vector_table_data(table_id, comment, sort_index) WHERE comment <> '';
+
+-- 每个向量表中引用各TimeSet的行数，由下面的触发器随向量行增删改维护
+CREATE TABLE IF NOT EXISTS timeset_usage(
+    timeset_id INTEGER NOT NULL,
+    table_id INTEGER NOT NULL,
+    row_count INTEGER NOT NULL DEFAULT 0,
+    PRIMARY KEY (timeset_id, table_id)
+) WITHOUT ROWID;
+
+CREATE TRIGGER IF NOT EXISTS trg_timeset_usage_insert AFTER INSERT ON vector_table_data
+BEGIN
+    INSERT OR IGNORE INTO timeset_usage (timeset_id, table_id, row_count) VALUES (NEW.timeset_id, NEW.table_id, 0);
+    UPDATE timeset_usage SET row_count = row_count + 1 WHERE timeset_id = NEW.timeset_id AND table_id = NEW.table_id;
+END;
+
+CREATE TRIGGER IF NOT EXISTS trg_timeset_usage_delete AFTER DELETE ON vector_table_data
+BEGIN
+    UPDATE timeset_usage SET row_count = row_count - 1 WHERE timeset_id = OLD.timeset_id AND table_id = OLD.table_id;
+    DELETE FROM timeset_usage WHERE timeset_id = OLD.timeset_id AND table_id = OLD.table_id AND row_count <= 0;
+END;
+
+CREATE TRIGGER IF NOT EXISTS trg_timeset_usage_update AFTER UPDATE OF timeset_id, table_id ON vector_table_data
+WHEN OLD.timeset_id IS NOT NEW.timeset_id OR OLD.table_id IS NOT NEW.table_id
+BEGIN
+    UPDATE timeset_usage SET row_count = row_count - 1 WHERE timeset_id = OLD.timeset_id AND table_id = OLD.table_id;
+    DELETE FROM timeset_usage WHERE timeset_id = OLD.timeset_id AND table_id = OLD.table_id AND row_count <= 0;
+    INSERT OR IGNORE INTO timeset_usage (timeset_id, table_id, row_count) VALUES (NEW.timeset_id, NEW.table_id, 0);
+    UPDATE timeset_usage SET row_count = row_count + 1 WHERE timeset_id = NEW.timeset_id AND table_id = NEW.table_id;
+END;
+
 CREATE TABLE timeset_settings(
     id INTEGER PRIMARY KEY AUTOINCREMENT, 
     timeset_id INTEGER NOT NULL REFERENCES timeset_list(id), 
@@ -78,6 +116,9 @@ CREATE TABLE timeset_settings(
     wave_id INTEGER REFERENCES wave_options(id)
 );
 
+-- 按TimeSet读取和对比边沿参数
+CREATE INDEX IF NOT EXISTS idx_timeset_settings_timeset ON timeset_settings(timeset_id, pin_id);
+
 CREATE TABLE vector_table_pin_values(
     id INTEGER PRIMARY KEY AUTOINCREMENT, 
     vector_data_id NOT NULL REFERENCES vector_table_data(id), 
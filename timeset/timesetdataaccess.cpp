@@ -1,5 +1,7 @@
 #include "timesetdataaccess.h"
 #include "database/databasemanager.h"
+#include "vector/vectordatahandler.h"
+#include <QSet>
 
 TimeSetDataAccess::TimeSetDataAccess(QSqlDatabase &db) : m_db(db)
 {
@@ -119,19 +121,10 @@ bool TimeSetDataAccess::loadExistingTimeSets(QList<TimeSetData> &timeSetDataList
             timeSet.name = query.value(1).toString();
             timeSet.period = query.value(2).toDouble();
 
-            // 加载关联的管脚ID
-            timeSet.pinIds = getPinIdsForTimeSet(timeSet.dbId);
-
-            // 加载边缘设置
-            timeSet.edges = loadTimeSetEdges(timeSet.dbId);
-
+            // 关联管脚和边沿参数在需要时通过getPinIdsForTimeSet/loadTimeSetEdges按需加载，
+            // 打开TimeSet对话框时不随TimeSet数量逐个查询
             timeSetDataList.append(timeSet);
             count++;
-
-            qDebug() << "加载TimeSet: id=" << timeSet.dbId << ", name=" << timeSet.name
-                     << ", period=" << timeSet.period
-                     << ", 关联管脚数:" << timeSet.pinIds.size()
-                     << ", 边缘设置数:" << timeSet.edges.size();
         }
 
         qDebug() << "成功加载" << count << "个TimeSet记录";
@@ -168,7 +161,8 @@ QList<int> TimeSetDataAccess::getPinIdsForTimeSet(int timeSetId)
 {
     QList<int> pinIds;
     QSqlQuery pinQuery(m_db);
-    pinQuery.prepare("SELECT pin_id FROM timeset_pins WHERE timeset_id = ?");
+    // TimeSet关联的管脚就是设置了边沿参数的管脚
+    pinQuery.prepare("SELECT pin_id FROM timeset_settings WHERE timeset_id = ? ORDER BY pin_id");
     pinQuery.addBindValue(timeSetId);
 
     if (pinQuery.exec())
@@ -219,7 +213,6 @@ QList<TimeSetEdgeData> TimeSetDataAccess::loadTimeSetEdges(int timeSetId)
             edge.stbr = query.value(4).toDouble();
             edge.waveId = query.value(5).toInt();
             edges.append(edge);
-            qDebug() << "TimeSetDataAccess::loadTimeSetEdges - 加载边沿: Pin ID=" << edge.pinId;
         }
         qDebug() << "TimeSetDataAccess::loadTimeSetEdges - 总共加载" << edges.size() << "个边沿 for TimeSet ID:" << timeSetId;
     }
@@ -283,59 +276,53 @@ bool TimeSetDataAccess::savePinSelection(int timeSetId, const QList<int> &select
 
     qDebug() << "TimeSetDataAccess::savePinSelection - 开始为 TimeSet ID:" << timeSetId << "保存管脚选择";
 
-    // 先删除旧关联
-    QSqlQuery deleteQuery(m_db);
-    QString deleteSql = "DELETE FROM timeset_settings WHERE timeset_id = ?";
-    qDebug() << "TimeSetDataAccess::savePinSelection - 准备执行删除SQL:" << deleteSql << "with ID:" << timeSetId;
-    deleteQuery.prepare(deleteSql);
-    deleteQuery.addBindValue(timeSetId);
-
-    if (!deleteQuery.exec())
-    {
-        qWarning() << "删除TimeSet管脚关联失败:" << deleteQuery.lastError().text();
-        qWarning() << "失败的SQL:" << deleteSql << "参数:" << timeSetId;
-        deleteQuery.finish(); // Explicitly finish
-        return false;
-    }
-    qDebug() << "TimeSetDataAccess::savePinSelection - 成功删除旧关联 for TimeSet ID:" << timeSetId;
-    deleteQuery.finish(); // Explicitly finish
+    // 只删除取消选择的管脚、只为新选择的管脚添加默认边沿，已有管脚的边沿参数保持不变
+    QList<int> existingPinIds = getPinIdsForTimeSet(timeSetId);
+    QSet<int> selected(selectedPinIds.begin(), selectedPinIds.end());
+    QSet<int> existing(existingPinIds.begin(), existingPinIds.end());
 
-    // 添加新关联
-    if (selectedPinIds.isEmpty())
-    {
-        qDebug() << "TimeSetDataAccess::savePinSelection - 没有需要添加的新管脚关联 for TimeSet ID:" << timeSetId;
-        return true; // 没有新管脚需要添加，操作成功
-    }
+    bool ownTransaction = m_db.transaction();
 
-    qDebug() << "TimeSetDataAccess::savePinSelection - 开始添加" << selectedPinIds.size() << "个新管脚关联 for TimeSet ID:" << timeSetId;
-    for (int pinId : selectedPinIds)
+    QSqlQuery deleteQuery(m_db);
+    deleteQuery.prepare("DELETE FROM timeset_settings WHERE timeset_id = ? AND pin_id = ?");
+    for (int pinId : existing)
     {
-        // 再次检查数据库连接状态（以防万一）
-        if (!m_db.isOpen())
+        if (selected.contains(pinId))
+            continue;
+        deleteQuery.bindValue(0, timeSetId);
+        deleteQuery.bindValue(1, pinId);
+        if (!deleteQuery.exec())
         {
-            qWarning() << "TimeSetDataAccess::savePinSelection - 错误：在循环中数据库未连接！";
+            qWarning() << "删除TimeSet管脚关联失败:" << deleteQuery.lastError().text() << "管脚ID:" << pinId;
+            if (ownTransaction)
+                m_db.rollback();
             return false;
         }
+    }
 
-        QSqlQuery insertQuery(m_db);
-        QString insertSql = "INSERT INTO timeset_settings (timeset_id, pin_id, T1R, T1F, STBR, wave_id) VALUES (?, ?, ?, ?, ?, ?)";
-        insertQuery.prepare(insertSql);
-        insertQuery.addBindValue(timeSetId);
-        insertQuery.addBindValue(pinId);
-        insertQuery.addBindValue(250.0); // 默认T1R
-        insertQuery.addBindValue(750.0); // 默认T1F
-        insertQuery.addBindValue(500.0); // 默认STBR
-        insertQuery.addBindValue(1);     // 默认wave_id
-
+    QSqlQuery insertQuery(m_db);
+    insertQuery.prepare("INSERT INTO timeset_settings (timeset_id, pin_id, T1R, T1F, STBR, wave_id) VALUES (?, ?, 250, 750, 500, 1)");
+    for (int pinId : selectedPinIds)
+    {
+        if (existing.contains(pinId))
+            continue;
+        existing.insert(pinId);
+        insertQuery.bindValue(0, timeSetId);
+        insertQuery.bindValue(1, pinId);
         if (!insertQuery.exec())
         {
-            qWarning() << "添加TimeSet管脚关联失败:" << insertQuery.lastError().text();
-            qWarning() << "失败的SQL:" << insertSql << "参数: (" << timeSetId << "," << pinId << ", 250, 750, 500, 1)";
-            insertQuery.finish(); // Explicitly finish
+            qWarning() << "添加TimeSet管脚关联失败:" << insertQuery.lastError().text() << "管脚ID:" << pinId;
+            if (ownTransaction)
+                m_db.rollback();
             return false;
         }
-        qDebug() << "TimeSetDataAccess::savePinSelection - 成功添加关联: TimeSet ID=" << timeSetId << ", Pin ID=" << pinId;
-        insertQuery.finish(); // Explicitly finish
+    }
+
+    if (ownTransaction && !m_db.commit())
+    {
+        qWarning() << "TimeSetDataAccess::savePinSelection - 提交事务失败:" << m_db.lastError().text();
+        m_db.rollback();
+        return false;
     }
 
     qDebug() << "TimeSetDataAccess::savePinSelection - 成功完成 for TimeSet ID:" << timeSetId;
@@ -351,78 +338,135 @@ bool TimeSetDataAccess::saveTimeSetEdgesToDatabase(int timeSetId, const QList<Ti
     }
     qDebug() << "TimeSetDataAccess::saveTimeSetEdgesToDatabase - 开始为 TimeSet ID:" << timeSetId << "保存边沿参数";
 
-    // 先删除旧的边沿参数
-    { // Scope for deleteQuery
-        QSqlQuery deleteQuery(m_db);
-        QString deleteSql = "DELETE FROM timeset_settings WHERE timeset_id = ?";
-        qDebug() << "TimeSetDataAccess::saveTimeSetEdgesToDatabase - 准备执行删除SQL:" << deleteSql << "with ID:" << timeSetId;
-        if (!deleteQuery.prepare(deleteSql))
+    // 读取数据库中现有的边沿，按管脚对比，只写入变化的部分
+    QMap<int, QPair<int, TimeSetEdgeData>> existing; // pin_id -> (行id, 边沿)
+    QList<int> rowsToDelete;
+    {
+        QSqlQuery selectQuery(m_db);
+        selectQuery.setForwardOnly(true);
+        selectQuery.prepare("SELECT id, pin_id, T1R, T1F, STBR, wave_id FROM timeset_settings WHERE timeset_id = ?");
+        selectQuery.addBindValue(timeSetId);
+        if (!selectQuery.exec())
         {
-            qWarning() << "准备删除旧边沿参数失败:" << deleteQuery.lastError().text();
+            qWarning() << "读取现有边沿参数失败:" << selectQuery.lastError().text();
             return false;
         }
-        deleteQuery.addBindValue(timeSetId);
+        while (selectQuery.next())
+        {
+            int rowId = selectQuery.value(0).toInt();
+            TimeSetEdgeData edge;
+            edge.timesetId = timeSetId;
+            edge.pinId = selectQuery.value(1).toInt();
+            edge.t1r = selectQuery.value(2).toDouble();
+            edge.t1f = selectQuery.value(3).toDouble();
+            edge.stbr = selectQuery.value(4).toDouble();
+            edge.waveId = selectQuery.value(5).toInt();
+
+            // 同一管脚的重复行只保留第一条
+            if (existing.contains(edge.pinId))
+                rowsToDelete.append(rowId);
+            else
+                existing.insert(edge.pinId, qMakePair(rowId, edge));
+        }
+    }
 
-        if (!m_db.isOpen())
-        { // Check connection *just before* exec
-            qWarning() << "TimeSetDataAccess::saveTimeSetEdgesToDatabase - 错误：数据库在执行删除前断开！";
-            return false;
+    QList<QPair<int, TimeSetEdgeData>> rowsToUpdate;
+    QList<TimeSetEdgeData> rowsToInsert;
+    QSet<int> keptPins;
+    for (const TimeSetEdgeData &edge : edges)
+    {
+        if (keptPins.contains(edge.pinId))
+            continue;
+        keptPins.insert(edge.pinId);
+
+        auto it = existing.constFind(edge.pinId);
+        if (it == existing.constEnd())
+        {
+            rowsToInsert.append(edge);
+            continue;
         }
 
-        if (!deleteQuery.exec())
+        const TimeSetEdgeData &old = it.value().second;
+        if (old.t1r != edge.t1r || old.t1f != edge.t1f || old.stbr != edge.stbr || old.waveId != edge.waveId)
         {
-            qWarning() << "删除旧边沿参数失败:" << deleteQuery.lastError().text();
-            qWarning() << "失败的SQL:" << deleteSql << "参数:" << timeSetId;
-            deleteQuery.finish(); // Explicitly finish
-            return false;
+            rowsToUpdate.append(qMakePair(it.value().first, edge));
         }
-        qDebug() << "TimeSetDataAccess::saveTimeSetEdgesToDatabase - 成功删除旧边沿参数 for TimeSet ID:" << timeSetId;
-        deleteQuery.finish(); // Explicitly finish
-    }                         // deleteQuery goes out of scope here
+    }
+    for (auto it = existing.constBegin(); it != existing.constEnd(); ++it)
+    {
+        if (!keptPins.contains(it.key()))
+            rowsToDelete.append(it.value().first);
+    }
 
-    // 添加新的边沿参数
-    if (edges.isEmpty())
+    if (rowsToDelete.isEmpty() && rowsToUpdate.isEmpty() && rowsToInsert.isEmpty())
     {
-        qDebug() << "TimeSetDataAccess::saveTimeSetEdgesToDatabase - 没有新的边沿参数需要添加 for TimeSet ID:" << timeSetId;
+        qDebug() << "TimeSetDataAccess::saveTimeSetEdgesToDatabase - 边沿参数未变化 for TimeSet ID:" << timeSetId;
         return true;
     }
 
-    qDebug() << "TimeSetDataAccess::saveTimeSetEdgesToDatabase - 开始添加" << edges.size() << "个新的边沿参数 for TimeSet ID:" << timeSetId;
-    for (const TimeSetEdgeData &edge : edges)
+    // 调用方已开启事务时并入其中
+    bool ownTransaction = m_db.transaction();
+
+    QSqlQuery deleteQuery(m_db);
+    QSqlQuery updateQuery(m_db);
+    QSqlQuery insertQuery(m_db);
+    bool success = deleteQuery.prepare("DELETE FROM timeset_settings WHERE id = ?") &&
+                   updateQuery.prepare("UPDATE timeset_settings SET T1R = ?, T1F = ?, STBR = ?, wave_id = ? WHERE id = ?") &&
+                   insertQuery.prepare("INSERT INTO timeset_settings (timeset_id, pin_id, T1R, T1F, STBR, wave_id) VALUES (?, ?, ?, ?, ?, ?)");
+    QString errorText = success ? QString() : m_db.lastError().text();
+
+    for (int i = 0; success && i < rowsToDelete.size(); ++i)
     {
-        if (!m_db.isOpen())
-        { // Check connection in loop
-            qWarning() << "TimeSetDataAccess::saveTimeSetEdgesToDatabase - 错误：数据库在插入循环中断开！";
-            return false;
-        }
+        deleteQuery.bindValue(0, rowsToDelete[i]);
+        success = deleteQuery.exec();
+        if (!success)
+            errorText = deleteQuery.lastError().text();
+    }
 
-        QSqlQuery insertQuery(m_db); // New query object for each iteration
-        QString insertSql = "INSERT INTO timeset_settings (timeset_id, pin_id, T1R, T1F, STBR, wave_id) VALUES (?, ?, ?, ?, ?, ?)";
-        if (!insertQuery.prepare(insertSql))
-        {
-            qWarning() << "准备插入边沿参数失败:" << insertQuery.lastError().text();
-            insertQuery.finish(); // Explicitly finish before returning
-            return false;         // Stop if prepare fails
-        }
-        insertQuery.addBindValue(timeSetId);
-        insertQuery.addBindValue(edge.pinId);
-        insertQuery.addBindValue(edge.t1r);
-        insertQuery.addBindValue(edge.t1f);
-        insertQuery.addBindValue(edge.stbr);
-        insertQuery.addBindValue(edge.waveId);
+    for (int i = 0; success && i < rowsToUpdate.size(); ++i)
+    {
+        const TimeSetEdgeData &edge = rowsToUpdate[i].second;
+        updateQuery.bindValue(0, edge.t1r);
+        updateQuery.bindValue(1, edge.t1f);
+        updateQuery.bindValue(2, edge.stbr);
+        updateQuery.bindValue(3, edge.waveId);
+        updateQuery.bindValue(4, rowsToUpdate[i].first);
+        success = updateQuery.exec();
+        if (!success)
+            errorText = updateQuery.lastError().text();
+    }
 
-        if (!insertQuery.exec())
-        {
-            qWarning() << "添加边沿参数失败:" << insertQuery.lastError().text();
-            qWarning() << "失败的SQL:" << insertSql << "参数: (" << timeSetId << "," << edge.pinId << "," << edge.t1r << "," << edge.t1f << "," << edge.stbr << "," << edge.waveId << ")";
-            insertQuery.finish(); // Explicitly finish
-            return false;         // Stop on first error
-        }
-        qDebug() << "TimeSetDataAccess::saveTimeSetEdgesToDatabase - 成功添加边沿: TS ID=" << timeSetId << ", Pin ID=" << edge.pinId;
-        insertQuery.finish(); // Explicitly finish
+    for (int i = 0; success && i < rowsToInsert.size(); ++i)
+    {
+        const TimeSetEdgeData &edge = rowsToInsert[i];
+        insertQuery.bindValue(0, timeSetId);
+        insertQuery.bindValue(1, edge.pinId);
+        insertQuery.bindValue(2, edge.t1r);
+        insertQuery.bindValue(3, edge.t1f);
+        insertQuery.bindValue(4, edge.stbr);
+        insertQuery.bindValue(5, edge.waveId);
+        success = insertQuery.exec();
+        if (!success)
+            errorText = insertQuery.lastError().text();
     }
 
-    qDebug() << "TimeSetDataAccess::saveTimeSetEdgesToDatabase - 成功完成 for TimeSet ID:" << timeSetId;
+    if (!success)
+    {
+        qWarning() << "TimeSetDataAccess::saveTimeSetEdgesToDatabase - 保存边沿参数失败:" << errorText;
+        if (ownTransaction)
+            m_db.rollback();
+        return false;
+    }
+
+    if (ownTransaction && !m_db.commit())
+    {
+        qWarning() << "TimeSetDataAccess::saveTimeSetEdgesToDatabase - 提交事务失败:" << m_db.lastError().text();
+        m_db.rollback();
+        return false;
+    }
+
+    qDebug() << "TimeSetDataAccess::saveTimeSetEdgesToDatabase - 成功完成 for TimeSet ID:" << timeSetId
+             << "删除" << rowsToDelete.size() << "更新" << rowsToUpdate.size() << "新增" << rowsToInsert.size();
     return true;
 }
 
@@ -455,6 +499,7 @@ bool TimeSetDataAccess::updateTimeSetPeriod(int timeSetId, double period)
         return false;
     }
 
+    emit DatabaseManager::instance()->timeSetPeriodChanged(timeSetId, period);
     return true;
 }
 
@@ -510,205 +555,129 @@ bool TimeSetDataAccess::deleteTimeSetEdge(int timeSetId, int pinId)
 
 bool TimeSetDataAccess::loadVectorData(int tableId, QTableWidget *vectorTable)
 {
-    // 首先查询表的行数
-    QSqlQuery rowCountQuery(m_db);
-    rowCountQuery.prepare("SELECT MAX(row_id) FROM vector_data WHERE table_id = ?");
-    rowCountQuery.addBindValue(tableId);
-
-    int maxRows = 0;
-    if (rowCountQuery.exec() && rowCountQuery.next())
-    {
-        maxRows = rowCountQuery.value(0).toInt() + 1; // 行ID从0开始
+    // 与主表格使用同一份存储(vector_table_data/vector_table_pin_values)，这里只显示管脚列
+    QList<int> vectorPinIds;
+    QStringList pinNames;
+    QVector<QStringList> rows;
+    QString errorMessage;
+    if (!VectorDataHandler::loadPinColumns(tableId, vectorPinIds, pinNames, errorMessage) ||
+        !VectorDataHandler::readPinStateRows(tableId, vectorPinIds, rows, errorMessage))
+    {
+        qWarning() << "加载向量数据失败:" << errorMessage;
+        return false;
     }
 
-    // 查询所有管脚选项 - 修改为使用vector_table_pins表和pin_list表
-    QSqlQuery pinOptionQuery(m_db);
-    pinOptionQuery.prepare("SELECT pl.id as pin_id, pl.pin_name FROM pin_list pl "
-                           "JOIN vector_table_pins vtp ON pl.id = vtp.pin_id "
-                           "WHERE vtp.table_id = ? ORDER BY vtp.id");
-    pinOptionQuery.addBindValue(tableId);
-
-    QStringList pinOptions;
-    QMap<int, QString> pinIdToName;
-    if (pinOptionQuery.exec())
+    vectorTable->setUpdatesEnabled(false);
+    vectorTable->setColumnCount(pinNames.size());
+    vectorTable->setHorizontalHeaderLabels(pinNames);
+    vectorTable->setRowCount(rows.size());
+    for (int row = 0; row < rows.size(); ++row)
     {
-        while (pinOptionQuery.next())
+        for (int col = 0; col < rows[row].size(); ++col)
         {
-            int pinId = pinOptionQuery.value(0).toInt();
-            QString pinName = pinOptionQuery.value(1).toString();
-            pinOptions << pinName;
-            pinIdToName[pinId] = pinName;
+            vectorTable->setItem(row, col, new QTableWidgetItem(rows[row][col]));
         }
     }
-
-    // 设置表格列数
-    vectorTable->setColumnCount(pinOptions.size());
-    vectorTable->setHorizontalHeaderLabels(pinOptions);
-
-    // 设置行数
-    vectorTable->setRowCount(maxRows);
-
-    // 加载数据 - 修改为使用vector_table_pins表关联
-    QSqlQuery dataQuery(m_db);
-    dataQuery.prepare("SELECT vd.row_id, vd.pin_id, vd.pin_value "
-                      "FROM vector_data vd "
-                      "JOIN vector_table_pins vtp ON vd.pin_id = vtp.pin_id AND vd.table_id = vtp.table_id "
-                      "WHERE vd.table_id = ? "
-                      "ORDER BY vd.row_id, vtp.id");
-    dataQuery.addBindValue(tableId);
-
-    if (dataQuery.exec())
-    {
-        while (dataQuery.next())
-        {
-            int rowId = dataQuery.value(0).toInt();
-            int pinId = dataQuery.value(1).toInt();
-            QString pinValue = dataQuery.value(2).toString();
-
-            // 使用pinIdToName映射获取管脚名称
-            QString pinName = pinIdToName.value(pinId);
-
-            // 找到对应的列
-            int col = pinOptions.indexOf(pinName);
-            if (col >= 0)
-            {
-                QTableWidgetItem *item = new QTableWidgetItem(pinValue);
-                vectorTable->setItem(rowId, col, item);
-            }
-        }
-    }
-    else
-    {
-        qWarning() << "加载向量数据失败:" << dataQuery.lastError().text();
-        return false;
-    }
-
+    vectorTable->setUpdatesEnabled(true);
     return true;
 }
 
 bool TimeSetDataAccess::saveVectorData(int tableId, QTableWidget *vectorTable, int insertPosition, bool appendToEnd)
 {
-    // 获取管脚ID映射 - 修改为使用vector_table_pins表和pin_list表
-    QSqlQuery pinOptionQuery(m_db);
-    pinOptionQuery.prepare("SELECT pl.pin_name, pl.id as pin_id FROM pin_list pl "
-                           "JOIN vector_table_pins vtp ON pl.id = vtp.pin_id "
-                           "WHERE vtp.table_id = ? ORDER BY vtp.id");
-    pinOptionQuery.addBindValue(tableId);
-
-    QMap<QString, int> pinNameToId;
-    if (pinOptionQuery.exec())
+    QList<int> vectorPinIds;
+    QStringList pinNames;
+    QString errorMessage;
+    if (!VectorDataHandler::loadPinColumns(tableId, vectorPinIds, pinNames, errorMessage))
     {
-        while (pinOptionQuery.next())
-        {
-            QString pinName = pinOptionQuery.value(0).toString();
-            int pinId = pinOptionQuery.value(1).toInt();
-            pinNameToId[pinName] = pinId;
-        }
-    }
-    else
-    {
-        qWarning() << "获取管脚选项失败:" << pinOptionQuery.lastError().text();
+        qWarning() << "获取管脚选项失败:" << errorMessage;
         return false;
     }
 
-    // 开始事务
-    m_db.transaction();
-
-    // 决定插入位置
-    int startRow = 0;
-    if (appendToEnd)
+    // 按表头的管脚名找到每列对应的管脚，未填写的管脚保存为X
+    QVector<int> sourceColumns(vectorPinIds.size(), -1);
+    for (int col = 0; col < vectorTable->columnCount(); ++col)
     {
-        // 获取最大行ID
-        QSqlQuery maxRowQuery(m_db);
-        maxRowQuery.prepare("SELECT MAX(row_id) FROM vector_data WHERE table_id = ?");
-        maxRowQuery.addBindValue(tableId);
-
-        if (maxRowQuery.exec() && maxRowQuery.next())
-        {
-            startRow = maxRowQuery.value(0).toInt() + 1;
-        }
+        QTableWidgetItem *headerItem = vectorTable->horizontalHeaderItem(col);
+        int index = headerItem ? pinNames.indexOf(headerItem->text()) : -1;
+        if (index >= 0)
+            sourceColumns[index] = col;
     }
-    else
-    {
-        startRow = insertPosition;
-
-        // 为新行腾出空间，将现有数据行ID向后移动
-        QSqlQuery updateRowsQuery(m_db);
-        updateRowsQuery.prepare("UPDATE vector_data SET row_id = row_id + ? "
-                                "WHERE table_id = ? AND row_id >= ? "
-                                "ORDER BY row_id DESC");
-        updateRowsQuery.addBindValue(vectorTable->rowCount());
-        updateRowsQuery.addBindValue(tableId);
-        updateRowsQuery.addBindValue(startRow);
 
-        if (!updateRowsQuery.exec())
+    QVector<QStringList> rows;
+    rows.reserve(vectorTable->rowCount());
+    for (int row = 0; row < vectorTable->rowCount(); ++row)
+    {
+        QStringList values;
+        for (int index = 0; index < vectorPinIds.size(); ++index)
         {
-            qWarning() << "移动现有行失败:" << updateRowsQuery.lastError().text();
-            m_db.rollback();
-            return false;
+            QTableWidgetItem *item = sourceColumns[index] >= 0 ? vectorTable->item(row, sourceColumns[index]) : nullptr;
+            values << ((item && !item->text().isEmpty()) ? item->text() : QString("X"));
         }
+        rows.append(values);
     }
 
-    // 插入新行数据
-    for (int row = 0; row < vectorTable->rowCount(); row++)
+    // 这里编辑的只有管脚状态，新行使用第一个TimeSet
+    QSqlQuery timeSetQuery(m_db);
+    if (!timeSetQuery.exec("SELECT MIN(id) FROM timeset_list") || !timeSetQuery.next() || timeSetQuery.value(0).isNull())
     {
-        for (int col = 0; col < vectorTable->columnCount(); col++)
-        {
-            QTableWidgetItem *item = vectorTable->item(row, col);
-            if (item)
-            {
-                QString pinName = vectorTable->horizontalHeaderItem(col)->text();
-                if (pinNameToId.contains(pinName))
-                {
-                    int pinId = pinNameToId[pinName];
-                    QString pinValue = item->text();
-
-                    QSqlQuery insertQuery(m_db);
-                    insertQuery.prepare("INSERT INTO vector_data (table_id, row_id, pin_id, pin_value) "
-                                        "VALUES (?, ?, ?, ?)");
-                    insertQuery.addBindValue(tableId);
-                    insertQuery.addBindValue(startRow + row);
-                    insertQuery.addBindValue(pinId);
-                    insertQuery.addBindValue(pinValue);
-
-                    if (!insertQuery.exec())
-                    {
-                        qWarning() << "插入向量数据失败:" << insertQuery.lastError().text();
-                        m_db.rollback();
-                        return false;
-                    }
-                }
-            }
-        }
+        qWarning() << "保存向量数据失败: 没有可用的TimeSet，请先创建TimeSet";
+        return false;
     }
+    int timeSetId = timeSetQuery.value(0).toInt();
 
-    // 提交事务
-    if (!m_db.commit())
+    if (!VectorDataHandler::insertPinStateRows(tableId, insertPosition, appendToEnd, timeSetId,
+                                               vectorPinIds, rows, 1, errorMessage))
     {
-        qWarning() << "提交事务失败:" << m_db.lastError().text();
-        m_db.rollback();
+        qWarning() << "插入向量数据失败:" << errorMessage;
         return false;
     }
-
     return true;
 }
 
 // 新增：检查TimeSet是否被向量表使用
 bool TimeSetDataAccess::isTimeSetInUse(int timeSetId)
 {
+    // 计数表由触发器随向量行维护，只需读取该TimeSet的几行计数
     QSqlQuery query(m_db);
-    query.prepare("SELECT COUNT(*) FROM vector_table_data WHERE timeset_id = ?");
+    query.prepare("SELECT COALESCE(SUM(row_count), 0) FROM timeset_usage WHERE timeset_id = ?");
     query.addBindValue(timeSetId);
 
-    if (query.exec() && query.next())
+    if (!query.exec() || !query.next())
     {
-        int count = query.value(0).toInt();
-        qDebug() << "TimeSetDataAccess::isTimeSetInUse - TimeSet ID:" << timeSetId << "在vector_table_data中的引用计数:" << count;
-        return count > 0;
+        // 计数表尚未建立(旧项目升级失败)时退回到扫描向量行
+        qWarning() << "TimeSetDataAccess::isTimeSetInUse - 读取使用计数失败，改为扫描向量行:" << query.lastError().text();
+        query.prepare("SELECT EXISTS(SELECT 1 FROM vector_table_data WHERE timeset_id = ?)");
+        query.addBindValue(timeSetId);
+        if (!query.exec() || !query.next())
+        {
+            qWarning() << "检查TimeSet是否在使用失败:" << query.lastError().text();
+            return false; // 查询失败时，保守地认为它可能在使用中或返回错误
+        }
     }
-    else
+
+    int count = query.value(0).toInt();
+    qDebug() << "TimeSetDataAccess::isTimeSetInUse - TimeSet ID:" << timeSetId << "在vector_table_data中的引用计数:" << count;
+    return count > 0;
+}
+
+bool TimeSetDataAccess::loadTimeSetUsage(QMap<int, TimeSetUsage> &usage)
+{
+    usage.clear();
+
+    QSqlQuery query(m_db);
+    if (!query.exec("SELECT timeset_id, SUM(row_count), COUNT(*) FROM timeset_usage "
+                    "WHERE row_count > 0 GROUP BY timeset_id"))
     {
-        qWarning() << "检查TimeSet是否在使用失败:" << query.lastError().text();
-        return false; // 查询失败时，保守地认为它可能在使用中或返回错误
+        qWarning() << "TimeSetDataAccess::loadTimeSetUsage - 读取使用计数失败:" << query.lastError().text();
+        return false;
     }
+
+    while (query.next())
+    {
+        TimeSetUsage item;
+        item.rowCount = query.value(1).toInt();
+        item.tableCount = query.value(2).toInt();
+        usage.insert(query.value(0).toInt(), item);
+    }
+    return true;
 }
\ No newline at end of file
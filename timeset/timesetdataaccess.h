@@ -32,6 +32,13 @@ struct TimeSetData
     QList<TimeSetEdgeData> edges; // 边沿参数列表
 };
 
+// TimeSet在向量表中的使用情况，来自timeset_usage计数表
+struct TimeSetUsage
+{
+    int rowCount;   // 引用该TimeSet的向量行数
+    int tableCount; // 引用该TimeSet的向量表数
+};
+
 class TimeSetDataAccess
 {
 public:
@@ -43,9 +50,12 @@ public:
     // 查询方法
     bool loadWaveOptions(QMap<int, QString> &waveOptions);
     bool loadPins(QMap<int, QString> &pinList);
+    // 只加载TimeSet的id、名称和周期，pinIds和edges为空
     bool loadExistingTimeSets(QList<TimeSetData> &timeSetDataList);
     QList<TimeSetData> loadExistingTimeSets();
     QList<TimeSetEdgeData> loadTimeSetEdges(int timeSetId);
+    // 读取所有TimeSet的使用计数，未被使用的TimeSet不在结果中
+    bool loadTimeSetUsage(QMap<int, TimeSetUsage> &usage);
 
     // 验证方法
     bool isTimeSetNameExists(const QString &name);
@@ -53,6 +63,7 @@ public:
 
     // 保存方法
     bool saveTimeSetToDatabase(const TimeSetData &timeSet, int &outTimeSetId);
+    // 与数据库中现有的边沿对比，只删除、更新、插入有变化的管脚
     bool saveTimeSetEdgesToDatabase(int timeSetId, const QList<TimeSetEdgeData> &edges);
     bool updateTimeSetName(int timeSetId, const QString &newName);
     bool updateTimeSetPeriod(int timeSetId, double period);
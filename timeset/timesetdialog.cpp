@@ -76,7 +76,6 @@ void WaveComboDelegate::updateEditorGeometry(QWidget *editor, const QStyleOption
 TimeSetDialog::TimeSetDialog(QWidget *parent, bool isInitialSetup)
     : QDialog(parent),
       m_mainWindow(qobject_cast<MainWindow *>(parent)),
-      m_currentTimeSetItem(nullptr),
       m_currentTimeSetIndex(-1),
       m_isInitialSetup(isInitialSetup)
 {
@@ -85,26 +84,26 @@ TimeSetDialog::TimeSetDialog(QWidget *parent, bool isInitialSetup)
     setMinimumSize(800, 600);
 
     // 设置全局样式
-    QString styleSheet = "QTreeWidget {"
+    QString styleSheet = "QTreeView {"
                          "    border: 1px solid #C0C0C0;"
                          "    background-color: white;"
                          "    font-size: 9pt;"
                          "}"
-                         "QTreeWidget::item {"
+                         "QTreeView::item {"
                          "    border-bottom: 1px solid #F0F0F0;"
                          "    height: 25px;"
                          "}"
-                         "QTreeWidget::item:selected {"
+                         "QTreeView::item:selected {"
                          "    background-color: #E0E8F0;"
                          "    color: black;"
                          "}"
-                         "QTreeWidget::branch:has-children:!has-siblings:closed,"
-                         "QTreeWidget::branch:closed:has-children:has-siblings {"
+                         "QTreeView::branch:has-children:!has-siblings:closed,"
+                         "QTreeView::branch:closed:has-children:has-siblings {"
                          "    border-image: none;"
                          "    image: url(:/icons/branch-closed.png);"
                          "}"
-                         "QTreeWidget::branch:open:has-children:!has-siblings,"
-                         "QTreeWidget::branch:open:has-children:has-siblings {"
+                         "QTreeView::branch:open:has-children:!has-siblings,"
+                         "QTreeView::branch:open:has-children:has-siblings {"
                          "    border-image: none;"
                          "    image: url(:/icons/branch-open.png);"
                          "}"
@@ -152,8 +151,20 @@ void TimeSetDialog::initialize()
     // 创建UI管理器
     m_uiManager = new TimeSetUIManager(this);
 
+    // 创建TimeSet树模型，边沿参数在展开时才加载
+    m_timeSetModel = new TimeSetTreeModel(m_dataAccess, this);
+    m_timeSetModel->setLookups(m_pinList, m_waveOptions);
+
+    // 时序规则按波形类型生成，读取失败时不做检查
+    QString ruleError;
+    if (m_timingChecker.loadRules(m_db, ruleError))
+        m_timeSetModel->setTimingChecker(&m_timingChecker);
+    else
+        qWarning() << "TimeSetDialog - 加载时序规则失败:" << ruleError;
+    m_uiManager->setTimeSetModel(m_timeSetModel);
+
     // 创建边缘管理器
-    m_edgeManager = new TimeSetEdgeManager(m_uiManager->getTimeSetTree(), m_dataAccess);
+    m_edgeManager = new TimeSetEdgeManager(m_timeSetModel, m_dataAccess);
 
     // 创建管脚选择管理器
     m_pinManager = new PinSelectionManager(m_uiManager->getPinListWidget(), m_dataAccess);
@@ -172,62 +183,44 @@ void TimeSetDialog::initialize()
         // 如果加载失败，显示错误信息
         QMessageBox::warning(this, "加载错误", "TimeSet数据加载失败，请检查数据库连接。");
     }
-
-    // 更新所有边沿项的显示格式
-    m_edgeManager->updateAllEdgeItemsDisplay(m_waveOptions);
 }
 
 bool TimeSetDialog::loadExistingTimeSets()
 {
-    QTreeWidget *timeSetTree = m_uiManager->getTimeSetTree();
-    timeSetTree->clear();
+    // 重新加载后UI与数据库一致，未保存的修改已丢弃
+    m_edgeManager->clearDirty();
+    m_changedPropertyIds.clear();
+    m_currentTimeSet = QPersistentModelIndex();
+    m_currentTimeSetIndex = -1;
 
     qDebug() << "开始加载TimeSet列表到UI";
 
-    // 从数据库加载TimeSet列表
+    // 只加载TimeSet列表，边沿参数在展开TimeSet时由模型按需加载
     if (m_dataAccess->loadExistingTimeSets(m_timeSetDataList))
     {
-        qDebug() << "成功从数据库加载，TimeSet数量：" << m_timeSetDataList.size();
-
-        // 添加每个TimeSet到树中
-        for (const TimeSetData &timeSet : m_timeSetDataList)
-        {
-            // 创建TimeSet项
-            QTreeWidgetItem *timeSetItem = new QTreeWidgetItem(timeSetTree);
-
-            // 设置数据
-            double period = timeSet.period;
-            double freq = 1000.0 / period;
-            timeSetItem->setText(0, timeSet.name + "/" + QString::number(period) + "ns=" + QString::number(freq, 'f', 3) + "MHz");
-            timeSetItem->setData(0, Qt::UserRole, timeSet.dbId);
-
-            // 设置字体和背景样式
-            QFont boldFont = timeSetItem->font(0);
-            boldFont.setBold(true);
-            boldFont.setPointSize(boldFont.pointSize() + 1);
-            timeSetItem->setFont(0, boldFont);
-
-            // 设置背景色
-            QBrush brush(QColor(230, 240, 250));
-            for (int col = 0; col < 5; col++)
-            {
-                timeSetItem->setBackground(col, brush);
-            }
-
-            // 加载并显示边沿参数
-            QList<TimeSetEdgeData> edges = m_dataAccess->loadTimeSetEdges(timeSet.dbId);
-            m_edgeManager->displayTimeSetEdges(timeSetItem, edges, m_waveOptions, m_pinList);
+        m_timeSetModel->setTimeSets(m_timeSetDataList);
 
-            // 展开
-            timeSetItem->setExpanded(true);
+        // 使用计数只读计数表，不扫描向量行
+        QMap<int, TimeSetUsage> usage;
+        m_dataAccess->loadTimeSetUsage(usage);
+        m_timeSetModel->setUsage(usage);
 
-            qDebug() << "已添加TimeSet到UI: id=" << timeSet.dbId << ", name=" << timeSet.name;
+        // 一次检查全部边沿，未展开的TimeSet也能标出问题
+        if (m_timingChecker.rulesLoaded())
+        {
+            QVector<TimingViolation> violations;
+            QString checkError;
+            if (m_timingChecker.checkDatabase(m_db, violations, checkError))
+                m_timeSetModel->setTimingViolations(violations);
+            else
+                qWarning() << "TimeSetDialog::loadExistingTimeSets - 时序检查失败:" << checkError;
         }
-
+        qDebug() << "成功从数据库加载，TimeSet数量：" << m_timeSetDataList.size();
         return true;
     }
     else
     {
+        m_timeSetModel->setTimeSets(QList<TimeSetData>());
         qWarning() << "加载TimeSet设置失败";
         return false;
     }
@@ -242,9 +235,12 @@ void TimeSetDialog::setupConnections()
     connect(m_uiManager->getRemoveEdgeButton(), &QPushButton::clicked, this, &TimeSetDialog::removeEdgeItem);
 
     // 连接TreeWidget信号
-    connect(m_uiManager->getTimeSetTree(), &QTreeWidget::itemSelectionChanged, this, &TimeSetDialog::timeSetSelectionChanged);
-    connect(m_uiManager->getTimeSetTree(), &QTreeWidget::itemChanged, this, &TimeSetDialog::onPropertyItemChanged);
-    connect(m_uiManager->getTimeSetTree(), &QTreeWidget::itemDoubleClicked, this, &TimeSetDialog::onItemDoubleClicked);
+    connect(m_uiManager->getTimeSetTree()->selectionModel(), &QItemSelectionModel::selectionChanged, this, &TimeSetDialog::timeSetSelectionChanged);
+    connect(m_uiManager->getTimeSetTree(), &QTreeView::doubleClicked, this, &TimeSetDialog::onItemDoubleClicked);
+
+    // 在表格中直接修改的边沿参数在确定时保存
+    connect(m_timeSetModel, &TimeSetTreeModel::edgeEdited, this, [this](int timeSetId)
+            { m_edgeManager->markDirty(timeSetId); });
 
     // 连接对话框按钮
     connect(m_uiManager->getButtonBox(), &QDialogButtonBox::accepted, this, &TimeSetDialog::onAccepted);
@@ -296,30 +292,11 @@ void TimeSetDialog::addTimeSet()
             newTimeSet.dbId = newTimeSetId;
             m_timeSetDataList.append(newTimeSet);
 
-            // 创建TreeWidget项
-            QTreeWidget *timeSetTree = m_uiManager->getTimeSetTree();
-            QTreeWidgetItem *newItem = new QTreeWidgetItem(timeSetTree);
-
-            // 设置数据
-            double freq = 1000.0 / newTimeSet.period;
-            newItem->setText(0, newTimeSet.name + "/" + QString::number(newTimeSet.period) + "ns=" + QString::number(freq, 'f', 3) + "MHz");
-            newItem->setData(0, Qt::UserRole, newTimeSet.dbId);
-
-            // 设置字体和背景样式
-            QFont boldFont = newItem->font(0);
-            boldFont.setBold(true);
-            boldFont.setPointSize(boldFont.pointSize() + 1);
-            newItem->setFont(0, boldFont);
-
-            // 设置背景色
-            QBrush brush(QColor(230, 240, 250));
-            for (int col = 0; col < 5; col++)
-            {
-                newItem->setBackground(col, brush);
-            }
-
-            // 选中新项
-            timeSetTree->setCurrentItem(newItem);
+            // 添加到树中并选中
+            QTreeView *timeSetTree = m_uiManager->getTimeSetTree();
+            QModelIndex newIndex = m_timeSetModel->addTimeSet(newTimeSet.dbId, newTimeSet.name, newTimeSet.period);
+            timeSetTree->setCurrentIndex(newIndex);
+            timeSetTree->scrollTo(newIndex);
             timeSetSelectionChanged();
 
             QMessageBox::information(this, "添加成功", "TimeSet \"" + name + "\" 创建成功！");
@@ -337,10 +314,10 @@ void TimeSetDialog::addTimeSet()
 
 void TimeSetDialog::removeTimeSet()
 {
-    if (!m_currentTimeSetItem)
+    if (!m_currentTimeSet.isValid())
         return;
 
-    int timeSetId = m_currentTimeSetItem->data(0, Qt::UserRole).toInt();
+    int timeSetId = m_timeSetModel->timeSetId(m_currentTimeSet);
     QString timeSetName = getTimeSetNameById(timeSetId); // 使用辅助函数获取名称
 
     if (timeSetName.isEmpty())
@@ -349,6 +326,14 @@ void TimeSetDialog::removeTimeSet()
         return;
     }
 
+    // 使用计数由计数表直接得到，正在使用的TimeSet不进入待删除列表
+    if (m_dataAccess->isTimeSetInUse(timeSetId))
+    {
+        QMessageBox::warning(this, "无法删除",
+                             QString("TimeSet '%1' 正在被向量表使用，无法删除。\n请先在向量表中修改或删除对它的引用。").arg(timeSetName));
+        return;
+    }
+
     // 确认删除
     if (QMessageBox::question(this, "确认删除",
                               "确定要删除TimeSet '" + timeSetName + "' 吗？",
@@ -367,34 +352,21 @@ void TimeSetDialog::removeTimeSet()
 
         // 从UI中移除该项 (稍后如果验证失败会恢复)
         qDebug() << "TimeSetDialog::removeTimeSet - 从UI移除TimeSet项:" << timeSetId;
-        int indexToRemove = m_uiManager->getTimeSetTree()->indexOfTopLevelItem(m_currentTimeSetItem);
-        if (indexToRemove != -1)
-        {
-            // 正确删除子项：手动遍历列表并删除每个子项指针
-            QList<QTreeWidgetItem *> children = m_currentTimeSetItem->takeChildren(); // 获取并移除子项列表
-            for (QTreeWidgetItem *child : children)
-            {
-                delete child; // 逐个删除子项
-            }
-            // children 列表本身是栈变量，会自动销毁，无需手动 clear()
-
-            // 删除父项本身
-            delete m_uiManager->getTimeSetTree()->takeTopLevelItem(indexToRemove);
-        }
+        m_timeSetModel->removeTimeSet(m_currentTimeSet);
 
         // 更新当前选择
-        m_currentTimeSetItem = nullptr;
+        m_currentTimeSet = QPersistentModelIndex();
         m_currentTimeSetIndex = -1;
         timeSetSelectionChanged();
     }
 }
 
-void TimeSetDialog::editTimeSetProperties(QTreeWidgetItem *item, int column)
+void TimeSetDialog::editTimeSetProperties(const QModelIndex &index)
 {
-    if (!item || column != 0 || item->parent() != nullptr)
+    if (!index.isValid() || index.column() != 0 || m_timeSetModel->isEdgeIndex(index))
         return;
 
-    int timeSetId = item->data(0, Qt::UserRole).toInt();
+    int timeSetId = m_timeSetModel->timeSetId(index);
     QString currentName = "";
     double currentPeriod = 0.0;
 
@@ -477,14 +449,10 @@ void TimeSetDialog::editTimeSetProperties(QTreeWidgetItem *item, int column)
             // 1. 更新内存中的数据
             m_timeSetDataList[dataIndex].name = newName;
             m_timeSetDataList[dataIndex].period = newPeriod;
+            m_changedPropertyIds.insert(timeSetId);
 
-            // 2. 更新UI TreeWidget Item 的显示文本 (直接格式化)
-            double freq = (newPeriod > 0) ? (1000.0 / newPeriod) : 0.0;
-            QString formattedText = QString("%1/%2ns=%3MHz")
-                                        .arg(newName)
-                                        .arg(QString::number(newPeriod)) // 保持原始精度
-                                        .arg(QString::number(freq, 'f', 3));
-            item->setText(0, formattedText);
+            // 2. 更新树中的显示，文本由模型生成
+            m_timeSetModel->updateTimeSet(index, newName, newPeriod);
 
             // 数据库的更新将在点击对话框的 OK 时在 onAccepted() 中处理
         }
@@ -497,7 +465,7 @@ void TimeSetDialog::editTimeSetProperties(QTreeWidgetItem *item, int column)
 
 void TimeSetDialog::updatePeriod(double value)
 {
-    if (!m_currentTimeSetItem || m_currentTimeSetIndex < 0 || m_currentTimeSetIndex >= m_timeSetDataList.size())
+    if (!m_currentTimeSet.isValid() || m_currentTimeSetIndex < 0 || m_currentTimeSetIndex >= m_timeSetDataList.size())
         return;
 
     // 获取当前TimeSet数据
@@ -506,12 +474,9 @@ void TimeSetDialog::updatePeriod(double value)
     // 更新周期
     if (m_dataAccess->updateTimeSetPeriod(timeSet.dbId, value))
     {
-        // 更新内存中的数据
+        // 更新内存中的数据和显示
         timeSet.period = value;
-
-        // 更新显示
-        double freq = 1000.0 / value;
-        m_currentTimeSetItem->setText(0, timeSet.name + "/" + QString::number(value) + "ns=" + QString::number(freq, 'f', 3) + "MHz");
+        m_timeSetModel->updateTimeSet(m_currentTimeSet, timeSet.name, value);
     }
     else
     {
@@ -521,59 +486,42 @@ void TimeSetDialog::updatePeriod(double value)
 
 void TimeSetDialog::timeSetSelectionChanged()
 {
-    QTreeWidget *timeSetTree = m_uiManager->getTimeSetTree();
-    QList<QTreeWidgetItem *> selectedItems = timeSetTree->selectedItems();
+    QTreeView *timeSetTree = m_uiManager->getTimeSetTree();
+    QModelIndexList selectedIndexes = timeSetTree->selectionModel()->selectedRows();
 
-    if (selectedItems.isEmpty())
+    if (selectedIndexes.isEmpty())
     {
         // 没有选中项，禁用边沿操作按钮
         m_uiManager->getAddEdgeButton()->setEnabled(false);
         m_uiManager->getRemoveEdgeButton()->setEnabled(false);
-        m_currentTimeSetItem = nullptr;
+        m_currentTimeSet = QPersistentModelIndex();
         m_currentTimeSetIndex = -1;
         return;
     }
 
-    QTreeWidgetItem *selectedItem = selectedItems.first();
-
-    // 检查是否是顶级项（TimeSet项）
-    if (selectedItem->parent() == nullptr)
-    {
-        // 是TimeSet项
-        m_currentTimeSetItem = selectedItem;
-        m_currentTimeSetIndex = timeSetTree->indexOfTopLevelItem(selectedItem);
-
-        // 启用边沿操作按钮
-        m_uiManager->getAddEdgeButton()->setEnabled(true);
-        m_uiManager->getRemoveEdgeButton()->setEnabled(false);
+    QModelIndex selectedIndex = selectedIndexes.first();
 
-        // 更新管脚选择
-        int timeSetId = selectedItem->data(0, Qt::UserRole).toInt();
-        m_pinManager->selectPinsForTimeSet(timeSetId);
-    }
-    else
-    {
-        // 是边沿项
-        m_currentTimeSetItem = selectedItem->parent();
-        m_currentTimeSetIndex = timeSetTree->indexOfTopLevelItem(m_currentTimeSetItem);
+    // 选中TimeSet项或边沿项时，当前TimeSet都是其所属的TimeSet
+    m_currentTimeSet = m_timeSetModel->timeSetIndex(selectedIndex);
+    m_currentTimeSetIndex = m_currentTimeSet.row();
 
-        // 启用边沿操作按钮
-        m_uiManager->getAddEdgeButton()->setEnabled(true);
-        m_uiManager->getRemoveEdgeButton()->setEnabled(true);
+    // 启用边沿操作按钮，只有选中边沿项时才能删除
+    m_uiManager->getAddEdgeButton()->setEnabled(true);
+    m_uiManager->getRemoveEdgeButton()->setEnabled(m_timeSetModel->isEdgeIndex(selectedIndex));
 
-        // 更新管脚选择
-        int timeSetId = m_currentTimeSetItem->data(0, Qt::UserRole).toInt();
-        m_pinManager->selectPinsForTimeSet(timeSetId);
-    }
+    // 更新管脚选择
+    int timeSetId = m_timeSetModel->timeSetId(m_currentTimeSet);
+    m_pinManager->selectPinsForTimeSet(timeSetId);
 }
 
 void TimeSetDialog::addEdgeItem()
 {
-    if (!m_currentTimeSetItem)
+    if (!m_currentTimeSet.isValid())
         return;
 
     // 获取当前选中的TimeSet ID
-    int timeSetId = m_currentTimeSetItem->data(0, Qt::UserRole).toInt();
+    QModelIndex timeSetIndex = m_currentTimeSet;
+    int timeSetId = m_timeSetModel->timeSetId(timeSetIndex);
 
     // 获取选中的管脚IDs
     QList<int> selectedPinIds = m_pinManager->getSelectedPinIds();
@@ -586,10 +534,10 @@ void TimeSetDialog::addEdgeItem()
 
     // 获取已存在的边沿项的管脚IDs
     QSet<int> existingPinIds;
-    for (int i = 0; i < m_currentTimeSetItem->childCount(); i++)
+    const QList<TimeSetEdgeData> existingEdges = m_timeSetModel->edges(timeSetIndex);
+    for (const TimeSetEdgeData &edge : existingEdges)
     {
-        QTreeWidgetItem *child = m_currentTimeSetItem->child(i);
-        existingPinIds.insert(child->data(0, Qt::UserRole).toInt());
+        existingPinIds.insert(edge.pinId);
     }
 
     // 设置默认值
@@ -626,42 +574,38 @@ void TimeSetDialog::addEdgeItem()
             edge.stbr = stbr;
             edge.waveId = waveId;
 
-            // 添加到UI
-            m_edgeManager->addEdgeItem(m_currentTimeSetItem, edge);
-
-            // 添加到列表
             newEdges.append(edge);
         }
 
-        // 获取所有边沿数据并保存到数据库
+        // 添加到模型并保存到数据库
         if (!newEdges.isEmpty())
         {
-            QList<TimeSetEdgeData> allEdges = m_edgeManager->getEdgeDataFromUI(m_currentTimeSetItem, timeSetId);
-            m_dataAccess->saveTimeSetEdgesToDatabase(timeSetId, allEdges);
-
-            // 重新加载边沿项以更新显示
-            QList<TimeSetEdgeData> edges = m_dataAccess->loadTimeSetEdges(timeSetId);
-            m_edgeManager->displayTimeSetEdges(m_currentTimeSetItem, edges, m_waveOptions, m_pinList);
+            m_edgeManager->addEdges(timeSetIndex, newEdges);
+            m_uiManager->getTimeSetTree()->expand(timeSetIndex);
+            if (!m_edgeManager->saveEdges(timeSetIndex))
+            {
+                QMessageBox::critical(this, "错误", "保存边沿参数失败");
+            }
         }
     }
 }
 
 void TimeSetDialog::removeEdgeItem()
 {
-    QTreeWidget *timeSetTree = m_uiManager->getTimeSetTree();
-    QList<QTreeWidgetItem *> selectedItems = timeSetTree->selectedItems();
+    QTreeView *timeSetTree = m_uiManager->getTimeSetTree();
+    QModelIndexList selectedIndexes = timeSetTree->selectionModel()->selectedRows();
 
-    if (selectedItems.isEmpty())
+    if (selectedIndexes.isEmpty())
         return;
 
-    QTreeWidgetItem *selectedItem = selectedItems.first();
+    QModelIndex selectedIndex = selectedIndexes.first();
 
     // 确保是边沿项
-    if (selectedItem->parent() == nullptr)
+    if (!m_timeSetModel->isEdgeIndex(selectedIndex))
         return;
 
     // 删除边沿项
-    if (m_edgeManager->removeEdgeItem(selectedItem))
+    if (m_edgeManager->removeEdge(selectedIndex))
     {
         // 更新UI状态
         timeSetSelectionChanged();
@@ -672,65 +616,31 @@ void TimeSetDialog::removeEdgeItem()
     }
 }
 
-void TimeSetDialog::editEdgeItem(QTreeWidgetItem *item, int column)
+void TimeSetDialog::editEdgeItem(const QModelIndex &index)
 {
-    m_edgeManager->editEdgeItem(item, column, m_waveOptions);
+    m_edgeManager->editEdge(index, m_waveOptions);
 }
 
-void TimeSetDialog::onItemDoubleClicked(QTreeWidgetItem *item, int column)
+void TimeSetDialog::onItemDoubleClicked(const QModelIndex &index)
 {
-    if (!item)
+    if (!index.isValid())
         return;
 
-    if (item->parent() == nullptr)
+    if (!m_timeSetModel->isEdgeIndex(index))
     {
         // TimeSet项
-        editTimeSetProperties(item, column);
+        editTimeSetProperties(index);
     }
     else
     {
         // 边沿项
-        editEdgeItem(item, column);
-    }
-}
-
-void TimeSetDialog::onPropertyItemChanged(QTreeWidgetItem *item, int column)
-{
-    // 此方法处理项目属性变更
-    // 注意：由于编辑操作（如重命名、修改边沿参数）会在完成后直接更新UI项，
-    // 这可能会触发itemChanged信号。为了避免在非用户直接编辑时触发不必要的逻辑（特别是保存），
-    // 这个槽函数目前保持为空，或者只包含非常轻量级的UI更新逻辑。
-    // 数据的保存应该在用户明确确认操作（如点击OK按钮）时进行。
-    Q_UNUSED(item);
-    Q_UNUSED(column);
-    // 注释掉原来的保存逻辑：
-    /*
-    if (!item)
-        return;
-
-    // 根据项的类型处理不同的更改
-    if (item->parent() == nullptr)
-    {
-        // TimeSet项的更改
-        // 这里不处理，因为已经在editTimeSetProperties方法中处理
+        editEdgeItem(index);
     }
-    else
-    {
-        // 边沿项的更改
-        // 获取父TimeSet项
-        QTreeWidgetItem *parentItem = item->parent();
-        int timeSetId = parentItem->data(0, Qt::UserRole).toInt();
-
-        // 获取所有边沿数据并保存 (问题在这里！)
-        QList<TimeSetEdgeData> edges = m_edgeManager->getEdgeDataFromUI(parentItem, timeSetId);
-        m_dataAccess->saveTimeSetEdgesToDatabase(timeSetId, edges);
-    }
-    */
 }
 
 void TimeSetDialog::onPinSelectionChanged()
 {
-    if (!m_currentTimeSetItem || m_currentTimeSetIndex < 0 || m_currentTimeSetIndex >= m_timeSetDataList.size())
+    if (!m_currentTimeSet.isValid() || m_currentTimeSetIndex < 0 || m_currentTimeSetIndex >= m_timeSetDataList.size())
         return;
 
     // 获取当前TimeSet数据
@@ -746,14 +656,13 @@ void TimeSetDialog::onPinSelectionChanged()
     m_dataAccess->savePinSelection(timeSet.dbId, selectedPinIds);
 }
 
-void TimeSetDialog::updatePinSelection(QTreeWidgetItem *item, int column)
+void TimeSetDialog::updatePinSelection(const QModelIndex &index)
 {
-    if (!item)
+    if (!index.isValid())
         return;
 
     // 获取当前TimeSet
-    QTreeWidgetItem *timeSetItem = (item->parent() == nullptr) ? item : item->parent();
-    int timeSetId = timeSetItem->data(0, Qt::UserRole).toInt();
+    int timeSetId = m_timeSetModel->timeSetId(index);
 
     // 更新管脚选择
     m_pinManager->selectPinsForTimeSet(timeSetId);
@@ -777,6 +686,16 @@ void TimeSetDialog::onAccepted()
 {
     qDebug() << "TimeSetDialog::onAccepted - 开始处理确定按钮事件";
 
+    // 时序问题只提示，仍允许保存，导出前可再用命令行检查
+    int timingViolations = m_timeSetModel->totalTimingViolationCount();
+    if (timingViolations > 0 &&
+        QMessageBox::question(this, "时序检查",
+                              QString("TimeSet中有%1处时序问题(已用红色标出)，是否仍然保存？").arg(timingViolations),
+                              QMessageBox::Yes | QMessageBox::No, QMessageBox::No) != QMessageBox::Yes)
+    {
+        return;
+    }
+
     // --- 删除验证 ---
     QStringList conflictingNames;
     QList<int> validatedIdsToDelete;
@@ -879,8 +798,8 @@ void TimeSetDialog::onAccepted()
     bool savePropsSuccess = true;
     for (const TimeSetData &timeSet : m_timeSetDataList)
     {
-        // 只更新数据库中已存在的记录 (dbId > 0)
-        if (timeSet.dbId > 0)
+        // 只更新数据库中已存在且属性被修改过的记录 (dbId > 0)
+        if (timeSet.dbId > 0 && m_changedPropertyIds.contains(timeSet.dbId))
         {
             qDebug() << "TimeSetDialog::onAccepted - 准备更新TimeSet ID:" << timeSet.dbId << " 名称:" << timeSet.name << " 周期:" << timeSet.period;
             // 分别更新名称和周期。可以考虑合并为一个更新函数，但目前分开处理更清晰
@@ -899,7 +818,7 @@ void TimeSetDialog::onAccepted()
                 // break; // 可选：一个失败则全部失败
             }
         }
-        else
+        else if (timeSet.dbId <= 0)
         {
             qDebug() << "TimeSetDialog::onAccepted - 跳过新添加的TimeSet (ID <= 0):" << timeSet.name << "，将在后续步骤处理";
             // 新添加的 TimeSet 的基本信息已在 addTimeSet 时保存，这里不需要重复处理
@@ -913,32 +832,30 @@ void TimeSetDialog::onAccepted()
         loadExistingTimeSets(); // 重新加载以反映部分成功或失败的状态
         return;                 // 阻止对话框关闭
     }
+    m_changedPropertyIds.clear();
     qDebug() << "TimeSetDialog::onAccepted - 所有TimeSet的名称和周期已尝试保存";
 
-    // --- 保存所有TimeSet的边沿设置 ---
-    qDebug() << "TimeSetDialog::onAccepted - 开始保存所有TimeSet的边沿设置";
+    // --- 保存边沿被修改过的TimeSet ---
+    qDebug() << "TimeSetDialog::onAccepted - 开始保存修改过的TimeSet边沿设置";
     bool saveSuccess = true;
-    QTreeWidget *tree = m_uiManager->getTimeSetTree();
-    for (int i = 0; i < tree->topLevelItemCount(); ++i)
+    m_db.transaction(); // 所有TimeSet的边沿在一个事务中写入
+    for (int i = 0; i < m_timeSetModel->rowCount(); ++i)
     {
-        QTreeWidgetItem *timeSetItem = tree->topLevelItem(i);
-        if (!timeSetItem)
-            continue;
-        int timeSetId = timeSetItem->data(0, Qt::UserRole).toInt();
+        QModelIndex timeSetIndex = m_timeSetModel->index(i, 0);
+        int timeSetId = m_timeSetModel->timeSetId(timeSetIndex);
         if (timeSetId <= 0)
             continue; // 跳过无效ID
+        if (!m_edgeManager->isDirty(timeSetId))
+            continue; // 边沿未修改，数据库中已是最新
 
         qDebug() << "TimeSetDialog::onAccepted - 准备保存 TimeSet ID:" << timeSetId << "的边沿";
-        QList<TimeSetEdgeData> edges = m_edgeManager->getEdgeDataFromUI(timeSetItem, timeSetId);
-        if (!m_dataAccess->saveTimeSetEdgesToDatabase(timeSetId, edges))
+        if (!m_edgeManager->saveEdges(timeSetIndex))
         {
             QString timeSetName = getTimeSetNameById(timeSetId);
             qWarning() << "TimeSetDialog::onAccepted - 保存TimeSet ID:" << timeSetId << "(" << timeSetName << ") 的边沿参数失败";
             QMessageBox::critical(this, "保存错误", QString("保存TimeSet '%1' (ID: %2) 的边沿参数时发生错误。请检查日志。").arg(timeSetName).arg(timeSetId));
             saveSuccess = false;
-            // 这里可以选择 break 或 continue，取决于是否希望一个失败阻止所有保存
-            // 为了数据一致性，可能需要回滚所有更改，但这会增加复杂性。
-            // 目前选择继续尝试保存其他的，但标记为失败。
+            break; // 事务整体回滚，不保留部分保存的结果
         }
         else
         {
@@ -946,12 +863,18 @@ void TimeSetDialog::onAccepted()
         }
     }
 
+    if (saveSuccess && !m_db.commit())
+    {
+        qWarning() << "TimeSetDialog::onAccepted - 提交边沿参数失败:" << m_db.lastError().text();
+        QMessageBox::critical(this, "保存错误", "提交边沿参数时发生错误：" + m_db.lastError().text());
+        saveSuccess = false;
+    }
+
     if (!saveSuccess)
     {
-        qDebug() << "TimeSetDialog::onAccepted - 保存边沿参数时至少发生一个错误";
-        // 可以选择在这里回滚之前的删除操作，或者只是阻止对话框关闭并提示用户
-        // 重新加载数据以确保UI一致性可能也是必要的
-        loadExistingTimeSets(); // 重新加载以反映部分成功或失败的状态
+        qDebug() << "TimeSetDialog::onAccepted - 保存边沿参数时发生错误，事务已回滚";
+        m_db.rollback();
+        loadExistingTimeSets(); // 重新加载以恢复到数据库中的状态
         return;                 // 阻止对话框关闭
     }
     qDebug() << "TimeSetDialog::onAccepted - 所有TimeSet的边沿设置已尝试保存";
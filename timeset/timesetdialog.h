@@ -2,16 +2,19 @@
 #define TIMESETDIALOG_H
 
 #include <QDialog>
-#include <QTreeWidget>
-#include <QTreeWidgetItem>
+#include <QTreeView>
+#include <QPersistentModelIndex>
 #include <QSqlDatabase>
 #include <QMap>
 #include <QList>
+#include <QSet>
 #include <QStyledItemDelegate>
 
 #include "timesetdataaccess.h"
 #include "timesetui.h"
 #include "timesetedgemanager.h"
+#include "timesettreemodel.h"
+#include "timingrulechecker.h"
 #include "pinselectionmanager.h"
 #include "vectordatamanager.h"
 
@@ -60,18 +63,17 @@ private slots:
     void removeTimeSet();
     void updatePeriod(double value);
     void timeSetSelectionChanged();
-    void editTimeSetProperties(QTreeWidgetItem *item, int column);
+    void editTimeSetProperties(const QModelIndex &index);
 
     // 边沿参数条目操作
     void addEdgeItem();
     void removeEdgeItem();
-    void editEdgeItem(QTreeWidgetItem *item, int column);
-    void onItemDoubleClicked(QTreeWidgetItem *item, int column);
-    void onPropertyItemChanged(QTreeWidgetItem *item, int column);
+    void editEdgeItem(const QModelIndex &index);
+    void onItemDoubleClicked(const QModelIndex &index);
 
     // 管脚选择
     void onPinSelectionChanged();
-    void updatePinSelection(QTreeWidgetItem *item, int column);
+    void updatePinSelection(const QModelIndex &index);
 
     // 对话框按钮
     void onAccepted();
@@ -103,9 +105,16 @@ private:
     QMap<int, QString> m_waveOptions;
     QMap<int, QString> m_pinList;
     QList<int> m_timeSetIdsToDelete; // Track TimeSet IDs marked for deletion
+    QSet<int> m_changedPropertyIds;  // 名称或周期被修改、确定时需要写回的TimeSet
 
-    // 当前选中的TimeSet项
-    QTreeWidgetItem *m_currentTimeSetItem;
+    // TimeSet树模型
+    TimeSetTreeModel *m_timeSetModel;
+
+    // 时序规则检查
+    TimingRuleChecker m_timingChecker;
+
+    // 当前选中的TimeSet项(顶层索引)
+    QPersistentModelIndex m_currentTimeSet;
     int m_currentTimeSetIndex;
 
     // 标识是否是初始设置流程
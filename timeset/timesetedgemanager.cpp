@@ -1,213 +1,91 @@
 #include "timesetedgemanager.h"
 #include "timesetedgedialog.h"
 #include <QApplication>
-#include <QStyle>
-#include <QBrush>
-#include <QMessageBox>
 #include <QDebug>
 
-TimeSetEdgeManager::TimeSetEdgeManager(QTreeWidget *tree, TimeSetDataAccess *dataAccess)
-    : m_treeWidget(tree), m_dataAccess(dataAccess)
+TimeSetEdgeManager::TimeSetEdgeManager(TimeSetTreeModel *model, TimeSetDataAccess *dataAccess)
+    : m_model(model), m_dataAccess(dataAccess)
 {
 }
 
-void TimeSetEdgeManager::addEdgeItem(QTreeWidgetItem *parentItem, const TimeSetEdgeData &edgeData)
+void TimeSetEdgeManager::addEdges(const QModelIndex &timeSetIndex, const QList<TimeSetEdgeData> &edges)
 {
-    if (!parentItem)
+    if (!timeSetIndex.isValid() || edges.isEmpty())
         return;
 
-    // 创建新的边沿项
-    QTreeWidgetItem *edgeItem = new QTreeWidgetItem(parentItem);
-
-    // 设置边沿项数据
-    edgeItem->setData(0, Qt::UserRole, edgeData.pinId);
-    edgeItem->setData(1, Qt::UserRole, edgeData.t1r);
-    edgeItem->setData(2, Qt::UserRole, edgeData.t1f);
-    edgeItem->setData(3, Qt::UserRole, edgeData.stbr);
-    edgeItem->setData(4, Qt::UserRole, edgeData.waveId);
-
-    // 设置所有列都可编辑
-    for (int col = 0; col < 5; col++)
-    {
-        edgeItem->setFlags(edgeItem->flags() | Qt::ItemIsEditable);
-    }
+    m_model->addEdges(timeSetIndex, edges);
+    markDirty(m_model->timeSetId(timeSetIndex));
 }
 
-bool TimeSetEdgeManager::removeEdgeItem(QTreeWidgetItem *item)
+bool TimeSetEdgeManager::removeEdge(const QModelIndex &edgeIndex)
 {
-    if (!item || !item->parent())
+    if (!m_model->isEdgeIndex(edgeIndex))
         return false;
 
-    QTreeWidgetItem *parentItem = item->parent();
-    int timeSetId = parentItem->data(0, Qt::UserRole).toInt();
-    int pinId = item->data(0, Qt::UserRole).toInt();
+    int timeSetId = m_model->timeSetId(edgeIndex);
+    int pinId = m_model->edgeData(edgeIndex).pinId;
 
     // 从数据库删除边沿项
     if (m_dataAccess->deleteTimeSetEdge(timeSetId, pinId))
     {
-        // 从树中删除项
-        delete item;
+        // 从模型中删除项
+        m_model->removeEdge(edgeIndex);
         return true;
     }
 
     return false;
 }
 
-void TimeSetEdgeManager::editEdgeItem(QTreeWidgetItem *item, int column, const QMap<int, QString> &waveOptions)
+void TimeSetEdgeManager::editEdge(const QModelIndex &edgeIndex, const QMap<int, QString> &waveOptions)
 {
-    if (!item || !item->parent())
-        return;
-
     // 检查是否是边沿项而不是TimeSet项
-    QTreeWidgetItem *parentItem = item->parent();
-    if (!parentItem)
+    if (!m_model->isEdgeIndex(edgeIndex))
         return;
 
     // 获取当前值
-    double currentT1R = item->data(1, Qt::UserRole).toDouble();
-    double currentT1F = item->data(2, Qt::UserRole).toDouble();
-    double currentSTBR = item->data(3, Qt::UserRole).toDouble();
-    int currentWaveId = item->data(4, Qt::UserRole).toInt();
+    TimeSetEdgeData edgeData = m_model->edgeData(edgeIndex);
 
     // 显示编辑对话框
-    TimeSetEdgeDialog dialog(currentT1R, currentT1F, currentSTBR, currentWaveId, waveOptions, QApplication::activeWindow());
+    TimeSetEdgeDialog dialog(edgeData.t1r, edgeData.t1f, edgeData.stbr, edgeData.waveId, waveOptions, QApplication::activeWindow());
 
     if (dialog.exec() == QDialog::Accepted)
     {
-        // 更新边沿项数据
-        TimeSetEdgeData edgeData;
-        edgeData.timesetId = parentItem->data(0, Qt::UserRole).toInt();
-        edgeData.pinId = item->data(0, Qt::UserRole).toInt();
+        // 更新边沿项数据，显示文本由模型生成
+        edgeData.timesetId = m_model->timeSetId(edgeIndex);
         edgeData.t1r = dialog.getT1R();
         edgeData.t1f = dialog.getT1F();
         edgeData.stbr = dialog.getSTBR();
         edgeData.waveId = dialog.getWaveId();
+        m_model->setEdgeData(edgeIndex, edgeData);
 
-        // 更新显示
-        updateEdgeItemText(item, edgeData, waveOptions);
-
-        // 更新存储数据
-        item->setData(1, Qt::UserRole, edgeData.t1r);
-        item->setData(2, Qt::UserRole, edgeData.t1f);
-        item->setData(3, Qt::UserRole, edgeData.stbr);
-        item->setData(4, Qt::UserRole, edgeData.waveId);
-
-        // 保存到数据库
-        QList<TimeSetEdgeData> edges = getEdgeDataFromUI(parentItem, edgeData.timesetId);
-        m_dataAccess->saveTimeSetEdgesToDatabase(edgeData.timesetId, edges);
+        // 保存到数据库，失败时保留修改标记，确定时再次尝试
+        markDirty(edgeData.timesetId);
+        saveEdges(m_model->timeSetIndex(edgeIndex));
     }
 }
 
-void TimeSetEdgeManager::updateEdgeItemText(QTreeWidgetItem *edgeItem, const TimeSetEdgeData &edgeData, const QMap<int, QString> &waveOptions)
+bool TimeSetEdgeManager::saveEdges(const QModelIndex &timeSetIndex)
 {
-    if (!edgeItem)
-        return;
-
-    QString waveName = waveOptions.value(edgeData.waveId, "未知");
-
-    // 更新文本
-    edgeItem->setText(1, QString::number(edgeData.t1r));
-    edgeItem->setText(2, QString::number(edgeData.t1f));
-    edgeItem->setText(3, QString::number(edgeData.stbr));
-    edgeItem->setText(4, waveName);
+    if (!timeSetIndex.isValid())
+        return false;
 
-    // 设置对齐方式
-    for (int i = 1; i < 5; i++)
-    {
-        edgeItem->setTextAlignment(i, Qt::AlignCenter);
-    }
-}
+    int timeSetId = m_model->timeSetId(timeSetIndex);
 
-void TimeSetEdgeManager::updateAllEdgeItemsDisplay(const QMap<int, QString> &waveOptions)
-{
-    for (int i = 0; i < m_treeWidget->topLevelItemCount(); i++)
+    // 边沿从未加载过，数据库中已是最新
+    if (!m_model->edgesLoaded(timeSetIndex))
     {
-        QTreeWidgetItem *timeSetItem = m_treeWidget->topLevelItem(i);
-
-        for (int j = 0; j < timeSetItem->childCount(); j++)
-        {
-            QTreeWidgetItem *edgeItem = timeSetItem->child(j);
-
-            TimeSetEdgeData edgeData;
-            edgeData.timesetId = timeSetItem->data(0, Qt::UserRole).toInt();
-            edgeData.pinId = edgeItem->data(0, Qt::UserRole).toInt();
-            edgeData.t1r = edgeItem->data(1, Qt::UserRole).toDouble();
-            edgeData.t1f = edgeItem->data(2, Qt::UserRole).toDouble();
-            edgeData.stbr = edgeItem->data(3, Qt::UserRole).toDouble();
-            edgeData.waveId = edgeItem->data(4, Qt::UserRole).toInt();
-
-            updateEdgeItemText(edgeItem, edgeData, waveOptions);
-        }
+        m_dirtyTimeSets.remove(timeSetId);
+        return true;
     }
-}
-
-QList<TimeSetEdgeData> TimeSetEdgeManager::getEdgeDataFromUI(QTreeWidgetItem *timeSetItem, int timeSetId)
-{
-    QList<TimeSetEdgeData> edges;
 
-    if (!timeSetItem)
-        return edges;
-
-    for (int i = 0; i < timeSetItem->childCount(); i++)
+    QList<TimeSetEdgeData> edges = m_model->edges(timeSetIndex);
+    for (TimeSetEdgeData &edge : edges)
     {
-        QTreeWidgetItem *edgeItem = timeSetItem->child(i);
-
-        TimeSetEdgeData edge;
         edge.timesetId = timeSetId;
-        edge.pinId = edgeItem->data(0, Qt::UserRole).toInt();
-        edge.t1r = edgeItem->data(1, Qt::UserRole).toDouble();
-        edge.t1f = edgeItem->data(2, Qt::UserRole).toDouble();
-        edge.stbr = edgeItem->data(3, Qt::UserRole).toDouble();
-        edge.waveId = edgeItem->data(4, Qt::UserRole).toInt();
-
-        edges.append(edge);
     }
+    if (!m_dataAccess->saveTimeSetEdgesToDatabase(timeSetId, edges))
+        return false;
 
-    return edges;
+    m_dirtyTimeSets.remove(timeSetId);
+    return true;
 }
-
-void TimeSetEdgeManager::displayTimeSetEdges(QTreeWidgetItem *timeSetItem, const QList<TimeSetEdgeData> &edges,
-                                             const QMap<int, QString> &waveOptions, const QMap<int, QString> &pinList)
-{
-    if (!timeSetItem)
-        return;
-
-    // 清除现有子项
-    timeSetItem->takeChildren();
-
-    // 添加所有边沿项
-    for (const TimeSetEdgeData &edge : edges)
-    {
-        QTreeWidgetItem *edgeItem = new QTreeWidgetItem(timeSetItem);
-
-        // 设置管脚名称
-        QString pinName = pinList.value(edge.pinId, "未知管脚");
-        edgeItem->setText(0, pinName);
-
-        // 存储数据
-        edgeItem->setData(0, Qt::UserRole, edge.pinId);
-        edgeItem->setData(1, Qt::UserRole, edge.t1r);
-        edgeItem->setData(2, Qt::UserRole, edge.t1f);
-        edgeItem->setData(3, Qt::UserRole, edge.stbr);
-        edgeItem->setData(4, Qt::UserRole, edge.waveId);
-
-        // 更新显示文本
-        updateEdgeItemText(edgeItem, edge, waveOptions);
-
-        // 设置背景色
-        QBrush backgroundBrush(QColor(245, 245, 245));
-        for (int col = 0; col < 5; col++)
-        {
-            edgeItem->setBackground(col, backgroundBrush);
-        }
-
-        // 设置所有列都可编辑
-        for (int col = 0; col < 5; col++)
-        {
-            edgeItem->setFlags(edgeItem->flags() | Qt::ItemIsEditable);
-        }
-    }
-
-    // 展开项
-    timeSetItem->setExpanded(true);
-}
\ No newline at end of file
@@ -1,34 +1,34 @@
 #ifndef TIMESETEDGEMANAGER_H
 #define TIMESETEDGEMANAGER_H
 
-#include <QTreeWidget>
-#include <QTreeWidgetItem>
+#include <QModelIndex>
 #include <QMap>
-#include <QBrush>
+#include <QSet>
 #include "timesetdataaccess.h"
+#include "timesettreemodel.h"
 
 class TimeSetEdgeManager
 {
 public:
-    TimeSetEdgeManager(QTreeWidget *tree, TimeSetDataAccess *dataAccess);
+    TimeSetEdgeManager(TimeSetTreeModel *model, TimeSetDataAccess *dataAccess);
 
-    // 边缘操作方法
-    void addEdgeItem(QTreeWidgetItem *parentItem, const TimeSetEdgeData &edgeData);
-    bool removeEdgeItem(QTreeWidgetItem *item);
-    void editEdgeItem(QTreeWidgetItem *item, int column, const QMap<int, QString> &waveOptions);
-    void updateEdgeItemText(QTreeWidgetItem *edgeItem, const TimeSetEdgeData &edgeData, const QMap<int, QString> &waveOptions);
-    void updateAllEdgeItemsDisplay(const QMap<int, QString> &waveOptions);
+    // 边缘操作方法，索引来自TimeSetTreeModel
+    void addEdges(const QModelIndex &timeSetIndex, const QList<TimeSetEdgeData> &edges);
+    bool removeEdge(const QModelIndex &edgeIndex);
+    void editEdge(const QModelIndex &edgeIndex, const QMap<int, QString> &waveOptions);
 
-    // 从UI获取边缘数据
-    QList<TimeSetEdgeData> getEdgeDataFromUI(QTreeWidgetItem *timeSetItem, int timeSetId);
+    // 把模型中的边沿保存到数据库，成功后清除该TimeSet的修改标记
+    bool saveEdges(const QModelIndex &timeSetIndex);
 
-    // 显示现有边缘数据
-    void displayTimeSetEdges(QTreeWidgetItem *timeSetItem, const QList<TimeSetEdgeData> &edges,
-                             const QMap<int, QString> &waveOptions, const QMap<int, QString> &pinList);
+    // 修改跟踪：只有边沿被修改过的TimeSet需要在确定时保存
+    void markDirty(int timeSetId) { m_dirtyTimeSets.insert(timeSetId); }
+    bool isDirty(int timeSetId) const { return m_dirtyTimeSets.contains(timeSetId); }
+    void clearDirty() { m_dirtyTimeSets.clear(); }
 
 private:
-    QTreeWidget *m_treeWidget;
+    TimeSetTreeModel *m_model;
     TimeSetDataAccess *m_dataAccess;
+    QSet<int> m_dirtyTimeSets;
 };
 
-#endif // TIMESETEDGEMANAGER_H
\ No newline at end of file
+#endif // TIMESETEDGEMANAGER_H
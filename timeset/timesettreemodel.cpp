@@ -0,0 +1,556 @@
+#include "timesettreemodel.h"
+#include <QFont>
+#include <QBrush>
+#include <QColor>
+#include <QtAlgorithms>
+#include <QDebug>
+
+TimeSetTreeModel::TimeSetTreeModel(TimeSetDataAccess *dataAccess, QObject *parent)
+    : QAbstractItemModel(parent), m_dataAccess(dataAccess), m_timingChecker(nullptr)
+{
+}
+
+TimeSetTreeModel::~TimeSetTreeModel()
+{
+    qDeleteAll(m_timeSets);
+}
+
+void TimeSetTreeModel::setLookups(const QMap<int, QString> &pinList, const QMap<int, QString> &waveOptions)
+{
+    m_pinList = pinList;
+    m_waveOptions = waveOptions;
+}
+
+void TimeSetTreeModel::setTimeSets(const QList<TimeSetData> &timeSets)
+{
+    beginResetModel();
+    qDeleteAll(m_timeSets);
+    m_timeSets.clear();
+    for (const TimeSetData &timeSet : timeSets)
+    {
+        TimeSetNode *node = new TimeSetNode;
+        node->timeSetId = timeSet.dbId;
+        node->name = timeSet.name;
+        node->period = timeSet.period;
+        node->edgesLoaded = false;
+        m_timeSets.append(node);
+    }
+    endResetModel();
+}
+
+void TimeSetTreeModel::setUsage(const QMap<int, TimeSetUsage> &usage)
+{
+    m_usage = usage;
+    if (!m_timeSets.isEmpty())
+        emit dataChanged(index(0, NameColumn), index(m_timeSets.size() - 1, NameColumn));
+}
+
+void TimeSetTreeModel::setTimingChecker(const TimingRuleChecker *checker)
+{
+    m_timingChecker = checker;
+}
+
+void TimeSetTreeModel::setTimingViolations(const QVector<TimingViolation> &violations)
+{
+    m_storedViolationCounts.clear();
+    for (const TimingViolation &violation : violations)
+        m_storedViolationCounts[violation.timeSetId]++;
+    if (!m_timeSets.isEmpty())
+        emit dataChanged(index(0, NameColumn), index(m_timeSets.size() - 1, NameColumn));
+}
+
+int TimeSetTreeModel::timingViolationCount(const QModelIndex &timeSetIndex) const
+{
+    TimeSetNode *node = nodeForIndex(timeSetIndex);
+    return node ? violationCount(node) : 0;
+}
+
+int TimeSetTreeModel::totalTimingViolationCount() const
+{
+    int total = 0;
+    for (const TimeSetNode *node : m_timeSets)
+        total += violationCount(node);
+    return total;
+}
+
+int TimeSetTreeModel::violationCount(const TimeSetNode *node) const
+{
+    if (!m_timingChecker)
+        return 0;
+    if (!(node->period > 0.0))
+        return 1;
+    if (!node->edgesLoaded)
+        return m_storedViolationCounts.value(node->timeSetId);
+
+    int count = 0;
+    for (const TimeSetEdgeData &edge : node->edges)
+    {
+        // 每个标志对应一条问题描述
+        count += qPopulationCount(m_timingChecker->checkEdge(node->period, edge));
+    }
+    return count;
+}
+
+void TimeSetTreeModel::refreshTimingMarks(const QModelIndex &timeSetIndex)
+{
+    QModelIndex top = this->timeSetIndex(timeSetIndex);
+    TimeSetNode *node = nodeForIndex(top);
+    if (!node)
+        return;
+
+    emit dataChanged(top, top);
+    if (!node->edges.isEmpty())
+        emit dataChanged(index(0, NameColumn, top), index(node->edges.size() - 1, WaveColumn, top));
+}
+
+QModelIndex TimeSetTreeModel::addTimeSet(int timeSetId, const QString &name, double period)
+{
+    int row = m_timeSets.size();
+    beginInsertRows(QModelIndex(), row, row);
+    TimeSetNode *node = new TimeSetNode;
+    node->timeSetId = timeSetId;
+    node->name = name;
+    node->period = period;
+    node->edgesLoaded = true; // 新建的TimeSet没有边沿
+    m_timeSets.append(node);
+    endInsertRows();
+    return index(row, NameColumn);
+}
+
+void TimeSetTreeModel::removeTimeSet(const QModelIndex &timeSetIndex)
+{
+    QModelIndex top = this->timeSetIndex(timeSetIndex);
+    if (!top.isValid())
+        return;
+
+    int row = top.row();
+    beginRemoveRows(QModelIndex(), row, row);
+    delete m_timeSets.takeAt(row);
+    endRemoveRows();
+}
+
+void TimeSetTreeModel::updateTimeSet(const QModelIndex &timeSetIndex, const QString &name, double period)
+{
+    TimeSetNode *node = nodeForIndex(timeSetIndex);
+    if (!node)
+        return;
+
+    bool periodChanged = node->period != period;
+    node->name = name;
+    node->period = period;
+
+    // 周期变化后所有边沿都要按新周期重新检查
+    if (periodChanged && m_timingChecker)
+        ensureEdgesLoaded(timeSetIndex);
+    refreshTimingMarks(timeSetIndex);
+}
+
+QModelIndex TimeSetTreeModel::findTimeSet(int timeSetId) const
+{
+    for (int row = 0; row < m_timeSets.size(); ++row)
+    {
+        if (m_timeSets[row]->timeSetId == timeSetId)
+            return index(row, NameColumn);
+    }
+    return QModelIndex();
+}
+
+bool TimeSetTreeModel::isEdgeIndex(const QModelIndex &index) const
+{
+    return index.isValid() && index.internalPointer() != nullptr;
+}
+
+QModelIndex TimeSetTreeModel::timeSetIndex(const QModelIndex &index) const
+{
+    if (!index.isValid())
+        return QModelIndex();
+    if (isEdgeIndex(index))
+        return parent(index);
+    return index.sibling(index.row(), NameColumn);
+}
+
+int TimeSetTreeModel::timeSetId(const QModelIndex &index) const
+{
+    TimeSetNode *node = nodeForIndex(index);
+    return node ? node->timeSetId : -1;
+}
+
+bool TimeSetTreeModel::edgesLoaded(const QModelIndex &timeSetIndex) const
+{
+    TimeSetNode *node = nodeForIndex(timeSetIndex);
+    return node && node->edgesLoaded;
+}
+
+void TimeSetTreeModel::ensureEdgesLoaded(const QModelIndex &timeSetIndex)
+{
+    QModelIndex top = this->timeSetIndex(timeSetIndex);
+    if (canFetchMore(top))
+        fetchMore(top);
+}
+
+QList<TimeSetEdgeData> TimeSetTreeModel::edges(const QModelIndex &timeSetIndex)
+{
+    ensureEdgesLoaded(timeSetIndex);
+    TimeSetNode *node = nodeForIndex(timeSetIndex);
+    return node ? node->edges : QList<TimeSetEdgeData>();
+}
+
+TimeSetEdgeData TimeSetTreeModel::edgeData(const QModelIndex &edgeIndex) const
+{
+    TimeSetNode *node = nodeForIndex(edgeIndex);
+    if (!isEdgeIndex(edgeIndex) || !node || edgeIndex.row() >= node->edges.size())
+        return TimeSetEdgeData();
+    return node->edges[edgeIndex.row()];
+}
+
+void TimeSetTreeModel::setEdgeData(const QModelIndex &edgeIndex, const TimeSetEdgeData &edge)
+{
+    TimeSetNode *node = nodeForIndex(edgeIndex);
+    if (!isEdgeIndex(edgeIndex) || !node || edgeIndex.row() >= node->edges.size())
+        return;
+
+    node->edges[edgeIndex.row()] = edge;
+    emit dataChanged(index(edgeIndex.row(), NameColumn, edgeIndex.parent()),
+                     index(edgeIndex.row(), WaveColumn, edgeIndex.parent()));
+    emit dataChanged(edgeIndex.parent(), edgeIndex.parent());
+}
+
+void TimeSetTreeModel::addEdges(const QModelIndex &timeSetIndex, const QList<TimeSetEdgeData> &newEdges)
+{
+    QModelIndex top = this->timeSetIndex(timeSetIndex);
+    TimeSetNode *node = nodeForIndex(top);
+    if (!node || newEdges.isEmpty())
+        return;
+
+    ensureEdgesLoaded(top);
+    int first = node->edges.size();
+    beginInsertRows(top, first, first + newEdges.size() - 1);
+    node->edges.append(newEdges);
+    endInsertRows();
+    emit dataChanged(top, top);
+}
+
+void TimeSetTreeModel::removeEdge(const QModelIndex &edgeIndex)
+{
+    TimeSetNode *node = nodeForIndex(edgeIndex);
+    if (!isEdgeIndex(edgeIndex) || !node || edgeIndex.row() >= node->edges.size())
+        return;
+
+    int row = edgeIndex.row();
+    QModelIndex top = edgeIndex.parent();
+    beginRemoveRows(top, row, row);
+    node->edges.removeAt(row);
+    endRemoveRows();
+    emit dataChanged(top, top);
+}
+
+QModelIndex TimeSetTreeModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (row < 0 || column < 0 || column >= ColumnCount)
+        return QModelIndex();
+
+    if (!parent.isValid())
+    {
+        if (row >= m_timeSets.size())
+            return QModelIndex();
+        return createIndex(row, column);
+    }
+
+    // 只有两层：TimeSet和边沿
+    if (isEdgeIndex(parent) || parent.row() >= m_timeSets.size())
+        return QModelIndex();
+
+    TimeSetNode *node = m_timeSets[parent.row()];
+    if (row >= node->edges.size())
+        return QModelIndex();
+    return createIndex(row, column, node);
+}
+
+QModelIndex TimeSetTreeModel::parent(const QModelIndex &child) const
+{
+    if (!isEdgeIndex(child))
+        return QModelIndex();
+
+    TimeSetNode *node = static_cast<TimeSetNode *>(child.internalPointer());
+    int row = m_timeSets.indexOf(node);
+    return row >= 0 ? createIndex(row, NameColumn) : QModelIndex();
+}
+
+int TimeSetTreeModel::rowCount(const QModelIndex &parent) const
+{
+    if (!parent.isValid())
+        return m_timeSets.size();
+    if (isEdgeIndex(parent) || parent.column() != NameColumn)
+        return 0;
+
+    TimeSetNode *node = nodeForIndex(parent);
+    return node ? node->edges.size() : 0;
+}
+
+int TimeSetTreeModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return ColumnCount;
+}
+
+bool TimeSetTreeModel::hasChildren(const QModelIndex &parent) const
+{
+    if (!parent.isValid())
+        return !m_timeSets.isEmpty();
+    if (isEdgeIndex(parent) || parent.column() != NameColumn)
+        return false;
+
+    // 未加载时显示展开标记，展开后再确定是否真的有边沿
+    TimeSetNode *node = nodeForIndex(parent);
+    return node && (!node->edgesLoaded || !node->edges.isEmpty());
+}
+
+bool TimeSetTreeModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (!parent.isValid() || isEdgeIndex(parent))
+        return false;
+
+    TimeSetNode *node = nodeForIndex(parent);
+    return node && !node->edgesLoaded;
+}
+
+void TimeSetTreeModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent))
+        return;
+
+    TimeSetNode *node = nodeForIndex(parent);
+    QList<TimeSetEdgeData> loaded = m_dataAccess->loadTimeSetEdges(node->timeSetId);
+    node->edgesLoaded = true;
+
+    QModelIndex top = timeSetIndex(parent);
+    if (loaded.isEmpty())
+    {
+        // 没有边沿，刷新展开标记
+        emit dataChanged(top, top);
+        return;
+    }
+
+    beginInsertRows(top, 0, loaded.size() - 1);
+    node->edges = loaded;
+    endInsertRows();
+    qDebug() << "TimeSetTreeModel::fetchMore - 加载TimeSet" << node->timeSetId << "的" << loaded.size() << "个边沿";
+}
+
+QVariant TimeSetTreeModel::data(const QModelIndex &index, int role) const
+{
+    TimeSetNode *node = nodeForIndex(index);
+    if (!node)
+        return QVariant();
+
+    if (!isEdgeIndex(index))
+        return timeSetData(node, index.column(), role);
+
+    if (index.row() >= node->edges.size())
+        return QVariant();
+    return edgeDisplayData(node->edges[index.row()], node->period, index.column(), role);
+}
+
+QVariant TimeSetTreeModel::timeSetData(const TimeSetNode *node, int column, int role) const
+{
+    switch (role)
+    {
+    case Qt::DisplayRole:
+        if (column == NameColumn)
+        {
+            double freq = node->period > 0 ? 1000.0 / node->period : 0.0;
+            QString text = node->name + "/" + QString::number(node->period) + "ns=" + QString::number(freq, 'f', 3) + "MHz";
+            int rowCount = m_usage.value(node->timeSetId, TimeSetUsage{0, 0}).rowCount;
+            return text + (rowCount > 0 ? QString("  [%1行]").arg(rowCount) : QString("  [未使用]"));
+        }
+        return QVariant();
+    case Qt::ToolTipRole:
+        if (column == NameColumn)
+        {
+            TimeSetUsage usage = m_usage.value(node->timeSetId, TimeSetUsage{0, 0});
+            QString tip = usage.rowCount == 0 ? QString("未被向量表使用，可以删除")
+                                              : QString("被%1个向量表的%2行使用").arg(usage.tableCount).arg(usage.rowCount);
+            int violations = violationCount(node);
+            if (violations > 0)
+                tip += QString("\n时序问题: %1处%2").arg(violations).arg(node->edgesLoaded ? "" : "，展开查看");
+            return tip;
+        }
+        return QVariant();
+    case Qt::UserRole:
+        return column == NameColumn ? QVariant(node->timeSetId) : QVariant();
+    case Qt::FontRole:
+        if (column == NameColumn)
+        {
+            QFont boldFont;
+            boldFont.setBold(true);
+            boldFont.setPointSize(boldFont.pointSize() + 1);
+            return boldFont;
+        }
+        return QVariant();
+    case Qt::BackgroundRole:
+        return violationCount(node) > 0 ? QBrush(QColor(255, 225, 225)) : QBrush(QColor(230, 240, 250));
+    default:
+        return QVariant();
+    }
+}
+
+QVariant TimeSetTreeModel::edgeDisplayData(const TimeSetEdgeData &edge, double period, int column, int role) const
+{
+    quint8 timingFlags = m_timingChecker ? m_timingChecker->checkEdge(period, edge) : 0;
+
+    switch (role)
+    {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+        switch (column)
+        {
+        case NameColumn:
+            return m_pinList.value(edge.pinId, "未知管脚");
+        case T1RColumn:
+            return role == Qt::EditRole ? QVariant(edge.t1r) : QVariant(QString::number(edge.t1r));
+        case T1FColumn:
+            return role == Qt::EditRole ? QVariant(edge.t1f) : QVariant(QString::number(edge.t1f));
+        case STBRColumn:
+            return role == Qt::EditRole ? QVariant(edge.stbr) : QVariant(QString::number(edge.stbr));
+        case WaveColumn:
+            return m_waveOptions.value(edge.waveId, "未知");
+        }
+        return QVariant();
+    case Qt::UserRole:
+        switch (column)
+        {
+        case NameColumn:
+            return edge.pinId;
+        case T1RColumn:
+            return edge.t1r;
+        case T1FColumn:
+            return edge.t1f;
+        case STBRColumn:
+            return edge.stbr;
+        case WaveColumn:
+            return edge.waveId;
+        }
+        return QVariant();
+    case Qt::TextAlignmentRole:
+        return column == NameColumn ? QVariant() : QVariant(int(Qt::AlignCenter));
+    case Qt::ToolTipRole:
+        if (timingFlags != 0)
+            return m_timingChecker->describe(timingFlags, period, edge).join("\n");
+        return QVariant();
+    case Qt::BackgroundRole:
+    {
+        // 标出违反规则的参数
+        quint8 columnFlags = 0;
+        switch (column)
+        {
+        case NameColumn:
+            columnFlags = timingFlags;
+            break;
+        case T1RColumn:
+            columnFlags = timingFlags & TimingRuleChecker::T1ROutOfPeriod;
+            break;
+        case T1FColumn:
+            columnFlags = timingFlags & (TimingRuleChecker::T1FOutOfPeriod | TimingRuleChecker::FallBeforeRise);
+            break;
+        case STBRColumn:
+            columnFlags = timingFlags & TimingRuleChecker::STBROutOfPeriod;
+            break;
+        case WaveColumn:
+            columnFlags = timingFlags & TimingRuleChecker::UnknownWave;
+            break;
+        }
+        return columnFlags != 0 ? QBrush(QColor(255, 200, 200)) : QBrush(QColor(245, 245, 245));
+    }
+    default:
+        return QVariant();
+    }
+}
+
+bool TimeSetTreeModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    TimeSetNode *node = nodeForIndex(index);
+    if (role != Qt::EditRole || !isEdgeIndex(index) || !node || index.row() >= node->edges.size())
+        return false;
+
+    TimeSetEdgeData edge = node->edges[index.row()];
+    bool ok = true;
+    switch (index.column())
+    {
+    case T1RColumn:
+        edge.t1r = value.toDouble(&ok);
+        break;
+    case T1FColumn:
+        edge.t1f = value.toDouble(&ok);
+        break;
+    case STBRColumn:
+        edge.stbr = value.toDouble(&ok);
+        break;
+    case WaveColumn:
+    {
+        // 波形下拉框提交的是波形名
+        int waveId = m_waveOptions.key(value.toString(), -1);
+        ok = waveId >= 0;
+        edge.waveId = waveId;
+        break;
+    }
+    default:
+        return false;
+    }
+    if (!ok)
+        return false;
+
+    node->edges[index.row()] = edge;
+    // 一个参数变化可能影响同一行其他参数的检查结果
+    emit dataChanged(index.sibling(index.row(), NameColumn), index.sibling(index.row(), WaveColumn));
+    emit dataChanged(index.parent(), index.parent());
+    emit edgeEdited(node->timeSetId);
+    return true;
+}
+
+QVariant TimeSetTreeModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal)
+        return QVariant();
+
+    if (role == Qt::DisplayRole)
+    {
+        switch (section)
+        {
+        case NameColumn:
+            return "名称/周期(单位)";
+        case T1RColumn:
+            return "T1R";
+        case T1FColumn:
+            return "T1F";
+        case STBRColumn:
+            return "STBR";
+        case WaveColumn:
+            return "WAVE";
+        }
+    }
+    else if (role == Qt::TextAlignmentRole && section != NameColumn)
+    {
+        return int(Qt::AlignCenter);
+    }
+    return QVariant();
+}
+
+Qt::ItemFlags TimeSetTreeModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid())
+        return Qt::NoItemFlags;
+
+    Qt::ItemFlags itemFlags = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+    if (isEdgeIndex(index) && index.column() != NameColumn)
+        itemFlags |= Qt::ItemIsEditable;
+    return itemFlags;
+}
+
+TimeSetTreeModel::TimeSetNode *TimeSetTreeModel::nodeForIndex(const QModelIndex &index) const
+{
+    if (!index.isValid())
+        return nullptr;
+    if (isEdgeIndex(index))
+        return static_cast<TimeSetNode *>(index.internalPointer());
+    return index.row() < m_timeSets.size() ? m_timeSets[index.row()] : nullptr;
+}
@@ -0,0 +1,109 @@
+#ifndef TIMESETTREEMODEL_H
+#define TIMESETTREEMODEL_H
+
+#include <QAbstractItemModel>
+#include <QMap>
+#include <QList>
+#include "timesetdataaccess.h"
+#include "timingrulechecker.h"
+
+// TimeSet树模型：顶层为TimeSet，子项为各管脚的边沿参数
+// 边沿参数在TimeSet第一次展开(或被访问)时才从数据库加载，显示文本在data()中按需生成
+class TimeSetTreeModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    enum Column
+    {
+        NameColumn = 0,
+        T1RColumn,
+        T1FColumn,
+        STBRColumn,
+        WaveColumn,
+        ColumnCount
+    };
+
+    TimeSetTreeModel(TimeSetDataAccess *dataAccess, QObject *parent = nullptr);
+    ~TimeSetTreeModel();
+
+    // 管脚名和波形名，用于生成显示文本
+    void setLookups(const QMap<int, QString> &pinList, const QMap<int, QString> &waveOptions);
+
+    // 重置TimeSet列表，边沿参数全部标记为未加载
+    void setTimeSets(const QList<TimeSetData> &timeSets);
+
+    // 各TimeSet被向量表引用的行数，显示在TimeSet名称后
+    void setUsage(const QMap<int, TimeSetUsage> &usage);
+
+    // 时序规则检查：已加载边沿的TimeSet按内存中的边沿实时检查，未加载的使用批量检查的结果
+    void setTimingChecker(const TimingRuleChecker *checker);
+    void setTimingViolations(const QVector<TimingViolation> &violations);
+    int timingViolationCount(const QModelIndex &timeSetIndex) const;
+    int totalTimingViolationCount() const;
+
+    // TimeSet操作，返回/接受的都是顶层索引
+    QModelIndex addTimeSet(int timeSetId, const QString &name, double period);
+    void removeTimeSet(const QModelIndex &timeSetIndex);
+    void updateTimeSet(const QModelIndex &timeSetIndex, const QString &name, double period);
+    QModelIndex findTimeSet(int timeSetId) const;
+
+    // 索引查询，边沿索引返回所属TimeSet
+    bool isEdgeIndex(const QModelIndex &index) const;
+    QModelIndex timeSetIndex(const QModelIndex &index) const;
+    int timeSetId(const QModelIndex &index) const;
+
+    // 边沿操作，访问边沿前会先加载该TimeSet的边沿
+    bool edgesLoaded(const QModelIndex &timeSetIndex) const;
+    void ensureEdgesLoaded(const QModelIndex &timeSetIndex);
+    QList<TimeSetEdgeData> edges(const QModelIndex &timeSetIndex);
+    TimeSetEdgeData edgeData(const QModelIndex &edgeIndex) const;
+    void setEdgeData(const QModelIndex &edgeIndex, const TimeSetEdgeData &edge);
+    void addEdges(const QModelIndex &timeSetIndex, const QList<TimeSetEdgeData> &newEdges);
+    void removeEdge(const QModelIndex &edgeIndex);
+
+    // QAbstractItemModel
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+signals:
+    // 在表格中直接修改了边沿参数
+    void edgeEdited(int timeSetId);
+
+private:
+    struct TimeSetNode
+    {
+        int timeSetId;
+        QString name;
+        double period;
+        bool edgesLoaded;
+        QList<TimeSetEdgeData> edges;
+    };
+
+    // 边沿索引的internalPointer指向所属的TimeSetNode，顶层索引为nullptr
+    TimeSetNode *nodeForIndex(const QModelIndex &index) const;
+    QVariant timeSetData(const TimeSetNode *node, int column, int role) const;
+    QVariant edgeDisplayData(const TimeSetEdgeData &edge, double period, int column, int role) const;
+    int violationCount(const TimeSetNode *node) const;
+    // 边沿或周期变化后刷新TimeSet行及其边沿行的标记
+    void refreshTimingMarks(const QModelIndex &timeSetIndex);
+
+    TimeSetDataAccess *m_dataAccess;
+    QList<TimeSetNode *> m_timeSets;
+    QMap<int, QString> m_pinList;
+    QMap<int, QString> m_waveOptions;
+    QMap<int, TimeSetUsage> m_usage;
+    const TimingRuleChecker *m_timingChecker;
+    QMap<int, int> m_storedViolationCounts; // 批量检查得到的每个TimeSet的问题数
+};
+
+#endif // TIMESETTREEMODEL_H
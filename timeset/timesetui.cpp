@@ -21,7 +21,7 @@ void TimeSetUIManager::setupMainLayout()
     leftLayout->setContentsMargins(0, 0, 0, 0);
 
     // TimeSet树
-    timeSetTree = new QTreeWidget(leftWidget);
+    timeSetTree = new QTreeView(leftWidget);
     leftLayout->addWidget(timeSetTree);
 
     // TimeSet操作按钮
@@ -77,49 +77,42 @@ void TimeSetUIManager::setupMainLayout()
 
 void TimeSetUIManager::setupTreeWidget()
 {
-    timeSetTree->setHeaderLabels(QStringList() << "名称/周期(单位)"
-                                               << "T1R"
-                                               << "T1F"
-                                               << "STBR"
-                                               << "WAVE");
-    timeSetTree->setColumnCount(5);
     timeSetTree->setAlternatingRowColors(true);
     timeSetTree->setSelectionMode(QAbstractItemView::SingleSelection);
 
-    // 设置列宽更合理
-    timeSetTree->header()->setSectionResizeMode(0, QHeaderView::Interactive); // 改为Interactive模式允许用户调整大小
-    for (int i = 1; i < 5; i++)
-    {
-        timeSetTree->header()->setSectionResizeMode(i, QHeaderView::ResizeToContents);
-        // 设置最小列宽，保证数据显示完整
-        timeSetTree->setColumnWidth(i, 80);
-    }
-
-    // 设置第一列的最小宽度，确保能显示完整的timeSet名称和周期信息
-    timeSetTree->setColumnWidth(0, 280);
+    // 所有行同高，大量TimeSet时滚动不需要逐行计算高度
+    timeSetTree->setUniformRowHeights(true);
 
     // 设置更大的行高
-    timeSetTree->setStyleSheet("QTreeWidget::item { height: 25px; }");
+    timeSetTree->setStyleSheet("QTreeView::item { height: 25px; }");
 
     // 设置表头样式
     QFont headerFont = timeSetTree->header()->font();
     headerFont.setBold(true);
     timeSetTree->header()->setFont(headerFont);
 
-    // 设置表头对齐方式
-    timeSetTree->headerItem()->setTextAlignment(1, Qt::AlignCenter);
-    timeSetTree->headerItem()->setTextAlignment(2, Qt::AlignCenter);
-    timeSetTree->headerItem()->setTextAlignment(3, Qt::AlignCenter);
-    timeSetTree->headerItem()->setTextAlignment(4, Qt::AlignCenter);
-
-    // 启用编辑功能
-    timeSetTree->setEditTriggers(QAbstractItemView::DoubleClicked |
+    // 双击打开编辑对话框，F2或单击已选中的单元格直接编辑边沿参数
+    timeSetTree->setEditTriggers(QAbstractItemView::SelectedClicked |
                                  QAbstractItemView::EditKeyPressed);
 
-    // 设置所有列可编辑
     timeSetTree->setItemsExpandable(true);
 }
 
+void TimeSetUIManager::setTimeSetModel(QAbstractItemModel *model)
+{
+    timeSetTree->setModel(model);
+
+    // 固定列宽，不按内容计算，打开时不需要遍历所有行
+    timeSetTree->header()->setSectionResizeMode(QHeaderView::Interactive);
+    for (int i = 1; i < 5; i++)
+    {
+        timeSetTree->setColumnWidth(i, 80);
+    }
+
+    // 设置第一列的最小宽度，确保能显示完整的timeSet名称和周期信息
+    timeSetTree->setColumnWidth(0, 280);
+}
+
 void TimeSetUIManager::setupPinSelection()
 {
     // 不需要任何操作，因为我们已经在setupMainLayout中创建了可用管脚列表
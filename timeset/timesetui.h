@@ -2,7 +2,8 @@
 #define TIMESETUI_H
 
 #include <QDialog>
-#include <QTreeWidget>
+#include <QTreeView>
+#include <QAbstractItemModel>
 #include <QPushButton>
 #include <QDialogButtonBox>
 #include <QListWidget>
@@ -24,8 +25,11 @@ public:
     void setupPinSelection();
     void setupButtonBox();
 
+    // 设置TimeSet树的模型并应用列宽
+    void setTimeSetModel(QAbstractItemModel *model);
+
     // 获取UI组件
-    QTreeWidget *getTimeSetTree() const { return timeSetTree; }
+    QTreeView *getTimeSetTree() const { return timeSetTree; }
     QListWidget *getPinListWidget() const { return availablePinsList; }
     QPushButton *getAddTimeSetButton() const { return addTimeSetButton; }
     QPushButton *getRemoveTimeSetButton() const { return removeTimeSetButton; }
@@ -40,7 +44,7 @@ private:
 
     // UI组件
     QSplitter *mainSplitter;
-    QTreeWidget *timeSetTree;
+    QTreeView *timeSetTree;
     QListWidget *availablePinsList;
     QPushButton *addTimeSetButton;
     QPushButton *removeTimeSetButton;
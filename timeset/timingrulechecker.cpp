@@ -0,0 +1,287 @@
+#include "timingrulechecker.h"
+
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QTextStream>
+#include <QFileInfo>
+#include <QDebug>
+
+void TimingEdgeColumns::reserve(int count)
+{
+    timeSetIds.reserve(count);
+    pinIds.reserve(count);
+    periods.reserve(count);
+    t1r.reserve(count);
+    t1f.reserve(count);
+    stbr.reserve(count);
+    waveIds.reserve(count);
+}
+
+void TimingEdgeColumns::append(int timeSetId, double period, const TimeSetEdgeData &edge)
+{
+    timeSetIds.append(timeSetId);
+    pinIds.append(edge.pinId);
+    periods.append(period);
+    t1r.append(edge.t1r);
+    t1f.append(edge.t1f);
+    stbr.append(edge.stbr);
+    waveIds.append(edge.waveId);
+}
+
+TimingRuleChecker::TimingRuleChecker()
+{
+}
+
+bool TimingRuleChecker::loadRules(QSqlDatabase &db, QString &errorMessage)
+{
+    m_waveUsesFall.clear();
+    m_waveNames.clear();
+
+    QSqlQuery query(db);
+    if (!query.exec("SELECT id, wave_type FROM wave_options"))
+    {
+        errorMessage = QString("读取波形类型失败: %1").arg(query.lastError().text());
+        return false;
+    }
+
+    while (query.next())
+    {
+        int id = query.value(0).toInt();
+        QString name = query.value(1).toString().trimmed().toUpper();
+        if (id < 0)
+            continue;
+        if (id >= m_waveUsesFall.size())
+            m_waveUsesFall.resize(id + 1);
+        m_waveNames.insert(id, name);
+
+        // RZ回零、RO回一、SBC在窗口外取反，都在T1F处返回；NRZ只使用T1R
+        m_waveUsesFall[id] = (name == "RZ" || name == "RO" || name == "SBC") ? 1 : 0;
+    }
+
+    // 数组中没有对应波形的位置按未知波形处理
+    for (int id = 0; id < m_waveUsesFall.size(); ++id)
+    {
+        if (!m_waveNames.contains(id))
+            m_waveUsesFall[id] = -1;
+    }
+    return true;
+}
+
+QVector<quint8> TimingRuleChecker::checkColumns(const TimingEdgeColumns &columns) const
+{
+    const int count = columns.size();
+    QVector<quint8> flags(count, 0);
+
+    const double *periods = columns.periods.constData();
+    const double *t1r = columns.t1r.constData();
+    const double *t1f = columns.t1f.constData();
+    const double *stbr = columns.stbr.constData();
+    const int *waveIds = columns.waveIds.constData();
+    const qint8 *waveUsesFall = m_waveUsesFall.constData();
+    const int waveCount = m_waveUsesFall.size();
+    quint8 *out = flags.data();
+
+    // 范围检查没有分支，编译器可以按列展开
+    for (int i = 0; i < count; ++i)
+    {
+        const double period = periods[i];
+        out[i] = (t1r[i] < 0.0 || t1r[i] > period ? T1ROutOfPeriod : 0) |
+                 (t1f[i] < 0.0 || t1f[i] > period ? T1FOutOfPeriod : 0) |
+                 (stbr[i] < 0.0 || stbr[i] > period ? STBROutOfPeriod : 0);
+    }
+
+    // 波形相关的规则
+    for (int i = 0; i < count; ++i)
+    {
+        const int waveId = waveIds[i];
+        const qint8 usesFall = (waveId >= 0 && waveId < waveCount) ? waveUsesFall[waveId] : qint8(-1);
+        if (usesFall < 0)
+        {
+            out[i] |= UnknownWave;
+        }
+        else if (usesFall == 0)
+        {
+            // NRZ不使用T1F，T1F超出周期也不影响波形
+            out[i] &= ~quint8(T1FOutOfPeriod);
+        }
+        else if (t1f[i] <= t1r[i])
+        {
+            out[i] |= FallBeforeRise;
+        }
+    }
+
+    // 周期本身无效时，边沿范围的判断没有意义
+    for (int i = 0; i < count; ++i)
+    {
+        if (!(periods[i] > 0.0))
+            out[i] = InvalidPeriod;
+    }
+
+    return flags;
+}
+
+quint8 TimingRuleChecker::checkEdge(double period, const TimeSetEdgeData &edge) const
+{
+    // 规则与checkColumns相同，直接检查一条边沿，不构造列数组
+    if (!(period > 0.0))
+        return InvalidPeriod;
+
+    quint8 flags = (edge.t1r < 0.0 || edge.t1r > period ? T1ROutOfPeriod : 0) |
+                   (edge.t1f < 0.0 || edge.t1f > period ? T1FOutOfPeriod : 0) |
+                   (edge.stbr < 0.0 || edge.stbr > period ? STBROutOfPeriod : 0);
+
+    const qint8 usesFall = (edge.waveId >= 0 && edge.waveId < m_waveUsesFall.size()) ? m_waveUsesFall[edge.waveId] : qint8(-1);
+    if (usesFall < 0)
+        flags |= UnknownWave;
+    else if (usesFall == 0)
+        flags &= ~quint8(T1FOutOfPeriod);
+    else if (edge.t1f <= edge.t1r)
+        flags |= FallBeforeRise;
+
+    return flags;
+}
+
+QStringList TimingRuleChecker::describe(quint8 flags, double period, const TimeSetEdgeData &edge) const
+{
+    QStringList messages;
+    if (flags & InvalidPeriod)
+        messages << QString("周期 %1ns 无效，必须大于0").arg(period);
+    if (flags & T1ROutOfPeriod)
+        messages << QString("T1R %1ns 超出周期 0~%2ns").arg(edge.t1r).arg(period);
+    if (flags & T1FOutOfPeriod)
+        messages << QString("T1F %1ns 超出周期 0~%2ns").arg(edge.t1f).arg(period);
+    if (flags & STBROutOfPeriod)
+        messages << QString("STBR %1ns 超出周期 0~%2ns").arg(edge.stbr).arg(period);
+    if (flags & FallBeforeRise)
+        messages << QString("%1波形的T1F(%2ns)必须晚于T1R(%3ns)")
+                        .arg(m_waveNames.value(edge.waveId))
+                        .arg(edge.t1f)
+                        .arg(edge.t1r);
+    if (flags & UnknownWave)
+        messages << QString("未知的波形类型(ID: %1)").arg(edge.waveId);
+    return messages;
+}
+
+bool TimingRuleChecker::checkDatabase(QSqlDatabase &db, QVector<TimingViolation> &violations, QString &errorMessage) const
+{
+    violations.clear();
+
+    // 一条查询读出所有TimeSet和边沿，没有边沿的TimeSet也返回一行用于检查周期
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT tl.id, tl.timeset_name, tl.period, ts.id, ts.pin_id, pl.pin_name, "
+                    "ts.T1R, ts.T1F, ts.STBR, ts.wave_id "
+                    "FROM timeset_list tl "
+                    "LEFT JOIN timeset_settings ts ON ts.timeset_id = tl.id "
+                    "LEFT JOIN pin_list pl ON pl.id = ts.pin_id "
+                    "ORDER BY tl.id, ts.pin_id"))
+    {
+        errorMessage = QString("读取TimeSet边沿失败: %1").arg(query.lastError().text());
+        return false;
+    }
+
+    TimingEdgeColumns columns;
+    QMap<int, QString> timeSetNames;
+    QMap<int, double> timeSetPeriods;
+    QMap<int, QString> pinNames;
+    while (query.next())
+    {
+        int timeSetId = query.value(0).toInt();
+        timeSetNames.insert(timeSetId, query.value(1).toString());
+        timeSetPeriods.insert(timeSetId, query.value(2).toDouble());
+        if (query.value(3).isNull())
+            continue;
+
+        TimeSetEdgeData edge;
+        edge.timesetId = timeSetId;
+        edge.pinId = query.value(4).toInt();
+        edge.t1r = query.value(6).toDouble();
+        edge.t1f = query.value(7).toDouble();
+        edge.stbr = query.value(8).toDouble();
+        edge.waveId = query.value(9).isNull() ? -1 : query.value(9).toInt();
+        pinNames.insert(edge.pinId, query.value(5).toString());
+        columns.append(timeSetId, query.value(2).toDouble(), edge);
+    }
+
+    // 周期无效的TimeSet只报告一次，不再逐条报告其边沿
+    for (auto it = timeSetPeriods.constBegin(); it != timeSetPeriods.constEnd(); ++it)
+    {
+        if (!(it.value() > 0.0))
+        {
+            violations.append(TimingViolation{it.key(), timeSetNames.value(it.key()), -1, QString(),
+                                              QString("周期 %1ns 无效，必须大于0").arg(it.value())});
+        }
+    }
+
+    const QVector<quint8> flags = checkColumns(columns);
+    for (int i = 0; i < flags.size(); ++i)
+    {
+        if (flags[i] == 0 || (flags[i] & InvalidPeriod))
+            continue;
+
+        TimeSetEdgeData edge;
+        edge.timesetId = columns.timeSetIds[i];
+        edge.pinId = columns.pinIds[i];
+        edge.t1r = columns.t1r[i];
+        edge.t1f = columns.t1f[i];
+        edge.stbr = columns.stbr[i];
+        edge.waveId = columns.waveIds[i];
+        for (const QString &message : describe(flags[i], columns.periods[i], edge))
+        {
+            violations.append(TimingViolation{edge.timesetId, timeSetNames.value(edge.timesetId),
+                                              edge.pinId, pinNames.value(edge.pinId), message});
+        }
+    }
+
+    qDebug() << "TimingRuleChecker::checkDatabase - 检查边沿数:" << columns.size() << "，问题数:" << violations.size();
+    return true;
+}
+
+int TimingRuleChecker::runCommandLine(const QString &dbFilePath)
+{
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    if (!QFileInfo::exists(dbFilePath))
+    {
+        err << "项目文件不存在: " << dbFilePath << Qt::endl;
+        return 2;
+    }
+
+    const QString connectionName = "timing_rule_check";
+    int result = 2;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        db.setDatabaseName(dbFilePath);
+        db.setConnectOptions("QSQLITE_OPEN_READONLY");
+        if (!db.open())
+        {
+            err << "无法打开项目文件: " << db.lastError().text() << Qt::endl;
+        }
+        else
+        {
+            TimingRuleChecker checker;
+            QVector<TimingViolation> violations;
+            QString errorMessage;
+            if (!checker.loadRules(db, errorMessage) || !checker.checkDatabase(db, violations, errorMessage))
+            {
+                err << errorMessage << Qt::endl;
+            }
+            else
+            {
+                for (const TimingViolation &violation : violations)
+                {
+                    out << "TimeSet " << violation.timeSetName;
+                    if (violation.pinId >= 0)
+                        out << " / " << (violation.pinName.isEmpty() ? QString::number(violation.pinId) : violation.pinName);
+                    out << ": " << violation.message << Qt::endl;
+                }
+                out << "时序检查完成，问题数: " << violations.size() << Qt::endl;
+                result = violations.isEmpty() ? 0 : 1;
+            }
+            db.close();
+        }
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+    return result;
+}
@@ -0,0 +1,79 @@
+#ifndef TIMINGRULECHECKER_H
+#define TIMINGRULECHECKER_H
+
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QMap>
+#include "timesetdataaccess.h"
+
+// 一条时序规则问题，pinId为-1表示TimeSet本身(周期)的问题
+struct TimingViolation
+{
+    int timeSetId;
+    QString timeSetName;
+    int pinId;
+    QString pinName;
+    QString message;
+};
+
+// 按列存放的边沿参数，所有TimeSet的所有边沿在同一组数组中一次检查完
+struct TimingEdgeColumns
+{
+    QVector<int> timeSetIds;
+    QVector<int> pinIds;
+    QVector<double> periods;
+    QVector<double> t1r;
+    QVector<double> t1f;
+    QVector<double> stbr;
+    QVector<int> waveIds;
+
+    int size() const { return timeSetIds.size(); }
+    void reserve(int count);
+    void append(int timeSetId, double period, const TimeSetEdgeData &edge);
+};
+
+// TimeSet时序规则检查：边沿必须落在周期内，RZ/RO/SBC的T1F必须在T1R之后
+// 规则按wave_options中的波形名称生成，TimeSet对话框和命令行共用
+class TimingRuleChecker
+{
+public:
+    // 每条边沿的检查结果，按位组合
+    enum ViolationFlag
+    {
+        InvalidPeriod = 0x01,
+        T1ROutOfPeriod = 0x02,
+        T1FOutOfPeriod = 0x04,
+        STBROutOfPeriod = 0x08,
+        FallBeforeRise = 0x10,
+        UnknownWave = 0x20
+    };
+
+    TimingRuleChecker();
+
+    // 从wave_options读取波形，按名称确定是否使用T1F
+    bool loadRules(QSqlDatabase &db, QString &errorMessage);
+    bool rulesLoaded() const { return !m_waveUsesFall.isEmpty(); }
+
+    // 一次遍历全部边沿，返回每条边沿的问题标志，0表示没有问题
+    QVector<quint8> checkColumns(const TimingEdgeColumns &columns) const;
+
+    // 检查单条边沿，规则与checkColumns相同；树模型绘制时逐条调用，不分配内存
+    quint8 checkEdge(double period, const TimeSetEdgeData &edge) const;
+    // 单条边沿的问题描述，对话框编辑时使用
+    QStringList describe(quint8 flags, double period, const TimeSetEdgeData &edge) const;
+
+    // 从数据库一次读出所有TimeSet的边沿并检查
+    bool checkDatabase(QSqlDatabase &db, QVector<TimingViolation> &violations, QString &errorMessage) const;
+
+    // 命令行入口：检查项目文件，输出问题列表；返回0表示没有问题，1表示有问题，2表示无法检查
+    static int runCommandLine(const QString &dbFilePath);
+
+private:
+    // 以wave_options.id为下标：-1未知波形，0不使用T1F(NRZ)，1使用T1F
+    QVector<qint8> m_waveUsesFall;
+    QMap<int, QString> m_waveNames;
+};
+
+#endif // TIMINGRULECHECKER_H
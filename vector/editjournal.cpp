@@ -0,0 +1,434 @@
+#include "editjournal.h"
+
+#include <QDataStream>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QtEndian>
+#include <QDebug>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const quint32 JOURNAL_MAGIC = 0x5645434A; // "VECJ"
+    const quint16 JOURNAL_VERSION = 1;
+    const qint64 HEADER_SIZE = 4 + 2 + 4 * 3;
+
+    inline quint64 cellKey(int row, int column)
+    {
+        return (quint64(quint32(row)) << 32) | quint32(column);
+    }
+
+    // 把已写入的数据落盘，保证异常退出后日志可用
+    void syncFile(QFile &file)
+    {
+#ifdef Q_OS_WIN
+        _commit(file.handle());
+#else
+        ::fsync(file.handle());
+#endif
+    }
+}
+
+EditJournal::EditJournal(QTableWidget *tableWidget, QObject *parent)
+    : QObject(parent), m_tableWidget(tableWidget), m_tableId(-1), m_recordCount(0), m_recoveryTableId(-1),
+      m_paused(false)
+{
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(FLUSH_INTERVAL_MS);
+    connect(&m_flushTimer, &QTimer::timeout, this, &EditJournal::flush);
+
+    QAbstractItemModel *model = m_tableWidget->model();
+    connect(model, &QAbstractItemModel::dataChanged, this, &EditJournal::onDataChanged);
+    connect(model, &QAbstractItemModel::rowsAboutToBeInserted, this, &EditJournal::onRowsAboutToChange);
+    connect(model, &QAbstractItemModel::rowsAboutToBeRemoved, this, &EditJournal::onRowsAboutToChange);
+    connect(model, &QAbstractItemModel::rowsInserted, this, &EditJournal::onRowsInserted);
+    connect(model, &QAbstractItemModel::rowsRemoved, this, &EditJournal::onRowsRemoved);
+}
+
+EditJournal::~EditJournal()
+{
+    close();
+}
+
+QString EditJournal::journalPath(const QString &dbPath)
+{
+    return dbPath + ".journal";
+}
+
+void EditJournal::open(const QString &dbPath)
+{
+    close();
+
+    QString path = journalPath(dbPath);
+    m_file.setFileName(path);
+    m_recoveryPath = path + ".recover";
+    m_recoveryTableId = -1;
+
+    // 上次的日志中有编辑记录，说明没有保存就退出了，改名保留以供恢复
+    QFileInfo journalInfo(path);
+    if (journalInfo.exists() && journalInfo.size() > HEADER_SIZE)
+    {
+        QFile::remove(m_recoveryPath);
+        if (!QFile::rename(path, m_recoveryPath))
+        {
+            qWarning() << "EditJournal::open - 无法保留上次的编辑日志:" << path;
+            return;
+        }
+    }
+
+    QFile recoveryFile(m_recoveryPath);
+    int rowCount = 0;
+    int columnCount = 0;
+    if (recoveryFile.open(QIODevice::ReadOnly) && recoveryFile.size() > HEADER_SIZE &&
+        readHeader(recoveryFile, m_recoveryTableId, rowCount, columnCount))
+    {
+        qDebug() << "EditJournal::open - 发现未保存的编辑，向量表ID:" << m_recoveryTableId
+                 << "日志大小:" << recoveryFile.size();
+    }
+    else
+    {
+        m_recoveryTableId = -1;
+    }
+}
+
+void EditJournal::close()
+{
+    stop();
+
+    if (!m_file.fileName().isEmpty() && m_recordCount == 0)
+    {
+        QFile::remove(m_file.fileName());
+    }
+    m_file.setFileName(QString());
+    m_recordCount = 0;
+    m_recoveryPath.clear();
+    m_recoveryTableId = -1;
+}
+
+void EditJournal::start(int tableId)
+{
+    stop();
+    if (m_file.fileName().isEmpty())
+        return;
+
+    m_tableId = tableId;
+    if (!writeHeader())
+    {
+        qWarning() << "EditJournal::start - 无法创建编辑日志:" << m_file.fileName() << m_file.errorString();
+        m_tableId = -1;
+    }
+}
+
+void EditJournal::stop()
+{
+    if (m_tableId >= 0)
+    {
+        flush();
+    }
+    m_flushTimer.stop();
+    m_dirtyCells.clear();
+    m_buffer.clear();
+    m_tableId = -1;
+
+    if (m_file.isOpen())
+    {
+        m_file.close();
+    }
+}
+
+void EditJournal::markSaved()
+{
+    if (m_tableId >= 0)
+    {
+        start(m_tableId);
+    }
+}
+
+bool EditJournal::writeHeader()
+{
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    QByteArray header;
+    QDataStream out(&header, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << JOURNAL_MAGIC << JOURNAL_VERSION << qint32(m_tableId)
+        << qint32(m_tableWidget->rowCount()) << qint32(m_tableWidget->columnCount());
+
+    m_recordCount = 0;
+    if (m_file.write(header) != header.size() || !m_file.flush())
+        return false;
+
+    syncFile(m_file);
+    return true;
+}
+
+bool EditJournal::readHeader(QFile &file, int &tableId, int &rowCount, int &columnCount)
+{
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    qint32 id = -1;
+    qint32 rows = 0;
+    qint32 columns = 0;
+    in >> magic >> version >> id >> rows >> columns;
+    if (in.status() != QDataStream::Ok || magic != JOURNAL_MAGIC || version != JOURNAL_VERSION)
+        return false;
+
+    tableId = id;
+    rowCount = rows;
+    columnCount = columns;
+    return true;
+}
+
+void EditJournal::onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    if (m_tableId < 0 || m_paused || !topLeft.isValid() || !bottomRight.isValid())
+        return;
+
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row)
+    {
+        for (int column = topLeft.column(); column <= bottomRight.column(); ++column)
+        {
+            m_dirtyCells.insert(cellKey(row, column));
+        }
+    }
+
+    if (m_dirtyCells.size() >= MAX_PENDING_CELLS)
+    {
+        flush();
+    }
+    else if (!m_flushTimer.isActive())
+    {
+        m_flushTimer.start();
+    }
+}
+
+void EditJournal::onRowsAboutToChange()
+{
+    // 行号即将变化，先按当前行号编码脏单元格
+    if (m_tableId >= 0)
+    {
+        serializeDirtyCells();
+    }
+}
+
+void EditJournal::onRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (m_tableId < 0 || parent.isValid())
+        return;
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << quint8(InsertRowsRecord) << qint32(first) << qint32(last - first + 1);
+    appendRecord(payload);
+}
+
+void EditJournal::onRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (m_tableId < 0 || parent.isValid())
+        return;
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << quint8(RemoveRowsRecord) << qint32(first) << qint32(last - first + 1);
+    appendRecord(payload);
+}
+
+void EditJournal::serializeDirtyCells()
+{
+    if (m_dirtyCells.isEmpty())
+        return;
+
+    int rowCount = m_tableWidget->rowCount();
+    int columnCount = m_tableWidget->columnCount();
+    const QSet<quint64> &dirtyCells = m_dirtyCells;
+    for (quint64 key : dirtyCells)
+    {
+        int row = int(key >> 32);
+        int column = int(key & 0xFFFFFFFFu);
+        if (row >= rowCount || column >= columnCount)
+            continue;
+
+        QTableWidgetItem *item = m_tableWidget->item(row, column);
+
+        QByteArray payload;
+        QDataStream out(&payload, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_5_0);
+        out << quint8(CellRecord) << qint32(row) << qint32(column) << (item ? item->text() : QString());
+        appendRecord(payload);
+    }
+    m_dirtyCells.clear();
+}
+
+void EditJournal::appendRecord(const QByteArray &payload)
+{
+    // 每条记录前写长度，回放时可以识别写了一半的最后一条记录
+    uchar length[4];
+    qToBigEndian(quint32(payload.size()), length);
+    m_buffer.append(reinterpret_cast<const char *>(length), 4);
+    m_buffer.append(payload);
+    ++m_recordCount;
+
+    if (!m_flushTimer.isActive())
+    {
+        m_flushTimer.start();
+    }
+}
+
+void EditJournal::flush()
+{
+    m_flushTimer.stop();
+    if (m_tableId < 0 || !m_file.isOpen())
+        return;
+
+    serializeDirtyCells();
+    if (m_buffer.isEmpty())
+        return;
+
+    if (m_file.write(m_buffer) != m_buffer.size() || !m_file.flush())
+    {
+        qWarning() << "EditJournal::flush - 写入编辑日志失败:" << m_file.errorString();
+        return;
+    }
+    syncFile(m_file);
+    m_buffer.clear();
+}
+
+int EditJournal::replayRecovery(QString &errorMessage)
+{
+    if (m_recoveryTableId < 0 || m_recoveryTableId != m_tableId)
+    {
+        errorMessage = "当前加载的向量表没有待恢复的编辑";
+        return -1;
+    }
+
+    QFile file(m_recoveryPath);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        errorMessage = "无法打开编辑日志: " + file.errorString();
+        return -1;
+    }
+
+    int tableId = -1;
+    int rowCount = 0;
+    int columnCount = 0;
+    if (!readHeader(file, tableId, rowCount, columnCount))
+    {
+        errorMessage = "编辑日志格式无效";
+        return -1;
+    }
+
+    // 日志从加载后的表格开始记录，表格结构不同说明数据库在此期间已被修改
+    if (rowCount != m_tableWidget->rowCount() || columnCount != m_tableWidget->columnCount())
+    {
+        errorMessage = QString("向量表的行数或列数已变化(日志: %1行%2列, 当前: %3行%4列)，无法恢复")
+                           .arg(rowCount)
+                           .arg(columnCount)
+                           .arg(m_tableWidget->rowCount())
+                           .arg(m_tableWidget->columnCount());
+        return -1;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_0);
+    QAbstractItemModel *model = m_tableWidget->model();
+    int applied = 0;
+    bool ok = true;
+
+    m_tableWidget->setUpdatesEnabled(false);
+    while (!in.atEnd())
+    {
+        quint32 length = 0;
+        in >> length;
+        if (in.status() != QDataStream::Ok || file.bytesAvailable() < qint64(length))
+        {
+            // 最后一条记录没有写完整，之前的记录都有效
+            qDebug() << "EditJournal::replayRecovery - 日志末尾的记录不完整，已忽略";
+            break;
+        }
+
+        QByteArray payload = file.read(length);
+        QDataStream record(payload);
+        record.setVersion(QDataStream::Qt_5_0);
+        quint8 type = 0;
+        qint32 a = 0;
+        qint32 b = 0;
+        record >> type >> a >> b;
+
+        if (type == CellRecord)
+        {
+            QString text;
+            record >> text;
+            if (a < 0 || a >= m_tableWidget->rowCount() || b < 0 || b >= m_tableWidget->columnCount())
+            {
+                ok = false;
+                break;
+            }
+
+            QTableWidgetItem *item = m_tableWidget->item(a, b);
+            if (item)
+                item->setText(text);
+            else if (!text.isEmpty())
+                m_tableWidget->setItem(a, b, new QTableWidgetItem(text));
+        }
+        else if (type == InsertRowsRecord)
+        {
+            if (a < 0 || a > m_tableWidget->rowCount() || b <= 0 || !model->insertRows(a, b))
+            {
+                ok = false;
+                break;
+            }
+        }
+        else if (type == RemoveRowsRecord)
+        {
+            if (a < 0 || b <= 0 || a + b > m_tableWidget->rowCount() || !model->removeRows(a, b))
+            {
+                ok = false;
+                break;
+            }
+        }
+        else
+        {
+            ok = false;
+            break;
+        }
+        ++applied;
+    }
+    m_tableWidget->setUpdatesEnabled(true);
+    file.close();
+
+    // 已回放的编辑都记入了新日志
+    flush();
+    discardRecovery();
+
+    qDebug() << "EditJournal::replayRecovery - 回放" << applied << "条记录，耗时" << timer.elapsed() << "毫秒";
+
+    if (!ok)
+    {
+        errorMessage = QString("编辑日志第%1条记录与表格不一致，只恢复了之前的记录").arg(applied + 1);
+        return -1;
+    }
+    return applied;
+}
+
+void EditJournal::discardRecovery()
+{
+    if (!m_recoveryPath.isEmpty())
+    {
+        QFile::remove(m_recoveryPath);
+    }
+    m_recoveryTableId = -1;
+}
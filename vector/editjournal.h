@@ -0,0 +1,104 @@
+#ifndef EDITJOURNAL_H
+#define EDITJOURNAL_H
+
+#include <QObject>
+#include <QTableWidget>
+#include <QFile>
+#include <QSet>
+#include <QString>
+#include <QByteArray>
+#include <QTimer>
+
+// 编辑日志：表格中未保存的编辑追加写入项目数据库旁边的<项目>.db.journal文件
+// 编辑的单元格先记为脏，定时批量写入并fsync，同一单元格多次修改只写最后的值
+// 行的插入和删除按顺序记录，回放时从文件头开始逐条应用即可还原表格
+// 保存向量表成功或重新从数据库加载后日志清空；程序异常退出后，下次打开项目时
+// 上一次的日志被改名为.recover，加载对应向量表时提示恢复
+class EditJournal : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 脏单元格的最长延迟写入时间(毫秒)
+    static const int FLUSH_INTERVAL_MS = 500;
+
+    // 脏单元格达到该数量时立即写入
+    static const int MAX_PENDING_CELLS = 65536;
+
+    EditJournal(QTableWidget *tableWidget, QObject *parent = nullptr);
+    ~EditJournal();
+
+    // 项目数据库对应的日志文件路径
+    static QString journalPath(const QString &dbPath);
+
+    // 打开项目后调用：保留上次未保存的日志以供恢复
+    void open(const QString &dbPath);
+
+    // 关闭项目时调用：写入剩余的编辑，没有编辑记录时删除日志文件
+    void close();
+
+    // 向量表从数据库加载完成后调用：清空日志并开始记录该表的编辑
+    void start(int tableId);
+
+    // 重新加载向量表前调用：写入剩余的编辑并停止记录
+    void stop();
+
+    // 向量表保存成功后调用：已保存的编辑不再需要恢复
+    void markSaved();
+
+    // 已直接写入数据库的修改同步到表格时暂停记录，这些单元格不算未保存的编辑
+    void setPaused(bool paused) { m_paused = paused; }
+
+    // 当前向量表在最近一次加载或保存后是否有编辑
+    bool hasUnsavedEdits() const { return m_tableId >= 0 && (m_recordCount > 0 || !m_dirtyCells.isEmpty()); }
+
+    // 有待恢复编辑的向量表ID，没有返回-1
+    int recoverableTableId() const { return m_recoveryTableId; }
+
+    // 把待恢复的编辑回放到当前加载的向量表，回放的编辑同样记入新日志
+    // 返回回放的记录数，失败返回-1
+    int replayRecovery(QString &errorMessage);
+
+    // 放弃待恢复的编辑
+    void discardRecovery();
+
+public slots:
+    // 把脏单元格和缓冲的记录写入文件并fsync
+    void flush();
+
+private slots:
+    void onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void onRowsAboutToChange();
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+    void onRowsRemoved(const QModelIndex &parent, int first, int last);
+
+private:
+    enum RecordType
+    {
+        CellRecord = 1,
+        InsertRowsRecord = 2,
+        RemoveRowsRecord = 3
+    };
+
+    void serializeDirtyCells();
+    void appendRecord(const QByteArray &payload);
+    bool writeHeader();
+
+    // 读取日志文件头，失败返回false
+    static bool readHeader(QFile &file, int &tableId, int &rowCount, int &columnCount);
+
+    QTableWidget *m_tableWidget;
+    QTimer m_flushTimer;
+    QFile m_file;
+    QString m_recoveryPath;
+
+    int m_tableId;      // 正在记录的向量表，-1表示未记录
+    int m_recordCount;  // 当前日志中的记录数
+    int m_recoveryTableId;
+    bool m_paused;
+
+    QSet<quint64> m_dirtyCells; // 行号<<32|列号
+    QByteArray m_buffer;        // 已编码但未写入文件的记录
+};
+
+#endif // EDITJOURNAL_H
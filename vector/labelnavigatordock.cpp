@@ -0,0 +1,243 @@
+#include "labelnavigatordock.h"
+#include "database/databasemanager.h"
+
+#include <QVBoxLayout>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+#include <limits>
+
+LabelNavigatorDock::LabelNavigatorDock(QWidget *parent)
+    : QDockWidget("标签导航", parent), m_tableId(-1), m_needsReload(false)
+{
+    setObjectName("LabelNavigatorDock");
+    setAllowedAreas(Qt::LeftDockWidgetArea | Qt::RightDockWidgetArea);
+
+    QWidget *content = new QWidget(this);
+    QVBoxLayout *layout = new QVBoxLayout(content);
+    layout->setContentsMargins(4, 4, 4, 4);
+
+    m_filterEdit = new QLineEdit(content);
+    m_filterEdit->setPlaceholderText("筛选标签");
+    m_filterEdit->setClearButtonEnabled(true);
+    layout->addWidget(m_filterEdit);
+
+    m_listWidget = new QListWidget(content);
+    layout->addWidget(m_listWidget);
+
+    m_countLabel = new QLabel(content);
+    layout->addWidget(m_countLabel);
+
+    setWidget(content);
+
+    connect(m_filterEdit, &QLineEdit::textChanged, this, &LabelNavigatorDock::applyFilter);
+    connect(m_listWidget, &QListWidget::itemActivated, this, &LabelNavigatorDock::onItemActivated);
+    connect(m_listWidget, &QListWidget::itemClicked, this, &LabelNavigatorDock::onItemActivated);
+}
+
+void LabelNavigatorDock::setTableId(int tableId)
+{
+    m_tableId = tableId;
+
+    // 隐藏时不查询，等显示时再加载
+    if (isVisible())
+        reload();
+    else
+        m_needsReload = true;
+}
+
+void LabelNavigatorDock::showEvent(QShowEvent *event)
+{
+    QDockWidget::showEvent(event);
+    if (m_needsReload)
+        reload();
+}
+
+void LabelNavigatorDock::reload()
+{
+    m_needsReload = false;
+    m_entries.clear();
+
+    QSqlDatabase db = DatabaseManager::instance()->database();
+    if (m_tableId < 0 || !db.isOpen())
+    {
+        rebuildList();
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // 只读标签部分索引(table_id, label, sort_index)，不触碰数据行
+    QSqlQuery labelQuery(db);
+    labelQuery.setForwardOnly(true);
+    labelQuery.prepare("SELECT sort_index, label FROM vector_table_data "
+                       "WHERE table_id = ? AND label <> ''");
+    labelQuery.addBindValue(m_tableId);
+    if (!labelQuery.exec())
+    {
+        qWarning() << "LabelNavigatorDock::reload - 查询标签失败:" << labelQuery.lastError().text();
+        rebuildList();
+        return;
+    }
+
+    QVector<QPair<qint64, QString>> labels;
+    while (labelQuery.next())
+    {
+        labels.append(qMakePair(labelQuery.value(0).toLongLong(), labelQuery.value(1).toString()));
+    }
+    std::sort(labels.begin(), labels.end(), [](const QPair<qint64, QString> &a, const QPair<qint64, QString> &b)
+              { return a.first < b.first; });
+
+    // sort_index不连续，按相邻标签之间的行数累计出行号(走(table_id, sort_index)覆盖索引)
+    QSqlQuery countQuery(db);
+    countQuery.prepare("SELECT COUNT(*) FROM vector_table_data "
+                       "WHERE table_id = ? AND sort_index >= ? AND sort_index < ?");
+
+    int row = 0;
+    qint64 previousSortIndex = std::numeric_limits<qint64>::min();
+    for (const auto &label : labels)
+    {
+        countQuery.bindValue(0, m_tableId);
+        countQuery.bindValue(1, previousSortIndex);
+        countQuery.bindValue(2, label.first);
+        if (!countQuery.exec() || !countQuery.next())
+        {
+            qWarning() << "LabelNavigatorDock::reload - 计算行号失败:" << countQuery.lastError().text();
+            break;
+        }
+        row += countQuery.value(0).toInt();
+        countQuery.finish();
+
+        m_entries.append(qMakePair(row, label.second));
+        previousSortIndex = label.first;
+    }
+
+    qDebug() << "LabelNavigatorDock::reload - 表ID:" << m_tableId << "标签数:" << m_entries.size()
+             << "耗时(ms):" << timer.elapsed();
+    rebuildList();
+}
+
+QString LabelNavigatorDock::entryText(int index) const
+{
+    return QString("%1    (第 %2 行)").arg(m_entries[index].second).arg(m_entries[index].first + 1);
+}
+
+void LabelNavigatorDock::rebuildList()
+{
+    m_listWidget->clear();
+    for (int i = 0; i < m_entries.size(); ++i)
+    {
+        m_listWidget->addItem(entryText(i));
+    }
+    applyFilter(m_filterEdit->text());
+}
+
+int LabelNavigatorDock::findEntry(int row) const
+{
+    // 返回第一个行号不小于row的条目位置
+    auto it = std::lower_bound(m_entries.constBegin(), m_entries.constEnd(), row,
+                               [](const QPair<int, QString> &entry, int value)
+                               { return entry.first < value; });
+    return static_cast<int>(it - m_entries.constBegin());
+}
+
+void LabelNavigatorDock::updateLabel(int row, const QString &label)
+{
+    if (m_needsReload)
+        return;
+
+    QString trimmed = label.trimmed();
+    int index = findEntry(row);
+    bool exists = index < m_entries.size() && m_entries[index].first == row;
+
+    if (exists && trimmed.isEmpty())
+    {
+        m_entries.removeAt(index);
+        delete m_listWidget->takeItem(index);
+    }
+    else if (exists)
+    {
+        m_entries[index].second = trimmed;
+        m_listWidget->item(index)->setText(entryText(index));
+    }
+    else if (!trimmed.isEmpty())
+    {
+        m_entries.insert(index, qMakePair(row, trimmed));
+        m_listWidget->insertItem(index, entryText(index));
+    }
+    else
+    {
+        return;
+    }
+
+    applyFilter(m_filterEdit->text());
+}
+
+void LabelNavigatorDock::onRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(parent);
+    if (m_needsReload || m_entries.isEmpty())
+        return;
+
+    int count = last - first + 1;
+    for (int i = findEntry(first); i < m_entries.size(); ++i)
+    {
+        m_entries[i].first += count;
+        m_listWidget->item(i)->setText(entryText(i));
+    }
+}
+
+void LabelNavigatorDock::onRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(parent);
+    if (m_needsReload || m_entries.isEmpty())
+        return;
+
+    int count = last - first + 1;
+    int begin = findEntry(first);
+    int end = findEntry(last + 1);
+
+    // 删除被移除行上的标签，其后的标签行号前移
+    for (int i = end - 1; i >= begin; --i)
+    {
+        m_entries.removeAt(i);
+        delete m_listWidget->takeItem(i);
+    }
+    for (int i = begin; i < m_entries.size(); ++i)
+    {
+        m_entries[i].first -= count;
+        m_listWidget->item(i)->setText(entryText(i));
+    }
+    applyFilter(m_filterEdit->text());
+}
+
+void LabelNavigatorDock::onItemActivated(QListWidgetItem *item)
+{
+    int index = m_listWidget->row(item);
+    if (index < 0 || index >= m_entries.size())
+        return;
+
+    qDebug() << "LabelNavigatorDock::onItemActivated - 跳转到标签:" << m_entries[index].second
+             << "行:" << m_entries[index].first + 1;
+    emit labelActivated(m_entries[index].first);
+}
+
+void LabelNavigatorDock::applyFilter(const QString &text)
+{
+    int visible = 0;
+    for (int i = 0; i < m_listWidget->count(); ++i)
+    {
+        bool match = text.isEmpty() || m_entries[i].second.contains(text, Qt::CaseInsensitive);
+        m_listWidget->item(i)->setHidden(!match);
+        if (match)
+            visible++;
+    }
+
+    if (text.isEmpty())
+        m_countLabel->setText(QString("共 %1 个标签").arg(m_entries.size()));
+    else
+        m_countLabel->setText(QString("%1 / %2 个标签").arg(visible).arg(m_entries.size()));
+}
@@ -0,0 +1,56 @@
+#ifndef LABELNAVIGATORDOCK_H
+#define LABELNAVIGATORDOCK_H
+
+#include <QDockWidget>
+#include <QListWidget>
+#include <QLineEdit>
+#include <QLabel>
+#include <QVector>
+#include <QPair>
+
+// 标签导航停靠窗口：列出当前向量表的所有非空标签，点击跳转到对应行
+class LabelNavigatorDock : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+    explicit LabelNavigatorDock(QWidget *parent = nullptr);
+
+    // 设置当前向量表并重新加载标签(隐藏时延迟到显示再加载)
+    void setTableId(int tableId);
+
+    // 增量更新：某行标签被编辑
+    void updateLabel(int row, const QString &label);
+
+public slots:
+    // 增量更新：表格插入/删除行后平移行号
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+    void onRowsRemoved(const QModelIndex &parent, int first, int last);
+
+signals:
+    // 用户选择了某个标签，row为0-based行号
+    void labelActivated(int row);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+
+private slots:
+    void onItemActivated(QListWidgetItem *item);
+    void applyFilter(const QString &text);
+
+private:
+    void reload();
+    void rebuildList();
+    int findEntry(int row) const;
+    QString entryText(int index) const;
+
+    QListWidget *m_listWidget;
+    QLineEdit *m_filterEdit;
+    QLabel *m_countLabel;
+
+    int m_tableId;
+    bool m_needsReload;
+    QVector<QPair<int, QString>> m_entries; // (行号, 标签)，按行号升序
+};
+
+#endif // LABELNAVIGATORDOCK_H
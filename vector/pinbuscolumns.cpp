@@ -0,0 +1,431 @@
+#include "pinbuscolumns.h"
+#include "database/databasemanager.h"
+#include "common/busvaluecodec.h"
+
+#include <QStyledItemDelegate>
+#include <QLineEdit>
+#include <QHeaderView>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDebug>
+
+namespace
+{
+    // 固定列数量：Label, Instruction, TimeSet, Capture, Ext, Comment
+    const int FIXED_COLUMNS = 6;
+
+    // 第row行成员管脚的状态，每个成员一个字符，第一个成员为最高位
+    QString memberStates(const QTableWidget *table, int row, const QVector<int> &columns)
+    {
+        QString states(columns.size(), QChar('X'));
+        for (int i = 0; i < columns.size(); ++i)
+        {
+            QTableWidgetItem *item = table->item(row, columns[i]);
+            if (item && !item->text().isEmpty())
+                states[i] = item->text().at(0);
+        }
+        return states;
+    }
+
+    // 总线列代理：显示时计算总线值，编辑时写回成员管脚
+    class BusItemDelegate : public QStyledItemDelegate
+    {
+    public:
+        BusItemDelegate(PinBusColumns *buses, QObject *parent)
+            : QStyledItemDelegate(parent), m_buses(buses)
+        {
+        }
+
+        QWidget *createEditor(QWidget *parent, const QStyleOptionViewItem &, const QModelIndex &) const override
+        {
+            QLineEdit *editor = new QLineEdit(parent);
+            editor->setFrame(false);
+            return editor;
+        }
+
+        void setEditorData(QWidget *editor, const QModelIndex &index) const override
+        {
+            static_cast<QLineEdit *>(editor)->setText(m_buses->busText(index.column(), index.row()));
+        }
+
+        void setModelData(QWidget *editor, QAbstractItemModel *, const QModelIndex &index) const override
+        {
+            QString text = static_cast<QLineEdit *>(editor)->text();
+            if (text == m_buses->busText(index.column(), index.row()))
+                return;
+
+            QString errorMessage;
+            if (!m_buses->setBusText(index.column(), index.row(), text, errorMessage))
+                emit m_buses->editRejected(errorMessage);
+        }
+
+    protected:
+        void initStyleOption(QStyleOptionViewItem *option, const QModelIndex &index) const override
+        {
+            QStyledItemDelegate::initStyleOption(option, index);
+            option->text = m_buses->busText(index.column(), index.row());
+            option->features |= QStyleOptionViewItem::HasDisplay;
+            option->displayAlignment = Qt::AlignCenter;
+
+            // 分组级覆盖值用斜体显示，与成员管脚推导出的值区分
+            if (m_buses->hasOverride(index.column(), index.row()))
+                option->font.setItalic(true);
+        }
+
+    private:
+        PinBusColumns *m_buses;
+    };
+}
+
+PinBusColumns::PinBusColumns(QTableWidget *tableWidget, QObject *parent)
+    : QObject(parent), m_tableWidget(tableWidget), m_tableId(-1), m_binary(false)
+{
+    m_delegate = new BusItemDelegate(this, this);
+
+    connect(m_tableWidget->model(), &QAbstractItemModel::dataChanged, this, &PinBusColumns::onDataChanged);
+    connect(m_tableWidget->horizontalHeader(), &QHeaderView::sectionDoubleClicked, this, &PinBusColumns::toggleBus);
+}
+
+int PinBusColumns::busColumnCount(const QTableWidget *tableWidget)
+{
+    int count = 0;
+    for (int col = tableWidget->columnCount() - 1; col >= FIXED_COLUMNS; --col)
+    {
+        QTableWidgetItem *headerItem = tableWidget->horizontalHeaderItem(col);
+        if (!headerItem || !headerItem->data(BusGroupRole).isValid())
+            break;
+        count++;
+    }
+    return count;
+}
+
+void PinBusColumns::clearBuses()
+{
+    for (const Bus &bus : m_buses)
+    {
+        m_tableWidget->setItemDelegateForColumn(bus.column, nullptr);
+    }
+    m_buses.clear();
+    m_columnToBus.clear();
+    m_isMemberColumn.clear();
+}
+
+void PinBusColumns::clear()
+{
+    clearBuses();
+    m_tableId = -1;
+}
+
+void PinBusColumns::setTableId(int tableId)
+{
+    clearBuses();
+    m_tableId = tableId;
+
+    QSqlDatabase db = DatabaseManager::instance()->database();
+    if (!db.isOpen())
+        return;
+
+    // 表头项中保存了每个管脚列对应的pin_list ID
+    int pinColumnEnd = m_tableWidget->columnCount() - busColumnCount(m_tableWidget);
+    QHash<int, int> pinToColumn;
+    for (int col = FIXED_COLUMNS; col < pinColumnEnd; ++col)
+    {
+        QTableWidgetItem *headerItem = m_tableWidget->horizontalHeaderItem(col);
+        if (headerItem && headerItem->data(Qt::UserRole).isValid())
+            pinToColumn[headerItem->data(Qt::UserRole).toInt()] = col;
+    }
+
+    QSqlQuery query(db);
+    query.prepare("SELECT pg.group_id, pg.group_name, pgm.pin_id "
+                  "FROM pin_groups pg "
+                  "JOIN pin_group_members pgm ON pgm.group_id = pg.group_id "
+                  "WHERE pg.table_id = ? "
+                  "ORDER BY pg.group_name, pgm.sort_index, pgm.id");
+    query.addBindValue(tableId);
+    if (!query.exec())
+    {
+        qWarning() << "PinBusColumns::setTableId - 查询管脚分组失败:" << query.lastError().text();
+        return;
+    }
+
+    QVector<Bus> buses;
+    while (query.next())
+    {
+        int groupId = query.value(0).toInt();
+        int column = pinToColumn.value(query.value(2).toInt(), -1);
+        if (column < 0)
+            continue; // 成员管脚不在当前表中
+
+        if (buses.isEmpty() || buses.last().groupId != groupId)
+        {
+            Bus bus;
+            bus.groupId = groupId;
+            bus.name = query.value(1).toString();
+            bus.column = -1;
+            buses.append(bus);
+        }
+
+        // 表头第三行为管脚类型
+        QString typeName = m_tableWidget->horizontalHeaderItem(column)->text().section('\n', 2, 2);
+        buses.last().memberColumns.append(column);
+        buses.last().memberIsOutput.append(typeName == "Out");
+    }
+
+    if (buses.isEmpty())
+        return;
+
+    // 一次性追加所有总线列
+    QHeaderView *header = m_tableWidget->horizontalHeader();
+    int firstBusColumn = m_tableWidget->columnCount();
+    m_tableWidget->setColumnCount(firstBusColumn + buses.size());
+    m_isMemberColumn.fill(false, firstBusColumn);
+
+    for (int i = 0; i < buses.size(); ++i)
+    {
+        Bus &bus = buses[i];
+        bus.column = firstBusColumn + i;
+        m_columnToBus[bus.column] = i;
+
+        QTableWidgetItem *headerItem = new QTableWidgetItem();
+        headerItem->setTextAlignment(Qt::AlignCenter);
+        headerItem->setData(BusGroupRole, bus.groupId);
+        m_tableWidget->setHorizontalHeaderItem(bus.column, headerItem);
+        m_tableWidget->setItemDelegateForColumn(bus.column, m_delegate);
+
+        // 总线列显示在第一个成员管脚前面
+        int firstVisual = header->visualIndex(bus.memberColumns.first());
+        for (int member : bus.memberColumns)
+        {
+            firstVisual = qMin(firstVisual, header->visualIndex(member));
+            m_isMemberColumn[member] = true;
+        }
+        header->moveSection(header->visualIndex(bus.column), firstVisual);
+    }
+    m_buses = buses;
+
+    loadOverrides();
+
+    for (const Bus &bus : m_buses)
+    {
+        updateHeader(bus);
+    }
+    updateMemberVisibility();
+
+    qDebug() << "PinBusColumns::setTableId - 表ID:" << tableId << "总线数:" << m_buses.size();
+}
+
+void PinBusColumns::loadOverrides()
+{
+    // 分组值由成员管脚推导，数据库中只保存分组级覆盖值，通常为空
+    QSqlDatabase db = DatabaseManager::instance()->database();
+    QSqlQuery query(db);
+    query.prepare("SELECT gv.vector_data_id, gv.group_id, gv.group_level "
+                  "FROM vector_table_group_values gv "
+                  "JOIN vector_table_data vtd ON vtd.id = gv.vector_data_id "
+                  "WHERE vtd.table_id = ?");
+    query.addBindValue(m_tableId);
+    if (!query.exec())
+    {
+        qWarning() << "PinBusColumns::loadOverrides - 查询分组覆盖值失败:" << query.lastError().text();
+        return;
+    }
+
+    QHash<int, int> groupToColumn;
+    for (const Bus &bus : m_buses)
+    {
+        groupToColumn[bus.groupId] = bus.column;
+    }
+
+    // 加载时每行第0列保存了vector_table_data的ID，有覆盖值时才建立映射
+    QHash<int, int> dataIdToRow;
+    int count = 0;
+    while (query.next())
+    {
+        int column = groupToColumn.value(query.value(1).toInt(), -1);
+        if (column < 0)
+            continue;
+
+        if (dataIdToRow.isEmpty())
+        {
+            for (int row = 0; row < m_tableWidget->rowCount(); ++row)
+            {
+                QTableWidgetItem *item = m_tableWidget->item(row, 0);
+                if (item)
+                    dataIdToRow[item->data(Qt::UserRole).toInt()] = row;
+            }
+        }
+
+        int row = dataIdToRow.value(query.value(0).toInt(), -1);
+        if (row < 0)
+            continue;
+
+        QTableWidgetItem *item = new QTableWidgetItem(query.value(2).toString());
+        item->setToolTip("分组级覆盖值，编辑总线值后改为由成员管脚推导");
+        m_tableWidget->setItem(row, column, item);
+        count++;
+    }
+
+    if (count > 0)
+        qDebug() << "PinBusColumns::loadOverrides - 表ID:" << m_tableId << "覆盖值数量:" << count;
+}
+
+bool PinBusColumns::hasOverride(int column, int row) const
+{
+    if (!m_columnToBus.contains(column))
+        return false;
+
+    QTableWidgetItem *item = m_tableWidget->item(row, column);
+    return item && !item->text().isEmpty();
+}
+
+QString PinBusColumns::busText(int column, int row) const
+{
+    auto it = m_columnToBus.constFind(column);
+    if (it == m_columnToBus.constEnd())
+        return QString();
+
+    // 有分组级覆盖值时直接显示，否则由成员管脚推导
+    QTableWidgetItem *item = m_tableWidget->item(row, column);
+    if (item && !item->text().isEmpty())
+        return item->text();
+
+    const Bus &bus = m_buses[it.value()];
+    return BusValueCodec::format(memberStates(m_tableWidget, row, bus.memberColumns), m_binary);
+}
+
+bool PinBusColumns::setBusText(int column, int row, const QString &text, QString &errorMessage)
+{
+    auto it = m_columnToBus.constFind(column);
+    if (it == m_columnToBus.constEnd())
+    {
+        errorMessage = "不是总线列";
+        return false;
+    }
+
+    const Bus &bus = m_buses[it.value()];
+    int bits = bus.memberColumns.size();
+    QString states;
+    if (!BusValueCodec::parse(text, bits, m_binary, states, errorMessage))
+    {
+        errorMessage = QString("总线 %1: %2").arg(bus.name, errorMessage);
+        return false;
+    }
+
+    // 只写入状态有变化的成员管脚
+    int written = 0;
+    for (int i = 0; i < bits; ++i)
+    {
+        QString state = QString(states.at(i));
+        if (state == "1")
+            state = bus.memberIsOutput[i] ? "H" : "1";
+        else if (state == "0")
+            state = bus.memberIsOutput[i] ? "L" : "0";
+
+        QTableWidgetItem *item = m_tableWidget->item(row, bus.memberColumns[i]);
+        if (!item)
+        {
+            m_tableWidget->setItem(row, bus.memberColumns[i], new QTableWidgetItem(state));
+            written++;
+        }
+        else if (item->text() != state)
+        {
+            item->setText(state);
+            written++;
+        }
+    }
+
+    // 总线值已写回成员管脚，不再需要覆盖值
+    if (m_tableWidget->item(row, column))
+        delete m_tableWidget->takeItem(row, column);
+
+    qDebug() << "PinBusColumns::setBusText - 总线" << bus.name << "第" << row + 1 << "行写入成员数:" << written;
+    return true;
+}
+
+void PinBusColumns::setBinaryDisplay(bool binary)
+{
+    if (m_binary == binary)
+        return;
+
+    m_binary = binary;
+    for (const Bus &bus : m_buses)
+    {
+        updateHeader(bus);
+    }
+    m_tableWidget->viewport()->update();
+}
+
+void PinBusColumns::setAllExpanded(bool expanded)
+{
+    for (const Bus &bus : m_buses)
+    {
+        if (expanded)
+            m_expandedGroups.insert(bus.groupId);
+        else
+            m_expandedGroups.remove(bus.groupId);
+    }
+    updateMemberVisibility();
+}
+
+void PinBusColumns::toggleBus(int column)
+{
+    auto it = m_columnToBus.constFind(column);
+    if (it == m_columnToBus.constEnd())
+        return;
+
+    int groupId = m_buses[it.value()].groupId;
+    if (m_expandedGroups.contains(groupId))
+        m_expandedGroups.remove(groupId);
+    else
+        m_expandedGroups.insert(groupId);
+    updateMemberVisibility();
+}
+
+void PinBusColumns::updateHeader(const Bus &bus)
+{
+    QTableWidgetItem *headerItem = m_tableWidget->horizontalHeaderItem(bus.column);
+    if (!headerItem)
+        return;
+
+    headerItem->setText(QString("%1\n[%2]\n%3").arg(bus.name).arg(bus.memberColumns.size()).arg(m_binary ? "BIN" : "HEX"));
+    headerItem->setToolTip("双击表头展开/折叠成员管脚");
+    m_tableWidget->resizeColumnToContents(bus.column);
+}
+
+void PinBusColumns::updateMemberVisibility()
+{
+    // 成员管脚属于任一折叠的总线时隐藏
+    QVector<bool> hidden(m_isMemberColumn.size(), false);
+    for (const Bus &bus : m_buses)
+    {
+        if (m_expandedGroups.contains(bus.groupId))
+            continue;
+        for (int member : bus.memberColumns)
+        {
+            hidden[member] = true;
+        }
+    }
+
+    for (int col = FIXED_COLUMNS; col < m_isMemberColumn.size(); ++col)
+    {
+        if (m_isMemberColumn[col])
+            m_tableWidget->setColumnHidden(col, hidden[col]);
+    }
+}
+
+void PinBusColumns::onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    if (m_buses.isEmpty())
+        return;
+
+    // 成员管脚变化后重绘总线列(总线值在绘制时重新计算)
+    int last = qMin(bottomRight.column(), m_isMemberColumn.size() - 1);
+    for (int col = topLeft.column(); col <= last; ++col)
+    {
+        if (m_isMemberColumn[col])
+        {
+            m_tableWidget->viewport()->update();
+            return;
+        }
+    }
+}
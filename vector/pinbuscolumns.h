@@ -0,0 +1,91 @@
+#ifndef PINBUSCOLUMNS_H
+#define PINBUSCOLUMNS_H
+
+#include <QObject>
+#include <QTableWidget>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QString>
+
+class QStyledItemDelegate;
+
+// 管脚分组的总线列：把一个分组的成员管脚合成一列，按十六进制或二进制显示
+// 总线值绘制时从成员管脚的状态按位打包计算，编辑总线值时批量写回成员管脚
+// 总线列中只有分组级覆盖值(vector_table_group_values)才有单元格项，保存时写回数据库
+// 总线列追加在管脚列之后(逻辑列)，显示时移动到第一个成员管脚前面，折叠时隐藏成员管脚列
+class PinBusColumns : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 总线列表头项中保存分组ID的数据角色
+    static const int BusGroupRole = Qt::UserRole + 1;
+
+    PinBusColumns(QTableWidget *tableWidget, QObject *parent = nullptr);
+
+    // 向量表加载完成后调用：读取该表的分组并追加总线列
+    void setTableId(int tableId);
+
+    // 重新加载向量表前调用：去掉旧表的总线列代理，加载期间不处理总线
+    void clear();
+
+    bool isBusColumn(int column) const { return m_columnToBus.contains(column); }
+    bool isBinaryDisplay() const { return m_binary; }
+
+    // 表格中总线列的数量(总线列之前的都是固定列和管脚列)
+    static int busColumnCount(const QTableWidget *tableWidget);
+
+    // 总线列在第row行的显示值
+    QString busText(int column, int row) const;
+
+    // 第row行是否有分组级覆盖值
+    bool hasOverride(int column, int row) const;
+
+    // 把总线值写回第row行的成员管脚，支持0x/0b前缀，X表示不确定
+    bool setBusText(int column, int row, const QString &text, QString &errorMessage);
+
+public slots:
+    // 十六进制/二进制显示切换
+    void setBinaryDisplay(bool binary);
+
+    // 展开或折叠所有总线
+    void setAllExpanded(bool expanded);
+
+    // 展开或折叠一个总线(双击总线列表头)
+    void toggleBus(int column);
+
+signals:
+    // 总线编辑的值无效
+    void editRejected(const QString &message);
+
+private slots:
+    void onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+
+private:
+    struct Bus
+    {
+        int groupId;
+        QString name;
+        int column;
+        QVector<int> memberColumns; // 第一个成员为最高位
+        QVector<bool> memberIsOutput; // 输出管脚写H/L，其他写1/0
+    };
+
+    void clearBuses();
+    void loadOverrides();
+    void updateHeader(const Bus &bus);
+    void updateMemberVisibility();
+
+    QTableWidget *m_tableWidget;
+    QStyledItemDelegate *m_delegate;
+    int m_tableId;
+    bool m_binary;
+
+    QVector<Bus> m_buses;
+    QHash<int, int> m_columnToBus; // 总线列 -> m_buses下标
+    QVector<bool> m_isMemberColumn;
+    QSet<int> m_expandedGroups; // 展开的分组ID，切换表后保留
+};
+
+#endif // PINBUSCOLUMNS_H
@@ -0,0 +1,497 @@
+#include "testtimeestimator.h"
+#include "database/databasemanager.h"
+
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+
+namespace
+{
+    const int COLUMN_INSTRUCTION = 1;
+    const int COLUMN_TIMESET = 2;
+    const int COLUMN_EXT = 4;
+}
+
+TestTimeEstimator::TestTimeEstimator(QTableWidget *tableWidget, QObject *parent)
+    : QObject(parent), m_tableWidget(tableWidget), m_loopRows(0),
+      m_fenwickDirty(true), m_rowsDirty(true), m_weightsDirty(true), m_prefixDirtyFrom(0)
+{
+    // 只有"未知"一项，打开项目后再读取
+    m_timeSetNames << QString();
+    m_timeSetIds << -1;
+    m_periods << 0.0;
+
+    QAbstractItemModel *model = m_tableWidget->model();
+    connect(model, &QAbstractItemModel::dataChanged, this, &TestTimeEstimator::onDataChanged);
+    connect(model, &QAbstractItemModel::rowsInserted, this, &TestTimeEstimator::onRowsInserted);
+    connect(model, &QAbstractItemModel::rowsRemoved, this, &TestTimeEstimator::onRowsRemoved);
+    connect(model, &QAbstractItemModel::modelReset, this, &TestTimeEstimator::onModelReset);
+}
+
+void TestTimeEstimator::reloadTimeSets()
+{
+    m_timeSetNames.clear();
+    m_timeSetIds.clear();
+    m_periods.clear();
+    m_nameToIndex.clear();
+
+    QSqlDatabase db = DatabaseManager::instance()->database();
+    if (db.isOpen())
+    {
+        QSqlQuery query(db);
+        if (query.exec("SELECT id, timeset_name, period FROM timeset_list ORDER BY id"))
+        {
+            while (query.next())
+            {
+                m_nameToIndex.insert(query.value(1).toString(), m_timeSetNames.size());
+                m_timeSetIds << query.value(0).toInt();
+                m_timeSetNames << query.value(1).toString();
+                m_periods << query.value(2).toDouble();
+            }
+        }
+        else
+        {
+            qWarning() << "TestTimeEstimator::reloadTimeSets - 查询TimeSet失败:" << query.lastError().text();
+        }
+    }
+
+    // 最后一项表示未知或已删除的TimeSet
+    m_timeSetNames << QString();
+    m_timeSetIds << -1;
+    m_periods << 0.0;
+
+    // TimeSet序号变化，需要重新读取每行
+    m_rowsDirty = true;
+    emit changed();
+}
+
+void TestTimeEstimator::updateTimeSetPeriod(int timeSetId, double period)
+{
+    int index = m_timeSetIds.indexOf(timeSetId);
+    if (index < 0)
+    {
+        reloadTimeSets();
+        return;
+    }
+
+    // 前缀和按周期数存放，周期修改只影响乘数；每行时间需要重建
+    m_periods[index] = period;
+    m_fenwickDirty = true;
+    emit changed();
+}
+
+int TestTimeEstimator::timeSetIndex(const QString &name) const
+{
+    return m_nameToIndex.value(name, m_periods.size() - 1);
+}
+
+QString TestTimeEstimator::cellText(int row, int column) const
+{
+    QTableWidgetItem *item = m_tableWidget->item(row, column);
+    return item ? item->text() : QString();
+}
+
+bool TestTimeEstimator::isControlInstruction(const QString &instruction)
+{
+    return instruction == "REPEAT" || instruction == "SET_LOOPA" || instruction == "END_LOOPA";
+}
+
+void TestTimeEstimator::onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    if (m_rowsDirty)
+        return;
+
+    bool timeSetChanged = topLeft.column() <= COLUMN_TIMESET && bottomRight.column() >= COLUMN_TIMESET;
+    bool instructionChanged = (topLeft.column() <= COLUMN_INSTRUCTION && bottomRight.column() >= COLUMN_INSTRUCTION) ||
+                              (topLeft.column() <= COLUMN_EXT && bottomRight.column() >= COLUMN_EXT);
+    if (!timeSetChanged && !instructionChanged)
+        return;
+
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row)
+    {
+        if (row >= m_rowTimeSet.size())
+        {
+            m_rowsDirty = true;
+            break;
+        }
+
+        if (timeSetChanged)
+        {
+            int oldIndex = m_rowTimeSet[row];
+            int newIndex = timeSetIndex(cellText(row, COLUMN_TIMESET));
+            if (oldIndex != newIndex)
+            {
+                if (!m_weightsDirty)
+                {
+                    m_totals[oldIndex] -= m_rowWeight[row];
+                    m_totals[newIndex] += m_rowWeight[row];
+                    if (!m_fenwickDirty)
+                        fenwickAdd(row, m_rowWeight[row] * (m_periods[newIndex] - m_periods[oldIndex]));
+                }
+                m_rowTimeSet[row] = newIndex;
+
+                int block = row / BLOCK_ROWS;
+                m_prefixDirtyFrom = m_prefixDirtyFrom < 0 ? block : qMin(m_prefixDirtyFrom, block);
+            }
+        }
+
+        // 只有涉及REPEAT/循环的行才会改变周期数
+        if (instructionChanged)
+        {
+            bool control = isControlInstruction(cellText(row, COLUMN_INSTRUCTION));
+            if (control || m_rowControl[row])
+                m_weightsDirty = true;
+            m_rowControl[row] = control;
+        }
+    }
+
+    emit changed();
+}
+
+void TestTimeEstimator::onRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(parent);
+    if (m_rowsDirty)
+        return;
+
+    // 新行的内容随后通过dataChanged填入，先按未知TimeSet、1个周期计
+    int count = last - first + 1;
+    int unknown = m_periods.size() - 1;
+    m_rowTimeSet.insert(first, count, unknown);
+    m_rowWeight.insert(first, count, 1);
+    m_rowControl.insert(first, count, false);
+    if (!m_weightsDirty)
+        m_totals[unknown] += count;
+    m_fenwickDirty = true;
+
+    // 插入到循环体中的行周期数由外层循环决定
+    if (m_loopRows > 0)
+        m_weightsDirty = true;
+
+    int block = first / BLOCK_ROWS;
+    m_prefixDirtyFrom = m_prefixDirtyFrom < 0 ? block : qMin(m_prefixDirtyFrom, block);
+    emit changed();
+}
+
+void TestTimeEstimator::onRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(parent);
+    if (m_rowsDirty)
+        return;
+
+    if (last >= m_rowTimeSet.size())
+    {
+        m_rowsDirty = true;
+        emit changed();
+        return;
+    }
+
+    for (int row = first; row <= last; ++row)
+    {
+        if (!m_weightsDirty)
+            m_totals[m_rowTimeSet[row]] -= m_rowWeight[row];
+        if (m_rowControl[row])
+            m_weightsDirty = true;
+    }
+
+    int count = last - first + 1;
+    m_rowTimeSet.remove(first, count);
+    m_rowWeight.remove(first, count);
+    m_rowControl.remove(first, count);
+    m_fenwickDirty = true;
+    if (m_loopRows > 0)
+        m_weightsDirty = true;
+
+    int block = first / BLOCK_ROWS;
+    m_prefixDirtyFrom = m_prefixDirtyFrom < 0 ? block : qMin(m_prefixDirtyFrom, block);
+    emit changed();
+}
+
+void TestTimeEstimator::onModelReset()
+{
+    m_rowsDirty = true;
+    emit changed();
+}
+
+void TestTimeEstimator::ensureUpToDate()
+{
+    if (m_rowTimeSet.size() != m_tableWidget->rowCount())
+        m_rowsDirty = true;
+
+    if (m_rowsDirty)
+        rebuildRows();
+    if (m_weightsDirty)
+        rebuildWeights();
+    if (m_prefixDirtyFrom >= 0)
+        rebuildPrefix(m_prefixDirtyFrom);
+}
+
+void TestTimeEstimator::rebuildRows()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    int rowCount = m_tableWidget->rowCount();
+    m_rowTimeSet.resize(rowCount);
+    m_rowWeight.resize(rowCount);
+    m_rowControl.resize(rowCount);
+    for (int row = 0; row < rowCount; ++row)
+    {
+        m_rowTimeSet[row] = timeSetIndex(cellText(row, COLUMN_TIMESET));
+        m_rowControl[row] = isControlInstruction(cellText(row, COLUMN_INSTRUCTION));
+    }
+
+    m_rowsDirty = false;
+    m_weightsDirty = true;
+    qDebug() << "TestTimeEstimator::rebuildRows - 行数:" << rowCount << "耗时(ms):" << timer.elapsed();
+}
+
+void TestTimeEstimator::rebuildWeights()
+{
+    // 循环可以嵌套，栈中保存每层的累计倍数；SET_LOOPA和END_LOOPA行本身属于循环体
+    QVector<qint64> multipliers;
+    multipliers << 1;
+    m_loopRows = 0;
+    m_totals.fill(0, m_periods.size());
+
+    for (int row = 0; row < m_rowTimeSet.size(); ++row)
+    {
+        qint64 weight = multipliers.last();
+        if (m_rowControl[row])
+        {
+            QString instruction = cellText(row, COLUMN_INSTRUCTION);
+            qint64 count = qMax(1, cellText(row, COLUMN_EXT).toInt());
+            if (instruction == "REPEAT")
+            {
+                weight *= count;
+            }
+            else if (instruction == "SET_LOOPA")
+            {
+                multipliers << multipliers.last() * count;
+                weight = multipliers.last();
+                m_loopRows++;
+            }
+            else if (instruction == "END_LOOPA")
+            {
+                if (multipliers.size() > 1)
+                    multipliers.removeLast();
+                m_loopRows++;
+            }
+        }
+
+        m_rowWeight[row] = weight;
+        m_totals[m_rowTimeSet[row]] += weight;
+    }
+
+    m_weightsDirty = false;
+    m_prefixDirtyFrom = 0;
+    m_fenwickDirty = true;
+}
+
+void TestTimeEstimator::rebuildPrefix(int fromBlock)
+{
+    int timeSetCount = m_periods.size();
+    int rowCount = m_rowTimeSet.size();
+    int blockCount = rowCount / BLOCK_ROWS + 1;
+    m_blockPrefix.resize(blockCount * timeSetCount);
+
+    // 第fromBlock块的起始前缀只依赖之前的行，仍然有效
+    if (fromBlock == 0)
+        std::fill(m_blockPrefix.begin(), m_blockPrefix.begin() + timeSetCount, 0);
+
+    for (int block = qMax(1, fromBlock + 1); block < blockCount; ++block)
+    {
+        qint64 *current = m_blockPrefix.data() + block * timeSetCount;
+        const qint64 *previous = current - timeSetCount;
+        std::copy(previous, previous + timeSetCount, current);
+        for (int row = (block - 1) * BLOCK_ROWS; row < block * BLOCK_ROWS; ++row)
+            current[m_rowTimeSet[row]] += m_rowWeight[row];
+    }
+
+    m_prefixDirtyFrom = -1;
+}
+
+void TestTimeEstimator::addPrefix(int row, QVector<qint64> &counts)
+{
+    int timeSetCount = m_periods.size();
+    int block = row / BLOCK_ROWS;
+    const qint64 *prefix = m_blockPrefix.constData() + block * timeSetCount;
+    for (int t = 0; t < timeSetCount; ++t)
+        counts[t] += prefix[t];
+    for (int r = block * BLOCK_ROWS; r < row; ++r)
+        counts[m_rowTimeSet[r]] += m_rowWeight[r];
+}
+
+qint64 TestTimeEstimator::totalCycles()
+{
+    ensureUpToDate();
+    qint64 cycles = 0;
+    for (qint64 count : m_totals)
+        cycles += count;
+    return cycles;
+}
+
+double TestTimeEstimator::totalTime()
+{
+    ensureUpToDate();
+    double time = 0.0;
+    for (int t = 0; t < m_totals.size(); ++t)
+        time += m_totals[t] * m_periods[t];
+    return time;
+}
+
+void TestTimeEstimator::selectionTotals(const QList<QTableWidgetSelectionRange> &ranges, int &rows, qint64 &cycles, double &time)
+{
+    rows = 0;
+    cycles = 0;
+    time = 0.0;
+    if (ranges.isEmpty())
+        return;
+
+    ensureUpToDate();
+
+    // 选区可能按列拆成多个范围，先合并成不重叠的行区间
+    QVector<QPair<int, int>> intervals;
+    for (const QTableWidgetSelectionRange &range : ranges)
+        intervals.append(qMakePair(range.topRow(), qMin(range.bottomRow(), m_rowTimeSet.size() - 1)));
+    std::sort(intervals.begin(), intervals.end());
+
+    QVector<QPair<int, int>> merged;
+    for (const auto &interval : intervals)
+    {
+        if (interval.first > interval.second)
+            continue;
+        if (!merged.isEmpty() && interval.first <= merged.last().second + 1)
+            merged.last().second = qMax(merged.last().second, interval.second);
+        else
+            merged.append(interval);
+    }
+
+    int timeSetCount = m_periods.size();
+    QVector<qint64> counts(timeSetCount, 0);
+    QVector<qint64> before(timeSetCount, 0);
+    for (const auto &interval : merged)
+    {
+        // 区间[first, last]的周期数 = 前缀(last + 1) - 前缀(first)
+        before.fill(0);
+        addPrefix(interval.first, before);
+        addPrefix(interval.second + 1, counts);
+        for (int t = 0; t < timeSetCount; ++t)
+            counts[t] -= before[t];
+        rows += interval.second - interval.first + 1;
+    }
+
+    for (int t = 0; t < timeSetCount; ++t)
+    {
+        cycles += counts[t];
+        time += counts[t] * m_periods[t];
+    }
+}
+
+double TestTimeEstimator::rowDuration(int row) const
+{
+    return m_rowWeight[row] * m_periods[m_rowTimeSet[row]];
+}
+
+void TestTimeEstimator::ensureFenwick()
+{
+    ensureUpToDate();
+    if (!m_fenwickDirty)
+        return;
+
+    // 线性建树：每个节点把自己累加到父节点
+    int rowCount = m_rowTimeSet.size();
+    m_fenwick.fill(0.0, rowCount + 1);
+    for (int i = 1; i <= rowCount; ++i)
+    {
+        m_fenwick[i] += rowDuration(i - 1);
+        int parent = i + (i & -i);
+        if (parent <= rowCount)
+            m_fenwick[parent] += m_fenwick[i];
+    }
+    m_fenwickDirty = false;
+}
+
+void TestTimeEstimator::fenwickAdd(int row, double delta)
+{
+    for (int i = row + 1; i < m_fenwick.size(); i += i & -i)
+        m_fenwick[i] += delta;
+}
+
+double TestTimeEstimator::rowStartTime(int row)
+{
+    ensureFenwick();
+    row = qBound(0, row, m_rowTimeSet.size());
+
+    double time = 0.0;
+    for (int i = row; i > 0; i -= i & -i)
+        time += m_fenwick[i];
+    return time;
+}
+
+int TestTimeEstimator::rowAtTime(double timeNs)
+{
+    ensureFenwick();
+    int rowCount = m_rowTimeSet.size();
+    if (timeNs < 0 || rowCount == 0)
+        return -1;
+
+    // 从高位向下查找前缀和不超过timeNs的最长前缀，下一行即为该时刻正在执行的行
+    int step = 1;
+    while (step * 2 <= rowCount)
+        step *= 2;
+
+    int position = 0;
+    double remaining = timeNs;
+    for (; step > 0; step /= 2)
+    {
+        int next = position + step;
+        if (next <= rowCount && m_fenwick[next] <= remaining)
+        {
+            position = next;
+            remaining -= m_fenwick[next];
+        }
+    }
+
+    return position < rowCount ? position : -1;
+}
+
+double TestTimeEstimator::parseTime(const QString &text, bool *ok)
+{
+    QString value = text.trimmed().toLower();
+    double scale = 1.0;
+    if (value.endsWith("ns"))
+    {
+        value.chop(2);
+    }
+    else if (value.endsWith("us"))
+    {
+        value.chop(2);
+        scale = 1e3;
+    }
+    else if (value.endsWith("ms"))
+    {
+        value.chop(2);
+        scale = 1e6;
+    }
+    else if (value.endsWith("s"))
+    {
+        value.chop(1);
+        scale = 1e9;
+    }
+
+    return value.trimmed().toDouble(ok) * scale;
+}
+
+QString TestTimeEstimator::formatTime(double ns)
+{
+    if (ns < 1e3)
+        return QString("%1 ns").arg(ns, 0, 'f', 0);
+    if (ns < 1e6)
+        return QString("%1 us").arg(ns / 1e3, 0, 'f', 3);
+    if (ns < 1e9)
+        return QString("%1 ms").arg(ns / 1e6, 0, 'f', 3);
+    return QString("%1 s").arg(ns / 1e9, 0, 'f', 3);
+}
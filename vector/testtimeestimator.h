@@ -0,0 +1,98 @@
+#ifndef TESTTIMEESTIMATOR_H
+#define TESTTIMEESTIMATOR_H
+
+#include <QObject>
+#include <QVector>
+#include <QHash>
+#include <QStringList>
+#include <QTableWidget>
+
+// 测试时间估算：按TimeSet分别维护周期数的块前缀和，总时间和任意选区的时间都能立即得到
+// 另用树状数组(Fenwick树)维护每行的执行时间，支持按绝对时间定位行
+// 每行执行的周期数考虑REPEAT次数和SET_LOOPA/END_LOOPA循环
+class TestTimeEstimator : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestTimeEstimator(QTableWidget *tableWidget, QObject *parent = nullptr);
+
+    // 前缀和的块大小(行)
+    static const int BLOCK_ROWS = 256;
+
+    // 从数据库重新读取TimeSet名称和周期
+    void reloadTimeSets();
+
+    // 整个表的周期数和时间(ns)
+    qint64 totalCycles();
+    double totalTime();
+
+    // 选区(可以是多个不连续范围)的行数、周期数和时间(ns)
+    void selectionTotals(const QList<QTableWidgetSelectionRange> &ranges, int &rows, qint64 &cycles, double &time);
+
+    // 第row行开始执行的绝对时间(ns)
+    double rowStartTime(int row);
+
+    // 绝对时间timeNs处正在执行的行，超出总时间返回-1
+    int rowAtTime(double timeNs);
+
+    // 把ns格式化为合适的单位
+    static QString formatTime(double ns);
+
+    // 解析带单位(ns/us/ms/s)的时间，不带单位按ns处理
+    static double parseTime(const QString &text, bool *ok);
+
+public slots:
+    // TimeSet周期被修改
+    void updateTimeSetPeriod(int timeSetId, double period);
+
+signals:
+    void changed();
+
+private slots:
+    void onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+    void onRowsRemoved(const QModelIndex &parent, int first, int last);
+    void onModelReset();
+
+private:
+    void ensureUpToDate();
+    void rebuildRows();
+    void rebuildWeights();
+    void rebuildPrefix(int fromBlock);
+    void addPrefix(int row, QVector<qint64> &counts);
+    void ensureFenwick();
+    void fenwickAdd(int row, double delta);
+    double rowDuration(int row) const;
+    int timeSetIndex(const QString &name) const;
+    QString cellText(int row, int column) const;
+    static bool isControlInstruction(const QString &instruction);
+
+    QTableWidget *m_tableWidget;
+
+    // TimeSet序号 -> 名称/ID/周期，最后一个序号表示未知或已删除的TimeSet(周期按0计)
+    QStringList m_timeSetNames;
+    QVector<int> m_timeSetIds;
+    QVector<double> m_periods;
+    QHash<QString, int> m_nameToIndex;
+
+    // 每行的TimeSet序号、执行周期数和是否为REPEAT/循环指令
+    QVector<int> m_rowTimeSet;
+    QVector<qint64> m_rowWeight;
+    QVector<bool> m_rowControl;
+    int m_loopRows; // SET_LOOPA/END_LOOPA行数，有循环时行增删会影响其他行的周期数
+
+    // 每个TimeSet的周期总数，以及每块起始处的前缀和(按块号 * TimeSet数 + 序号存放)
+    QVector<qint64> m_totals;
+    QVector<qint64> m_blockPrefix;
+
+    // 每行执行时间的树状数组(1-based)，行增删或周期修改后整体重建(O(n))，TimeSet修改时单点更新(O(log n))
+    QVector<double> m_fenwick;
+    bool m_fenwickDirty;
+
+    bool m_rowsDirty;     // 需要从表格重新读取全部行
+    bool m_weightsDirty;  // 需要重新计算每行周期数
+    int m_prefixDirtyFrom; // 从该块开始的前缀和需要重算，-1表示全部有效
+};
+
+#endif // TESTTIMEESTIMATOR_H
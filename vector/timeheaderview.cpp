@@ -0,0 +1,62 @@
+#include "timeheaderview.h"
+#include "testtimeestimator.h"
+
+#include <QPainter>
+#include <QStyleOptionHeader>
+
+TimeHeaderView::TimeHeaderView(TestTimeEstimator *estimator, QWidget *parent)
+    : QHeaderView(Qt::Vertical, parent), m_estimator(estimator), m_showTime(false)
+{
+    // 与QTableView默认的行表头保持一致
+    setSectionsClickable(true);
+    setHighlightSections(true);
+
+    connect(m_estimator, &TestTimeEstimator::changed, this, [this]()
+            {
+        if (m_showTime)
+            viewport()->update(); });
+}
+
+void TimeHeaderView::setTimeVisible(bool visible)
+{
+    if (m_showTime == visible)
+        return;
+
+    m_showTime = visible;
+
+    // 宽度随内容变化
+    updateGeometries();
+    if (parentWidget())
+        parentWidget()->updateGeometry();
+    viewport()->update();
+}
+
+void TimeHeaderView::paintSection(QPainter *painter, const QRect &rect, int logicalIndex) const
+{
+    if (!m_showTime || !rect.isValid())
+    {
+        QHeaderView::paintSection(painter, rect, logicalIndex);
+        return;
+    }
+
+    QStyleOptionHeader option;
+    initStyleOption(&option);
+    option.rect = rect;
+    option.section = logicalIndex;
+    option.textAlignment = Qt::AlignRight | Qt::AlignVCenter;
+    option.text = QString("%1  @ %2")
+                      .arg(model()->headerData(logicalIndex, Qt::Vertical).toString())
+                      .arg(TestTimeEstimator::formatTime(m_estimator->rowStartTime(logicalIndex)));
+
+    painter->save();
+    style()->drawControl(QStyle::CE_Header, &option, painter, this);
+    painter->restore();
+}
+
+QSize TimeHeaderView::sectionSizeFromContents(int logicalIndex) const
+{
+    QSize size = QHeaderView::sectionSizeFromContents(logicalIndex);
+    if (m_showTime)
+        size.setWidth(size.width() + fontMetrics().horizontalAdvance("  @ 000.000 ms"));
+    return size;
+}
@@ -0,0 +1,30 @@
+#ifndef TIMEHEADERVIEW_H
+#define TIMEHEADERVIEW_H
+
+#include <QHeaderView>
+
+class TestTimeEstimator;
+
+// 向量表行表头：可选在行号旁显示该行开始执行的绝对时间，只为绘制到的可见行计算
+class TimeHeaderView : public QHeaderView
+{
+    Q_OBJECT
+
+public:
+    TimeHeaderView(TestTimeEstimator *estimator, QWidget *parent = nullptr);
+
+    bool isTimeVisible() const { return m_showTime; }
+
+public slots:
+    void setTimeVisible(bool visible);
+
+protected:
+    void paintSection(QPainter *painter, const QRect &rect, int logicalIndex) const override;
+    QSize sectionSizeFromContents(int logicalIndex) const override;
+
+private:
+    TestTimeEstimator *m_estimator;
+    bool m_showTime;
+};
+
+#endif // TIMEHEADERVIEW_H
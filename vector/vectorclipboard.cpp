@@ -0,0 +1,497 @@
+#include "vectorclipboard.h"
+#include "pinbuscolumns.h"
+#include "database/databasemanager.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QMimeData>
+#include <QDataStream>
+#include <QSqlQuery>
+#include <QHash>
+#include <QElapsedTimer>
+#include <QDebug>
+
+const char *const VectorClipboard::MIME_TYPE = "application/x-vecedit-vectors";
+
+namespace
+{
+    // 固定列数量：Label, Instruction, TimeSet, Capture, Ext, Comment
+    const int FIXED_COLUMNS = 6;
+
+    const quint32 BINARY_MAGIC = 0x56454342; // "VECB"
+    const quint16 BINARY_VERSION = 1;
+
+    // 管脚状态编码，与pin_options表的ID一致；0表示空，按X处理
+    const char PIN_STATES[] = " 01LHXZ";
+    const int PIN_STATE_X = 5;
+
+    // ASCII字符到管脚状态编码的查找表，无效字符为-1，大小写都可以
+    struct PinStateTable
+    {
+        qint8 codes[128];
+
+        PinStateTable()
+        {
+            for (int c = 0; c < 128; ++c)
+            {
+                codes[c] = -1;
+            }
+            for (int code = 1; code <= 6; ++code)
+            {
+                codes[int(PIN_STATES[code])] = qint8(code);
+                codes[QChar::toLower(uint(PIN_STATES[code]))] = qint8(code);
+            }
+        }
+    };
+
+    const PinStateTable &pinStateTable()
+    {
+        static const PinStateTable table;
+        return table;
+    }
+
+    // 单元格文本的管脚状态编码，空按X处理，无效返回-1
+    inline int pinStateCode(const QString &value)
+    {
+        if (value.isEmpty())
+            return PIN_STATE_X;
+        if (value.size() != 1)
+            return -1;
+
+        ushort c = value.at(0).unicode();
+        return c < 128 ? pinStateTable().codes[c] : -1;
+    }
+
+    inline QString pinStateText(int code)
+    {
+        return QString(QChar(PIN_STATES[(code >= 1 && code <= 6) ? code : PIN_STATE_X]));
+    }
+}
+
+int VectorClipboard::dataColumnCount(const QTableWidget *table)
+{
+    return table->columnCount() - PinBusColumns::busColumnCount(table);
+}
+
+int VectorClipboard::copySelection(QTableWidget *table, QString &errorMessage)
+{
+    QList<QTableWidgetSelectionRange> ranges = table->selectedRanges();
+    if (ranges.isEmpty())
+    {
+        errorMessage = "请先选择要复制的行或单元格";
+        return -1;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // 所有选区的行去重后按顺序复制，列取所有选区的并集
+    int dataColumns = dataColumnCount(table);
+    QVector<bool> rowSelected(table->rowCount(), false);
+    int left = dataColumns;
+    int right = -1;
+    for (const QTableWidgetSelectionRange &range : ranges)
+    {
+        for (int row = range.topRow(); row <= range.bottomRow(); ++row)
+        {
+            rowSelected[row] = true;
+        }
+        left = qMin(left, range.leftColumn());
+        right = qMax(right, qMin(range.rightColumn(), dataColumns - 1));
+    }
+
+    if (right < left)
+    {
+        errorMessage = "选中的列中没有可复制的数据(总线列不能复制)";
+        return -1;
+    }
+
+    // 表头第一行为列名或管脚名
+    QStringList headers;
+    QVector<bool> pinColumns;
+    for (int col = left; col <= right; ++col)
+    {
+        QTableWidgetItem *headerItem = table->horizontalHeaderItem(col);
+        headers << (headerItem ? headerItem->text().section('\n', 0, 0) : QString::number(col + 1));
+        pinColumns << (col >= FIXED_COLUMNS);
+    }
+    bool fullRows = (left == 0 && right == dataColumns - 1);
+
+    QVector<QStringList> rows;
+    for (int row = 0; row < rowSelected.size(); ++row)
+    {
+        if (!rowSelected[row])
+            continue;
+
+        QStringList cells;
+        cells.reserve(right - left + 1);
+        for (int col = left; col <= right; ++col)
+        {
+            QTableWidgetItem *item = table->item(row, col);
+            cells << (item ? item->text() : QString());
+        }
+        rows.append(cells);
+    }
+
+    QMimeData *mimeData = new QMimeData();
+    mimeData->setText(encodeTsv(rows));
+    mimeData->setData(MIME_TYPE, encodeBinary(headers, fullRows, pinColumns, rows));
+    QApplication::clipboard()->setMimeData(mimeData);
+
+    qDebug() << "VectorClipboard::copySelection - 复制行数:" << rows.size() << "列数:" << headers.size()
+             << "耗时(ms):" << timer.elapsed();
+    return rows.size();
+}
+
+int VectorClipboard::paste(QTableWidget *table, QString &errorMessage)
+{
+    const QMimeData *mimeData = QApplication::clipboard()->mimeData();
+    if (!mimeData)
+    {
+        errorMessage = "剪贴板为空";
+        return -1;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    int dataColumns = dataColumnCount(table);
+    int startRow = qMax(table->currentRow(), 0);
+
+    QVector<QStringList> rows;
+    QVector<int> targetColumns;
+    QStringList headers;
+    bool fullRows = false;
+
+    bool internal = mimeData->hasFormat(MIME_TYPE) && decodeBinary(mimeData->data(MIME_TYPE), headers, fullRows, rows);
+    if (!internal)
+        rows.clear();
+
+    if (internal && fullRows)
+    {
+        // 整行数据从第0列开始：固定列按位置，管脚列按管脚名对应，当前表没有的管脚丢弃
+        QHash<QString, int> targetPins;
+        for (int col = FIXED_COLUMNS; col < dataColumns; ++col)
+        {
+            QTableWidgetItem *headerItem = table->horizontalHeaderItem(col);
+            if (headerItem)
+                targetPins[headerItem->text().section('\n', 0, 0)] = col;
+        }
+
+        QVector<bool> covered(dataColumns, false);
+        for (int i = 0; i < headers.size(); ++i)
+        {
+            int col = (i < FIXED_COLUMNS) ? i : targetPins.value(headers[i], -1);
+            targetColumns << col;
+            if (col >= 0)
+                covered[col] = true;
+        }
+
+        // 源数据中没有的管脚置为X
+        for (int col = FIXED_COLUMNS; col < dataColumns; ++col)
+        {
+            if (covered[col])
+                continue;
+            targetColumns << col;
+            for (QStringList &cells : rows)
+            {
+                cells << "X";
+            }
+        }
+    }
+    else
+    {
+        // 内部格式的部分列或外部程序的TSV：从当前单元格开始按位置粘贴
+        if (!internal)
+            rows = decodeTsv(mimeData->text());
+
+        int startColumn = qMax(table->currentColumn(), 0);
+        if (startColumn >= dataColumns)
+        {
+            errorMessage = "不能粘贴到总线列，请选择固定列或管脚列";
+            return -1;
+        }
+
+        int width = 0;
+        for (const QStringList &cells : rows)
+        {
+            width = qMax(width, int(cells.size()));
+        }
+        if (startColumn + width > dataColumns)
+        {
+            errorMessage = QString("粘贴的数据有 %1 列，超出了表格从第 %2 列开始的范围").arg(width).arg(startColumn + 1);
+            return -1;
+        }
+        for (int i = 0; i < width; ++i)
+        {
+            targetColumns << startColumn + i;
+        }
+    }
+
+    if (rows.isEmpty() || targetColumns.isEmpty())
+    {
+        errorMessage = "剪贴板中没有可粘贴的数据";
+        return -1;
+    }
+
+    if (!applyRows(table, startRow, targetColumns, rows, errorMessage))
+        return -1;
+
+    qDebug() << "VectorClipboard::paste - 粘贴行数:" << rows.size() << "起始行:" << startRow + 1
+             << "耗时(ms):" << timer.elapsed();
+    return rows.size();
+}
+
+bool VectorClipboard::applyRows(QTableWidget *table, int startRow, const QVector<int> &targetColumns,
+                                const QVector<QStringList> &rows, QString &errorMessage)
+{
+    // 先校验全部管脚状态，有错误时不修改表格
+    for (int r = 0; r < rows.size(); ++r)
+    {
+        const QStringList &cells = rows[r];
+        for (int i = 0; i < cells.size() && i < targetColumns.size(); ++i)
+        {
+            int col = targetColumns[i];
+            if (col >= FIXED_COLUMNS && pinStateCode(cells[i].trimmed()) < 0)
+            {
+                errorMessage = QString("第 %1 行第 %2 列的管脚状态 \"%3\" 无效，只能是 0/1/L/H/X/Z")
+                                   .arg(startRow + r + 1)
+                                   .arg(col + 1)
+                                   .arg(cells[i]);
+                return false;
+            }
+        }
+    }
+
+    // 追加的行沿用最后一行的TimeSet，表格为空时使用第一个TimeSet，与添加向量行的默认值一致
+    int oldRowCount = table->rowCount();
+    int neededRows = startRow + rows.size();
+    QString defaultTimeSet;
+    if (neededRows > oldRowCount)
+    {
+        QTableWidgetItem *lastTimeSet = oldRowCount > 0 ? table->item(oldRowCount - 1, 2) : nullptr;
+        if (lastTimeSet && !lastTimeSet->text().isEmpty())
+        {
+            defaultTimeSet = lastTimeSet->text();
+        }
+        else
+        {
+            QSqlQuery query(DatabaseManager::instance()->database());
+            if (query.exec("SELECT timeset_name FROM timeset_list ORDER BY id LIMIT 1") && query.next())
+                defaultTimeSet = query.value(0).toString();
+        }
+
+        if (defaultTimeSet.isEmpty())
+        {
+            errorMessage = "粘贴需要追加新行，但项目中还没有TimeSet，请先添加TimeSet";
+            return false;
+        }
+    }
+
+    table->setUpdatesEnabled(false);
+
+    // 行数不够时一次性追加，新行的管脚默认为X，指令默认为INC
+    if (neededRows > oldRowCount)
+    {
+        int dataColumns = dataColumnCount(table);
+        table->setRowCount(neededRows);
+        for (int row = oldRowCount; row < neededRows; ++row)
+        {
+            table->setItem(row, 1, new QTableWidgetItem("INC"));
+            table->setItem(row, 2, new QTableWidgetItem(defaultTimeSet));
+            for (int col = FIXED_COLUMNS; col < dataColumns; ++col)
+            {
+                table->setItem(row, col, new QTableWidgetItem("X"));
+            }
+        }
+    }
+
+    for (int r = 0; r < rows.size(); ++r)
+    {
+        const QStringList &cells = rows[r];
+        int row = startRow + r;
+        for (int i = 0; i < cells.size() && i < targetColumns.size(); ++i)
+        {
+            int col = targetColumns[i];
+            if (col < 0)
+                continue;
+
+            QString text = (col >= FIXED_COLUMNS) ? pinStateText(pinStateCode(cells[i].trimmed())) : cells[i];
+            QTableWidgetItem *item = table->item(row, col);
+            if (!item)
+                table->setItem(row, col, new QTableWidgetItem(text));
+            else if (item->text() != text)
+                item->setText(text);
+        }
+    }
+
+    table->setUpdatesEnabled(true);
+    return true;
+}
+
+QString VectorClipboard::encodeTsv(const QVector<QStringList> &rows)
+{
+    QString text;
+    for (const QStringList &cells : rows)
+    {
+        for (int i = 0; i < cells.size(); ++i)
+        {
+            if (i > 0)
+                text += '\t';
+
+            // 含有制表符、换行或引号的字段按Excel的规则加引号
+            const QString &cell = cells[i];
+            if (cell.contains('\t') || cell.contains('\n') || cell.contains('\r') || cell.contains('"'))
+            {
+                QString escaped = cell;
+                escaped.replace("\"", "\"\"");
+                text += '"' + escaped + '"';
+            }
+            else
+            {
+                text += cell;
+            }
+        }
+        text += '\n';
+    }
+    return text;
+}
+
+QVector<QStringList> VectorClipboard::decodeTsv(const QString &text)
+{
+    QVector<QStringList> rows;
+    QStringList fields;
+    QString field;
+    bool quoted = false;
+
+    for (int i = 0; i < text.size(); ++i)
+    {
+        QChar c = text.at(i);
+        if (quoted)
+        {
+            if (c == '"')
+            {
+                if (i + 1 < text.size() && text.at(i + 1) == '"')
+                {
+                    field += '"';
+                    ++i;
+                }
+                else
+                {
+                    quoted = false;
+                }
+            }
+            else
+            {
+                field += c;
+            }
+        }
+        else if (c == '"' && field.isEmpty())
+        {
+            quoted = true;
+        }
+        else if (c == '\t')
+        {
+            fields << field;
+            field.clear();
+        }
+        else if (c == '\n' || c == '\r')
+        {
+            if (c == '\r' && i + 1 < text.size() && text.at(i + 1) == '\n')
+                ++i;
+            fields << field;
+            rows.append(fields);
+            fields.clear();
+            field.clear();
+        }
+        else
+        {
+            field += c;
+        }
+    }
+
+    // 最后一行可能没有换行符
+    if (!field.isEmpty() || !fields.isEmpty())
+    {
+        fields << field;
+        rows.append(fields);
+    }
+    return rows;
+}
+
+QByteArray VectorClipboard::encodeBinary(const QStringList &headers, bool fullRows, const QVector<bool> &pinColumns,
+                                         const QVector<QStringList> &rows)
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream << BINARY_MAGIC << BINARY_VERSION << headers << fullRows << pinColumns << qint32(rows.size());
+
+    // 每行：非管脚列的文本 + 管脚状态(每个4位，两个一字节)
+    int pinCount = pinColumns.count(true);
+    for (const QStringList &cells : rows)
+    {
+        QStringList texts;
+        QByteArray packed((pinCount + 1) / 2, 0);
+        int pin = 0;
+        for (int i = 0; i < cells.size(); ++i)
+        {
+            if (!pinColumns[i])
+            {
+                texts << cells[i];
+                continue;
+            }
+
+            int code = qMax(pinStateCode(cells[i]), 0);
+            packed[pin / 2] = char(packed[pin / 2] | (code << ((pin % 2) * 4)));
+            pin++;
+        }
+        stream << texts << packed;
+    }
+    return data;
+}
+
+bool VectorClipboard::decodeBinary(const QByteArray &data, QStringList &headers, bool &fullRows, QVector<QStringList> &rows)
+{
+    QDataStream stream(data);
+    quint32 magic = 0;
+    quint16 version = 0;
+    QVector<bool> pinColumns;
+    qint32 rowCount = 0;
+    stream >> magic >> version;
+    if (magic != BINARY_MAGIC || version != BINARY_VERSION)
+        return false;
+
+    stream >> headers >> fullRows >> pinColumns >> rowCount;
+    if (stream.status() != QDataStream::Ok || pinColumns.size() != headers.size() || rowCount < 0)
+        return false;
+
+    rows.clear();
+    rows.reserve(rowCount);
+    for (int r = 0; r < rowCount; ++r)
+    {
+        QStringList texts;
+        QByteArray packed;
+        stream >> texts >> packed;
+        if (stream.status() != QDataStream::Ok)
+            return false;
+
+        QStringList cells;
+        cells.reserve(pinColumns.size());
+        int text = 0;
+        int pin = 0;
+        for (int i = 0; i < pinColumns.size(); ++i)
+        {
+            if (!pinColumns[i])
+            {
+                cells << texts.value(text++);
+                continue;
+            }
+
+            int code = (pin / 2 < packed.size()) ? (uchar(packed[pin / 2]) >> ((pin % 2) * 4)) & 0xF : 0;
+            cells << pinStateText(code);
+            pin++;
+        }
+        rows.append(cells);
+    }
+    return true;
+}
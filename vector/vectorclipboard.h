@@ -0,0 +1,39 @@
+#ifndef VECTORCLIPBOARD_H
+#define VECTORCLIPBOARD_H
+
+#include <QTableWidget>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// 向量表复制粘贴：选中的行列同时以TSV文本(供Excel等外部程序)和紧凑的二进制格式(VecEdit内部)放入剪贴板
+// 二进制格式中管脚状态按4位一个打包；粘贴TSV时用查表法逐字符校验管脚列
+// 粘贴只修改表格，与其他编辑一样在保存时批量写入数据库
+class VectorClipboard
+{
+public:
+    // VecEdit内部使用的剪贴板格式
+    static const char *const MIME_TYPE;
+
+    // 复制选中范围，返回复制的行数，失败返回-1
+    static int copySelection(QTableWidget *table, QString &errorMessage);
+
+    // 从当前单元格开始粘贴(整行数据从第0列开始，按列名对应管脚)，行数不够时追加，返回粘贴的行数，失败返回-1
+    static int paste(QTableWidget *table, QString &errorMessage);
+
+private:
+    // 可复制粘贴的列：固定列和管脚列，不含末尾的总线列
+    static int dataColumnCount(const QTableWidget *table);
+
+    // 把单元格写入目标列(-1表示丢弃)，写入前校验所有管脚列的状态
+    static bool applyRows(QTableWidget *table, int startRow, const QVector<int> &targetColumns,
+                         const QVector<QStringList> &rows, QString &errorMessage);
+
+    static QString encodeTsv(const QVector<QStringList> &rows);
+    static QVector<QStringList> decodeTsv(const QString &text);
+    static QByteArray encodeBinary(const QStringList &headers, bool fullRows, const QVector<bool> &pinColumns,
+                                   const QVector<QStringList> &rows);
+    static bool decodeBinary(const QByteArray &data, QStringList &headers, bool &fullRows, QVector<QStringList> &rows);
+};
+
+#endif // VECTORCLIPBOARD_H
@@ -1,23 +1,35 @@
 #include "vectordatahandler.h"
 #include "database/databasemanager.h"
 #include "pin/pinvalueedit.h"
+#include "pinbuscolumns.h"
 
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QSet>
+#include <QHash>
+#include <QHeaderView>
+#include <QFontMetrics>
 #include <QDebug>
 #include <algorithm>
 
 VectorDataHandler::VectorDataHandler()
+    : m_loadedTableId(-1), m_loadedWidget(nullptr)
 {
 }
 
-bool VectorDataHandler::loadVectorTableData(int tableId, QTableWidget *tableWidget)
+bool VectorDataHandler::loadVectorTableData(int tableId, QTableWidget *tableWidget, int initialRows)
 {
     if (!tableWidget)
         return false;
 
+    // 记下当前显示的表的列宽，切换回来时直接复用
+    rememberColumnLayout(tableWidget);
+    cancelPendingRows();
+
+    // 加载期间暂停重绘，所有行列一次性设置好
+    tableWidget->setUpdatesEnabled(false);
+
     // 清空表格
     tableWidget->clear();
     tableWidget->setRowCount(0);
@@ -27,12 +39,13 @@ bool VectorDataHandler::loadVectorTableData(int tableId, QTableWidget *tableWidg
     QSqlDatabase db = DatabaseManager::instance()->database();
     if (!db.isOpen())
     {
+        tableWidget->setUpdatesEnabled(true);
         return false;
     }
 
     // 1. 获取表的管脚信息以设置表头
     QSqlQuery pinsQuery(db);
-    pinsQuery.prepare("SELECT vtp.id, pl.pin_name, vtp.pin_channel_count, topt.type_name "
+    pinsQuery.prepare("SELECT vtp.id, pl.pin_name, vtp.pin_channel_count, topt.type_name, vtp.pin_id "
                       "FROM vector_table_pins vtp "
                       "JOIN pin_list pl ON vtp.pin_id = pl.id "
                       "JOIN type_options topt ON vtp.pin_type = topt.id "
@@ -40,21 +53,15 @@ bool VectorDataHandler::loadVectorTableData(int tableId, QTableWidget *tableWidg
                       "ORDER BY pl.pin_name");
     pinsQuery.addBindValue(tableId);
 
-    QList<int> pinIds;
-    QMap<int, int> pinIdToColumn; // 管脚ID到列索引的映射
+    RowLoadState state;
+    state.tableId = tableId;
+    state.widget = tableWidget;
 
-    int columnIndex = 0;
+    QList<int> pinListIds; // 每个管脚列对应的pin_list ID
 
     // 固定列: 标签，指令，TimeSet，Capture，Ext，Comment
-    tableWidget->setColumnCount(6);
-    tableWidget->setHorizontalHeaderItem(0, new QTableWidgetItem("Label"));
-    tableWidget->setHorizontalHeaderItem(1, new QTableWidgetItem("Instruction"));
-    tableWidget->setHorizontalHeaderItem(2, new QTableWidgetItem("TimeSet"));
-    tableWidget->setHorizontalHeaderItem(3, new QTableWidgetItem("Capture"));
-    tableWidget->setHorizontalHeaderItem(4, new QTableWidgetItem("Ext"));
-    tableWidget->setHorizontalHeaderItem(5, new QTableWidgetItem("Comment"));
-
-    columnIndex = 6;
+    QStringList headers;
+    headers << "Label" << "Instruction" << "TimeSet" << "Capture" << "Ext" << "Comment";
 
     if (pinsQuery.exec())
     {
@@ -65,177 +72,321 @@ bool VectorDataHandler::loadVectorTableData(int tableId, QTableWidget *tableWidg
             int channelCount = pinsQuery.value(2).toInt();
             QString typeName = pinsQuery.value(3).toString();
 
-            pinIds.append(pinId);
-            pinIdToColumn[pinId] = columnIndex;
+            state.pinIdToColumn[pinId] = headers.size();
+            pinListIds.append(pinsQuery.value(4).toInt());
+            headers << pinName + "\nx" + QString::number(channelCount) + "\n" + typeName;
+        }
+    }
+
+    // 一次性设置列数和表头，表头的粗体由表格样式统一设置
+    tableWidget->setColumnCount(headers.size());
+    tableWidget->setHorizontalHeaderLabels(headers);
+    for (int col = 6; col < headers.size(); ++col)
+    {
+        tableWidget->horizontalHeaderItem(col)->setTextAlignment(Qt::AlignCenter);
+        tableWidget->horizontalHeaderItem(col)->setData(Qt::UserRole, pinListIds[col - 6]);
+    }
+
+    // 2. 先按总行数设置行数，滚动条立即可用，行数据按排序分批读取
+    normalizeNullSortIndexes(db, tableId);
+    state.totalRows = getVectorTableRowCount(tableId);
+    tableWidget->setRowCount(state.totalRows);
+    m_rowLoad = state;
+
+    int firstRows = initialRows < 0 ? state.totalRows : qMin(initialRows, state.totalRows);
+    while (m_rowLoad.nextRow < firstRows)
+    {
+        if (loadRowChunk(qMin(firstRows - m_rowLoad.nextRow, int(LOAD_CHUNK_ROWS))) <= 0)
+            break;
+    }
+
+    // 调整列宽
+    applyColumnLayout(tableId, tableWidget, headers);
+
+    tableWidget->setUpdatesEnabled(true);
+
+    if (!hasPendingRows())
+    {
+        finishRowLoad();
+    }
+    return true;
+}
+
+int VectorDataHandler::loadPendingRows(QTableWidget *tableWidget, int maxRows)
+{
+    if (!hasPendingRows() || m_rowLoad.widget != tableWidget)
+        return 0;
+
+    tableWidget->setUpdatesEnabled(false);
+    int loaded = loadRowChunk(maxRows);
+    tableWidget->setUpdatesEnabled(true);
+
+    if (loaded <= 0 || !hasPendingRows())
+    {
+        finishRowLoad();
+    }
+    return qMax(loaded, 0);
+}
+
+void VectorDataHandler::loadAllPendingRows(QTableWidget *tableWidget)
+{
+    while (hasPendingRows() && m_rowLoad.widget == tableWidget)
+    {
+        if (loadPendingRows(tableWidget, LOAD_CHUNK_ROWS) <= 0)
+            break;
+    }
+}
+
+void VectorDataHandler::cancelPendingRows()
+{
+    m_rowLoad = RowLoadState();
+}
+
+void VectorDataHandler::normalizeNullSortIndexes(QSqlDatabase &db, int tableId)
+{
+    // 走(table_id, sort_index)索引，没有空值时只是一次索引查找
+    QSqlQuery query(db);
+    query.prepare("SELECT id FROM vector_table_data WHERE table_id = ? AND sort_index IS NULL ORDER BY id");
+    query.addBindValue(tableId);
+    if (!query.exec())
+    {
+        qWarning() << "VectorDataHandler::normalizeNullSortIndexes - 查询失败:" << query.lastError().text();
+        return;
+    }
 
-            // 添加管脚列
-            tableWidget->insertColumn(columnIndex);
+    QList<int> ids;
+    while (query.next())
+        ids.append(query.value(0).toInt());
+    if (ids.isEmpty())
+        return;
 
-            // 创建自定义表头
-            QTableWidgetItem *headerItem = new QTableWidgetItem();
-            headerItem->setText(pinName + "\nx" + QString::number(channelCount) + "\n" + typeName);
-            headerItem->setTextAlignment(Qt::AlignCenter);
-            QFont headerFont = headerItem->font();
-            headerFont.setBold(true);
-            headerItem->setFont(headerFont);
+    // 保持原来的显示顺序：空值行按ID排在所有已排序的行之前
+    qint64 firstSortIndex = 0;
+    query.prepare("SELECT MIN(sort_index) FROM vector_table_data WHERE table_id = ?");
+    query.addBindValue(tableId);
+    if (query.exec() && query.next() && !query.value(0).isNull())
+        firstSortIndex = query.value(0).toLongLong();
+    firstSortIndex -= ids.size();
 
-            tableWidget->setHorizontalHeaderItem(columnIndex, headerItem);
-            columnIndex++;
+    db.transaction();
+    QSqlQuery updateQuery(db);
+    updateQuery.prepare("UPDATE vector_table_data SET sort_index = ? WHERE id = ?");
+    for (int i = 0; i < ids.size(); ++i)
+    {
+        updateQuery.bindValue(0, firstSortIndex + i);
+        updateQuery.bindValue(1, ids[i]);
+        if (!updateQuery.exec())
+        {
+            qWarning() << "VectorDataHandler::normalizeNullSortIndexes - 更新失败:" << updateQuery.lastError().text();
+            db.rollback();
+            return;
         }
     }
+    db.commit();
+
+    qDebug() << "VectorDataHandler::normalizeNullSortIndexes - 表ID:" << tableId << "补全sort_index的行数:" << ids.size();
+}
+
+int VectorDataHandler::loadRowChunk(int maxRows)
+{
+    QTableWidget *tableWidget = m_rowLoad.widget;
+    QSqlDatabase db = DatabaseManager::instance()->database();
+    if (!tableWidget || !db.isOpen() || maxRows <= 0)
+        return -1;
 
-    // 2. 获取向量表数据
+    // 按(sort_index, id)接着上一批读取，走(table_id, sort_index)索引，不随已读行数变慢
     QSqlQuery dataQuery(db);
+    dataQuery.setForwardOnly(true);
     dataQuery.prepare("SELECT vtd.id, vtd.label, io.instruction_value, tl.timeset_name, "
                       "vtd.capture, vtd.ext, vtd.comment, vtd.sort_index "
                       "FROM vector_table_data vtd "
-                      "JOIN instruction_options io ON vtd.instruction_id = io.id "
+                      "LEFT JOIN instruction_options io ON vtd.instruction_id = io.id "
                       "LEFT JOIN timeset_list tl ON vtd.timeset_id = tl.id "
-                      "WHERE vtd.table_id = ? "
-                      "ORDER BY vtd.sort_index");
-    dataQuery.addBindValue(tableId);
-
-    if (dataQuery.exec())
+                      "WHERE vtd.table_id = ? AND (vtd.sort_index, vtd.id) > (?, ?) "
+                      "ORDER BY vtd.sort_index, vtd.id "
+                      "LIMIT ?");
+    dataQuery.addBindValue(m_rowLoad.tableId);
+    dataQuery.addBindValue(m_rowLoad.lastSortIndex);
+    dataQuery.addBindValue(m_rowLoad.lastId);
+    dataQuery.addBindValue(maxRows);
+
+    if (!dataQuery.exec())
     {
-        QMap<int, int> vectorDataIdToRow; // 向量数据ID到行索引的映射
-        int rowIndex = 0;
+        qWarning() << "VectorDataHandler::loadRowChunk - 查询向量行失败:" << dataQuery.lastError().text();
+        return -1;
+    }
 
-        while (dataQuery.next())
+    int firstRow = m_rowLoad.nextRow;
+    int row = firstRow;
+    QHash<int, int> vectorDataIdToRow; // 向量数据ID到行索引的映射
+    QStringList idList;
+    while (dataQuery.next() && row < tableWidget->rowCount())
+    {
+        int vectorDataId = dataQuery.value(0).toInt();
+
+        // 修改Capture列显示逻辑，当值为"0"时显示为空白
+        QString capture = dataQuery.value(4).toString();
+        QStringList values;
+        values << dataQuery.value(1).toString()
+               << dataQuery.value(2).toString()
+               << dataQuery.value(3).toString()
+               << ((capture == "0") ? "" : capture)
+               << dataQuery.value(5).toString()
+               << dataQuery.value(6).toString();
+        for (int col = 0; col < values.size(); ++col)
         {
-            int vectorDataId = dataQuery.value(0).toInt();
-            QString label = dataQuery.value(1).toString();
-            QString instruction = dataQuery.value(2).toString();
-            QString timeset = dataQuery.value(3).toString();
-            QString capture = dataQuery.value(4).toString();
-            QString ext = dataQuery.value(5).toString();
-            QString comment = dataQuery.value(6).toString();
-
-            // 添加新行
-            tableWidget->insertRow(rowIndex);
-
-            // 设置固定列数据
-            tableWidget->setItem(rowIndex, 0, new QTableWidgetItem(label));
-            tableWidget->setItem(rowIndex, 1, new QTableWidgetItem(instruction));
-            tableWidget->setItem(rowIndex, 2, new QTableWidgetItem(timeset));
-
-            // 修改Capture列显示逻辑，当值为"0"时显示为空白
-            QString captureDisplay = (capture == "0") ? "" : capture;
-            tableWidget->setItem(rowIndex, 3, new QTableWidgetItem(captureDisplay));
-
-            tableWidget->setItem(rowIndex, 4, new QTableWidgetItem(ext));
-            tableWidget->setItem(rowIndex, 5, new QTableWidgetItem(comment));
-
-            vectorDataIdToRow[vectorDataId] = rowIndex;
-            rowIndex++;
-        }
-
-        // 3. 获取管脚数值 - 直接从数据库中查询pin_options表获取值
-        QSqlQuery valueQuery(db);
-        QString valueQueryStr = QString(
-                                    "SELECT vtd.id AS vector_data_id, "
-                                    "       vtp.id AS vector_pin_id, "
-                                    "       po.pin_value "
-                                    "FROM vector_table_data vtd "
-                                    "JOIN vector_table_pin_values vtpv ON vtd.id = vtpv.vector_data_id "
-                                    "JOIN vector_table_pins vtp ON vtpv.vector_pin_id = vtp.id "
-                                    "JOIN pin_options po ON vtpv.pin_level = po.id "
-                                    "WHERE vtd.table_id = %1 "
-                                    "ORDER BY vtd.sort_index")
-                                    .arg(tableId);
-
-        if (valueQuery.exec(valueQueryStr))
-        {
-            int count = 0;
-            while (valueQuery.next())
-            {
-                int vectorDataId = valueQuery.value(0).toInt();
-                int vectorPinId = valueQuery.value(1).toInt();
-                QString pinValue = valueQuery.value(2).toString();
-                count++;
+            tableWidget->setItem(row, col, new QTableWidgetItem(values[col]));
+        }
+        // 第0列保存vector_table_data的ID，用于关联分组覆盖值
+        tableWidget->item(row, 0)->setData(Qt::UserRole, vectorDataId);
+
+        vectorDataIdToRow[vectorDataId] = row;
+        idList << QString::number(vectorDataId);
+        m_rowLoad.lastSortIndex = dataQuery.value(7).toLongLong();
+        m_rowLoad.lastId = vectorDataId;
+        ++row;
+    }
+    m_rowLoad.nextRow = row;
 
-                // 找到对应的行和列
-                if (vectorDataIdToRow.contains(vectorDataId) && pinIdToColumn.contains(vectorPinId))
-                {
-                    int row = vectorDataIdToRow[vectorDataId];
-                    int col = pinIdToColumn[vectorPinId];
+    // 数据库中的行已读完；比加载开始时统计的少时去掉剩下的空行
+    if (row - firstRow < maxRows)
+    {
+        if (row < tableWidget->rowCount())
+        {
+            tableWidget->setRowCount(row);
+        }
+        m_rowLoad.totalRows = row;
+    }
 
-                    // 设置单元格值
-                    tableWidget->setItem(row, col, new QTableWidgetItem(pinValue));
-                }
-            }
+    if (idList.isEmpty())
+        return 0;
+
+    // 3. 获取这一批行的管脚数值，pin_options中没有的等级直接显示ID
+    QSqlQuery valueQuery(db);
+    valueQuery.setForwardOnly(true);
+    QString valueQueryStr = QString(
+                                "SELECT vtd.id, vtpv.vector_pin_id, vtpv.pin_level, po.pin_value "
+                                "FROM vector_table_data vtd "
+                                "JOIN vector_table_pin_values vtpv ON vtpv.vector_data_id = +vtd.id "
+                                "LEFT JOIN pin_options po ON vtpv.pin_level = po.id "
+                                "WHERE vtd.id IN (%1)")
+                                .arg(idList.join(','));
+
+    if (valueQuery.exec(valueQueryStr))
+    {
+        while (valueQuery.next())
+        {
+            int itemRow = vectorDataIdToRow.value(valueQuery.value(0).toInt(), -1);
+            int col = m_rowLoad.pinIdToColumn.value(valueQuery.value(1).toInt(), -1);
 
-            // 如果没有找到任何记录，尝试直接使用pin_level值
-            if (count == 0)
+            // 设置单元格值
+            if (itemRow >= 0 && col >= 0)
             {
-                QSqlQuery fallbackQuery(db);
-                QString fallbackQueryStr = QString(
-                                               "SELECT vtd.id AS vector_data_id, "
-                                               "       vtp.id AS vector_pin_id, "
-                                               "       vtpv.pin_level "
-                                               "FROM vector_table_data vtd "
-                                               "JOIN vector_table_pin_values vtpv ON vtd.id = vtpv.vector_data_id "
-                                               "JOIN vector_table_pins vtp ON vtpv.vector_pin_id = vtp.id "
-                                               "WHERE vtd.table_id = %1 "
-                                               "ORDER BY vtd.sort_index")
-                                               .arg(tableId);
-
-                if (fallbackQuery.exec(fallbackQueryStr))
-                {
-                    while (fallbackQuery.next())
-                    {
-                        int vectorDataId = fallbackQuery.value(0).toInt();
-                        int vectorPinId = fallbackQuery.value(1).toInt();
-                        int pinLevelId = fallbackQuery.value(2).toInt();
-
-                        // 尝试从pin_options表获取实际值
-                        QSqlQuery getPinValue(db);
-                        QString pinValue;
-
-                        getPinValue.prepare("SELECT pin_value FROM pin_options WHERE id = ?");
-                        getPinValue.addBindValue(pinLevelId);
-
-                        if (getPinValue.exec() && getPinValue.next())
-                        {
-                            pinValue = getPinValue.value(0).toString();
-                        }
-                        else
-                        {
-                            // 如果获取失败，直接使用ID作为字符串
-                            pinValue = QString::number(pinLevelId);
-                        }
-
-                        // 找到对应的行和列
-                        if (vectorDataIdToRow.contains(vectorDataId) && pinIdToColumn.contains(vectorPinId))
-                        {
-                            int row = vectorDataIdToRow[vectorDataId];
-                            int col = pinIdToColumn[vectorPinId];
-
-                            // 设置单元格值
-                            tableWidget->setItem(row, col, new QTableWidgetItem(pinValue));
-                        }
-                    }
-                }
+                QString pinValue = valueQuery.value(3).isNull() ? valueQuery.value(2).toString()
+                                                                 : valueQuery.value(3).toString();
+                tableWidget->setItem(itemRow, col, new QTableWidgetItem(pinValue));
             }
         }
     }
-
-    // 调整列宽
-    tableWidget->resizeColumnsToContents();
+    else
+    {
+        qWarning() << "VectorDataHandler::loadRowChunk - 查询管脚数值失败:" << valueQuery.lastError().text();
+    }
 
     // 确保所有管脚单元格都有默认值"X"
-    for (int row = 0; row < tableWidget->rowCount(); ++row)
+    for (int itemRow = firstRow; itemRow < row; ++itemRow)
     {
         for (int col = 6; col < tableWidget->columnCount(); ++col)
         {
-            QTableWidgetItem *item = tableWidget->item(row, col);
+            QTableWidgetItem *item = tableWidget->item(itemRow, col);
             if (!item || item->text().isEmpty())
             {
-                tableWidget->setItem(row, col, new QTableWidgetItem("X"));
+                tableWidget->setItem(itemRow, col, new QTableWidgetItem("X"));
             }
         }
     }
 
-    return true;
+    return row - firstRow;
+}
+
+void VectorDataHandler::finishRowLoad()
+{
+    qDebug() << "VectorDataHandler::finishRowLoad - 表ID:" << m_rowLoad.tableId << "加载完成，行数:" << m_rowLoad.nextRow;
+    cancelPendingRows();
+}
+
+QString VectorDataHandler::pinValuesInsertSql(int pinCount)
+{
+    QStringList values;
+    for (int i = 0; i < pinCount; ++i)
+    {
+        values << "(?, ?, ?)";
+    }
+    return "INSERT INTO vector_table_pin_values (vector_data_id, vector_pin_id, pin_level) VALUES " + values.join(", ");
+}
+
+void VectorDataHandler::rememberColumnLayout(QTableWidget *tableWidget)
+{
+    if (m_loadedTableId < 0 || m_loadedWidget != tableWidget)
+        return;
+
+    // 表格末尾可能还有总线列，只记录加载时的列；隐藏的列保留原宽度
+    auto it = m_columnLayouts.find(m_loadedTableId);
+    if (it == m_columnLayouts.end() || it->widths.size() > tableWidget->columnCount())
+        return;
+
+    for (int col = 0; col < it->widths.size(); ++col)
+    {
+        if (!tableWidget->isColumnHidden(col))
+            it->widths[col] = tableWidget->columnWidth(col);
+    }
+}
+
+void VectorDataHandler::applyColumnLayout(int tableId, QTableWidget *tableWidget, const QStringList &headers)
+{
+    m_loadedTableId = tableId;
+    m_loadedWidget = tableWidget;
+
+    // 表头没有变化(管脚未增删改名)时复用上次的列宽
+    auto it = m_columnLayouts.constFind(tableId);
+    if (it != m_columnLayouts.constEnd() && it->headers == headers)
+    {
+        for (int col = 0; col < it->widths.size(); ++col)
+        {
+            tableWidget->setColumnWidth(col, it->widths[col]);
+        }
+        return;
+    }
+
+    ColumnLayout layout;
+    layout.headers = headers;
+    layout.widths.resize(headers.size());
+
+    // 固定列按内容计算宽度，只取可见行附近的少量行，不随表的行数增长
+    QHeaderView *header = tableWidget->horizontalHeader();
+    header->setResizeContentsPrecision(RESIZE_SAMPLE_ROWS);
+    for (int col = 0; col < qMin(6, headers.size()); ++col)
+    {
+        tableWidget->resizeColumnToContents(col);
+        layout.widths[col] = tableWidget->columnWidth(col);
+    }
+
+    // 管脚列的内容只有一个字符，宽度由表头决定，直接按表头文字计算，不逐个单元格测量
+    QFont headerFont = header->font();
+    headerFont.setBold(true);
+    QFontMetrics metrics(headerFont);
+    for (int col = 6; col < headers.size(); ++col)
+    {
+        int textWidth = 0;
+        for (const QString &line : headers[col].split('\n'))
+        {
+            textWidth = qMax(textWidth, metrics.horizontalAdvance(line));
+        }
+        layout.widths[col] = textWidth + PIN_COLUMN_PADDING;
+        tableWidget->setColumnWidth(col, layout.widths[col]);
+    }
+
+    m_columnLayouts[tableId] = layout;
 }
 
 bool VectorDataHandler::saveVectorTableData(int tableId, QTableWidget *tableWidget, QString &errorMessage)
@@ -260,7 +411,15 @@ bool VectorDataHandler::saveVectorTableData(int tableId, QTableWidget *tableWidg
 
     try
     {
-        // 清除现有数据 - 先删除关联的pin_values，再删除主数据
+        // 清除现有数据 - 先删除关联的分组覆盖值和pin_values，再删除主数据
+        query.prepare("DELETE FROM vector_table_group_values WHERE vector_data_id IN "
+                      "(SELECT id FROM vector_table_data WHERE table_id = ?)");
+        query.addBindValue(tableId);
+        if (!query.exec())
+        {
+            throw QString("无法清除关联的分组值数据: " + query.lastError().text());
+        }
+
         query.prepare("DELETE FROM vector_table_pin_values WHERE vector_data_id IN "
                       "(SELECT id FROM vector_table_data WHERE table_id = ?)");
         query.addBindValue(tableId);
@@ -299,6 +458,55 @@ bool VectorDataHandler::saveVectorTableData(int tableId, QTableWidget *tableWidg
             throw QString("没有找到任何关联的管脚");
         }
 
+        // 总线列中的单元格项是分组级覆盖值，分组值本身由成员管脚推导，不保存
+        QList<QPair<int, int>> busColumns; // 列 -> 分组ID
+        for (int col = 6 + pinIds.size(); col < tableWidget->columnCount(); ++col)
+        {
+            QTableWidgetItem *headerItem = tableWidget->horizontalHeaderItem(col);
+            if (headerItem && headerItem->data(PinBusColumns::BusGroupRole).isValid())
+                busColumns.append(qMakePair(col, headerItem->data(PinBusColumns::BusGroupRole).toInt()));
+        }
+
+        // 指令、TimeSet和管脚状态一次性读入，逐行保存时不再查询
+        QHash<QString, int> instructionIds;
+        if (query.exec("SELECT id, instruction_value FROM instruction_options"))
+        {
+            while (query.next())
+                instructionIds[query.value(1).toString()] = query.value(0).toInt();
+        }
+
+        QHash<QString, int> timeSetIds;
+        if (query.exec("SELECT id, timeset_name FROM timeset_list"))
+        {
+            while (query.next())
+                timeSetIds[query.value(1).toString()] = query.value(0).toInt();
+        }
+
+        QHash<QString, int> pinOptionIds;
+        if (query.exec("SELECT id, pin_value FROM pin_options"))
+        {
+            while (query.next())
+                pinOptionIds[query.value(1).toString()] = query.value(0).toInt();
+        }
+
+        // 语句只准备一次；管脚值每条语句插入多个管脚，减少语句执行次数
+        QSqlQuery insertRowQuery(db);
+        insertRowQuery.prepare("INSERT INTO vector_table_data "
+                               "(table_id, label, instruction_id, timeset_id, capture, ext, comment, sort_index) "
+                               "VALUES (?, ?, ?, ?, ?, ?, ?, ?)");
+
+        int pinsPerStatement = qMin(int(pinIds.size()), int(PINS_PER_INSERT));
+        int remainderPins = pinIds.size() % pinsPerStatement;
+        QSqlQuery pinDataQuery(db);
+        pinDataQuery.prepare(pinValuesInsertSql(pinsPerStatement));
+        QSqlQuery remainderPinDataQuery(db);
+        if (remainderPins > 0)
+            remainderPinDataQuery.prepare(pinValuesInsertSql(remainderPins));
+
+        QSqlQuery groupValueQuery(db);
+        groupValueQuery.prepare("INSERT INTO vector_table_group_values "
+                                "(vector_data_id, group_id, group_level) VALUES (?, ?, ?)");
+
         // 逐行保存数据
         for (int row = 0; row < tableWidget->rowCount(); ++row)
         {
@@ -310,45 +518,23 @@ bool VectorDataHandler::saveVectorTableData(int tableId, QTableWidget *tableWidg
             QString ext = tableWidget->item(row, 4) ? tableWidget->item(row, 4)->text() : "";
             QString comment = tableWidget->item(row, 5) ? tableWidget->item(row, 5)->text() : "";
 
-            // 获取指令ID
-            int instructionId = 1; // 默认为1 (VECTOR)
-            if (!instruction.isEmpty())
-            {
-                QSqlQuery instrQuery(db);
-                instrQuery.prepare("SELECT id FROM instruction_options WHERE instruction_value = ?");
-                instrQuery.addBindValue(instruction);
-                if (instrQuery.exec() && instrQuery.next())
-                {
-                    instructionId = instrQuery.value(0).toInt();
-                }
-            }
-
-            // 获取时间集ID
-            int timeSetId = -1;
-            if (!timeSet.isEmpty())
+            // 指令ID默认为1；timeset_id不能为空，TimeSet不存在时给出具体的行号
+            int instructionId = instructionIds.value(instruction, 1);
+            int timeSetId = timeSetIds.value(timeSet, -1);
+            if (timeSetId <= 0)
             {
-                QSqlQuery timeSetQuery(db);
-                timeSetQuery.prepare("SELECT id FROM timeset_list WHERE timeset_name = ?");
-                timeSetQuery.addBindValue(timeSet);
-                if (timeSetQuery.exec() && timeSetQuery.next())
-                {
-                    timeSetId = timeSetQuery.value(0).toInt();
-                }
+                throw QString("第 %1 行的TimeSet \"%2\" 不存在，请先设置有效的TimeSet").arg(row + 1).arg(timeSet);
             }
 
             // 插入行数据
-            QSqlQuery insertRowQuery(db);
-            insertRowQuery.prepare("INSERT INTO vector_table_data "
-                                   "(table_id, label, instruction_id, timeset_id, capture, ext, comment, sort_index) "
-                                   "VALUES (?, ?, ?, ?, ?, ?, ?, ?)");
-            insertRowQuery.addBindValue(tableId);
-            insertRowQuery.addBindValue(label);
-            insertRowQuery.addBindValue(instructionId);
-            insertRowQuery.addBindValue(timeSetId > 0 ? timeSetId : QVariant());
-            insertRowQuery.addBindValue(capture == "Y" ? 1 : 0);
-            insertRowQuery.addBindValue(ext);
-            insertRowQuery.addBindValue(comment);
-            insertRowQuery.addBindValue(row);
+            insertRowQuery.bindValue(0, tableId);
+            insertRowQuery.bindValue(1, label);
+            insertRowQuery.bindValue(2, instructionId);
+            insertRowQuery.bindValue(3, timeSetId);
+            insertRowQuery.bindValue(4, capture == "Y" ? 1 : 0);
+            insertRowQuery.bindValue(5, ext);
+            insertRowQuery.bindValue(6, comment);
+            insertRowQuery.bindValue(7, row);
 
             if (!insertRowQuery.exec())
             {
@@ -359,47 +545,48 @@ bool VectorDataHandler::saveVectorTableData(int tableId, QTableWidget *tableWidg
             int rowId = insertRowQuery.lastInsertId().toInt();
 
             // 保存管脚数据
-            for (int i = 0; i < pinIds.size(); ++i)
+            for (int first = 0; first < pinIds.size(); first += pinsPerStatement)
             {
-                int pinCol = i + 6; // 管脚从第6列开始
-                QString pinValue = tableWidget->item(row, pinCol) ? tableWidget->item(row, pinCol)->text() : "X";
+                int count = qMin(pinsPerStatement, pinIds.size() - first);
+                QSqlQuery &pinQuery = (count == pinsPerStatement) ? pinDataQuery : remainderPinDataQuery;
 
-                // 如果值为空，使用默认值"X"
-                if (pinValue.isEmpty())
+                for (int i = 0; i < count; ++i)
                 {
-                    pinValue = "X";
-                }
+                    int pinCol = first + i + 6; // 管脚从第6列开始
+                    QString pinValue = tableWidget->item(row, pinCol) ? tableWidget->item(row, pinCol)->text() : "X";
 
-                // 获取pin_option_id
-                int pinOptionId = 5; // 默认为X (id=5)
-                QSqlQuery pinOptionQuery(db);
-                pinOptionQuery.prepare("SELECT id FROM pin_options WHERE pin_value = ?");
-                pinOptionQuery.addBindValue(pinValue);
-                if (pinOptionQuery.exec() && pinOptionQuery.next())
-                {
-                    pinOptionId = pinOptionQuery.value(0).toInt();
+                    // 空值或无效值使用默认值X (id=5)
+                    pinQuery.bindValue(i * 3, rowId);
+                    pinQuery.bindValue(i * 3 + 1, pinIds[first + i]);
+                    pinQuery.bindValue(i * 3 + 2, pinOptionIds.value(pinValue, 5));
                 }
-                else
+
+                if (!pinQuery.exec())
                 {
-                    // 如果查询失败或没有找到对应的值，确保使用默认值X的ID
-                    pinOptionId = 5; // X的ID固定为5
+                    throw QString("保存行 " + QString::number(row + 1) + " 的管脚 " + pinNames[first] + " 等数据失败: " +
+                                  pinQuery.lastError().text());
                 }
+            }
 
-                // 插入管脚数据
-                QSqlQuery pinDataQuery(db);
-                pinDataQuery.prepare("INSERT INTO vector_table_pin_values "
-                                     "(vector_data_id, vector_pin_id, pin_level) VALUES (?, ?, ?)");
-                pinDataQuery.addBindValue(rowId);
-                pinDataQuery.addBindValue(pinIds[i]);
-                pinDataQuery.addBindValue(pinOptionId);
+            // 保存分组级覆盖值
+            for (const auto &busColumn : busColumns)
+            {
+                QTableWidgetItem *item = tableWidget->item(row, busColumn.first);
+                if (!item || item->text().isEmpty())
+                    continue;
 
-                if (!pinDataQuery.exec())
+                groupValueQuery.bindValue(0, rowId);
+                groupValueQuery.bindValue(1, busColumn.second);
+                groupValueQuery.bindValue(2, item->text());
+                if (!groupValueQuery.exec())
                 {
-                    throw QString("保存管脚 " + pinNames[i] + " 数据失败: " + pinDataQuery.lastError().text());
+                    throw QString("保存行 " + QString::number(row + 1) + " 的分组值失败: " + groupValueQuery.lastError().text());
                 }
             }
         }
 
+        qDebug() << "VectorDataHandler::saveVectorTableData - 表ID:" << tableId << "保存行数:" << tableWidget->rowCount();
+
         // 提交事务
         db.commit();
         return true;
@@ -444,7 +631,15 @@ bool VectorDataHandler::deleteVectorTable(int tableId, QString &errorMessage)
 
     try
     {
-        // 先删除与该表关联的管脚值数据
+        // 先删除与该表关联的分组覆盖值和管脚值数据
+        query.prepare("DELETE FROM vector_table_group_values WHERE vector_data_id IN "
+                      "(SELECT id FROM vector_table_data WHERE table_id = ?)");
+        query.addBindValue(tableId);
+        if (!query.exec())
+        {
+            throw QString("删除分组值数据失败: " + query.lastError().text());
+        }
+
         query.prepare("DELETE FROM vector_table_pin_values WHERE vector_data_id IN "
                       "(SELECT id FROM vector_table_data WHERE table_id = ?)");
         query.addBindValue(tableId);
@@ -490,6 +685,153 @@ bool VectorDataHandler::deleteVectorTable(int tableId, QString &errorMessage)
     }
 }
 
+qint64 VectorDataHandler::copyIdOffset(QSqlDatabase &db, const QString &tableName, const QString &idColumn, int sourceTableId)
+{
+    // AUTOINCREMENT表的ID不会重用，已删除的最大ID记录在sqlite_sequence中，也要排在它之后
+    QSqlQuery query(db);
+    query.prepare(QString("SELECT MAX(COALESCE((SELECT seq FROM sqlite_sequence WHERE name = '%1'), 0), "
+                          "COALESCE((SELECT MAX(%2) FROM %1), 0)) "
+                          "- COALESCE((SELECT MIN(%2) FROM %1 WHERE table_id = ?), 0) + 1")
+                      .arg(tableName, idColumn));
+    query.addBindValue(sourceTableId);
+    if (!query.exec() || !query.next())
+    {
+        throw QString("计算%1的ID失败: %2").arg(tableName, query.lastError().text());
+    }
+    return query.value(0).toLongLong();
+}
+
+bool VectorDataHandler::duplicateVectorTable(int sourceTableId, const QString &newTableName, int &newTableId, QString &errorMessage)
+{
+    // 获取数据库连接
+    QSqlDatabase db = DatabaseManager::instance()->database();
+    if (!db.isOpen())
+    {
+        errorMessage = "数据库未打开";
+        return false;
+    }
+
+    db.transaction();
+    QSqlQuery query(db);
+
+    try
+    {
+        // 向量表记录
+        query.prepare("INSERT INTO vector_tables (table_name, table_nav_note) "
+                      "SELECT ?, table_nav_note FROM vector_tables WHERE id = ?");
+        query.addBindValue(newTableName);
+        query.addBindValue(sourceTableId);
+        if (!query.exec())
+        {
+            throw QString("创建向量表记录失败: " + query.lastError().text());
+        }
+        if (query.numRowsAffected() != 1)
+        {
+            throw QString("源向量表不存在");
+        }
+        newTableId = query.lastInsertId().toInt();
+
+        // 新行、新管脚列和新分组的ID = 源ID + 偏移，引用关系直接按偏移换算，不需要逐行建立映射
+        const qint64 pinOffset = copyIdOffset(db, "vector_table_pins", "id", sourceTableId);
+        const qint64 groupOffset = copyIdOffset(db, "pin_groups", "group_id", sourceTableId);
+        const qint64 rowOffset = copyIdOffset(db, "vector_table_data", "id", sourceTableId);
+
+        // 管脚列
+        query.prepare("INSERT INTO vector_table_pins (id, table_id, pin_id, pin_channel_count, pin_type) "
+                      "SELECT id + ?, ?, pin_id, pin_channel_count, pin_type FROM vector_table_pins WHERE table_id = ?");
+        query.addBindValue(pinOffset);
+        query.addBindValue(newTableId);
+        query.addBindValue(sourceTableId);
+        if (!query.exec())
+        {
+            throw QString("复制管脚列失败: " + query.lastError().text());
+        }
+
+        // 分组名在整个项目中唯一，复制的分组加上新表名作为后缀
+        query.prepare("INSERT INTO pin_groups (group_id, table_id, group_name, group_channel_count, group_type) "
+                      "SELECT group_id + ?, ?, group_name || '_' || ?, group_channel_count, group_type "
+                      "FROM pin_groups WHERE table_id = ?");
+        query.addBindValue(groupOffset);
+        query.addBindValue(newTableId);
+        query.addBindValue(newTableName);
+        query.addBindValue(sourceTableId);
+        if (!query.exec())
+        {
+            throw QString("复制管脚分组失败: " + query.lastError().text());
+        }
+
+        query.prepare("INSERT INTO pin_group_members (group_id, pin_id, sort_index) "
+                      "SELECT m.group_id + ?, m.pin_id, m.sort_index FROM pin_group_members m "
+                      "JOIN pin_groups g ON g.group_id = m.group_id WHERE g.table_id = ?");
+        query.addBindValue(groupOffset);
+        query.addBindValue(sourceTableId);
+        if (!query.exec())
+        {
+            throw QString("复制分组成员失败: " + query.lastError().text());
+        }
+
+        // 行数据，TimeSet引用计数由触发器随插入维护
+        query.prepare("INSERT INTO vector_table_data "
+                      "(id, table_id, label, instruction_id, timeset_id, capture, ext, comment, sort_index) "
+                      "SELECT id + ?, ?, label, instruction_id, timeset_id, capture, ext, comment, sort_index "
+                      "FROM vector_table_data WHERE table_id = ?");
+        query.addBindValue(rowOffset);
+        query.addBindValue(newTableId);
+        query.addBindValue(sourceTableId);
+        if (!query.exec())
+        {
+            throw QString("复制向量行失败: " + query.lastError().text());
+        }
+        const int copiedRows = query.numRowsAffected();
+
+        // 管脚值和分组覆盖值，按源表的行读取，通过唯一索引找到每行的值
+        // (vector_table_pin_values的列没有声明类型，连接条件写成+d.id才能使用索引)
+        query.prepare("INSERT INTO vector_table_pin_values (vector_data_id, vector_pin_id, pin_level) "
+                      "SELECT v.vector_data_id + ?, v.vector_pin_id + ?, v.pin_level "
+                      "FROM vector_table_data d JOIN vector_table_pin_values v ON v.vector_data_id = +d.id "
+                      "JOIN vector_table_pins p ON p.id = v.vector_pin_id AND p.table_id = d.table_id "
+                      "WHERE d.table_id = ?");
+        query.addBindValue(rowOffset);
+        query.addBindValue(pinOffset);
+        query.addBindValue(sourceTableId);
+        if (!query.exec())
+        {
+            throw QString("复制管脚值失败: " + query.lastError().text());
+        }
+        const int copiedValues = query.numRowsAffected();
+
+        query.prepare("INSERT INTO vector_table_group_values (vector_data_id, group_id, group_level) "
+                      "SELECT gv.vector_data_id + ?, gv.group_id + ?, gv.group_level "
+                      "FROM vector_table_data d JOIN vector_table_group_values gv ON gv.vector_data_id = d.id "
+                      "JOIN pin_groups g ON g.group_id = gv.group_id AND g.table_id = d.table_id "
+                      "WHERE d.table_id = ?");
+        query.addBindValue(rowOffset);
+        query.addBindValue(groupOffset);
+        query.addBindValue(sourceTableId);
+        if (!query.exec())
+        {
+            throw QString("复制分组值失败: " + query.lastError().text());
+        }
+
+        // 提交事务
+        if (!db.commit())
+        {
+            throw QString("提交事务失败: " + db.lastError().text());
+        }
+
+        qDebug() << "VectorDataHandler::duplicateVectorTable - 源表:" << sourceTableId << "，新表:" << newTableId
+                 << "，行数:" << copiedRows << "，管脚值:" << copiedValues;
+        return true;
+    }
+    catch (const QString &error)
+    {
+        // 回滚事务
+        db.rollback();
+        errorMessage = error;
+        return false;
+    }
+}
+
 bool VectorDataHandler::deleteVectorRows(int tableId, const QList<int> &rowIndexes, QString &errorMessage)
 {
     // 获取数据库连接
@@ -547,7 +889,14 @@ bool VectorDataHandler::deleteVectorRows(int tableId, const QList<int> &rowIndex
         QSqlQuery deleteQuery(db);
         for (int dataId : dataIdsToDelete)
         {
-            // 先删除关联的管脚值
+            // 先删除关联的分组覆盖值和管脚值
+            deleteQuery.prepare("DELETE FROM vector_table_group_values WHERE vector_data_id = ?");
+            deleteQuery.addBindValue(dataId);
+            if (!deleteQuery.exec())
+            {
+                throw QString("删除数据ID " + QString::number(dataId) + " 的分组值失败: " + deleteQuery.lastError().text());
+            }
+
             deleteQuery.prepare("DELETE FROM vector_table_pin_values WHERE vector_data_id = ?");
             deleteQuery.addBindValue(dataId);
             if (!deleteQuery.exec())
@@ -600,140 +949,252 @@ bool VectorDataHandler::insertVectorRows(int tableId, int startIndex, int rowCou
                                          const QList<QPair<int, QPair<QString, QPair<int, QString>>>> &selectedPins,
                                          QString &errorMessage)
 {
-    // 保存向量行数据
-    QSqlDatabase db = DatabaseManager::instance()->database();
-    db.transaction();
-
-    bool success = true;
-
     // 获取实际数据行数
     int rowDataCount = dataTable->rowCount();
+    if (rowDataCount <= 0)
+    {
+        errorMessage = "没有需要添加的行数据！";
+        return false;
+    }
 
     // 检查行数设置
     if (rowCount < rowDataCount)
     {
         errorMessage = "设置的总行数小于实际添加的行数据数量！";
-        db.rollback();
         return false;
     }
 
     if (rowCount % rowDataCount != 0)
     {
         errorMessage = "设置的总行数必须是行数据数量的整数倍！";
-        db.rollback();
         return false;
     }
 
-    // 计算重复次数
-    int repeatTimes = rowCount / rowDataCount;
-
-    // 获取插入位置
-    int actualStartIndex = startIndex;
-
-    // 如果不是添加到最后，需要先将目标位置及之后的数据往后移动
-    if (!appendToEnd)
+    // 从输入框读出管脚状态，空值默认使用X
+    QList<int> vectorPinIds;
+    for (const auto &pin : selectedPins)
     {
-        QSqlQuery updateQuery(db);
-        updateQuery.prepare("UPDATE vector_table_data SET sort_index = sort_index + ? "
-                            "WHERE table_id = ? AND sort_index >= ?");
-        updateQuery.addBindValue(rowCount);
-        updateQuery.addBindValue(tableId);
-        updateQuery.addBindValue(actualStartIndex);
+        vectorPinIds.append(pin.first);
+    }
 
-        if (!updateQuery.exec())
+    QVector<QStringList> rows(rowDataCount);
+    for (int row = 0; row < rowDataCount; row++)
+    {
+        for (int col = 0; col < selectedPins.size(); col++)
         {
-            errorMessage = "更新现有数据索引失败：" + updateQuery.lastError().text();
-            db.rollback();
-            return false;
+            PinValueLineEdit *pinEdit = qobject_cast<PinValueLineEdit *>(dataTable->cellWidget(row, col));
+            QString pinValue = pinEdit ? pinEdit->text() : QString();
+            rows[row] << (pinValue.isEmpty() ? QString("X") : pinValue);
         }
     }
 
     // 根据重复次数添加行数据
-    for (int repeat = 0; repeat < repeatTimes; repeat++)
-    {
-        for (int row = 0; row < rowDataCount; row++)
-        {
-            // 添加vector_table_data记录
-            QSqlQuery dataQuery(db);
-            dataQuery.prepare("INSERT INTO vector_table_data "
-                              "(table_id, instruction_id, timeset_id, label, capture, ext, comment, sort_index) "
-                              "VALUES (?, ?, ?, ?, ?, ?, ?, ?)");
-            dataQuery.addBindValue(tableId);
-            dataQuery.addBindValue(1); // 默认instruction_id为1
-            dataQuery.addBindValue(timesetId);
-            dataQuery.addBindValue("");                                             // label默认为空
-            dataQuery.addBindValue(0);                                              // capture默认为0
-            dataQuery.addBindValue("");                                             // ext默认为空
-            dataQuery.addBindValue("");                                             // comment默认为空
-            dataQuery.addBindValue(actualStartIndex + repeat * rowDataCount + row); // 计算实际排序索引
-
-            if (!dataQuery.exec())
+    return insertPinStateRows(tableId, startIndex, appendToEnd, timesetId, vectorPinIds, rows,
+                              rowCount / rowDataCount, errorMessage);
+}
+
+bool VectorDataHandler::loadPinColumns(int tableId, QList<int> &vectorPinIds, QStringList &pinNames, QString &errorMessage)
+{
+    vectorPinIds.clear();
+    pinNames.clear();
+
+    QSqlDatabase db = DatabaseManager::instance()->database();
+    QSqlQuery query(db);
+    query.prepare("SELECT vtp.id, pl.pin_name FROM vector_table_pins vtp "
+                  "JOIN pin_list pl ON vtp.pin_id = pl.id "
+                  "WHERE vtp.table_id = ? ORDER BY pl.pin_name");
+    query.addBindValue(tableId);
+    if (!query.exec())
+    {
+        errorMessage = "无法获取管脚列表: " + query.lastError().text();
+        return false;
+    }
+
+    while (query.next())
+    {
+        vectorPinIds.append(query.value(0).toInt());
+        pinNames.append(query.value(1).toString());
+    }
+    return true;
+}
+
+bool VectorDataHandler::readPinStateRows(int tableId, const QList<int> &vectorPinIds, QVector<QStringList> &rows, QString &errorMessage)
+{
+    rows.clear();
+
+    QSqlDatabase db = DatabaseManager::instance()->database();
+    QHash<int, int> pinColumns;
+    for (int col = 0; col < vectorPinIds.size(); ++col)
+    {
+        pinColumns[vectorPinIds[col]] = col;
+    }
+
+    // 先按排序读出行ID，再一次读出所有管脚值，不按行逐条查询
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    query.prepare("SELECT id FROM vector_table_data WHERE table_id = ? ORDER BY sort_index, id");
+    query.addBindValue(tableId);
+    if (!query.exec())
+    {
+        errorMessage = "读取向量行失败: " + query.lastError().text();
+        return false;
+    }
+
+    QHash<int, int> dataIdToRow;
+    while (query.next())
+    {
+        dataIdToRow[query.value(0).toInt()] = rows.size();
+        QStringList row;
+        row.reserve(vectorPinIds.size());
+        for (int col = 0; col < vectorPinIds.size(); ++col)
+            row << QString();
+        rows.append(row);
+    }
+
+    query.prepare("SELECT vtpv.vector_data_id, vtpv.vector_pin_id, po.pin_value "
+                  "FROM vector_table_data vtd "
+                  "JOIN vector_table_pin_values vtpv ON vtpv.vector_data_id = +vtd.id "
+                  "LEFT JOIN pin_options po ON po.id = vtpv.pin_level "
+                  "WHERE vtd.table_id = ?");
+    query.addBindValue(tableId);
+    if (!query.exec())
+    {
+        errorMessage = "读取管脚值失败: " + query.lastError().text();
+        return false;
+    }
+
+    while (query.next())
+    {
+        auto rowIt = dataIdToRow.constFind(query.value(0).toInt());
+        auto colIt = pinColumns.constFind(query.value(1).toInt());
+        if (rowIt != dataIdToRow.constEnd() && colIt != pinColumns.constEnd())
+            rows[rowIt.value()][colIt.value()] = query.value(2).toString();
+    }
+    return true;
+}
+
+bool VectorDataHandler::insertPinStateRows(int tableId, int startIndex, bool appendToEnd, int timeSetId,
+                                           const QList<int> &vectorPinIds, const QVector<QStringList> &rows,
+                                           int repeatTimes, QString &errorMessage)
+{
+    if (rows.isEmpty() || repeatTimes <= 0)
+        return true;
+
+    QSqlDatabase db = DatabaseManager::instance()->database();
+    if (!db.isOpen())
+    {
+        errorMessage = "数据库未打开";
+        return false;
+    }
+
+    int totalRows = rows.size() * repeatTimes;
+    bool ownTransaction = db.transaction();
+    QSqlQuery query(db);
+
+    try
+    {
+        if (appendToEnd)
+        {
+            query.prepare("SELECT COALESCE(MAX(sort_index) + 1, 0) FROM vector_table_data WHERE table_id = ?");
+            query.addBindValue(tableId);
+            if (!query.exec() || !query.next())
+            {
+                throw QString("获取向量表末尾位置失败：" + query.lastError().text());
+            }
+            startIndex = query.value(0).toInt();
+        }
+        else
+        {
+            // 插入位置及之后的行整体后移，一条语句完成
+            query.prepare("UPDATE vector_table_data SET sort_index = sort_index + ? "
+                          "WHERE table_id = ? AND sort_index >= ?");
+            query.addBindValue(totalRows);
+            query.addBindValue(tableId);
+            query.addBindValue(startIndex);
+            if (!query.exec())
             {
-                errorMessage = "添加向量行数据失败：" + dataQuery.lastError().text();
-                success = false;
-                break;
+                throw QString("更新现有数据索引失败：" + query.lastError().text());
             }
+        }
 
-            int vectorDataId = dataQuery.lastInsertId().toInt();
+        // 管脚状态只转换一次，重复的行直接复用
+        QHash<QString, int> pinOptionIds;
+        if (query.exec("SELECT id, pin_value FROM pin_options"))
+        {
+            while (query.next())
+                pinOptionIds[query.value(1).toString()] = query.value(0).toInt();
+        }
 
-            // 为每个管脚添加vector_table_pin_values记录
-            for (int col = 0; col < selectedPins.size(); col++)
+        QVector<QVector<int>> levels(rows.size());
+        for (int row = 0; row < rows.size(); ++row)
+        {
+            levels[row].resize(vectorPinIds.size());
+            for (int col = 0; col < vectorPinIds.size(); ++col)
             {
-                int pinId = selectedPins[col].first;
+                QString pinValue = col < rows[row].size() ? rows[row][col] : QString();
+                levels[row][col] = pinOptionIds.value(pinValue, 5); // 空值或无效值使用X (id=5)
+            }
+        }
 
-                // 获取单元格中的输入框
-                PinValueLineEdit *pinEdit = qobject_cast<PinValueLineEdit *>(dataTable->cellWidget(row, col));
-                if (!pinEdit)
-                    continue;
+        // 语句只准备一次；管脚值每条语句插入多个管脚
+        QSqlQuery insertRowQuery(db);
+        insertRowQuery.prepare("INSERT INTO vector_table_data "
+                               "(table_id, instruction_id, timeset_id, label, capture, ext, comment, sort_index) "
+                               "VALUES (?, 1, ?, '', 0, '', '', ?)");
+
+        int pinsPerStatement = qMax(1, qMin(int(vectorPinIds.size()), int(PINS_PER_INSERT)));
+        int remainderPins = vectorPinIds.size() % pinsPerStatement;
+        QSqlQuery pinDataQuery(db);
+        pinDataQuery.prepare(pinValuesInsertSql(pinsPerStatement));
+        QSqlQuery remainderPinDataQuery(db);
+        if (remainderPins > 0)
+            remainderPinDataQuery.prepare(pinValuesInsertSql(remainderPins));
+
+        for (int i = 0; i < totalRows; ++i)
+        {
+            const QVector<int> &rowLevels = levels[i % rows.size()];
 
-                QString pinValue = pinEdit->text();
-                if (pinValue.isEmpty())
-                    pinValue = "X"; // 如果为空，默认使用X
+            insertRowQuery.bindValue(0, tableId);
+            insertRowQuery.bindValue(1, timeSetId);
+            insertRowQuery.bindValue(2, startIndex + i);
+            if (!insertRowQuery.exec())
+            {
+                throw QString("添加向量行数据失败：" + insertRowQuery.lastError().text());
+            }
+            int vectorDataId = insertRowQuery.lastInsertId().toInt();
 
-                // 获取pin_option_id
-                int pinOptionId = 5; // 默认为X (id=5)
-                QSqlQuery pinOptionQuery(db);
-                pinOptionQuery.prepare("SELECT id FROM pin_options WHERE pin_value = ?");
-                pinOptionQuery.addBindValue(pinValue);
-                if (pinOptionQuery.exec() && pinOptionQuery.next())
+            for (int first = 0; first < vectorPinIds.size(); first += pinsPerStatement)
+            {
+                int count = qMin(pinsPerStatement, int(vectorPinIds.size()) - first);
+                QSqlQuery &pinQuery = (count == pinsPerStatement) ? pinDataQuery : remainderPinDataQuery;
+                for (int j = 0; j < count; ++j)
                 {
-                    pinOptionId = pinOptionQuery.value(0).toInt();
+                    pinQuery.bindValue(j * 3, vectorDataId);
+                    pinQuery.bindValue(j * 3 + 1, vectorPinIds[first + j]);
+                    pinQuery.bindValue(j * 3 + 2, rowLevels[first + j]);
                 }
-
-                QSqlQuery pinValueQuery(db);
-                pinValueQuery.prepare("INSERT INTO vector_table_pin_values "
-                                      "(vector_data_id, vector_pin_id, pin_level) "
-                                      "VALUES (?, ?, ?)");
-                pinValueQuery.addBindValue(vectorDataId);
-                pinValueQuery.addBindValue(pinId);
-                pinValueQuery.addBindValue(pinOptionId);
-
-                if (!pinValueQuery.exec())
+                if (!pinQuery.exec())
                 {
-                    errorMessage = "保存管脚值失败：" + pinValueQuery.lastError().text();
-                    success = false;
-                    break;
+                    throw QString("保存管脚值失败：" + pinQuery.lastError().text());
                 }
             }
-
-            if (!success)
-                break;
         }
 
-        if (!success)
-            break;
-    }
-
-    if (success)
-    {
-        db.commit();
-        return true;
+        if (ownTransaction && !db.commit())
+        {
+            throw QString("提交事务失败：" + db.lastError().text());
+        }
     }
-    else
+    catch (const QString &error)
     {
-        db.rollback();
+        if (ownTransaction)
+            db.rollback();
+        errorMessage = error;
         return false;
     }
+
+    qDebug() << "VectorDataHandler::insertPinStateRows - 表ID:" << tableId << "插入行数:" << totalRows << "，起始位置:" << startIndex;
+    return true;
 }
 
 bool VectorDataHandler::deleteVectorRowsInRange(int tableId, int fromRow, int toRow, QString &errorMessage)
@@ -817,7 +1278,14 @@ bool VectorDataHandler::deleteVectorRowsInRange(int tableId, int fromRow, int to
         QSqlQuery deleteQuery(db);
         for (int dataId : dataIdsToDelete)
         {
-            // 先删除关联的管脚值
+            // 先删除关联的分组覆盖值和管脚值
+            deleteQuery.prepare("DELETE FROM vector_table_group_values WHERE vector_data_id = ?");
+            deleteQuery.addBindValue(dataId);
+            if (!deleteQuery.exec())
+            {
+                throw QString("删除数据ID " + QString::number(dataId) + " 的分组值失败: " + deleteQuery.lastError().text());
+            }
+
             deleteQuery.prepare("DELETE FROM vector_table_pin_values WHERE vector_data_id = ?");
             deleteQuery.addBindValue(dataId);
             if (!deleteQuery.exec())
@@ -4,16 +4,39 @@
 #include <QString>
 #include <QList>
 #include <QMap>
+#include <QHash>
+#include <QStringList>
+#include <QVector>
 #include <QTableWidget>
 #include <QWidget>
+#include <QSqlDatabase>
+#include <limits>
 
 class VectorDataHandler
 {
 public:
+    // 分批加载时每批读取的行数
+    static const int LOAD_CHUNK_ROWS = 2000;
+
     VectorDataHandler();
 
-    // 加载向量表数据到表格控件
-    bool loadVectorTableData(int tableId, QTableWidget *tableWidget);
+    // 加载向量表数据到表格控件：表头和行数立即设置好，先加载前initialRows行(-1表示全部)
+    // 其余行通过loadPendingRows分批加载，没加载的行暂时为空
+    bool loadVectorTableData(int tableId, QTableWidget *tableWidget, int initialRows = -1);
+
+    // 接着加载最多maxRows行，返回加载的行数
+    int loadPendingRows(QTableWidget *tableWidget, int maxRows);
+
+    // 同步加载剩余的所有行(保存等需要完整表格的操作之前调用)
+    void loadAllPendingRows(QTableWidget *tableWidget);
+
+    // 是否还有未加载的行，以及已加载/总行数
+    bool hasPendingRows() const { return m_rowLoad.widget && m_rowLoad.nextRow < m_rowLoad.totalRows; }
+    int loadedRowCount() const { return m_rowLoad.nextRow; }
+    int pendingTotalRows() const { return m_rowLoad.totalRows; }
+
+    // 放弃未加载的行
+    void cancelPendingRows();
 
     // 保存表格控件数据到数据库
     bool saveVectorTableData(int tableId, QTableWidget *tableWidget, QString &errorMessage);
@@ -24,6 +47,9 @@ public:
     // 删除向量表
     bool deleteVectorTable(int tableId, QString &errorMessage);
 
+    // 复制向量表：表记录、管脚列、分组和全部行数据都在数据库内用INSERT…SELECT复制，不经过表格控件
+    bool duplicateVectorTable(int sourceTableId, const QString &newTableName, int &newTableId, QString &errorMessage);
+
     // 删除向量行
     bool deleteVectorRows(int tableId, const QList<int> &rowIndexes, QString &errorMessage);
 
@@ -41,6 +67,62 @@ public:
 
     // 跳转到指定行
     bool gotoLine(int tableId, int lineNumber);
+
+    // 向量表的管脚列(vector_table_pins ID和管脚名)，按管脚名排序，与表格中的管脚列顺序一致
+    static bool loadPinColumns(int tableId, QList<int> &vectorPinIds, QStringList &pinNames, QString &errorMessage);
+
+    // 按行顺序读出所有行的管脚状态，每行按vectorPinIds的顺序排列，没有保存的管脚为空
+    static bool readPinStateRows(int tableId, const QList<int> &vectorPinIds, QVector<QStringList> &rows, QString &errorMessage);
+
+    // 批量插入只有管脚状态的行：rows按vectorPinIds的顺序给出管脚状态，整体重复repeatTimes次
+    // appendToEnd为true时追加到末尾，否则插入到startIndex之前；已在事务中时加入外层事务
+    static bool insertPinStateRows(int tableId, int startIndex, bool appendToEnd, int timeSetId,
+                                   const QList<int> &vectorPinIds, const QVector<QStringList> &rows,
+                                   int repeatTimes, QString &errorMessage);
+
+private:
+    // 计算固定列宽时最多测量的行数
+    static const int RESIZE_SAMPLE_ROWS = 200;
+    // 管脚列宽在表头文字宽度之外的留白
+    static const int PIN_COLUMN_PADDING = 20;
+    // 保存时每条INSERT语句插入的管脚值数量(每个3个参数，低于SQLite的999个参数限制)
+    static const int PINS_PER_INSERT = 300;
+
+    // 复制表时新ID相对源ID的偏移：新ID排在该表已用过的所有ID之后，并保持源行之间的顺序
+    static qint64 copyIdOffset(QSqlDatabase &db, const QString &tableName, const QString &idColumn, int sourceTableId);
+
+    // 分批加载的进度，按(sort_index, id)接着上一批读取
+    struct RowLoadState
+    {
+        int tableId = -1;
+        QTableWidget *widget = nullptr;
+        QHash<int, int> pinIdToColumn; // vector_table_pins ID到列索引的映射
+        int totalRows = 0;
+        int nextRow = 0;
+        qint64 lastSortIndex = std::numeric_limits<qint64>::min();
+        int lastId = 0;
+    };
+
+    // 每个向量表的列布局(表头和列宽)，表头不变时切换回来直接复用
+    struct ColumnLayout
+    {
+        QStringList headers;
+        QVector<int> widths;
+    };
+
+    static QString pinValuesInsertSql(int pinCount);
+    // sort_index为空的行排在最前面，打开表时改为最小sort_index之前的连续值，
+    // 分批加载、行数统计和按sort_index定位都不需要再单独处理空值
+    static void normalizeNullSortIndexes(QSqlDatabase &db, int tableId);
+    int loadRowChunk(int maxRows);
+    void finishRowLoad();
+    void rememberColumnLayout(QTableWidget *tableWidget);
+    void applyColumnLayout(int tableId, QTableWidget *tableWidget, const QStringList &headers);
+
+    QHash<int, ColumnLayout> m_columnLayouts;
+    int m_loadedTableId;         // 当前显示在表格控件中的表
+    QTableWidget *m_loadedWidget;
+    RowLoadState m_rowLoad;
 };
 
 #endif // VECTORDATAHANDLER_H
\ No newline at end of file
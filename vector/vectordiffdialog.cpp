@@ -0,0 +1,399 @@
+#include "vectordiffdialog.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QGridLayout>
+#include <QGroupBox>
+#include <QSplitter>
+#include <QScrollBar>
+#include <QHeaderView>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QMessageBox>
+#include <QThread>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDebug>
+
+namespace
+{
+    // 并排视图每次最多显示的行数，以及差异段前后的上下文行数
+    const int PREVIEW_ROWS = 200;
+    const int CONTEXT_ROWS = 3;
+}
+
+VectorDiffDialog::VectorDiffDialog(const QString &currentDbPath, int currentTableId, QWidget *parent)
+    : QDialog(parent), m_thread(nullptr), m_worker(nullptr)
+{
+    setWindowTitle("比较向量表");
+    resize(1100, 700);
+
+    setupUI();
+
+    // 默认两侧都是当前项目
+    m_leftPathEdit->setText(currentDbPath);
+    m_rightPathEdit->setText(currentDbPath);
+    loadTables(currentDbPath, m_leftTableComboBox, currentTableId);
+    loadTables(currentDbPath, m_rightTableComboBox, currentTableId);
+}
+
+VectorDiffDialog::~VectorDiffDialog()
+{
+    stopCompare();
+}
+
+void VectorDiffDialog::setupUI()
+{
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+
+    // 两侧的项目文件和向量表选择
+    QGroupBox *sourceGroup = new QGroupBox("比较对象", this);
+    QGridLayout *sourceLayout = new QGridLayout(sourceGroup);
+
+    m_leftPathEdit = new QLineEdit(sourceGroup);
+    m_leftPathEdit->setReadOnly(true);
+    QPushButton *leftBrowseButton = new QPushButton("浏览...", sourceGroup);
+    m_leftTableComboBox = new QComboBox(sourceGroup);
+    m_leftTableComboBox->setMinimumWidth(150);
+
+    m_rightPathEdit = new QLineEdit(sourceGroup);
+    m_rightPathEdit->setReadOnly(true);
+    QPushButton *rightBrowseButton = new QPushButton("浏览...", sourceGroup);
+    m_rightTableComboBox = new QComboBox(sourceGroup);
+    m_rightTableComboBox->setMinimumWidth(150);
+
+    sourceLayout->addWidget(new QLabel("左侧项目:", sourceGroup), 0, 0);
+    sourceLayout->addWidget(m_leftPathEdit, 0, 1);
+    sourceLayout->addWidget(leftBrowseButton, 0, 2);
+    sourceLayout->addWidget(new QLabel("向量表:", sourceGroup), 0, 3);
+    sourceLayout->addWidget(m_leftTableComboBox, 0, 4);
+
+    sourceLayout->addWidget(new QLabel("右侧项目:", sourceGroup), 1, 0);
+    sourceLayout->addWidget(m_rightPathEdit, 1, 1);
+    sourceLayout->addWidget(rightBrowseButton, 1, 2);
+    sourceLayout->addWidget(new QLabel("向量表:", sourceGroup), 1, 3);
+    sourceLayout->addWidget(m_rightTableComboBox, 1, 4);
+    sourceLayout->setColumnStretch(1, 1);
+
+    mainLayout->addWidget(sourceGroup);
+
+    // 操作按钮和状态
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    m_compareButton = new QPushButton("开始比较", this);
+    m_stopButton = new QPushButton("停止", this);
+    m_stopButton->setEnabled(false);
+    m_statusLabel = new QLabel(this);
+    buttonLayout->addWidget(m_compareButton);
+    buttonLayout->addWidget(m_stopButton);
+    buttonLayout->addSpacing(20);
+    buttonLayout->addWidget(m_statusLabel);
+    buttonLayout->addStretch();
+    mainLayout->addLayout(buttonLayout);
+
+    // 差异段列表 + 并排视图
+    QSplitter *splitter = new QSplitter(Qt::Horizontal, this);
+
+    m_rangeListWidget = new QListWidget(splitter);
+    m_rangeListWidget->setMinimumWidth(250);
+    splitter->addWidget(m_rangeListWidget);
+
+    QSplitter *tableSplitter = new QSplitter(Qt::Horizontal, splitter);
+    m_leftTable = new QTableWidget(tableSplitter);
+    m_rightTable = new QTableWidget(tableSplitter);
+    for (QTableWidget *table : {m_leftTable, m_rightTable})
+    {
+        table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        table->setSelectionBehavior(QAbstractItemView::SelectRows);
+        table->horizontalHeader()->setDefaultSectionSize(60);
+        tableSplitter->addWidget(table);
+    }
+    splitter->addWidget(tableSplitter);
+    splitter->setStretchFactor(1, 1);
+
+    mainLayout->addWidget(splitter, 1);
+
+    // 两侧表格同步滚动
+    connect(m_leftTable->verticalScrollBar(), &QScrollBar::valueChanged, m_rightTable->verticalScrollBar(), &QScrollBar::setValue);
+    connect(m_rightTable->verticalScrollBar(), &QScrollBar::valueChanged, m_leftTable->verticalScrollBar(), &QScrollBar::setValue);
+    connect(m_leftTable->horizontalScrollBar(), &QScrollBar::valueChanged, m_rightTable->horizontalScrollBar(), &QScrollBar::setValue);
+    connect(m_rightTable->horizontalScrollBar(), &QScrollBar::valueChanged, m_leftTable->horizontalScrollBar(), &QScrollBar::setValue);
+
+    connect(leftBrowseButton, &QPushButton::clicked, this, &VectorDiffDialog::browseLeftDatabase);
+    connect(rightBrowseButton, &QPushButton::clicked, this, &VectorDiffDialog::browseRightDatabase);
+    connect(m_compareButton, &QPushButton::clicked, this, &VectorDiffDialog::startCompare);
+    connect(m_stopButton, &QPushButton::clicked, this, &VectorDiffDialog::stopCompare);
+    connect(m_rangeListWidget, &QListWidget::currentRowChanged, this, &VectorDiffDialog::onRangeSelected);
+}
+
+void VectorDiffDialog::loadTables(const QString &dbPath, QComboBox *comboBox, int selectTableId)
+{
+    comboBox->clear();
+    if (dbPath.isEmpty())
+        return;
+
+    QString connectionName = QString("vector_diff_tables_%1").arg(reinterpret_cast<quintptr>(comboBox));
+    {
+        QString errorMessage;
+        QSqlDatabase db = VectorDiffWorker::openReadOnlyConnection(dbPath, connectionName, errorMessage);
+        if (db.isOpen())
+        {
+            QSqlQuery query(db);
+            if (query.exec("SELECT id, table_name FROM vector_tables ORDER BY table_name"))
+            {
+                while (query.next())
+                {
+                    comboBox->addItem(query.value(1).toString(), query.value(0).toInt());
+                }
+            }
+            else
+            {
+                qWarning() << "VectorDiffDialog::loadTables - 查询向量表失败:" << query.lastError().text();
+            }
+            db.close();
+        }
+        else
+        {
+            QMessageBox::warning(this, "警告", errorMessage);
+        }
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+
+    int index = comboBox->findData(selectTableId);
+    if (index >= 0)
+        comboBox->setCurrentIndex(index);
+}
+
+void VectorDiffDialog::browseLeftDatabase()
+{
+    QString path = QFileDialog::getOpenFileName(this, "选择项目数据库", QFileInfo(m_leftPathEdit->text()).absolutePath(),
+                                                "SQLite数据库 (*.db)");
+    if (path.isEmpty())
+        return;
+    m_leftPathEdit->setText(path);
+    loadTables(path, m_leftTableComboBox);
+}
+
+void VectorDiffDialog::browseRightDatabase()
+{
+    QString path = QFileDialog::getOpenFileName(this, "选择项目数据库", QFileInfo(m_rightPathEdit->text()).absolutePath(),
+                                                "SQLite数据库 (*.db)");
+    if (path.isEmpty())
+        return;
+    m_rightPathEdit->setText(path);
+    loadTables(path, m_rightTableComboBox);
+}
+
+void VectorDiffDialog::startCompare()
+{
+    if (m_leftTableComboBox->currentIndex() < 0 || m_rightTableComboBox->currentIndex() < 0)
+    {
+        QMessageBox::warning(this, "警告", "请先选择要比较的两个向量表");
+        return;
+    }
+
+    stopCompare();
+    m_ranges.clear();
+    m_rangeListWidget->clear();
+    m_leftTable->clear();
+    m_rightTable->clear();
+    m_leftTable->setRowCount(0);
+    m_rightTable->setRowCount(0);
+
+    m_thread = new QThread(this);
+    m_worker = new VectorDiffWorker(m_leftPathEdit->text(), m_leftTableComboBox->currentData().toInt(),
+                                    m_rightPathEdit->text(), m_rightTableComboBox->currentData().toInt());
+    m_worker->moveToThread(m_thread);
+
+    connect(m_thread, &QThread::started, m_worker, &VectorDiffWorker::run);
+    connect(m_worker, &VectorDiffWorker::progress, this, &VectorDiffDialog::onProgress);
+    connect(m_worker, &VectorDiffWorker::rangeFound, this, &VectorDiffDialog::onRangeFound);
+    connect(m_worker, &VectorDiffWorker::finished, this, &VectorDiffDialog::onFinished);
+
+    m_compareButton->setEnabled(false);
+    m_stopButton->setEnabled(true);
+    m_statusLabel->setText("正在比较...");
+    m_thread->start();
+}
+
+void VectorDiffDialog::cleanupWorker()
+{
+    if (!m_thread)
+        return;
+
+    disconnect(m_worker, nullptr, this, nullptr);
+    m_thread->quit();
+    m_thread->wait();
+    delete m_worker;
+    delete m_thread;
+    m_worker = nullptr;
+    m_thread = nullptr;
+
+    m_compareButton->setEnabled(true);
+    m_stopButton->setEnabled(false);
+}
+
+void VectorDiffDialog::stopCompare()
+{
+    if (!m_worker)
+        return;
+
+    m_worker->cancel();
+    cleanupWorker();
+    m_statusLabel->setText(QString("比较已停止，已发现 %1 段差异").arg(m_ranges.size()));
+}
+
+void VectorDiffDialog::onProgress(int comparedRows)
+{
+    m_statusLabel->setText(QString("正在比较... 已比较 %1 行，发现 %2 段差异").arg(comparedRows).arg(m_ranges.size()));
+}
+
+void VectorDiffDialog::onRangeFound(const VectorDiffRange &range)
+{
+    m_ranges.append(range);
+
+    QString text;
+    if (range.rowCount == 1)
+        text = QString("第 %1 行").arg(range.firstRow + 1);
+    else
+        text = QString("第 %1 - %2 行").arg(range.firstRow + 1).arg(range.firstRow + range.rowCount);
+    text += ": " + range.columns.join(", ");
+
+    QListWidgetItem *item = new QListWidgetItem(text, m_rangeListWidget);
+    item->setToolTip(text);
+}
+
+void VectorDiffDialog::onFinished(bool success, const QString &errorMessage, int leftRows, int rightRows,
+                                  int differentRows, int identicalChunks, int totalChunks)
+{
+    cleanupWorker();
+
+    if (!success)
+    {
+        m_statusLabel->setText(errorMessage);
+        return;
+    }
+
+    QString text = QString("比较完成: 左侧 %1 行，右侧 %2 行，%3 行不同，%4 段差异；%5/%6 个数据块完全相同")
+                       .arg(leftRows)
+                       .arg(rightRows)
+                       .arg(differentRows)
+                       .arg(m_ranges.size())
+                       .arg(identicalChunks)
+                       .arg(totalChunks);
+    if (m_ranges.size() >= VectorDiffWorker::MAX_RANGES)
+        text += QString("(仅列出前 %1 段)").arg(VectorDiffWorker::MAX_RANGES);
+    m_statusLabel->setText(text);
+
+    if (!m_ranges.isEmpty())
+        m_rangeListWidget->setCurrentRow(0);
+}
+
+bool VectorDiffDialog::readRows(const QString &dbPath, int tableId, int offset, int limit,
+                                QStringList &pinNames, QVector<VectorRowRecord> &rows, QString &errorMessage)
+{
+    bool success = false;
+    QString connectionName = QString("vector_diff_preview_%1").arg(tableId);
+    {
+        QSqlDatabase db = VectorDiffWorker::openReadOnlyConnection(dbPath, connectionName, errorMessage);
+        if (db.isOpen())
+        {
+            VectorRowReader reader(db, tableId);
+            if (reader.open(errorMessage, offset, limit))
+            {
+                pinNames = reader.pinNames();
+                VectorRowRecord record;
+                while (reader.next(record))
+                    rows.append(record);
+                success = true;
+            }
+        }
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+    return success;
+}
+
+void VectorDiffDialog::onRangeSelected(int index)
+{
+    if (index < 0 || index >= m_ranges.size())
+        return;
+
+    const VectorDiffRange &range = m_ranges[index];
+    int offset = qMax(0, range.firstRow - CONTEXT_ROWS);
+    int limit = qMin(PREVIEW_ROWS, range.firstRow - offset + range.rowCount + CONTEXT_ROWS);
+
+    // 只读取差异段附近的行
+    QStringList leftPins;
+    QStringList rightPins;
+    QVector<VectorRowRecord> leftRows;
+    QVector<VectorRowRecord> rightRows;
+    QString errorMessage;
+    if (!readRows(m_leftPathEdit->text(), m_leftTableComboBox->currentData().toInt(), offset, limit, leftPins, leftRows, errorMessage) ||
+        !readRows(m_rightPathEdit->text(), m_rightTableComboBox->currentData().toInt(), offset, limit, rightPins, rightRows, errorMessage))
+    {
+        m_statusLabel->setText(errorMessage);
+        return;
+    }
+
+    QVector<int> leftMap;
+    QVector<int> rightMap;
+    QStringList pinNames = VectorDiffWorker::unionPinNames(leftPins, rightPins, leftMap, rightMap);
+    QStringList headers = VectorRowReader::fieldNames() + pinNames;
+    int fieldCount = VectorRowReader::fieldNames().size();
+
+    // 按并集列对齐后填充两侧表格
+    auto alignRow = [&](const VectorRowRecord &record, const QVector<int> &pinMap)
+    {
+        QStringList cells = record.fields;
+        QVector<QString> pins(pinNames.size());
+        for (int p = 0; p < record.pins.size(); ++p)
+            pins[pinMap[p]] = record.pins[p];
+        for (const QString &pin : pins)
+            cells << pin;
+        return cells;
+    };
+
+    int rowCount = qMax(leftRows.size(), rightRows.size());
+    for (QTableWidget *table : {m_leftTable, m_rightTable})
+    {
+        table->clear();
+        table->setColumnCount(headers.size());
+        table->setHorizontalHeaderLabels(headers);
+        table->setRowCount(rowCount);
+        QStringList rowLabels;
+        for (int r = 0; r < rowCount; ++r)
+            rowLabels << QString::number(offset + r + 1);
+        table->setVerticalHeaderLabels(rowLabels);
+    }
+
+    const QColor diffColor(255, 200, 200);
+    for (int r = 0; r < rowCount; ++r)
+    {
+        QStringList leftCells = r < leftRows.size() ? alignRow(leftRows[r], leftMap) : QStringList();
+        QStringList rightCells = r < rightRows.size() ? alignRow(rightRows[r], rightMap) : QStringList();
+
+        for (int c = 0; c < headers.size(); ++c)
+        {
+            QString leftValue = c < leftCells.size() ? leftCells[c] : QString();
+            QString rightValue = c < rightCells.size() ? rightCells[c] : QString();
+
+            QTableWidgetItem *leftItem = new QTableWidgetItem(leftValue);
+            QTableWidgetItem *rightItem = new QTableWidgetItem(rightValue);
+            if (c >= fieldCount)
+            {
+                leftItem->setTextAlignment(Qt::AlignCenter);
+                rightItem->setTextAlignment(Qt::AlignCenter);
+            }
+            if (leftCells.isEmpty() || rightCells.isEmpty() || leftValue != rightValue)
+            {
+                leftItem->setBackground(diffColor);
+                rightItem->setBackground(diffColor);
+            }
+            m_leftTable->setItem(r, c, leftItem);
+            m_rightTable->setItem(r, c, rightItem);
+        }
+    }
+
+    // 滚动到差异段第一行
+    int firstDiffRow = range.firstRow - offset;
+    m_leftTable->scrollToItem(m_leftTable->item(firstDiffRow, 0), QAbstractItemView::PositionAtTop);
+}
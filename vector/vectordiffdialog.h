@@ -0,0 +1,59 @@
+#ifndef VECTORDIFFDIALOG_H
+#define VECTORDIFFDIALOG_H
+
+#include <QDialog>
+#include <QComboBox>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QLabel>
+#include <QListWidget>
+#include <QTableWidget>
+#include <QVector>
+#include "vectordiffworker.h"
+
+class QThread;
+
+// 向量表比较窗口：选择两个项目中的向量表，后台流式比较，并排显示差异行
+class VectorDiffDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    VectorDiffDialog(const QString &currentDbPath, int currentTableId, QWidget *parent = nullptr);
+    ~VectorDiffDialog();
+
+private slots:
+    void browseLeftDatabase();
+    void browseRightDatabase();
+    void startCompare();
+    void stopCompare();
+    void onProgress(int comparedRows);
+    void onRangeFound(const VectorDiffRange &range);
+    void onFinished(bool success, const QString &errorMessage, int leftRows, int rightRows,
+                    int differentRows, int identicalChunks, int totalChunks);
+    void onRangeSelected(int index);
+
+private:
+    void setupUI();
+    void loadTables(const QString &dbPath, QComboBox *comboBox, int selectTableId = -1);
+    void cleanupWorker();
+    static bool readRows(const QString &dbPath, int tableId, int offset, int limit,
+                         QStringList &pinNames, QVector<VectorRowRecord> &rows, QString &errorMessage);
+
+    QLineEdit *m_leftPathEdit;
+    QLineEdit *m_rightPathEdit;
+    QComboBox *m_leftTableComboBox;
+    QComboBox *m_rightTableComboBox;
+    QPushButton *m_compareButton;
+    QPushButton *m_stopButton;
+    QLabel *m_statusLabel;
+    QListWidget *m_rangeListWidget;
+    QTableWidget *m_leftTable;
+    QTableWidget *m_rightTable;
+
+    QThread *m_thread;
+    VectorDiffWorker *m_worker;
+    QVector<VectorDiffRange> m_ranges;
+};
+
+#endif // VECTORDIFFDIALOG_H
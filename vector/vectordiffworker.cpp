@@ -0,0 +1,329 @@
+#include "vectordiffworker.h"
+
+#include <QSqlError>
+#include <QDebug>
+#include <algorithm>
+
+// ---------------- VectorRowReader ----------------
+
+VectorRowReader::VectorRowReader(const QSqlDatabase &db, int tableId)
+    : m_db(db), m_tableId(tableId), m_rowQuery(db), m_valueQuery(db), m_hasValue(false)
+{
+}
+
+QStringList VectorRowReader::fieldNames()
+{
+    return QStringList() << "Label" << "Instruction" << "TimeSet" << "Capture" << "Ext" << "Comment";
+}
+
+bool VectorRowReader::open(QString &errorMessage, int offset, int limit)
+{
+    m_pinNames.clear();
+    m_vectorPinToIndex.clear();
+
+    // 管脚按名称排序，与向量表列顺序一致
+    QSqlQuery pinQuery(m_db);
+    pinQuery.prepare("SELECT vtp.id, pl.pin_name FROM vector_table_pins vtp "
+                     "JOIN pin_list pl ON vtp.pin_id = pl.id "
+                     "WHERE vtp.table_id = ? ORDER BY pl.pin_name");
+    pinQuery.addBindValue(m_tableId);
+    if (!pinQuery.exec())
+    {
+        errorMessage = "查询管脚失败: " + pinQuery.lastError().text();
+        return false;
+    }
+    while (pinQuery.next())
+    {
+        m_vectorPinToIndex[pinQuery.value(0).toInt()] = m_pinNames.size();
+        m_pinNames << pinQuery.value(1).toString();
+    }
+
+    m_rowQuery.setForwardOnly(true);
+    QString rowSql = QString("SELECT vtd.id, vtd.label, io.instruction_value, tl.timeset_name, "
+                             "vtd.capture, vtd.ext, vtd.comment "
+                             "FROM vector_table_data vtd "
+                             "LEFT JOIN instruction_options io ON vtd.instruction_id = io.id "
+                             "LEFT JOIN timeset_list tl ON vtd.timeset_id = tl.id "
+                             "WHERE vtd.table_id = %1 "
+                             "ORDER BY vtd.sort_index, vtd.id LIMIT %2 OFFSET %3")
+                         .arg(m_tableId)
+                         .arg(limit)
+                         .arg(offset);
+    if (!m_rowQuery.exec(rowSql))
+    {
+        errorMessage = "查询向量行失败: " + m_rowQuery.lastError().text();
+        return false;
+    }
+
+    // 管脚状态按同样的顺序读取，vector_data_id列没有类型亲和性，用+vtd.id才能走唯一索引
+    QString rangeFilter;
+    if (offset > 0 || limit >= 0)
+    {
+        rangeFilter = QString("AND vtd.id IN (SELECT id FROM vector_table_data WHERE table_id = %1 "
+                              "ORDER BY sort_index, id LIMIT %2 OFFSET %3) ")
+                          .arg(m_tableId)
+                          .arg(limit)
+                          .arg(offset);
+    }
+
+    m_valueQuery.setForwardOnly(true);
+    QString valueSql = QString("SELECT vtd.id, vtpv.vector_pin_id, po.pin_value "
+                               "FROM vector_table_data vtd "
+                               "JOIN vector_table_pin_values vtpv ON vtpv.vector_data_id = +vtd.id "
+                               "JOIN pin_options po ON vtpv.pin_level = po.id "
+                               "WHERE vtd.table_id = %1 %2"
+                               "ORDER BY vtd.sort_index, vtd.id")
+                           .arg(m_tableId)
+                           .arg(rangeFilter);
+    if (!m_valueQuery.exec(valueSql))
+    {
+        errorMessage = "查询管脚状态失败: " + m_valueQuery.lastError().text();
+        return false;
+    }
+    m_hasValue = m_valueQuery.next();
+
+    return true;
+}
+
+bool VectorRowReader::next(VectorRowRecord &record)
+{
+    if (!m_rowQuery.next())
+        return false;
+
+    int vectorDataId = m_rowQuery.value(0).toInt();
+    record.id = vectorDataId;
+
+    // 与表格显示一致：Capture为"0"时视为空
+    QString capture = m_rowQuery.value(4).toString();
+    record.fields = QStringList() << m_rowQuery.value(1).toString()
+                                  << m_rowQuery.value(2).toString()
+                                  << m_rowQuery.value(3).toString()
+                                  << (capture == "0" ? QString() : capture)
+                                  << m_rowQuery.value(5).toString()
+                                  << m_rowQuery.value(6).toString();
+
+    // 没有记录的管脚按X处理
+    record.pins.fill("X", m_pinNames.size());
+    while (m_hasValue && m_valueQuery.value(0).toInt() == vectorDataId)
+    {
+        int index = m_vectorPinToIndex.value(m_valueQuery.value(1).toInt(), -1);
+        if (index >= 0)
+            record.pins[index] = m_valueQuery.value(2).toString();
+        m_hasValue = m_valueQuery.next();
+    }
+
+    return true;
+}
+
+// ---------------- VectorDiffWorker ----------------
+
+VectorDiffWorker::VectorDiffWorker(const QString &leftDbPath, int leftTableId,
+                                   const QString &rightDbPath, int rightTableId)
+    : QObject(nullptr), m_leftDbPath(leftDbPath), m_leftTableId(leftTableId),
+      m_rightDbPath(rightDbPath), m_rightTableId(rightTableId), m_cancelled(false),
+      m_leftRows(0), m_rightRows(0), m_differentRows(0), m_identicalChunks(0), m_totalChunks(0),
+      m_emittedRanges(0)
+{
+    qRegisterMetaType<VectorDiffRange>("VectorDiffRange");
+    m_pendingRange.firstRow = -1;
+    m_pendingRange.rowCount = 0;
+}
+
+void VectorDiffWorker::cancel()
+{
+    m_cancelled = true;
+}
+
+QSqlDatabase VectorDiffWorker::openReadOnlyConnection(const QString &dbPath, const QString &connectionName, QString &errorMessage)
+{
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+    db.setDatabaseName(dbPath);
+    db.setConnectOptions("QSQLITE_OPEN_READONLY");
+    if (!db.open())
+    {
+        errorMessage = QString("无法打开数据库 %1: %2").arg(dbPath).arg(db.lastError().text());
+    }
+    return db;
+}
+
+QStringList VectorDiffWorker::unionPinNames(const QStringList &left, const QStringList &right,
+                                            QVector<int> &leftMap, QVector<int> &rightMap)
+{
+    QStringList names = left;
+    for (const QString &name : right)
+    {
+        if (!names.contains(name))
+            names << name;
+    }
+    std::sort(names.begin(), names.end());
+
+    leftMap.resize(left.size());
+    for (int i = 0; i < left.size(); ++i)
+        leftMap[i] = names.indexOf(left[i]);
+
+    rightMap.resize(right.size());
+    for (int i = 0; i < right.size(); ++i)
+        rightMap[i] = names.indexOf(right[i]);
+
+    return names;
+}
+
+void VectorDiffWorker::run()
+{
+    QString leftConnection = QString("vector_diff_left_%1").arg(reinterpret_cast<quintptr>(this));
+    QString rightConnection = QString("vector_diff_right_%1").arg(reinterpret_cast<quintptr>(this));
+    bool success = false;
+    QString errorMessage;
+
+    {
+        QSqlDatabase leftDb = openReadOnlyConnection(m_leftDbPath, leftConnection, errorMessage);
+        QSqlDatabase rightDb = openReadOnlyConnection(m_rightDbPath, rightConnection, errorMessage);
+        if (leftDb.isOpen() && rightDb.isOpen())
+        {
+            success = compare(leftDb, rightDb, errorMessage);
+        }
+        leftDb.close();
+        rightDb.close();
+    }
+    QSqlDatabase::removeDatabase(leftConnection);
+    QSqlDatabase::removeDatabase(rightConnection);
+
+    if (m_cancelled)
+    {
+        success = false;
+        errorMessage = "比较已取消";
+    }
+
+    qDebug() << "VectorDiffWorker::run - 比较结束, 成功:" << success << "差异行:" << m_differentRows
+             << "相同块:" << m_identicalChunks << "/" << m_totalChunks;
+    emit finished(success, errorMessage, m_leftRows, m_rightRows, m_differentRows, m_identicalChunks, m_totalChunks);
+}
+
+void VectorDiffWorker::addDifference(int row, const QStringList &columns)
+{
+    m_differentRows++;
+
+    // 与上一段相邻则合并
+    if (m_pendingRange.firstRow >= 0 && m_pendingRange.firstRow + m_pendingRange.rowCount == row)
+    {
+        m_pendingRange.rowCount++;
+        for (const QString &column : columns)
+        {
+            if (!m_pendingRange.columns.contains(column))
+                m_pendingRange.columns << column;
+        }
+        return;
+    }
+
+    flushRange();
+    m_pendingRange.firstRow = row;
+    m_pendingRange.rowCount = 1;
+    m_pendingRange.columns = columns;
+}
+
+void VectorDiffWorker::flushRange()
+{
+    if (m_pendingRange.firstRow < 0)
+        return;
+
+    if (m_emittedRanges < MAX_RANGES)
+    {
+        emit rangeFound(m_pendingRange);
+        m_emittedRanges++;
+    }
+    m_pendingRange.firstRow = -1;
+    m_pendingRange.rowCount = 0;
+    m_pendingRange.columns.clear();
+}
+
+bool VectorDiffWorker::compare(QSqlDatabase &leftDb, QSqlDatabase &rightDb, QString &errorMessage)
+{
+    VectorRowReader leftReader(leftDb, m_leftTableId);
+    VectorRowReader rightReader(rightDb, m_rightTableId);
+    if (!leftReader.open(errorMessage) || !rightReader.open(errorMessage))
+        return false;
+
+    QVector<int> leftMap;
+    QVector<int> rightMap;
+    QStringList pinNames = unionPinNames(leftReader.pinNames(), rightReader.pinNames(), leftMap, rightMap);
+    QStringList fieldNames = VectorRowReader::fieldNames();
+    int unionSize = pinNames.size();
+
+    // 两侧管脚相同(最常见的情况)时直接比较整行，QVector/QStringList的比较在第一个不同处结束
+    const bool samePins = leftReader.pinNames() == rightReader.pinNames();
+
+    // 两侧各保留一个块的缓冲区，内存占用固定
+    QVector<VectorRowRecord> leftChunk(CHUNK_ROWS);
+    QVector<VectorRowRecord> rightChunk(CHUNK_ROWS);
+    QVector<QString> leftAligned(unionSize);
+    QVector<QString> rightAligned(unionSize);
+    int row = 0;
+
+    while (!m_cancelled)
+    {
+        int leftCount = 0;
+        while (leftCount < CHUNK_ROWS && leftReader.next(leftChunk[leftCount]))
+            leftCount++;
+        int rightCount = 0;
+        while (rightCount < CHUNK_ROWS && rightReader.next(rightChunk[rightCount]))
+            rightCount++;
+
+        if (leftCount == 0 && rightCount == 0)
+            break;
+
+        m_leftRows += leftCount;
+        m_rightRows += rightCount;
+        m_totalChunks++;
+
+        // 逐行比较，相同的行不再逐列检查；只有不同的行才列出差异列
+        int common = qMin(leftCount, rightCount);
+        bool chunkIdentical = leftCount == rightCount;
+        for (int i = 0; i < common; ++i)
+        {
+            const VectorRowRecord &left = leftChunk[i];
+            const VectorRowRecord &right = rightChunk[i];
+            if (samePins && left.fields == right.fields && left.pins == right.pins)
+                continue;
+
+            QStringList columns;
+            for (int f = 0; f < fieldNames.size(); ++f)
+            {
+                if (left.fields[f] != right.fields[f])
+                    columns << fieldNames[f];
+            }
+
+            leftAligned.fill(QString());
+            rightAligned.fill(QString());
+            for (int p = 0; p < left.pins.size(); ++p)
+                leftAligned[leftMap[p]] = left.pins[p];
+            for (int p = 0; p < right.pins.size(); ++p)
+                rightAligned[rightMap[p]] = right.pins[p];
+            for (int p = 0; p < unionSize; ++p)
+            {
+                if (leftAligned[p] != rightAligned[p])
+                    columns << pinNames[p];
+            }
+
+            if (!columns.isEmpty())
+            {
+                addDifference(row + i, columns);
+                chunkIdentical = false;
+            }
+        }
+
+        if (chunkIdentical)
+            m_identicalChunks++;
+
+        // 只有一侧存在的行
+        for (int i = common; i < qMax(leftCount, rightCount); ++i)
+        {
+            addDifference(row + i, QStringList() << (leftCount > rightCount ? "仅左侧" : "仅右侧"));
+        }
+
+        row += qMax(leftCount, rightCount);
+        emit progress(row);
+    }
+
+    flushRange();
+    return !m_cancelled;
+}
@@ -0,0 +1,112 @@
+#ifndef VECTORDIFFWORKER_H
+#define VECTORDIFFWORKER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QMetaType>
+#include <atomic>
+
+// 一行向量数据的规范化表示：固定列 + 按管脚顺序的状态
+struct VectorRowRecord
+{
+    int id;                // vector_table_data.id
+    QStringList fields;    // Label, Instruction, TimeSet, Capture, Ext, Comment
+    QVector<QString> pins; // 与读取器的pinNames()顺序一致
+};
+
+// 按sort_index顺序流式读取一个向量表，行数据和管脚状态用两个游标合并，内存占用与表大小无关
+class VectorRowReader
+{
+public:
+    VectorRowReader(const QSqlDatabase &db, int tableId);
+
+    // 打开游标，limit < 0 表示读到表尾
+    bool open(QString &errorMessage, int offset = 0, int limit = -1);
+
+    // 读取下一行，没有更多行时返回false
+    bool next(VectorRowRecord &record);
+
+    const QStringList &pinNames() const { return m_pinNames; }
+
+    // 固定列名称，与向量表表头一致
+    static QStringList fieldNames();
+
+private:
+    QSqlDatabase m_db;
+    int m_tableId;
+    QStringList m_pinNames;
+    QHash<int, int> m_vectorPinToIndex; // vector_table_pins.id -> 管脚序号
+    QSqlQuery m_rowQuery;
+    QSqlQuery m_valueQuery;
+    bool m_hasValue; // m_valueQuery当前是否停在一条有效记录上
+};
+
+// 一段连续的差异行
+struct VectorDiffRange
+{
+    int firstRow;        // 起始行(0-based)
+    int rowCount;        // 行数
+    QStringList columns; // 有差异的列(固定列名或管脚名)
+};
+Q_DECLARE_METATYPE(VectorDiffRange)
+
+// 后台比较两个向量表(可以来自不同的项目文件)
+class VectorDiffWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    VectorDiffWorker(const QString &leftDbPath, int leftTableId,
+                     const QString &rightDbPath, int rightTableId);
+
+    void cancel();
+
+    // 每次从两侧各读取的行数
+    static const int CHUNK_ROWS = 1024;
+
+    // 最多保留的差异段数量，超出后只计数
+    static const int MAX_RANGES = 10000;
+
+    // 打开只读连接，供比较和并排视图使用
+    static QSqlDatabase openReadOnlyConnection(const QString &dbPath, const QString &connectionName, QString &errorMessage);
+
+    // 计算两侧管脚的并集，并给出两侧管脚序号到并集序号的映射
+    static QStringList unionPinNames(const QStringList &left, const QStringList &right,
+                                     QVector<int> &leftMap, QVector<int> &rightMap);
+
+public slots:
+    void run();
+
+signals:
+    void progress(int comparedRows);
+    void rangeFound(const VectorDiffRange &range);
+    void finished(bool success, const QString &errorMessage, int leftRows, int rightRows,
+                  int differentRows, int identicalChunks, int totalChunks);
+
+private:
+    bool compare(QSqlDatabase &leftDb, QSqlDatabase &rightDb, QString &errorMessage);
+    void addDifference(int row, const QStringList &columns);
+    void flushRange();
+
+    QString m_leftDbPath;
+    int m_leftTableId;
+    QString m_rightDbPath;
+    int m_rightTableId;
+    std::atomic<bool> m_cancelled;
+
+    // 统计和当前正在合并的差异段
+    int m_leftRows;
+    int m_rightRows;
+    int m_differentRows;
+    int m_identicalChunks;
+    int m_totalChunks;
+    int m_emittedRanges;
+    VectorDiffRange m_pendingRange;
+};
+
+#endif // VECTORDIFFWORKER_H
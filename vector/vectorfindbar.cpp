@@ -0,0 +1,295 @@
+#include "vectorfindbar.h"
+#include "vectorsearchworker.h"
+#include "database/databasemanager.h"
+
+#include <QHBoxLayout>
+#include <QThread>
+#include <QHeaderView>
+#include <QDebug>
+#include <algorithm>
+
+VectorFindBar::VectorFindBar(QTableWidget *tableWidget, QWidget *parent)
+    : QWidget(parent), m_tableWidget(tableWidget), m_searchThread(nullptr), m_searchWorker(nullptr),
+      m_tableId(-1), m_currentMatch(-1), m_searching(false), m_jumpOnResult(false),
+      m_scannedRows(0), m_totalRows(0), m_lastMode(-1)
+{
+    setupUI();
+
+    // 表格行变化后行号失效，清空结果
+    if (m_tableWidget)
+    {
+        connect(m_tableWidget->model(), &QAbstractItemModel::rowsInserted, this, &VectorFindBar::invalidateResults);
+        connect(m_tableWidget->model(), &QAbstractItemModel::rowsRemoved, this, &VectorFindBar::invalidateResults);
+        connect(m_tableWidget->model(), &QAbstractItemModel::modelReset, this, &VectorFindBar::invalidateResults);
+    }
+}
+
+VectorFindBar::~VectorFindBar()
+{
+    stopSearch();
+}
+
+void VectorFindBar::setupUI()
+{
+    QHBoxLayout *layout = new QHBoxLayout(this);
+    layout->setContentsMargins(0, 2, 0, 2);
+
+    QLabel *findLabel = new QLabel("查找:", this);
+    m_modeComboBox = new QComboBox(this);
+    m_modeComboBox->addItem("标签", VectorSearchWorker::SearchLabel);
+    m_modeComboBox->addItem("注释", VectorSearchWorker::SearchComment);
+    m_modeComboBox->addItem("管脚状态", VectorSearchWorker::SearchPinPattern);
+
+    m_patternEdit = new QLineEdit(this);
+    m_patternEdit->setMinimumWidth(250);
+    m_patternEdit->setClearButtonEnabled(true);
+
+    m_findButton = new QPushButton("查找", this);
+    m_prevButton = new QPushButton("上一个", this);
+    m_nextButton = new QPushButton("下一个", this);
+    m_closeButton = new QPushButton("关闭", this);
+    m_statusLabel = new QLabel(this);
+
+    layout->addWidget(findLabel);
+    layout->addWidget(m_modeComboBox);
+    layout->addWidget(m_patternEdit);
+    layout->addWidget(m_findButton);
+    layout->addWidget(m_prevButton);
+    layout->addWidget(m_nextButton);
+    layout->addWidget(m_statusLabel);
+    layout->addStretch();
+    layout->addWidget(m_closeButton);
+
+    auto updatePlaceholder = [this]()
+    {
+        if (m_modeComboBox->currentData().toInt() == VectorSearchWorker::SearchPinPattern)
+            m_patternEdit->setPlaceholderText("例如 CLK=1, DATA*=X, CS=01 (管脚名支持*和?)");
+        else
+            m_patternEdit->setPlaceholderText("包含的文字，或使用*和?通配符");
+    };
+    updatePlaceholder();
+
+    connect(m_modeComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, updatePlaceholder);
+    connect(m_patternEdit, &QLineEdit::returnPressed, this, &VectorFindBar::findNext);
+    connect(m_findButton, &QPushButton::clicked, this, &VectorFindBar::startSearch);
+    connect(m_prevButton, &QPushButton::clicked, this, &VectorFindBar::findPrevious);
+    connect(m_nextButton, &QPushButton::clicked, this, &VectorFindBar::findNext);
+    connect(m_closeButton, &QPushButton::clicked, this, &VectorFindBar::closeBar);
+}
+
+void VectorFindBar::setTableId(int tableId)
+{
+    if (m_tableId == tableId)
+        return;
+
+    m_tableId = tableId;
+    invalidateResults();
+}
+
+void VectorFindBar::activate()
+{
+    show();
+    m_patternEdit->setFocus();
+    m_patternEdit->selectAll();
+}
+
+void VectorFindBar::closeBar()
+{
+    stopSearch();
+    hide();
+}
+
+void VectorFindBar::startSearch()
+{
+    QString pattern = m_patternEdit->text().trimmed();
+    if (pattern.isEmpty() || m_tableId < 0)
+        return;
+
+    QString dbPath = DatabaseManager::instance()->database().databaseName();
+    if (dbPath.isEmpty())
+    {
+        m_statusLabel->setText("请先打开或创建一个项目数据库");
+        return;
+    }
+
+    stopSearch();
+    m_matches.clear();
+    m_currentMatch = -1;
+    m_scannedRows = 0;
+    m_totalRows = 0;
+    m_lastPattern = pattern;
+    m_lastMode = m_modeComboBox->currentData().toInt();
+    m_jumpOnResult = true;
+
+    qDebug() << "VectorFindBar::startSearch - 开始查找, 表ID:" << m_tableId << "模式:" << m_lastMode << "条件:" << pattern;
+
+    // 在后台线程查找，结果分批返回
+    m_searchThread = new QThread(this);
+    m_searchWorker = new VectorSearchWorker(dbPath, m_tableId,
+                                            static_cast<VectorSearchWorker::SearchMode>(m_lastMode), pattern);
+    m_searchWorker->moveToThread(m_searchThread);
+
+    connect(m_searchThread, &QThread::started, m_searchWorker, &VectorSearchWorker::run);
+    connect(m_searchWorker, &VectorSearchWorker::matchesFound, this, &VectorFindBar::onMatchesFound);
+    connect(m_searchWorker, &VectorSearchWorker::progress, this, &VectorFindBar::onSearchProgress);
+    connect(m_searchWorker, &VectorSearchWorker::finished, this, &VectorFindBar::onSearchFinished);
+
+    m_searching = true;
+    updateStatus();
+    m_searchThread->start();
+}
+
+void VectorFindBar::stopSearch()
+{
+    if (!m_searchThread)
+        return;
+
+    m_searchWorker->cancel();
+    disconnect(m_searchWorker, nullptr, this, nullptr);
+    m_searchThread->quit();
+    m_searchThread->wait();
+
+    delete m_searchWorker;
+    delete m_searchThread;
+    m_searchWorker = nullptr;
+    m_searchThread = nullptr;
+    m_searching = false;
+}
+
+void VectorFindBar::invalidateResults()
+{
+    stopSearch();
+    m_matches.clear();
+    m_currentMatch = -1;
+    m_lastPattern.clear();
+    m_lastMode = -1;
+    m_jumpOnResult = false;
+    m_statusLabel->clear();
+}
+
+void VectorFindBar::onMatchesFound(const QVector<int> &rows)
+{
+    m_matches += rows;
+
+    if (m_jumpOnResult && !m_matches.isEmpty())
+    {
+        m_jumpOnResult = false;
+
+        // 跳到当前行之后的第一个匹配
+        int currentRow = m_tableWidget ? m_tableWidget->currentRow() : -1;
+        auto it = std::upper_bound(m_matches.constBegin(), m_matches.constEnd(), currentRow);
+        if (it != m_matches.constEnd())
+            jumpToMatch(static_cast<int>(it - m_matches.constBegin()));
+        else
+            m_jumpOnResult = true;
+    }
+    updateStatus();
+}
+
+void VectorFindBar::onSearchProgress(int scannedRows, int totalRows)
+{
+    m_scannedRows = scannedRows;
+    m_totalRows = totalRows;
+    updateStatus();
+}
+
+void VectorFindBar::onSearchFinished(bool success, const QString &errorMessage)
+{
+    stopSearch();
+
+    if (!success)
+    {
+        m_lastPattern.clear();
+        m_statusLabel->setText(errorMessage);
+        return;
+    }
+
+    // 当前行之后没有匹配时回绕到第一个
+    if (m_jumpOnResult && !m_matches.isEmpty())
+        jumpToMatch(0);
+    m_jumpOnResult = false;
+    updateStatus();
+}
+
+void VectorFindBar::findNext()
+{
+    QString pattern = m_patternEdit->text().trimmed();
+    if (pattern != m_lastPattern || m_modeComboBox->currentData().toInt() != m_lastMode)
+    {
+        startSearch();
+        return;
+    }
+
+    if (m_matches.isEmpty())
+        return;
+
+    int currentRow = m_tableWidget ? m_tableWidget->currentRow() : -1;
+    auto it = std::upper_bound(m_matches.constBegin(), m_matches.constEnd(), currentRow);
+    if (it != m_matches.constEnd())
+    {
+        jumpToMatch(static_cast<int>(it - m_matches.constBegin()));
+    }
+    else if (m_searching)
+    {
+        // 后面的结果还在扫描中
+        m_jumpOnResult = true;
+    }
+    else
+    {
+        jumpToMatch(0);
+    }
+}
+
+void VectorFindBar::findPrevious()
+{
+    QString pattern = m_patternEdit->text().trimmed();
+    if (pattern != m_lastPattern || m_modeComboBox->currentData().toInt() != m_lastMode)
+    {
+        startSearch();
+        return;
+    }
+
+    if (m_matches.isEmpty())
+        return;
+
+    int currentRow = m_tableWidget ? m_tableWidget->currentRow() : 0;
+    auto it = std::lower_bound(m_matches.constBegin(), m_matches.constEnd(), currentRow);
+    int index = static_cast<int>(it - m_matches.constBegin()) - 1;
+    if (index < 0)
+        index = m_matches.size() - 1;
+    jumpToMatch(index);
+}
+
+void VectorFindBar::jumpToMatch(int matchIndex)
+{
+    if (!m_tableWidget || matchIndex < 0 || matchIndex >= m_matches.size())
+        return;
+
+    int row = m_matches[matchIndex];
+    if (row >= m_tableWidget->rowCount())
+        return;
+
+    m_currentMatch = matchIndex;
+    m_tableWidget->clearSelection();
+    m_tableWidget->selectRow(row);
+    m_tableWidget->scrollTo(m_tableWidget->model()->index(row, 0), QAbstractItemView::PositionAtCenter);
+    updateStatus();
+}
+
+void VectorFindBar::updateStatus()
+{
+    QString text;
+    if (m_currentMatch >= 0)
+        text = QString("第 %1 / %2 个匹配").arg(m_currentMatch + 1).arg(m_matches.size());
+    else if (!m_lastPattern.isEmpty())
+        text = QString("%1 个匹配").arg(m_matches.size());
+
+    if (m_searching && m_totalRows > 0)
+        text += QString(" (扫描中 %1%)").arg(qMin(100, int(qint64(m_scannedRows) * 100 / m_totalRows)));
+    else if (m_searching)
+        text += " (扫描中...)";
+    else if (!m_lastPattern.isEmpty() && m_matches.isEmpty())
+        text = "未找到匹配项";
+
+    m_statusLabel->setText(text);
+}
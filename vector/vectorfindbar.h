@@ -0,0 +1,71 @@
+#ifndef VECTORFINDBAR_H
+#define VECTORFINDBAR_H
+
+#include <QWidget>
+#include <QComboBox>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QLabel>
+#include <QTableWidget>
+#include <QVector>
+
+class QThread;
+class VectorSearchWorker;
+
+// 向量表查找栏：按标签/注释/管脚状态在后台查找，并在结果间跳转
+class VectorFindBar : public QWidget
+{
+    Q_OBJECT
+
+public:
+    VectorFindBar(QTableWidget *tableWidget, QWidget *parent = nullptr);
+    ~VectorFindBar();
+
+    // 设置当前向量表，切换表时清空结果
+    void setTableId(int tableId);
+
+    // 显示查找栏并聚焦输入框
+    void activate();
+
+public slots:
+    void findNext();
+    void findPrevious();
+
+private slots:
+    void startSearch();
+    void onMatchesFound(const QVector<int> &rows);
+    void onSearchProgress(int scannedRows, int totalRows);
+    void onSearchFinished(bool success, const QString &errorMessage);
+    void invalidateResults();
+    void closeBar();
+
+private:
+    void setupUI();
+    void stopSearch();
+    void jumpToMatch(int matchIndex);
+    void updateStatus();
+
+    QTableWidget *m_tableWidget;
+    QComboBox *m_modeComboBox;
+    QLineEdit *m_patternEdit;
+    QPushButton *m_findButton;
+    QPushButton *m_prevButton;
+    QPushButton *m_nextButton;
+    QPushButton *m_closeButton;
+    QLabel *m_statusLabel;
+
+    QThread *m_searchThread;
+    VectorSearchWorker *m_searchWorker;
+
+    int m_tableId;
+    QVector<int> m_matches; // 匹配的行号(升序)
+    int m_currentMatch;     // 当前所在的匹配序号
+    bool m_searching;
+    bool m_jumpOnResult;    // 查找刚开始时，等第一批结果到达再跳转
+    int m_scannedRows;
+    int m_totalRows;
+    QString m_lastPattern;  // 上次查找的条件，用于判断是否需要重新查找
+    int m_lastMode;
+};
+
+#endif // VECTORFINDBAR_H
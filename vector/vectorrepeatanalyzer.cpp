@@ -0,0 +1,428 @@
+#include "vectorrepeatanalyzer.h"
+#include "vectordiffworker.h"
+#include "database/databasemanager.h"
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QMap>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <queue>
+#include <algorithm>
+
+namespace
+{
+    // 64位FNV-1a哈希
+    const quint64 FNV_OFFSET = 1469598103934665603ULL;
+    const quint64 FNV_PRIME = 1099511628211ULL;
+
+    void hashString(quint64 &hash, const QString &text)
+    {
+        const ushort *data = text.utf16();
+        for (int i = 0; i < text.size(); ++i)
+        {
+            hash ^= data[i];
+            hash *= FNV_PRIME;
+        }
+        hash ^= 0x1F;
+        hash *= FNV_PRIME;
+    }
+
+    // 改变执行顺序的指令，其后一行不参与折叠
+    const QSet<QString> CONTROL_FLOW_INSTRUCTIONS = {"JUMP", "CALL", "RETURN", "MJUMP", "IF_MATCH_JUMP",
+                                                     "IF_NOTMATCH_JUMP", "MATCH_START", "MATCH_END"};
+
+    // 批量删除时每条语句的ID数量，低于SQLite的参数上限
+    const int DELETE_BATCH = 500;
+
+    // 候选块按节省行数从大到小处理，相同时优先周期小的
+    struct FoldLess
+    {
+        bool operator()(const VectorRepeatFold &a, const VectorRepeatFold &b) const
+        {
+            if (a.savedRows() != b.savedRows())
+                return a.savedRows() < b.savedRows();
+            if (a.period != b.period)
+                return a.period > b.period;
+            return a.firstRow > b.firstRow;
+        }
+    };
+}
+
+VectorRepeatAnalyzer::VectorRepeatAnalyzer(const QString &dbPath, int tableId, int maxPeriod)
+    : QObject(nullptr), m_dbPath(dbPath), m_tableId(tableId), m_maxPeriod(maxPeriod), m_cancelled(false)
+{
+    qRegisterMetaType<VectorRepeatFold>("VectorRepeatFold");
+    qRegisterMetaType<QVector<VectorRepeatFold>>("QVector<VectorRepeatFold>");
+    qRegisterMetaType<QVector<int>>("QVector<int>");
+}
+
+void VectorRepeatAnalyzer::cancel()
+{
+    m_cancelled = true;
+}
+
+void VectorRepeatAnalyzer::run()
+{
+    QString connectionName = QString("vector_repeat_%1").arg(reinterpret_cast<quintptr>(this));
+    QString errorMessage;
+    bool success = false;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    {
+        QSqlDatabase db = VectorDiffWorker::openReadOnlyConnection(m_dbPath, connectionName, errorMessage);
+        if (db.isOpen())
+        {
+            VectorRowReader reader(db, m_tableId);
+            if (reader.open(errorMessage))
+            {
+                // 每行只保留哈希、ID和是否可折叠，内存与管脚数无关
+                // 只有一个循环寄存器，已有SET_LOOPA...END_LOOPA循环体和MATCH_START...MATCH_END匹配段内的行
+                // 不能再折叠；跳转、调用等控制流指令之后的一行可能是跳转目标或返回点，同样保留原样
+                VectorRowRecord record;
+                bool insideLoop = false;
+                bool insideMatch = false;
+                bool afterControlFlow = false;
+                while (!m_cancelled && reader.next(record))
+                {
+                    quint64 hash = FNV_OFFSET;
+                    for (const QString &field : record.fields)
+                        hashString(hash, field);
+                    for (const QString &pin : record.pins)
+                        hashString(hash, pin);
+
+                    // fields: Label, Instruction, TimeSet, Capture, Ext, Comment
+                    const QString &instruction = record.fields[1];
+                    if (instruction == "SET_LOOPA")
+                        insideLoop = true;
+                    else if (instruction == "MATCH_START")
+                        insideMatch = true;
+
+                    bool foldable = record.fields[0].isEmpty() && instruction == "INC" && record.fields[4].isEmpty() &&
+                                    !insideLoop && !insideMatch && !afterControlFlow;
+
+                    if (instruction == "END_LOOPA")
+                        insideLoop = false;
+                    else if (instruction == "MATCH_END")
+                        insideMatch = false;
+                    afterControlFlow = CONTROL_FLOW_INSTRUCTIONS.contains(instruction);
+
+                    m_rowHashes.append(hash);
+                    m_foldable.append(foldable);
+                    m_rowIds.append(record.id);
+
+                    if (m_rowIds.size() % 4096 == 0)
+                        emit progress(m_rowIds.size());
+                }
+                if (!m_cancelled)
+                {
+                    selectFolds();
+                    success = true;
+                }
+            }
+            db.close();
+        }
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+
+    if (m_cancelled)
+    {
+        success = false;
+        errorMessage = "分析已取消";
+    }
+
+    qDebug() << "VectorRepeatAnalyzer::run - 表ID:" << m_tableId << "行数:" << m_rowIds.size()
+             << "可折叠块:" << m_folds.size() << "耗时(ms):" << timer.elapsed();
+    emit finished(success, errorMessage, m_rowIds.size(), m_rowIds, m_folds);
+}
+
+void VectorRepeatAnalyzer::selectFolds()
+{
+    const int rowCount = m_rowHashes.size();
+    std::priority_queue<VectorRepeatFold, std::vector<VectorRepeatFold>, FoldLess> candidates;
+
+    // 周期为p的重复等价于行哈希序列与自身错开p行后连续相等：
+    // 相等段[a, a+L)意味着第a行到第a+L+p-1行由长度p的窗口重复构成
+    for (int period = 1; period <= m_maxPeriod && !m_cancelled; ++period)
+    {
+        int runStart = -1;
+        for (int i = 0; i + period <= rowCount; ++i)
+        {
+            bool match = i + period < rowCount &&
+                         m_foldable[i] && m_foldable[i + period] &&
+                         m_rowHashes[i] == m_rowHashes[i + period];
+            if (match)
+            {
+                if (runStart < 0)
+                    runStart = i;
+                continue;
+            }
+
+            if (runStart >= 0)
+            {
+                int count = (i - runStart + period) / period;
+                if (count >= 2)
+                {
+                    VectorRepeatFold fold;
+                    fold.firstRow = runStart;
+                    fold.period = period;
+                    fold.count = count;
+                    candidates.push(fold);
+                }
+                runStart = -1;
+            }
+        }
+    }
+
+    // 贪心选择互不重叠的块，与已选块冲突时裁剪到空闲区间后重新排队
+    QMap<int, int> occupied; // 起始行 -> 结束行(不含)
+    while (!candidates.empty() && !m_cancelled)
+    {
+        VectorRepeatFold fold = candidates.top();
+        candidates.pop();
+
+        int start = fold.firstRow;
+        int end = start + fold.totalRows();
+
+        auto next = occupied.upperBound(start);
+        if (next != occupied.begin())
+        {
+            auto previous = next;
+            --previous;
+            start = qMax(start, previous.value());
+        }
+        next = occupied.lowerBound(start);
+        if (next != occupied.end())
+            end = qMin(end, next.key());
+
+        if (start == fold.firstRow && end == fold.firstRow + fold.totalRows())
+        {
+            occupied.insert(start, end);
+            m_folds.append(fold);
+            continue;
+        }
+
+        // 重复关系对起点平移不变，裁剪后的区间仍是同周期的重复
+        int count = (end - start) / fold.period;
+        if (count >= 2)
+        {
+            fold.firstRow = start;
+            fold.count = count;
+            candidates.push(fold);
+        }
+    }
+
+    std::sort(m_folds.begin(), m_folds.end(), [](const VectorRepeatFold &a, const VectorRepeatFold &b)
+              { return a.firstRow < b.firstRow; });
+}
+
+QVector<QString> VectorRepeatAnalyzer::readRowContents(QSqlDatabase &db, const QVector<int> &rowIds, int first, int count)
+{
+    QHash<int, int> positions; // vector_table_data.id -> 结果下标
+    QStringList idList;
+    for (int i = 0; i < count; ++i)
+    {
+        positions.insert(rowIds[first + i], i);
+        idList << QString::number(rowIds[first + i]);
+    }
+    const QString ids = idList.join(",");
+
+    // 每行的内容按"固定列|管脚值|分组值"拼接，管脚和分组按ID排序，直接比较字符串即可
+    QVector<QStringList> parts(count);
+    QVector<bool> found(count, false);
+
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    if (!query.exec(QString("SELECT id, label, instruction_id, timeset_id, capture, ext, comment "
+                            "FROM vector_table_data WHERE id IN (%1)")
+                        .arg(ids)))
+        throw QString("读取向量行失败: " + query.lastError().text());
+    while (query.next())
+    {
+        int index = positions.value(query.value(0).toInt(), -1);
+        if (index < 0)
+            continue;
+        found[index] = true;
+        for (int column = 1; column <= 6; ++column)
+            parts[index] << query.value(column).toString();
+    }
+    for (bool rowFound : found)
+    {
+        if (!rowFound)
+            throw QString("向量表在分析后已被修改，请重新分析");
+    }
+
+    if (!query.exec(QString("SELECT vector_data_id, vector_pin_id, pin_level FROM vector_table_pin_values "
+                            "WHERE vector_data_id IN (%1) ORDER BY vector_data_id, vector_pin_id")
+                        .arg(ids)))
+        throw QString("读取管脚值失败: " + query.lastError().text());
+    while (query.next())
+    {
+        int index = positions.value(query.value(0).toInt(), -1);
+        if (index >= 0)
+            parts[index] << QString("p%1=%2").arg(query.value(1).toString(), query.value(2).toString());
+    }
+
+    if (!query.exec(QString("SELECT vector_data_id, group_id, group_level FROM vector_table_group_values "
+                            "WHERE vector_data_id IN (%1) ORDER BY vector_data_id, group_id")
+                        .arg(ids)))
+        throw QString("读取分组值失败: " + query.lastError().text());
+    while (query.next())
+    {
+        int index = positions.value(query.value(0).toInt(), -1);
+        if (index >= 0)
+            parts[index] << QString("g%1=%2").arg(query.value(1).toString(), query.value(2).toString());
+    }
+
+    QVector<QString> contents(count);
+    for (int i = 0; i < count; ++i)
+        contents[i] = parts[i].join(QChar(0x1F));
+    return contents;
+}
+
+bool VectorRepeatAnalyzer::foldMatches(QSqlDatabase &db, const QVector<int> &rowIds, const VectorRepeatFold &fold)
+{
+    // 第一组作为基准，其余各组分批读取，逐行与基准中对应的行比较
+    const QVector<QString> reference = readRowContents(db, rowIds, fold.firstRow, fold.period);
+    const int total = fold.totalRows();
+    for (int offset = fold.period; offset < total; offset += DELETE_BATCH)
+    {
+        int count = qMin(int(DELETE_BATCH), total - offset);
+        const QVector<QString> contents = readRowContents(db, rowIds, fold.firstRow + offset, count);
+        for (int i = 0; i < count; ++i)
+        {
+            if (contents[i] != reference[(offset + i) % fold.period])
+                return false;
+        }
+    }
+    return true;
+}
+
+bool VectorRepeatAnalyzer::applyFolds(int tableId, const QVector<int> &rowIds, const QVector<VectorRepeatFold> &folds,
+                                      int &skippedFolds, int &deletedRows, QString &errorMessage)
+{
+    qDebug() << "VectorRepeatAnalyzer::applyFolds - 开始折叠，表ID:" << tableId << "块数:" << folds.size();
+    skippedFolds = 0;
+    deletedRows = 0;
+
+    QSqlDatabase db = DatabaseManager::instance()->database();
+    if (!db.isOpen())
+    {
+        errorMessage = "数据库未打开";
+        return false;
+    }
+
+    db.transaction();
+
+    try
+    {
+        // 查找折叠用的指令ID
+        QMap<QString, int> instructionIds;
+        QSqlQuery instructionQuery(db);
+        if (!instructionQuery.exec("SELECT id, instruction_value FROM instruction_options "
+                                   "WHERE instruction_value IN ('REPEAT', 'SET_LOOPA', 'END_LOOPA')"))
+        {
+            throw QString("查询指令失败: " + instructionQuery.lastError().text());
+        }
+        while (instructionQuery.next())
+        {
+            instructionIds[instructionQuery.value(1).toString()] = instructionQuery.value(0).toInt();
+        }
+        if (instructionIds.size() != 3)
+        {
+            throw QString("指令表中缺少REPEAT/SET_LOOPA/END_LOOPA");
+        }
+
+        QSqlQuery updateQuery(db);
+        updateQuery.prepare("UPDATE vector_table_data SET instruction_id = ?, ext = ? WHERE id = ? AND table_id = ?");
+
+        auto updateRow = [&](int rowId, int instructionId, const QString &ext)
+        {
+            updateQuery.bindValue(0, instructionId);
+            updateQuery.bindValue(1, ext);
+            updateQuery.bindValue(2, rowId);
+            updateQuery.bindValue(3, tableId);
+            if (!updateQuery.exec())
+                throw QString("更新指令失败: " + updateQuery.lastError().text());
+            if (updateQuery.numRowsAffected() != 1)
+                throw QString("向量表在分析后已被修改，请重新分析");
+        };
+
+        QVector<int> idsToDelete;
+        for (const VectorRepeatFold &fold : folds)
+        {
+            int lastRow = fold.firstRow + fold.totalRows() - 1;
+            if (fold.firstRow < 0 || lastRow >= rowIds.size())
+                throw QString("折叠范围超出向量表行数");
+
+            // 行哈希相同不代表内容相同，删除前确认每一组与第一组完全一致
+            if (!foldMatches(db, rowIds, fold))
+            {
+                qWarning() << "VectorRepeatAnalyzer::applyFolds - 块内容与哈希结果不一致，跳过，起始行:"
+                           << fold.firstRow + 1 << "周期:" << fold.period;
+                ++skippedFolds;
+                continue;
+            }
+
+            // 保留第一组，计数写入Ext列
+            QString countText = QString::number(fold.count);
+            if (fold.period == 1)
+            {
+                updateRow(rowIds[fold.firstRow], instructionIds["REPEAT"], countText);
+            }
+            else
+            {
+                updateRow(rowIds[fold.firstRow], instructionIds["SET_LOOPA"], countText);
+                updateRow(rowIds[fold.firstRow + fold.period - 1], instructionIds["END_LOOPA"], QString());
+            }
+
+            for (int row = fold.firstRow + fold.period; row <= lastRow; ++row)
+                idsToDelete.append(rowIds[row]);
+        }
+
+        // 分批删除其余各组
+        QSqlQuery deleteQuery(db);
+        for (int offset = 0; offset < idsToDelete.size(); offset += DELETE_BATCH)
+        {
+            QStringList idList;
+            for (int i = offset; i < qMin(offset + DELETE_BATCH, idsToDelete.size()); ++i)
+                idList << QString::number(idsToDelete[i]);
+            QString ids = idList.join(",");
+
+            if (!deleteQuery.exec(QString("DELETE FROM vector_table_pin_values WHERE vector_data_id IN (%1)").arg(ids)))
+                throw QString("删除管脚值失败: " + deleteQuery.lastError().text());
+            if (!deleteQuery.exec(QString("DELETE FROM vector_table_group_values WHERE vector_data_id IN (%1)").arg(ids)))
+                throw QString("删除分组值失败: " + deleteQuery.lastError().text());
+            if (!deleteQuery.exec(QString("DELETE FROM vector_table_data WHERE table_id = %1 AND id IN (%2)").arg(tableId).arg(ids)))
+                throw QString("删除向量行失败: " + deleteQuery.lastError().text());
+            deletedRows += deleteQuery.numRowsAffected();
+        }
+
+        if (deletedRows != idsToDelete.size())
+        {
+            throw QString("向量表在分析后已被修改，请重新分析");
+        }
+
+        if (!db.commit())
+        {
+            throw QString("提交事务失败: " + db.lastError().text());
+        }
+
+        qDebug() << "VectorRepeatAnalyzer::applyFolds - 折叠完成，删除行数:" << deletedRows << "跳过块数:" << skippedFolds;
+        return true;
+    }
+    catch (const QString &error)
+    {
+        db.rollback();
+        errorMessage = error;
+        deletedRows = 0;
+        qDebug() << "VectorRepeatAnalyzer::applyFolds - 错误:" << errorMessage;
+        return false;
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef VECTORREPEATANALYZER_H
+#define VECTORREPEATANALYZER_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QMetaType>
+#include <QSqlDatabase>
+#include <atomic>
+
+// 一个可折叠的重复块：从firstRow开始，period行为一组，连续重复count次
+struct VectorRepeatFold
+{
+    int firstRow; // 起始行(0-based)
+    int period;   // 每组行数，1表示静止段
+    int count;    // 重复次数(>=2)
+
+    int totalRows() const { return period * count; }
+    int savedRows() const { return period * (count - 1); }
+};
+Q_DECLARE_METATYPE(VectorRepeatFold)
+Q_DECLARE_METATYPE(QVector<VectorRepeatFold>)
+
+// 后台扫描向量表，找出物理展开的重复行序列和静止段
+class VectorRepeatAnalyzer : public QObject
+{
+    Q_OBJECT
+
+public:
+    VectorRepeatAnalyzer(const QString &dbPath, int tableId, int maxPeriod);
+
+    void cancel();
+
+    // 按分析结果改写向量表：每个块只保留第一组，静止段改为REPEAT，多行组用SET_LOOPA/END_LOOPA包围
+    // rowIds为分析时各行的vector_table_data.id
+    // 分析只比较行哈希，改写前逐行比较实际内容，不完全相同的块跳过，跳过的块数写入skippedFolds
+    static bool applyFolds(int tableId, const QVector<int> &rowIds, const QVector<VectorRepeatFold> &folds,
+                           int &skippedFolds, int &deletedRows, QString &errorMessage);
+
+public slots:
+    void run();
+
+signals:
+    void progress(int scannedRows);
+    void finished(bool success, const QString &errorMessage, int totalRows,
+                  const QVector<int> &rowIds, const QVector<VectorRepeatFold> &folds);
+
+private:
+    void selectFolds();
+
+    // 从数据库读取rowIds[first, first + count)各行的完整内容(固定列、管脚值和分组值)，按行序返回
+    static QVector<QString> readRowContents(QSqlDatabase &db, const QVector<int> &rowIds, int first, int count);
+    // 块内每一行与前一组对应行的内容完全相同
+    static bool foldMatches(QSqlDatabase &db, const QVector<int> &rowIds, const VectorRepeatFold &fold);
+
+    QString m_dbPath;
+    int m_tableId;
+    int m_maxPeriod;
+    std::atomic<bool> m_cancelled;
+
+    QVector<quint64> m_rowHashes;
+    QVector<bool> m_foldable; // 只有普通INC行且没有标签和扩展参数、不在已有循环/匹配段内、不紧跟控制流指令的行才能折叠
+    QVector<int> m_rowIds;
+    QVector<VectorRepeatFold> m_folds;
+};
+
+#endif // VECTORREPEATANALYZER_H
@@ -0,0 +1,263 @@
+#include "vectorrepeatdialog.h"
+#include "database/databasemanager.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QThread>
+#include <QSqlQuery>
+#include <QDebug>
+
+VectorRepeatDialog::VectorRepeatDialog(const QString &dbPath, int tableId, const QString &tableName, QWidget *parent)
+    : QDialog(parent), m_dbPath(dbPath), m_tableId(tableId), m_tableName(tableName),
+      m_thread(nullptr), m_worker(nullptr)
+{
+    setWindowTitle("重复检测 - " + tableName);
+    resize(700, 500);
+    setupUI();
+}
+
+VectorRepeatDialog::~VectorRepeatDialog()
+{
+    stopAnalysis();
+}
+
+void VectorRepeatDialog::setupUI()
+{
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+
+    // 参数和操作按钮
+    QHBoxLayout *controlLayout = new QHBoxLayout();
+    controlLayout->addWidget(new QLabel("最大重复周期(行):", this));
+    m_maxPeriodSpinBox = new QSpinBox(this);
+    m_maxPeriodSpinBox->setRange(1, 256);
+    m_maxPeriodSpinBox->setValue(32);
+    controlLayout->addWidget(m_maxPeriodSpinBox);
+
+    m_analyzeButton = new QPushButton("开始分析", this);
+    m_stopButton = new QPushButton("停止", this);
+    m_stopButton->setEnabled(false);
+    controlLayout->addWidget(m_analyzeButton);
+    controlLayout->addWidget(m_stopButton);
+    controlLayout->addSpacing(20);
+    m_statusLabel = new QLabel(this);
+    controlLayout->addWidget(m_statusLabel);
+    controlLayout->addStretch();
+    mainLayout->addLayout(controlLayout);
+
+    // 结果列表
+    m_resultTable = new QTableWidget(this);
+    m_resultTable->setColumnCount(6);
+    m_resultTable->setHorizontalHeaderLabels(QStringList() << "起始行" << "结束行" << "周期" << "重复次数" << "可节省行数" << "类型");
+    m_resultTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_resultTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_resultTable->verticalHeader()->setVisible(false);
+    m_resultTable->horizontalHeader()->setStretchLastSection(true);
+    mainLayout->addWidget(m_resultTable, 1);
+
+    // 汇总和折叠
+    QHBoxLayout *bottomLayout = new QHBoxLayout();
+    m_summaryLabel = new QLabel(this);
+    m_summaryLabel->setWordWrap(true);
+    bottomLayout->addWidget(m_summaryLabel, 1);
+    m_foldButton = new QPushButton("折叠为紧凑形式", this);
+    m_foldButton->setEnabled(false);
+    bottomLayout->addWidget(m_foldButton);
+    mainLayout->addLayout(bottomLayout);
+
+    connect(m_analyzeButton, &QPushButton::clicked, this, &VectorRepeatDialog::startAnalysis);
+    connect(m_stopButton, &QPushButton::clicked, this, &VectorRepeatDialog::stopAnalysis);
+    connect(m_foldButton, &QPushButton::clicked, this, &VectorRepeatDialog::applyFolds);
+    connect(m_resultTable, &QTableWidget::cellDoubleClicked, this, &VectorRepeatDialog::onCellDoubleClicked);
+}
+
+void VectorRepeatDialog::startAnalysis()
+{
+    stopAnalysis();
+    m_rowIds.clear();
+    m_folds.clear();
+    m_resultTable->setRowCount(0);
+    m_summaryLabel->clear();
+    m_foldButton->setEnabled(false);
+
+    m_thread = new QThread(this);
+    m_worker = new VectorRepeatAnalyzer(m_dbPath, m_tableId, m_maxPeriodSpinBox->value());
+    m_worker->moveToThread(m_thread);
+
+    connect(m_thread, &QThread::started, m_worker, &VectorRepeatAnalyzer::run);
+    connect(m_worker, &VectorRepeatAnalyzer::progress, this, &VectorRepeatDialog::onProgress);
+    connect(m_worker, &VectorRepeatAnalyzer::finished, this, &VectorRepeatDialog::onFinished);
+
+    m_analyzeButton->setEnabled(false);
+    m_stopButton->setEnabled(true);
+    m_statusLabel->setText("正在分析...");
+    m_thread->start();
+}
+
+void VectorRepeatDialog::cleanupWorker()
+{
+    if (!m_thread)
+        return;
+
+    disconnect(m_worker, nullptr, this, nullptr);
+    m_thread->quit();
+    m_thread->wait();
+    delete m_worker;
+    delete m_thread;
+    m_worker = nullptr;
+    m_thread = nullptr;
+
+    m_analyzeButton->setEnabled(true);
+    m_stopButton->setEnabled(false);
+}
+
+void VectorRepeatDialog::stopAnalysis()
+{
+    if (!m_worker)
+        return;
+
+    m_worker->cancel();
+    cleanupWorker();
+    m_statusLabel->setText("分析已停止");
+}
+
+void VectorRepeatDialog::onProgress(int scannedRows)
+{
+    m_statusLabel->setText(QString("正在分析... 已读取 %1 行").arg(scannedRows));
+}
+
+void VectorRepeatDialog::onFinished(bool success, const QString &errorMessage, int totalRows,
+                                    const QVector<int> &rowIds, const QVector<VectorRepeatFold> &folds)
+{
+    cleanupWorker();
+
+    if (!success)
+    {
+        m_statusLabel->setText(errorMessage);
+        return;
+    }
+
+    m_rowIds = rowIds;
+    m_folds = folds;
+
+    // 填充结果并统计静止段和循环块
+    int savedRows = 0;
+    int deadRuns = 0;
+    int deadRows = 0;
+    int loopBlocks = 0;
+    int loopRows = 0;
+    m_resultTable->setRowCount(folds.size());
+    for (int i = 0; i < folds.size(); ++i)
+    {
+        const VectorRepeatFold &fold = folds[i];
+        bool dead = fold.period == 1;
+        savedRows += fold.savedRows();
+        if (dead)
+        {
+            deadRuns++;
+            deadRows += fold.totalRows();
+        }
+        else
+        {
+            loopBlocks++;
+            loopRows += fold.totalRows();
+        }
+
+        QStringList cells;
+        cells << QString::number(fold.firstRow + 1)
+              << QString::number(fold.firstRow + fold.totalRows())
+              << QString::number(fold.period)
+              << QString::number(fold.count)
+              << QString::number(fold.savedRows())
+              << (dead ? "静止段(REPEAT)" : "循环块(SET_LOOPA)");
+        for (int c = 0; c < cells.size(); ++c)
+        {
+            QTableWidgetItem *item = new QTableWidgetItem(cells[c]);
+            if (c < cells.size() - 1)
+                item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            m_resultTable->setItem(i, c, item);
+        }
+    }
+
+    // 每行数据还带有每个管脚一条状态记录
+    int pinCount = 0;
+    QSqlQuery pinQuery(DatabaseManager::instance()->database());
+    pinQuery.prepare("SELECT COUNT(*) FROM vector_table_pins WHERE table_id = ?");
+    pinQuery.addBindValue(m_tableId);
+    if (pinQuery.exec() && pinQuery.next())
+        pinCount = pinQuery.value(0).toInt();
+
+    double percent = totalRows > 0 ? savedRows * 100.0 / totalRows : 0.0;
+    m_summaryLabel->setText(QString("共 %1 行；静止段 %2 处(%3 行)，循环块 %4 处(%5 行)。\n"
+                                    "折叠后剩余 %6 行，可节省 %7 行(%8%)，约 %9 条管脚状态记录。")
+                                .arg(totalRows)
+                                .arg(deadRuns)
+                                .arg(deadRows)
+                                .arg(loopBlocks)
+                                .arg(loopRows)
+                                .arg(totalRows - savedRows)
+                                .arg(savedRows)
+                                .arg(percent, 0, 'f', 1)
+                                .arg(static_cast<qint64>(savedRows) * pinCount));
+    m_statusLabel->setText("分析完成");
+    m_foldButton->setEnabled(!folds.isEmpty());
+}
+
+void VectorRepeatDialog::onCellDoubleClicked(int row, int column)
+{
+    Q_UNUSED(column);
+    if (row >= 0 && row < m_folds.size())
+        emit rowActivated(m_folds[row].firstRow);
+}
+
+void VectorRepeatDialog::applyFolds()
+{
+    if (m_folds.isEmpty())
+        return;
+
+    // 折叠后向量表会重新加载，先让主窗口保存或取消
+    if (m_beforeFoldCheck && !m_beforeFoldCheck())
+        return;
+
+    int savedRows = 0;
+    for (const VectorRepeatFold &fold : m_folds)
+        savedRows += fold.savedRows();
+
+    QMessageBox::StandardButton reply = QMessageBox::question(
+        this, "确认折叠",
+        QString("将改写向量表 %1：%2 处重复块只保留第一组，重复次数写入Ext列，共删除 %3 行。\n"
+                "测试机执行的行序列不变，内容与分析结果不一致的块会被跳过。此操作不可撤销。\n是否继续？")
+            .arg(m_tableName)
+            .arg(m_folds.size())
+            .arg(savedRows),
+        QMessageBox::Yes | QMessageBox::No);
+    if (reply != QMessageBox::Yes)
+        return;
+
+    QString errorMessage;
+    int skippedFolds = 0;
+    int deletedRows = 0;
+    if (!VectorRepeatAnalyzer::applyFolds(m_tableId, m_rowIds, m_folds, skippedFolds, deletedRows, errorMessage))
+    {
+        QMessageBox::critical(this, "折叠失败", errorMessage);
+        return;
+    }
+
+    qDebug() << "VectorRepeatDialog::applyFolds - 折叠完成，表:" << m_tableName << "删除行数:" << deletedRows
+             << "跳过块数:" << skippedFolds;
+    QString message = QString("已折叠 %1 处重复块，删除 %2 行").arg(m_folds.size() - skippedFolds).arg(deletedRows);
+    if (skippedFolds > 0)
+        message += QString("\n%1 处块的实际内容与分析结果不一致，已跳过").arg(skippedFolds);
+    QMessageBox::information(this, "折叠完成", message);
+
+    // 行号已变化，旧结果作废
+    m_rowIds.clear();
+    m_folds.clear();
+    m_resultTable->setRowCount(0);
+    m_summaryLabel->clear();
+    m_foldButton->setEnabled(false);
+    m_statusLabel->clear();
+
+    emit tableFolded(m_tableId);
+}
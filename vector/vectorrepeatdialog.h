@@ -0,0 +1,69 @@
+#ifndef VECTORREPEATDIALOG_H
+#define VECTORREPEATDIALOG_H
+
+#include <QDialog>
+#include <QSpinBox>
+#include <QPushButton>
+#include <QLabel>
+#include <QTableWidget>
+#include <QVector>
+#include <functional>
+#include "vectorrepeatanalyzer.h"
+
+class QThread;
+
+// 重复检测窗口：分析向量表中可折叠的重复块，报告可节省的空间，并可选择改写为REPEAT/循环形式
+class VectorRepeatDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    VectorRepeatDialog(const QString &dbPath, int tableId, const QString &tableName, QWidget *parent = nullptr);
+    ~VectorRepeatDialog();
+
+    // 折叠前调用，由主窗口处理表格中未保存的编辑，返回false时取消折叠
+    typedef std::function<bool()> BeforeFoldCheck;
+    void setBeforeFoldCheck(const BeforeFoldCheck &check) { m_beforeFoldCheck = check; }
+
+signals:
+    // 双击结果时跳转到向量表对应行
+    void rowActivated(int row);
+
+    // 折叠完成，需要重新加载向量表
+    void tableFolded(int tableId);
+
+private slots:
+    void startAnalysis();
+    void stopAnalysis();
+    void onProgress(int scannedRows);
+    void onFinished(bool success, const QString &errorMessage, int totalRows,
+                    const QVector<int> &rowIds, const QVector<VectorRepeatFold> &folds);
+    void onCellDoubleClicked(int row, int column);
+    void applyFolds();
+
+private:
+    void setupUI();
+    void cleanupWorker();
+
+    QString m_dbPath;
+    int m_tableId;
+    QString m_tableName;
+
+    QSpinBox *m_maxPeriodSpinBox;
+    QPushButton *m_analyzeButton;
+    QPushButton *m_stopButton;
+    QPushButton *m_foldButton;
+    QLabel *m_statusLabel;
+    QLabel *m_summaryLabel;
+    QTableWidget *m_resultTable;
+
+    QThread *m_thread;
+    VectorRepeatAnalyzer *m_worker;
+    BeforeFoldCheck m_beforeFoldCheck;
+
+    // 最近一次分析结果
+    QVector<int> m_rowIds;
+    QVector<VectorRepeatFold> m_folds;
+};
+
+#endif // VECTORREPEATDIALOG_H
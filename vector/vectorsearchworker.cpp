@@ -0,0 +1,384 @@
+#include "vectorsearchworker.h"
+
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QRegularExpression>
+#include <QHash>
+#include <QDebug>
+#include <limits>
+#include <algorithm>
+
+namespace
+{
+    // 每批返回的匹配数和进度上报间隔(行)
+    const int MATCH_BATCH_SIZE = 256;
+    const int PROGRESS_INTERVAL = 65536;
+
+    // 掩码最多容纳的pin_options取值个数
+    const int MAX_PIN_OPTIONS = 32;
+}
+
+VectorSearchWorker::VectorSearchWorker(const QString &dbPath, int tableId, SearchMode mode, const QString &pattern)
+    : QObject(nullptr), m_dbPath(dbPath), m_tableId(tableId), m_mode(mode), m_pattern(pattern), m_cancelled(false)
+{
+    qRegisterMetaType<QVector<int>>("QVector<int>");
+}
+
+void VectorSearchWorker::cancel()
+{
+    m_cancelled = true;
+}
+
+bool VectorSearchWorker::loadPinOptions(QSqlDatabase &db, QHash<int, int> &bitByOptionId,
+                                        QHash<QChar, int> &bitByValue, QString &errorMessage)
+{
+    bitByOptionId.clear();
+    bitByValue.clear();
+
+    QSqlQuery query(db);
+    if (!query.exec("SELECT id, pin_value FROM pin_options ORDER BY id"))
+    {
+        errorMessage = "查询管脚状态选项失败: " + query.lastError().text();
+        return false;
+    }
+    while (query.next())
+    {
+        QString value = query.value(1).toString().trimmed().toUpper();
+        if (value.size() != 1 || bitByValue.contains(value.at(0)))
+            continue;
+        if (bitByValue.size() >= MAX_PIN_OPTIONS)
+        {
+            qWarning() << "VectorSearchWorker::loadPinOptions - 管脚状态选项过多，忽略:" << value;
+            continue;
+        }
+        int bit = bitByValue.size();
+        bitByValue.insert(value.at(0), bit);
+        bitByOptionId.insert(query.value(0).toInt(), bit);
+    }
+
+    // 没有取值记录的管脚按X处理
+    if (!bitByValue.contains('X'))
+    {
+        errorMessage = "pin_options中缺少X状态";
+        return false;
+    }
+    return true;
+}
+
+bool VectorSearchWorker::parsePinPattern(const QString &pattern, const QMap<int, QString> &vectorPins,
+                                         const QHash<QChar, int> &optionBits,
+                                         QList<PinPatternTerm> &terms, QString &errorMessage)
+{
+    terms.clear();
+
+    const QStringList parts = pattern.split(QRegularExpression("[,;\\s]+"), Qt::SkipEmptyParts);
+    if (parts.isEmpty())
+    {
+        errorMessage = "请输入管脚状态条件，例如 CLK=1, DATA=X";
+        return false;
+    }
+
+    for (const QString &part : parts)
+    {
+        int eq = part.indexOf('=');
+        if (eq <= 0 || eq == part.size() - 1)
+        {
+            errorMessage = QString("无效的条件: %1").arg(part);
+            return false;
+        }
+
+        QString namePattern = part.left(eq).trimmed();
+        QString values = part.mid(eq + 1).trimmed();
+
+        // 取值为*或?表示任意状态，不参与匹配
+        if (values == "*" || values == "?")
+            continue;
+
+        quint32 mask = 0;
+        for (QChar c : values)
+        {
+            int bit = optionBits.value(c.toUpper(), -1);
+            if (bit < 0)
+            {
+                QStringList available;
+                for (auto it = optionBits.constBegin(); it != optionBits.constEnd(); ++it)
+                    available << QString(it.key());
+                std::sort(available.begin(), available.end());
+                errorMessage = QString("无效的管脚状态 '%1'，可用状态: %2").arg(c).arg(available.join(" "));
+                return false;
+            }
+            mask |= 1u << bit;
+        }
+
+        QRegularExpression nameRegex(QRegularExpression::wildcardToRegularExpression(namePattern),
+                                     QRegularExpression::CaseInsensitiveOption);
+        bool matched = false;
+        for (auto it = vectorPins.constBegin(); it != vectorPins.constEnd(); ++it)
+        {
+            if (nameRegex.match(it.value()).hasMatch())
+            {
+                terms.append(PinPatternTerm{it.key(), mask});
+                matched = true;
+            }
+        }
+
+        if (!matched)
+        {
+            errorMessage = QString("当前向量表中没有匹配 '%1' 的管脚").arg(namePattern);
+            return false;
+        }
+    }
+
+    if (terms.isEmpty())
+    {
+        errorMessage = "条件中没有需要匹配的管脚状态";
+        return false;
+    }
+
+    return true;
+}
+
+void VectorSearchWorker::run()
+{
+    QString connectionName = QString("vector_search_%1").arg(reinterpret_cast<quintptr>(this));
+    bool success = false;
+    QString errorMessage;
+
+    {
+        // SQLite连接不能跨线程使用，查找线程打开自己的只读连接
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        db.setDatabaseName(m_dbPath);
+        db.setConnectOptions("QSQLITE_OPEN_READONLY");
+
+        if (!db.open())
+        {
+            errorMessage = "无法打开数据库: " + db.lastError().text();
+        }
+        else
+        {
+            if (m_mode == SearchPinPattern)
+                success = searchPinPattern(db, errorMessage);
+            else
+                success = searchText(db, errorMessage);
+            db.close();
+        }
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+
+    if (m_cancelled)
+    {
+        success = false;
+        errorMessage = "查找已取消";
+    }
+
+    qDebug() << "VectorSearchWorker::run - 查找结束, 成功:" << success << errorMessage;
+    emit finished(success, errorMessage);
+}
+
+int VectorSearchWorker::countRows(QSqlDatabase &db)
+{
+    QSqlQuery query(db);
+    query.prepare("SELECT COUNT(*) FROM vector_table_data WHERE table_id = ?");
+    query.addBindValue(m_tableId);
+    if (query.exec() && query.next())
+        return query.value(0).toInt();
+    return 0;
+}
+
+bool VectorSearchWorker::searchText(QSqlDatabase &db, QString &errorMessage)
+{
+    QString column = (m_mode == SearchLabel) ? "label" : "comment";
+
+    // 不含通配符时按包含匹配
+    QString glob = m_pattern;
+    if (!glob.contains('*') && !glob.contains('?') && !glob.contains('['))
+        glob = "*" + glob + "*";
+
+    int totalRows = countRows(db);
+
+    // 走(table_id, label/comment, sort_index)的部分覆盖索引，只扫描非空的标签/注释
+    QSqlQuery hitQuery(db);
+    hitQuery.setForwardOnly(true);
+    hitQuery.prepare(QString("SELECT sort_index FROM vector_table_data "
+                             "WHERE table_id = ? AND %1 <> '' AND %1 GLOB ?")
+                         .arg(column));
+    hitQuery.addBindValue(m_tableId);
+    hitQuery.addBindValue(glob);
+    if (!hitQuery.exec())
+    {
+        errorMessage = "查找失败: " + hitQuery.lastError().text();
+        return false;
+    }
+
+    // 命中数远小于行数，在内存中排序，避免按sort_index扫描整张表
+    QVector<qint64> hits;
+    while (hitQuery.next())
+    {
+        hits.append(hitQuery.value(0).toLongLong());
+    }
+    std::sort(hits.begin(), hits.end());
+
+    // sort_index不连续，行号通过累计两个命中之间的行数得到
+    QSqlQuery countQuery(db);
+    countQuery.prepare("SELECT COUNT(*) FROM vector_table_data "
+                       "WHERE table_id = ? AND sort_index >= ? AND sort_index < ?");
+
+    QVector<int> batch;
+    int row = 0;
+    qint64 previousSortIndex = std::numeric_limits<qint64>::min();
+
+    for (qint64 sortIndex : hits)
+    {
+        if (m_cancelled)
+            return false;
+
+        countQuery.bindValue(0, m_tableId);
+        countQuery.bindValue(1, previousSortIndex);
+        countQuery.bindValue(2, sortIndex);
+        if (!countQuery.exec() || !countQuery.next())
+        {
+            errorMessage = "计算行号失败: " + countQuery.lastError().text();
+            return false;
+        }
+        row += countQuery.value(0).toInt();
+        countQuery.finish();
+
+        batch.append(row);
+        previousSortIndex = sortIndex;
+
+        if (batch.size() >= MATCH_BATCH_SIZE)
+        {
+            emit matchesFound(batch);
+            emit progress(row + 1, totalRows);
+            batch.clear();
+        }
+    }
+
+    if (!batch.isEmpty())
+        emit matchesFound(batch);
+    emit progress(totalRows, totalRows);
+    return true;
+}
+
+bool VectorSearchWorker::searchPinPattern(QSqlDatabase &db, QString &errorMessage)
+{
+    // 读取本表管脚并解析条件
+    QMap<int, QString> vectorPins;
+    QSqlQuery pinQuery(db);
+    pinQuery.prepare("SELECT vtp.id, pl.pin_name FROM vector_table_pins vtp "
+                     "JOIN pin_list pl ON vtp.pin_id = pl.id WHERE vtp.table_id = ?");
+    pinQuery.addBindValue(m_tableId);
+    if (!pinQuery.exec())
+    {
+        errorMessage = "查询管脚失败: " + pinQuery.lastError().text();
+        return false;
+    }
+    while (pinQuery.next())
+    {
+        vectorPins[pinQuery.value(0).toInt()] = pinQuery.value(1).toString();
+    }
+
+    // 取值ID从pin_options读取，不依赖默认数据的ID
+    QHash<int, int> bitByOptionId;
+    QHash<QChar, int> bitByValue;
+    if (!loadPinOptions(db, bitByOptionId, bitByValue, errorMessage))
+        return false;
+    const int xBit = bitByValue.value('X');
+
+    QList<PinPatternTerm> terms;
+    if (!parsePinPattern(m_pattern, vectorPins, bitByValue, terms, errorMessage))
+        return false;
+
+    // 同一管脚可能被多个条件匹配到
+    QHash<int, QList<int>> pinToTerms;
+    QStringList idStrings;
+    for (int i = 0; i < terms.size(); ++i)
+    {
+        pinToTerms[terms[i].vectorPinId].append(i);
+        idStrings << QString::number(terms[i].vectorPinId);
+    }
+
+    int totalRows = countRows(db);
+
+    // 按行顺序扫描，只连接条件涉及的管脚；没有取值记录的管脚按X处理
+    // vector_data_id列没有声明类型，用+vtd.id去掉右侧的类型亲和性，才能走唯一索引
+    QSqlQuery scanQuery(db);
+    scanQuery.setForwardOnly(true);
+    QString scanSql = QString("SELECT vtd.id, vtpv.vector_pin_id, vtpv.pin_level "
+                              "FROM vector_table_data vtd "
+                              "LEFT JOIN vector_table_pin_values vtpv "
+                              "  ON vtpv.vector_data_id = +vtd.id AND vtpv.vector_pin_id IN (%1) "
+                              "WHERE vtd.table_id = %2 "
+                              "ORDER BY vtd.sort_index, vtd.id")
+                          .arg(idStrings.join(","))
+                          .arg(m_tableId);
+    if (!scanQuery.exec(scanSql))
+    {
+        errorMessage = "查找失败: " + scanQuery.lastError().text();
+        return false;
+    }
+
+    QVector<int> levels(terms.size(), xBit);
+    QVector<int> batch;
+    int row = -1;
+    int currentId = -1;
+
+    auto evaluateRow = [&]()
+    {
+        for (int i = 0; i < terms.size(); ++i)
+        {
+            if (!(terms[i].allowedMask & (1u << levels[i])))
+                return;
+        }
+        batch.append(row);
+    };
+
+    while (scanQuery.next())
+    {
+        int vectorDataId = scanQuery.value(0).toInt();
+        if (vectorDataId != currentId)
+        {
+            if (row >= 0)
+                evaluateRow();
+
+            currentId = vectorDataId;
+            ++row;
+            levels.fill(xBit);
+
+            if (row % PROGRESS_INTERVAL == 0)
+            {
+                if (m_cancelled)
+                    return false;
+                if (!batch.isEmpty())
+                {
+                    emit matchesFound(batch);
+                    batch.clear();
+                }
+                emit progress(row, totalRows);
+            }
+        }
+
+        if (!scanQuery.value(1).isNull())
+        {
+            int bit = bitByOptionId.value(scanQuery.value(2).toInt(), -1);
+            if (bit >= 0)
+            {
+                for (int term : pinToTerms.value(scanQuery.value(1).toInt()))
+                    levels[term] = bit;
+            }
+        }
+
+        if (batch.size() >= MATCH_BATCH_SIZE)
+        {
+            emit matchesFound(batch);
+            batch.clear();
+        }
+    }
+
+    if (row >= 0)
+        evaluateRow();
+    if (!batch.isEmpty())
+        emit matchesFound(batch);
+    emit progress(totalRows, totalRows);
+    return true;
+}
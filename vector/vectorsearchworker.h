@@ -0,0 +1,69 @@
+#ifndef VECTORSEARCHWORKER_H
+#define VECTORSEARCHWORKER_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QList>
+#include <QMap>
+#include <QHash>
+#include <QSqlDatabase>
+#include <atomic>
+
+// 单条管脚状态匹配条件: 某个向量表管脚允许的pin_options取值集合
+struct PinPatternTerm
+{
+    int vectorPinId;   // vector_table_pins.id
+    quint32 allowedMask; // 第n位表示按id顺序的第n个pin_options取值被允许
+};
+
+// 后台查找向量表的工作对象，运行在独立线程并使用独立的数据库连接
+class VectorSearchWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum SearchMode
+    {
+        SearchLabel = 0,
+        SearchComment,
+        SearchPinPattern
+    };
+
+    VectorSearchWorker(const QString &dbPath, int tableId, SearchMode mode, const QString &pattern);
+
+    // 请求取消(可从任意线程调用)
+    void cancel();
+
+    // 解析管脚状态模式，如"CLK=1, DATA=X"，管脚名支持*和?通配符，取值可写多个字符如"DATA=01"，*表示任意
+    // optionBits是pin_options取值(大写字符)到掩码位的映射
+    static bool parsePinPattern(const QString &pattern, const QMap<int, QString> &vectorPins,
+                                const QHash<QChar, int> &optionBits,
+                                QList<PinPatternTerm> &terms, QString &errorMessage);
+
+public slots:
+    void run();
+
+signals:
+    // 按行号升序分批返回匹配的行(0-based)
+    void matchesFound(const QVector<int> &rows);
+    void progress(int scannedRows, int totalRows);
+    void finished(bool success, const QString &errorMessage);
+
+private:
+    bool searchText(QSqlDatabase &db, QString &errorMessage);
+    bool searchPinPattern(QSqlDatabase &db, QString &errorMessage);
+    int countRows(QSqlDatabase &db);
+
+    // 读取pin_options，按id顺序为每个取值分配一个掩码位
+    static bool loadPinOptions(QSqlDatabase &db, QHash<int, int> &bitByOptionId,
+                               QHash<QChar, int> &bitByValue, QString &errorMessage);
+
+    QString m_dbPath;
+    int m_tableId;
+    SearchMode m_mode;
+    QString m_pattern;
+    std::atomic<bool> m_cancelled;
+};
+
+#endif // VECTORSEARCHWORKER_H
@@ -0,0 +1,118 @@
+#include "vectorvalidationdock.h"
+#include "vectorvalidator.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QDebug>
+
+namespace
+{
+    // 列表最多显示的问题数量，避免一次创建过多条目
+    const int MAX_LIST_ITEMS = 10000;
+}
+
+VectorValidationDock::VectorValidationDock(QTableWidget *tableWidget, QWidget *parent)
+    : QDockWidget("校验结果", parent)
+{
+    setObjectName("VectorValidationDock");
+    setAllowedAreas(Qt::BottomDockWidgetArea | Qt::LeftDockWidgetArea | Qt::RightDockWidgetArea);
+
+    m_validator = new VectorValidator(tableWidget, this);
+
+    QWidget *content = new QWidget(this);
+    QVBoxLayout *layout = new QVBoxLayout(content);
+    layout->setContentsMargins(4, 4, 4, 4);
+
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    m_validateButton = new QPushButton("全部校验", content);
+    m_revalidateButton = new QPushButton("校验修改部分", content);
+    m_revalidateButton->setEnabled(false);
+    m_statusLabel = new QLabel(content);
+    buttonLayout->addWidget(m_validateButton);
+    buttonLayout->addWidget(m_revalidateButton);
+    buttonLayout->addWidget(m_statusLabel, 1);
+    layout->addLayout(buttonLayout);
+
+    m_listWidget = new QListWidget(content);
+    layout->addWidget(m_listWidget);
+
+    setWidget(content);
+
+    connect(m_validateButton, &QPushButton::clicked, this, &VectorValidationDock::validateAll);
+    connect(m_revalidateButton, &QPushButton::clicked, this, &VectorValidationDock::revalidate);
+    connect(m_validator, &VectorValidator::progress, this, &VectorValidationDock::onProgress);
+    connect(m_validator, &VectorValidator::finished, this, &VectorValidationDock::onFinished);
+    connect(m_validator, &VectorValidator::resultsOutdated, this, &VectorValidationDock::onResultsOutdated);
+    connect(m_listWidget, &QListWidget::itemActivated, this, &VectorValidationDock::onItemActivated);
+    connect(m_listWidget, &QListWidget::itemClicked, this, &VectorValidationDock::onItemActivated);
+}
+
+void VectorValidationDock::setTableId(int tableId)
+{
+    m_validator->setTableId(tableId);
+    m_listWidget->clear();
+    m_statusLabel->clear();
+    m_revalidateButton->setEnabled(false);
+}
+
+void VectorValidationDock::validateAll()
+{
+    QString errorMessage;
+    m_statusLabel->setText("正在校验...");
+    if (!m_validator->validateAll(errorMessage))
+        m_statusLabel->setText(errorMessage);
+}
+
+void VectorValidationDock::revalidate()
+{
+    QString errorMessage;
+    m_statusLabel->setText(QString("正在校验 %1 个修改过的块...").arg(m_validator->dirtyChunkCount()));
+    if (!m_validator->revalidate(errorMessage))
+        m_statusLabel->setText(errorMessage);
+}
+
+void VectorValidationDock::onProgress(int finishedChunks, int totalChunks)
+{
+    m_statusLabel->setText(QString("正在校验... %1 / %2 块").arg(finishedChunks).arg(totalChunks));
+}
+
+void VectorValidationDock::onFinished(int violationCount)
+{
+    const QVector<ValidationViolation> &violations = m_validator->violations();
+
+    m_listWidget->clear();
+    int shown = qMin(violations.size(), MAX_LIST_ITEMS);
+    for (int i = 0; i < shown; ++i)
+    {
+        const ValidationViolation &violation = violations[i];
+        QListWidgetItem *item = new QListWidgetItem(QString("第 %1 行: %2").arg(violation.row + 1).arg(violation.message),
+                                                    m_listWidget);
+        item->setData(Qt::UserRole, violation.row);
+        item->setData(Qt::UserRole + 1, violation.column);
+    }
+
+    QString text = violationCount == 0 ? QString("未发现问题") : QString("共 %1 个问题").arg(violationCount);
+    if (violationCount > shown)
+        text += QString("(仅列出前 %1 个)").arg(shown);
+    m_statusLabel->setText(text);
+    m_revalidateButton->setEnabled(m_validator->dirtyChunkCount() > 0);
+
+    qDebug() << "VectorValidationDock::onFinished - 校验完成，问题数:" << violationCount;
+}
+
+void VectorValidationDock::onResultsOutdated()
+{
+    if (m_validator->isRunning())
+        return;
+
+    m_revalidateButton->setEnabled(true);
+    m_statusLabel->setText(QString("共 %1 个问题，表格已修改，结果可能已过期").arg(m_validator->violations().size()));
+}
+
+void VectorValidationDock::onItemActivated(QListWidgetItem *item)
+{
+    if (!item)
+        return;
+
+    emit cellActivated(item->data(Qt::UserRole).toInt(), item->data(Qt::UserRole + 1).toInt());
+}
@@ -0,0 +1,49 @@
+#ifndef VECTORVALIDATIONDOCK_H
+#define VECTORVALIDATIONDOCK_H
+
+#include <QDockWidget>
+#include <QListWidget>
+#include <QPushButton>
+#include <QLabel>
+#include <QTableWidget>
+
+class VectorValidator;
+
+// 校验结果停靠窗口：列出当前向量表的校验问题，点击跳转到对应单元格
+class VectorValidationDock : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+    VectorValidationDock(QTableWidget *tableWidget, QWidget *parent = nullptr);
+
+    // 切换向量表，清空结果
+    void setTableId(int tableId);
+
+public slots:
+    // 校验全部行
+    void validateAll();
+
+    // 只校验修改过的部分
+    void revalidate();
+
+signals:
+    // 用户选择了某个问题，column为-1时只定位到行
+    void cellActivated(int row, int column);
+
+private slots:
+    void onProgress(int finishedChunks, int totalChunks);
+    void onFinished(int violationCount);
+    void onResultsOutdated();
+    void onItemActivated(QListWidgetItem *item);
+
+private:
+    QListWidget *m_listWidget;
+    QPushButton *m_validateButton;
+    QPushButton *m_revalidateButton;
+    QLabel *m_statusLabel;
+
+    VectorValidator *m_validator;
+};
+
+#endif // VECTORVALIDATIONDOCK_H
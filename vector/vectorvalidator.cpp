@@ -0,0 +1,423 @@
+#include "vectorvalidator.h"
+#include "pinbuscolumns.h"
+#include "database/databasemanager.h"
+
+#include <QRunnable>
+#include <QThread>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QHash>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+#include <functional>
+
+namespace
+{
+    // 固定列数量：Label, Instruction, TimeSet, Capture, Ext, Comment
+    const int FIXED_COLUMNS = 6;
+
+    const int TYPE_IN = 1;
+    const int TYPE_OUT = 2;
+
+    // 在线程池中校验一个块，结果投递回主线程
+    class ChunkTask : public QRunnable
+    {
+    public:
+        ChunkTask(VectorValidator *validator, QSharedPointer<const ValidationRules> rules, std::atomic<bool> *cancelled,
+                  int epoch, int chunk, int generation, int firstRow, QVector<QStringList> rows,
+                  std::function<void(int, int, int, const QVector<ValidationViolation> &, const QVector<QPair<int, QString>> &)> callback)
+            : m_validator(validator), m_rules(rules), m_cancelled(cancelled), m_epoch(epoch), m_chunk(chunk),
+              m_generation(generation), m_firstRow(firstRow), m_rows(rows), m_callback(callback)
+        {
+        }
+
+        void run() override
+        {
+            if (*m_cancelled)
+                return;
+
+            QVector<ValidationViolation> violations;
+            QVector<QPair<int, QString>> labels;
+            VectorValidator::validateChunk(*m_rules, m_firstRow, m_rows, violations, labels);
+
+            auto callback = m_callback;
+            int epoch = m_epoch;
+            int chunk = m_chunk;
+            int generation = m_generation;
+            QMetaObject::invokeMethod(m_validator, [callback, epoch, chunk, generation, violations, labels]()
+                                      { callback(epoch, chunk, generation, violations, labels); }, Qt::QueuedConnection);
+        }
+
+    private:
+        VectorValidator *m_validator;
+        QSharedPointer<const ValidationRules> m_rules;
+        std::atomic<bool> *m_cancelled;
+        int m_epoch;
+        int m_chunk;
+        int m_generation;
+        int m_firstRow;
+        QVector<QStringList> m_rows;
+        std::function<void(int, int, int, const QVector<ValidationViolation> &, const QVector<QPair<int, QString>> &)> m_callback;
+    };
+}
+
+VectorValidator::VectorValidator(QTableWidget *tableWidget, QObject *parent)
+    : QObject(parent), m_tableWidget(tableWidget), m_tableId(-1), m_cancelled(false),
+      m_generationCounter(0), m_epoch(0), m_pendingChunks(0), m_finishedChunks(0), m_totalChunksInRun(0)
+{
+    // 使用全部核心
+    m_pool.setMaxThreadCount(QThread::idealThreadCount());
+
+    QAbstractItemModel *model = m_tableWidget->model();
+    connect(model, &QAbstractItemModel::dataChanged, this, &VectorValidator::onDataChanged);
+    connect(model, &QAbstractItemModel::rowsInserted, this, &VectorValidator::onRowsInserted);
+    connect(model, &QAbstractItemModel::rowsRemoved, this, &VectorValidator::onRowsRemoved);
+}
+
+VectorValidator::~VectorValidator()
+{
+    m_cancelled = true;
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+void VectorValidator::setTableId(int tableId)
+{
+    // 停止进行中的任务，已投递的结果通过epoch丢弃
+    m_cancelled = true;
+    m_pool.clear();
+    m_pool.waitForDone();
+    m_cancelled = false;
+    m_epoch++;
+
+    m_tableId = tableId;
+    m_rules.reset();
+    m_chunkDirty.clear();
+    m_chunkGeneration.clear();
+    m_chunkViolations.clear();
+    m_chunkLabels.clear();
+    m_violations.clear();
+    m_pendingChunks = 0;
+}
+
+int VectorValidator::dirtyChunkCount() const
+{
+    return static_cast<int>(std::count(m_chunkDirty.constBegin(), m_chunkDirty.constEnd(), true));
+}
+
+bool VectorValidator::loadRules(QString &errorMessage)
+{
+    QSqlDatabase db = DatabaseManager::instance()->database();
+    if (m_tableId < 0 || !db.isOpen())
+    {
+        errorMessage = "请先打开或创建一个项目数据库";
+        return false;
+    }
+
+    QSharedPointer<ValidationRules> rules(new ValidationRules);
+
+    // 管脚按名称排序，与表格列顺序一致
+    QSqlQuery query(db);
+    query.prepare("SELECT vtp.pin_type, pl.pin_name FROM vector_table_pins vtp "
+                  "JOIN pin_list pl ON vtp.pin_id = pl.id "
+                  "WHERE vtp.table_id = ? ORDER BY pl.pin_name");
+    query.addBindValue(m_tableId);
+    if (!query.exec())
+    {
+        errorMessage = "查询管脚类型失败: " + query.lastError().text();
+        return false;
+    }
+    while (query.next())
+    {
+        rules->pinTypes.append(query.value(0).toInt());
+        rules->pinNames.append(query.value(1).toString());
+    }
+
+    if (rules->pinTypes.size() != m_tableWidget->columnCount() - FIXED_COLUMNS - PinBusColumns::busColumnCount(m_tableWidget))
+    {
+        errorMessage = "表格列与管脚设置不一致，请先刷新向量表";
+        return false;
+    }
+
+    if (!query.exec("SELECT timeset_name FROM timeset_list"))
+    {
+        errorMessage = "查询TimeSet失败: " + query.lastError().text();
+        return false;
+    }
+    while (query.next())
+        rules->timesets.insert(query.value(0).toString());
+
+    if (!query.exec("SELECT instruction_value FROM instruction_options"))
+    {
+        errorMessage = "查询指令失败: " + query.lastError().text();
+        return false;
+    }
+    while (query.next())
+        rules->instructions.insert(query.value(0).toString());
+
+    m_rules = rules;
+    return true;
+}
+
+bool VectorValidator::validateAll(QString &errorMessage)
+{
+    setTableId(m_tableId);
+    if (!loadRules(errorMessage))
+        return false;
+
+    resizeChunks();
+    startDirtyChunks();
+    return true;
+}
+
+bool VectorValidator::revalidate(QString &errorMessage)
+{
+    if (!m_rules || m_chunkDirty.isEmpty())
+        return validateAll(errorMessage);
+
+    // 管脚增删后列变化，只能全部重新校验
+    if (m_rules->pinTypes.size() != m_tableWidget->columnCount() - FIXED_COLUMNS - PinBusColumns::busColumnCount(m_tableWidget))
+        return validateAll(errorMessage);
+
+    startDirtyChunks();
+    return true;
+}
+
+void VectorValidator::resizeChunks()
+{
+    int chunkCount = (m_tableWidget->rowCount() + CHUNK_ROWS - 1) / CHUNK_ROWS;
+    int oldCount = m_chunkDirty.size();
+
+    m_chunkDirty.resize(chunkCount);
+    m_chunkGeneration.resize(chunkCount);
+    m_chunkViolations.resize(chunkCount);
+    m_chunkLabels.resize(chunkCount);
+    if (chunkCount > oldCount)
+        markDirty(oldCount, chunkCount - 1);
+}
+
+void VectorValidator::markDirty(int firstChunk, int lastChunk)
+{
+    firstChunk = qMax(0, firstChunk);
+    lastChunk = qMin(lastChunk, m_chunkDirty.size() - 1);
+    for (int chunk = firstChunk; chunk <= lastChunk; ++chunk)
+    {
+        m_chunkDirty[chunk] = true;
+        m_chunkGeneration[chunk] = ++m_generationCounter;
+    }
+}
+
+void VectorValidator::onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    if (m_chunkDirty.isEmpty())
+        return;
+
+    markDirty(topLeft.row() / CHUNK_ROWS, bottomRight.row() / CHUNK_ROWS);
+    emit resultsOutdated();
+}
+
+void VectorValidator::onRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(parent);
+    Q_UNUSED(last);
+    if (m_chunkDirty.isEmpty())
+        return;
+
+    // 插入点之后的行号全部后移，这些块都需要重新校验
+    resizeChunks();
+    markDirty(first / CHUNK_ROWS, m_chunkDirty.size() - 1);
+    emit resultsOutdated();
+}
+
+void VectorValidator::onRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(parent);
+    Q_UNUSED(last);
+    if (m_chunkDirty.isEmpty())
+        return;
+
+    resizeChunks();
+    markDirty(first / CHUNK_ROWS, m_chunkDirty.size() - 1);
+    emit resultsOutdated();
+}
+
+void VectorValidator::startDirtyChunks()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    m_finishedChunks = 0;
+    m_totalChunksInRun = 0;
+
+    int rowCount = m_tableWidget->rowCount();
+    int columnCount = m_tableWidget->columnCount();
+    auto callback = [this](int epoch, int chunk, int generation, const QVector<ValidationViolation> &violations,
+                           const QVector<QPair<int, QString>> &labels)
+    {
+        onChunkValidated(epoch, chunk, generation, violations, labels);
+    };
+
+    for (int chunk = 0; chunk < m_chunkDirty.size(); ++chunk)
+    {
+        if (!m_chunkDirty[chunk])
+            continue;
+
+        // 在主线程中复制块内容，工作线程不访问控件
+        int firstRow = chunk * CHUNK_ROWS;
+        int lastRow = qMin(firstRow + CHUNK_ROWS, rowCount);
+        QVector<QStringList> rows;
+        rows.reserve(lastRow - firstRow);
+        for (int row = firstRow; row < lastRow; ++row)
+        {
+            QStringList cells;
+            cells.reserve(columnCount);
+            for (int column = 0; column < columnCount; ++column)
+            {
+                QTableWidgetItem *item = m_tableWidget->item(row, column);
+                cells << (item ? item->text() : QString());
+            }
+            rows.append(cells);
+        }
+
+        m_chunkDirty[chunk] = false;
+        m_pendingChunks++;
+        m_totalChunksInRun++;
+        m_pool.start(new ChunkTask(this, m_rules, &m_cancelled, m_epoch, chunk, m_chunkGeneration[chunk],
+                                   firstRow, rows, callback));
+    }
+
+    qDebug() << "VectorValidator::startDirtyChunks - 表ID:" << m_tableId << "提交块数:" << m_totalChunksInRun
+             << "/" << m_chunkDirty.size() << "快照耗时(ms):" << timer.elapsed();
+
+    if (m_pendingChunks == 0)
+    {
+        mergeResults();
+        emit finished(m_violations.size());
+    }
+}
+
+void VectorValidator::onChunkValidated(int epoch, int chunk, int generation, const QVector<ValidationViolation> &violations,
+                                       const QVector<QPair<int, QString>> &labels)
+{
+    if (epoch != m_epoch)
+        return;
+
+    m_pendingChunks--;
+    m_finishedChunks++;
+
+    // 校验期间块又被修改时保留脏标记，结果丢弃
+    if (chunk < m_chunkGeneration.size() && m_chunkGeneration[chunk] == generation)
+    {
+        m_chunkViolations[chunk] = violations;
+        m_chunkLabels[chunk] = labels;
+    }
+
+    emit progress(m_finishedChunks, m_totalChunksInRun);
+
+    if (m_pendingChunks == 0)
+    {
+        mergeResults();
+        emit finished(m_violations.size());
+    }
+}
+
+void VectorValidator::mergeResults()
+{
+    m_violations.clear();
+    for (const auto &chunkViolations : m_chunkViolations)
+        m_violations += chunkViolations;
+
+    // 重复标签需要跨块判断
+    QHash<QString, int> firstLabelRow;
+    for (const auto &chunkLabels : m_chunkLabels)
+    {
+        for (const auto &label : chunkLabels)
+        {
+            auto it = firstLabelRow.constFind(label.second);
+            if (it == firstLabelRow.constEnd())
+            {
+                firstLabelRow.insert(label.second, label.first);
+                continue;
+            }
+
+            ValidationViolation violation;
+            violation.row = label.first;
+            violation.column = 0;
+            violation.message = QString("标签 %1 重复，首次出现在第 %2 行").arg(label.second).arg(it.value() + 1);
+            m_violations.append(violation);
+        }
+    }
+
+    std::stable_sort(m_violations.begin(), m_violations.end(), [](const ValidationViolation &a, const ValidationViolation &b)
+                     { return a.row < b.row || (a.row == b.row && a.column < b.column); });
+}
+
+void VectorValidator::validateChunk(const ValidationRules &rules, int firstRow, const QVector<QStringList> &rows,
+                                    QVector<ValidationViolation> &violations, QVector<QPair<int, QString>> &labels)
+{
+    auto addViolation = [&violations](int row, int column, const QString &message)
+    {
+        ValidationViolation violation;
+        violation.row = row;
+        violation.column = column;
+        violation.message = message;
+        violations.append(violation);
+    };
+
+    for (int i = 0; i < rows.size(); ++i)
+    {
+        const QStringList &cells = rows[i];
+        int row = firstRow + i;
+        if (cells.size() < FIXED_COLUMNS)
+            continue;
+
+        QString label = cells[0].trimmed();
+        if (!label.isEmpty())
+            labels.append(qMakePair(row, label));
+
+        // 指令必须在指令表中，REPEAT/SET_LOOPA的次数写在Ext列
+        const QString &instruction = cells[1];
+        if (!rules.instructions.contains(instruction))
+        {
+            addViolation(row, 1, QString("未知指令 %1").arg(instruction.isEmpty() ? "(空)" : instruction));
+        }
+        else if (instruction == "REPEAT" || instruction == "SET_LOOPA")
+        {
+            bool ok = false;
+            int count = cells[4].toInt(&ok);
+            if (!ok || count < 1)
+                addViolation(row, 4, QString("%1 的次数无效: %2").arg(instruction, cells[4].isEmpty() ? "(空)" : cells[4]));
+        }
+
+        // TimeSet为空说明引用的TimeSet已被删除
+        const QString &timeset = cells[2];
+        if (timeset.isEmpty())
+            addViolation(row, 2, "TimeSet为空或已被删除");
+        else if (!rules.timesets.contains(timeset))
+            addViolation(row, 2, QString("TimeSet %1 不存在").arg(timeset));
+
+        // 管脚状态按管脚类型检查
+        for (int p = 0; p < rules.pinTypes.size() && FIXED_COLUMNS + p < cells.size(); ++p)
+        {
+            int column = FIXED_COLUMNS + p;
+            QString value = cells[column].trimmed().toUpper();
+            if (value.isEmpty())
+                continue;
+
+            QChar state = value[0];
+            if (value.size() != 1 || !QString("01LHXZ").contains(state))
+            {
+                addViolation(row, column, QString("管脚 %1 的状态 %2 无效").arg(rules.pinNames[p], cells[column]));
+            }
+            else if (rules.pinTypes[p] == TYPE_IN && (state == 'L' || state == 'H'))
+            {
+                addViolation(row, column, QString("输入管脚 %1 使用了比较状态 %2").arg(rules.pinNames[p], value));
+            }
+            else if (rules.pinTypes[p] == TYPE_OUT && (state == '0' || state == '1'))
+            {
+                addViolation(row, column, QString("输出管脚 %1 使用了驱动状态 %2").arg(rules.pinNames[p], value));
+            }
+        }
+    }
+}
@@ -0,0 +1,105 @@
+#ifndef VECTORVALIDATOR_H
+#define VECTORVALIDATOR_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QSet>
+#include <QPair>
+#include <QSharedPointer>
+#include <QThreadPool>
+#include <QTableWidget>
+#include <atomic>
+
+// 一条校验问题
+struct ValidationViolation
+{
+    int row;         // 行号(0-based)
+    int column;      // 列号，-1表示整行
+    QString message; // 问题描述
+};
+
+// 校验规则，由数据库中的管脚类型、TimeSet和指令表生成，校验期间只读共享给各线程
+struct ValidationRules
+{
+    QVector<int> pinTypes;      // 每个管脚列的类型(type_options.id: 1=In, 2=Out, 3=InOut)
+    QStringList pinNames;       // 与pinTypes一一对应
+    QSet<QString> timesets;     // 现有的TimeSet名称
+    QSet<QString> instructions; // 现有的指令
+};
+
+// 向量表校验引擎：按块快照表格内容，在线程池中并行校验，编辑后只重新校验变化的块
+class VectorValidator : public QObject
+{
+    Q_OBJECT
+
+public:
+    VectorValidator(QTableWidget *tableWidget, QObject *parent = nullptr);
+    ~VectorValidator();
+
+    // 每块的行数
+    static const int CHUNK_ROWS = 2048;
+
+    // 切换向量表，清空已有结果
+    void setTableId(int tableId);
+
+    // 重新读取规则并校验全部行
+    bool validateAll(QString &errorMessage);
+
+    // 只校验标记为已修改的块
+    bool revalidate(QString &errorMessage);
+
+    bool isRunning() const { return m_pendingChunks > 0; }
+    bool hasResults() const { return !m_chunkDirty.isEmpty(); }
+    int dirtyChunkCount() const;
+
+    // 合并后的全部问题，按行排序
+    const QVector<ValidationViolation> &violations() const { return m_violations; }
+
+    // 单个块的校验，在工作线程中执行
+    static void validateChunk(const ValidationRules &rules, int firstRow, const QVector<QStringList> &rows,
+                              QVector<ValidationViolation> &violations, QVector<QPair<int, QString>> &labels);
+
+signals:
+    void progress(int finishedChunks, int totalChunks);
+    void finished(int violationCount);
+
+    // 表格内容变化，已有结果可能过期
+    void resultsOutdated();
+
+private slots:
+    void onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+    void onRowsRemoved(const QModelIndex &parent, int first, int last);
+
+private:
+    bool loadRules(QString &errorMessage);
+    void markDirty(int firstChunk, int lastChunk);
+    void resizeChunks();
+    void startDirtyChunks();
+    void onChunkValidated(int epoch, int chunk, int generation, const QVector<ValidationViolation> &violations,
+                          const QVector<QPair<int, QString>> &labels);
+    void mergeResults();
+
+    QTableWidget *m_tableWidget;
+    int m_tableId;
+    QSharedPointer<const ValidationRules> m_rules;
+    QThreadPool m_pool;
+    std::atomic<bool> m_cancelled;
+
+    // 按块保存的结果，块号 = 行号 / CHUNK_ROWS
+    QVector<bool> m_chunkDirty;
+    QVector<int> m_chunkGeneration; // 块被修改时重新编号，用于丢弃过期的结果
+    int m_generationCounter;
+    int m_epoch; // 切换表或全量校验时递增，丢弃之前提交的任务结果
+    QVector<QVector<ValidationViolation>> m_chunkViolations;
+    QVector<QVector<QPair<int, QString>>> m_chunkLabels;
+    int m_pendingChunks;
+    int m_finishedChunks;
+    int m_totalChunksInRun;
+
+    QVector<ValidationViolation> m_violations;
+};
+
+#endif // VECTORVALIDATOR_H
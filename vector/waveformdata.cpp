@@ -0,0 +1,414 @@
+#include "waveformdata.h"
+#include "database/databasemanager.h"
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QHash>
+#include <QDebug>
+#include <algorithm>
+
+namespace
+{
+    // 没有关联TimeSet的行使用的默认周期(ns)，与新建TimeSet的默认值一致
+    const double DEFAULT_PERIOD = 1000.0;
+
+    // 金字塔节点打包格式: bit0-1最低电平, bit2-3最高电平, bit4-5首行电平, bit6-7末行电平, bit8-31翻转次数
+    const quint32 EMPTY_NODE = 0xFFFFFFFFu;
+    const quint32 MAX_TOGGLES = 0x00FFFFFFu;
+}
+
+WaveformData::WaveformData()
+{
+}
+
+void WaveformData::clear()
+{
+    m_rowTimeSetIds.clear();
+    m_rowStart.clear();
+    m_periods.clear();
+    m_edges.clear();
+    m_pins.clear();
+}
+
+bool WaveformData::load(int tableId, const QList<int> &vectorPinIds, QString &errorMessage)
+{
+    clear();
+
+    QSqlDatabase db = DatabaseManager::instance()->database();
+    if (!db.isOpen())
+    {
+        errorMessage = "数据库未打开";
+        return false;
+    }
+
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+
+    // 1. TimeSet周期
+    if (!query.exec("SELECT id, period FROM timeset_list"))
+    {
+        errorMessage = "查询TimeSet周期失败: " + query.lastError().text();
+        return false;
+    }
+    while (query.next())
+    {
+        double period = query.value(1).toDouble();
+        m_periods[query.value(0).toInt()] = period > 0 ? period : DEFAULT_PERIOD;
+    }
+
+    // 2. TimeSet边沿参数
+    if (!query.exec("SELECT ts.timeset_id, ts.pin_id, ts.T1R, ts.T1F, ts.STBR, wo.wave_type "
+                    "FROM timeset_settings ts "
+                    "LEFT JOIN wave_options wo ON ts.wave_id = wo.id"))
+    {
+        errorMessage = "查询TimeSet边沿失败: " + query.lastError().text();
+        return false;
+    }
+    while (query.next())
+    {
+        WaveformEdge edge;
+        edge.t1r = query.value(2).toDouble();
+        edge.t1f = query.value(3).toDouble();
+        edge.stbr = query.value(4).toDouble();
+        edge.waveName = query.value(5).toString().toUpper();
+        m_edges[qMakePair(query.value(0).toInt(), query.value(1).toInt())] = edge;
+    }
+
+    // 3. 选中的管脚
+    QStringList idStrings;
+    for (int vectorPinId : vectorPinIds)
+    {
+        idStrings << QString::number(vectorPinId);
+    }
+
+    QHash<int, int> vectorPinToIndex;
+    if (!idStrings.isEmpty())
+    {
+        QString pinSql = QString("SELECT vtp.id, vtp.pin_id, pl.pin_name "
+                                 "FROM vector_table_pins vtp "
+                                 "JOIN pin_list pl ON vtp.pin_id = pl.id "
+                                 "WHERE vtp.table_id = %1 AND vtp.id IN (%2) "
+                                 "ORDER BY pl.pin_name")
+                             .arg(tableId)
+                             .arg(idStrings.join(","));
+        if (!query.exec(pinSql))
+        {
+            errorMessage = "查询管脚失败: " + query.lastError().text();
+            return false;
+        }
+        while (query.next())
+        {
+            PinTrack track;
+            track.vectorPinId = query.value(0).toInt();
+            track.pinId = query.value(1).toInt();
+            track.name = query.value(2).toString();
+            vectorPinToIndex[track.vectorPinId] = m_pins.size();
+            m_pins.append(track);
+        }
+    }
+
+    // 4. 行的TimeSet和时间轴
+    QHash<int, int> vectorDataIdToRow;
+    query.prepare("SELECT id, timeset_id FROM vector_table_data "
+                  "WHERE table_id = ? ORDER BY sort_index, id");
+    query.addBindValue(tableId);
+    if (!query.exec())
+    {
+        errorMessage = "查询向量行失败: " + query.lastError().text();
+        return false;
+    }
+
+    double time = 0.0;
+    while (query.next())
+    {
+        int timeSetId = query.value(1).isNull() ? -1 : query.value(1).toInt();
+        vectorDataIdToRow.insert(query.value(0).toInt(), m_rowTimeSetIds.size());
+        m_rowTimeSetIds.append(timeSetId);
+        m_rowStart.append(time);
+        time += m_periods.value(timeSetId, DEFAULT_PERIOD);
+    }
+
+    // 5. 管脚状态，缺省为X
+    for (PinTrack &track : m_pins)
+    {
+        track.states.fill(StateX, m_rowTimeSetIds.size());
+    }
+
+    if (!m_pins.isEmpty() && !m_rowTimeSetIds.isEmpty())
+    {
+        // 从本表的行出发，vector_data_id列没有类型亲和性，用+vtd.id才能走唯一索引
+        QString valueSql = QString("SELECT vtd.id, vtpv.vector_pin_id, po.pin_value "
+                                   "FROM vector_table_data vtd "
+                                   "JOIN vector_table_pin_values vtpv ON vtpv.vector_data_id = +vtd.id "
+                                   "AND vtpv.vector_pin_id IN (%2) "
+                                   "JOIN pin_options po ON vtpv.pin_level = po.id "
+                                   "WHERE vtd.table_id = %1")
+                               .arg(tableId)
+                               .arg(idStrings.join(","));
+        if (!query.exec(valueSql))
+        {
+            errorMessage = "查询管脚状态失败: " + query.lastError().text();
+            return false;
+        }
+        while (query.next())
+        {
+            auto rowIt = vectorDataIdToRow.constFind(query.value(0).toInt());
+            auto pinIt = vectorPinToIndex.constFind(query.value(1).toInt());
+            if (rowIt == vectorDataIdToRow.constEnd() || pinIt == vectorPinToIndex.constEnd())
+                continue;
+
+            QString value = query.value(2).toString().toUpper();
+            PinState state = StateX;
+            if (value == "0")
+                state = State0;
+            else if (value == "1")
+                state = State1;
+            else if (value == "L")
+                state = StateL;
+            else if (value == "H")
+                state = StateH;
+            else if (value == "Z")
+                state = StateZ;
+
+            m_pins[pinIt.value()].states[rowIt.value()] = state;
+        }
+    }
+
+    for (PinTrack &track : m_pins)
+    {
+        buildPyramid(track);
+    }
+
+    qDebug() << "WaveformData::load - 加载完成, 行数:" << m_rowTimeSetIds.size()
+             << "管脚数:" << m_pins.size() << "总时长(ns):" << totalTime();
+    return true;
+}
+
+double WaveformData::totalTime() const
+{
+    if (m_rowStart.isEmpty())
+        return 0.0;
+    return m_rowStart.last() + rowPeriod(m_rowStart.size() - 1);
+}
+
+double WaveformData::rowPeriod(int row) const
+{
+    return m_periods.value(m_rowTimeSetIds.at(row), DEFAULT_PERIOD);
+}
+
+int WaveformData::rowAtTime(double time) const
+{
+    if (m_rowStart.isEmpty())
+        return -1;
+
+    // 二分查找起始时间不大于time的最后一行
+    auto it = std::upper_bound(m_rowStart.constBegin(), m_rowStart.constEnd(), time);
+    int row = static_cast<int>(it - m_rowStart.constBegin()) - 1;
+    return qBound(0, row, m_rowStart.size() - 1);
+}
+
+WaveformData::PinState WaveformData::pinState(int pinIndex, int row) const
+{
+    return static_cast<PinState>(m_pins.at(pinIndex).states.at(row));
+}
+
+int WaveformData::stateLevel(PinState state)
+{
+    switch (state)
+    {
+    case State0:
+    case StateL:
+        return 0;
+    case State1:
+    case StateH:
+        return 1;
+    default:
+        return 2;
+    }
+}
+
+bool WaveformData::isDriveState(PinState state)
+{
+    return state == State0 || state == State1;
+}
+
+WaveformEdge WaveformData::edgeFor(const PinTrack &track, int timeSetId) const
+{
+    auto it = m_edges.constFind(qMakePair(timeSetId, track.pinId));
+    if (it != m_edges.constEnd())
+        return it.value();
+
+    // 未设置边沿的管脚按NRZ、周期起点驱动处理
+    WaveformEdge edge;
+    edge.t1r = 0.0;
+    edge.t1f = 0.0;
+    edge.stbr = m_periods.value(timeSetId, DEFAULT_PERIOD) / 2.0;
+    edge.waveName = "NRZ";
+    return edge;
+}
+
+QList<WaveformSegment> WaveformData::rowSegments(int pinIndex, int row) const
+{
+    QList<WaveformSegment> segments;
+    const PinTrack &track = m_pins.at(pinIndex);
+    PinState state = static_cast<PinState>(track.states.at(row));
+    int level = stateLevel(state);
+
+    double start = m_rowStart.at(row);
+    double period = rowPeriod(row);
+    double end = start + period;
+
+    // 比较状态和X/Z在整个周期内保持不变
+    if (!isDriveState(state))
+    {
+        segments.append(WaveformSegment{start, end, level});
+        return segments;
+    }
+
+    WaveformEdge edge = edgeFor(track, m_rowTimeSetIds.at(row));
+    double rise = start + qBound(0.0, edge.t1r, period);
+    double fall = start + qBound(0.0, edge.t1f, period);
+    if (fall < rise)
+        fall = rise;
+
+    if (edge.waveName == "RZ" || edge.waveName == "RO" || edge.waveName == "SBC")
+    {
+        // RZ回零，RO回一，SBC在有效窗口外取反
+        int idle = edge.waveName == "RZ" ? 0 : (edge.waveName == "RO" ? 1 : 1 - level);
+        segments.append(WaveformSegment{start, rise, idle});
+        segments.append(WaveformSegment{rise, fall, level});
+        segments.append(WaveformSegment{fall, end, idle});
+    }
+    else
+    {
+        // NRZ: T1R之前保持上一行电平
+        int previous = level;
+        if (row > 0)
+            previous = stateLevel(static_cast<PinState>(track.states.at(row - 1)));
+        segments.append(WaveformSegment{start, rise, previous});
+        segments.append(WaveformSegment{rise, end, level});
+    }
+
+    // 去掉零宽度的段
+    for (int i = segments.size() - 1; i >= 0; --i)
+    {
+        if (segments[i].end <= segments[i].start)
+            segments.removeAt(i);
+    }
+    return segments;
+}
+
+double WaveformData::rowStrobeTime(int pinIndex, int row) const
+{
+    WaveformEdge edge = edgeFor(m_pins.at(pinIndex), m_rowTimeSetIds.at(row));
+    return m_rowStart.at(row) + qBound(0.0, edge.stbr, rowPeriod(row));
+}
+
+quint32 WaveformData::packLeaf(int level)
+{
+    quint32 l = static_cast<quint32>(level);
+    return l | (l << 2) | (l << 4) | (l << 6);
+}
+
+quint32 WaveformData::combine(quint32 left, quint32 right)
+{
+    if (left == EMPTY_NODE)
+        return right;
+    if (right == EMPTY_NODE)
+        return left;
+
+    quint32 minLevel = qMin(left & 0x3u, right & 0x3u);
+    quint32 maxLevel = qMax((left >> 2) & 0x3u, (right >> 2) & 0x3u);
+    quint32 first = (left >> 4) & 0x3u;
+    quint32 last = (right >> 6) & 0x3u;
+
+    quint64 toggles = static_cast<quint64>(left >> 8) + (right >> 8);
+    if (((left >> 6) & 0x3u) != ((right >> 4) & 0x3u))
+        toggles++;
+    toggles = qMin<quint64>(toggles, MAX_TOGGLES);
+
+    return minLevel | (maxLevel << 2) | (first << 4) | (last << 6) | (static_cast<quint32>(toggles) << 8);
+}
+
+WaveformSummary WaveformData::unpack(quint32 node)
+{
+    WaveformSummary summary;
+    summary.valid = node != EMPTY_NODE;
+    summary.minLevel = summary.valid ? static_cast<int>(node & 0x3u) : 0;
+    summary.maxLevel = summary.valid ? static_cast<int>((node >> 2) & 0x3u) : 0;
+    summary.firstLevel = summary.valid ? static_cast<int>((node >> 4) & 0x3u) : 0;
+    summary.lastLevel = summary.valid ? static_cast<int>((node >> 6) & 0x3u) : 0;
+    summary.toggles = summary.valid ? (node >> 8) : 0;
+    return summary;
+}
+
+void WaveformData::buildPyramid(PinTrack &track)
+{
+    track.levels.clear();
+    int rows = track.states.size();
+    if (rows < BASE_BLOCK)
+        return;
+
+    // 第0层: 每BASE_BLOCK行一个节点
+    QVector<quint32> base(rows / BASE_BLOCK);
+    for (int i = 0; i < base.size(); ++i)
+    {
+        quint32 node = EMPTY_NODE;
+        for (int r = i * BASE_BLOCK; r < (i + 1) * BASE_BLOCK; ++r)
+        {
+            node = combine(node, packLeaf(stateLevel(static_cast<PinState>(track.states.at(r)))));
+        }
+        base[i] = node;
+    }
+    track.levels.append(base);
+
+    // 逐层两两合并，只保留完整节点
+    while (track.levels.last().size() >= 2)
+    {
+        const QVector<quint32> &lower = track.levels.last();
+        QVector<quint32> upper(lower.size() / 2);
+        for (int i = 0; i < upper.size(); ++i)
+        {
+            upper[i] = combine(lower.at(2 * i), lower.at(2 * i + 1));
+        }
+        track.levels.append(upper);
+    }
+}
+
+WaveformSummary WaveformData::summarize(int pinIndex, int firstRow, int lastRow) const
+{
+    const PinTrack &track = m_pins.at(pinIndex);
+    firstRow = qMax(0, firstRow);
+    lastRow = qMin(lastRow, track.states.size());
+
+    quint32 node = EMPTY_NODE;
+    int row = firstRow;
+    while (row < lastRow)
+    {
+        // 对齐到块边界且剩余行数足够时，选择能覆盖的最大金字塔节点
+        if ((row & (BASE_BLOCK - 1)) == 0 && row + BASE_BLOCK <= lastRow && !track.levels.isEmpty())
+        {
+            int level = 0;
+            while (level + 1 < track.levels.size())
+            {
+                int span = BASE_BLOCK << (level + 1);
+                if ((row & (span - 1)) != 0 || row + span > lastRow)
+                    break;
+                ++level;
+            }
+            int index = row >> (BASE_BLOCK_SHIFT + level);
+            if (index < track.levels.at(level).size())
+            {
+                node = combine(node, track.levels.at(level).at(index));
+                row += BASE_BLOCK << level;
+                continue;
+            }
+        }
+
+        node = combine(node, packLeaf(stateLevel(static_cast<PinState>(track.states.at(row)))));
+        ++row;
+    }
+
+    return unpack(node);
+}
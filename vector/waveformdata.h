@@ -0,0 +1,115 @@
+#ifndef WAVEFORMDATA_H
+#define WAVEFORMDATA_H
+
+#include <QString>
+#include <QList>
+#include <QMap>
+#include <QVector>
+#include <QPair>
+#include <QtGlobal>
+
+// 单个管脚在某个TimeSet下的边沿参数
+struct WaveformEdge
+{
+    double t1r;      // 驱动上升沿
+    double t1f;      // 驱动下降沿
+    double stbr;     // 比较选通
+    QString waveName; // 波形类型: NRZ/RZ/RO/SBC
+};
+
+// 波形中的一段恒定电平
+struct WaveformSegment
+{
+    double start; // 起始时间(ns)
+    double end;   // 结束时间(ns)
+    int level;    // 电平: 0低 1高 2未知(X/Z)
+};
+
+// 一段行区间内的波形概要(金字塔节点)
+struct WaveformSummary
+{
+    int minLevel;    // 最低电平
+    int maxLevel;    // 最高电平
+    int firstLevel;  // 区间首行电平
+    int lastLevel;   // 区间末行电平
+    quint32 toggles; // 区间内电平翻转次数
+    bool valid;      // 是否包含数据
+};
+
+// 向量表波形数据，负责加载管脚状态、时间轴与min/max/toggle金字塔
+class WaveformData
+{
+public:
+    // 管脚状态编码，与pin_options的取值对应
+    enum PinState : quint8
+    {
+        State0 = 0,
+        State1,
+        StateL,
+        StateH,
+        StateX,
+        StateZ
+    };
+
+    WaveformData();
+
+    // 加载向量表的时间轴和指定管脚的状态(vectorPinIds为vector_table_pins.id)
+    bool load(int tableId, const QList<int> &vectorPinIds, QString &errorMessage);
+
+    // 清空数据
+    void clear();
+
+    int rowCount() const { return m_rowTimeSetIds.size(); }
+    int pinCount() const { return m_pins.size(); }
+    QString pinName(int pinIndex) const { return m_pins.at(pinIndex).name; }
+
+    // 时间轴
+    double totalTime() const;
+    double rowStartTime(int row) const { return m_rowStart.at(row); }
+    double rowPeriod(int row) const;
+    int rowAtTime(double time) const;
+
+    // 某行某管脚的原始状态
+    PinState pinState(int pinIndex, int row) const;
+
+    // 计算某行的实际电平段(按TimeSet边沿和波形类型放置)
+    QList<WaveformSegment> rowSegments(int pinIndex, int row) const;
+
+    // 某行某管脚的比较选通时刻(绝对时间)
+    double rowStrobeTime(int pinIndex, int row) const;
+
+    // 行区间[firstRow, lastRow)的波形概要，复杂度O(log n)
+    WaveformSummary summarize(int pinIndex, int firstRow, int lastRow) const;
+
+    // 状态对应的电平
+    static int stateLevel(PinState state);
+    static bool isDriveState(PinState state);
+
+private:
+    struct PinTrack
+    {
+        int vectorPinId;                 // vector_table_pins.id
+        int pinId;                       // pin_list.id
+        QString name;                    // 管脚名称
+        QVector<quint8> states;          // 每行状态
+        QVector<QVector<quint32>> levels; // 金字塔各层，第k层每个节点覆盖(BASE_BLOCK << k)行
+    };
+
+    void buildPyramid(PinTrack &track);
+    static quint32 packLeaf(int level);
+    static quint32 combine(quint32 left, quint32 right);
+    static WaveformSummary unpack(quint32 node);
+    WaveformEdge edgeFor(const PinTrack &track, int timeSetId) const;
+
+    // 金字塔最底层节点覆盖的行数，更细的区间直接扫描原始状态
+    static const int BASE_BLOCK_SHIFT = 4;
+    static const int BASE_BLOCK = 1 << BASE_BLOCK_SHIFT;
+
+    QVector<int> m_rowTimeSetIds;   // 每行的TimeSet ID
+    QVector<double> m_rowStart;     // 每行起始时间(ns)
+    QMap<int, double> m_periods;    // TimeSet ID -> 周期
+    QMap<QPair<int, int>, WaveformEdge> m_edges; // (TimeSet ID, pin_list.id) -> 边沿
+    QList<PinTrack> m_pins;
+};
+
+#endif // WAVEFORMDATA_H
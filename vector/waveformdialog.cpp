@@ -0,0 +1,158 @@
+#include "waveformdialog.h"
+#include "waveformview.h"
+#include "database/databasemanager.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QSplitter>
+#include <QScrollArea>
+#include <QMessageBox>
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDebug>
+
+WaveformDialog::WaveformDialog(int tableId, const QString &tableName, QWidget *parent)
+    : QDialog(parent), m_tableId(tableId)
+{
+    setWindowTitle("波形图 - " + tableName);
+    resize(1000, 600);
+
+    setupUI();
+    loadPinList();
+}
+
+void WaveformDialog::setupUI()
+{
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+
+    // 顶部工具栏
+    QHBoxLayout *toolLayout = new QHBoxLayout();
+    m_applyButton = new QPushButton("显示选中管脚", this);
+    m_zoomInButton = new QPushButton("放大", this);
+    m_zoomOutButton = new QPushButton("缩小", this);
+    m_zoomFitButton = new QPushButton("全部", this);
+    m_cursorLabel = new QLabel(this);
+
+    toolLayout->addWidget(m_applyButton);
+    toolLayout->addSpacing(20);
+    toolLayout->addWidget(m_zoomInButton);
+    toolLayout->addWidget(m_zoomOutButton);
+    toolLayout->addWidget(m_zoomFitButton);
+    toolLayout->addSpacing(20);
+    toolLayout->addWidget(m_cursorLabel);
+    toolLayout->addStretch();
+    mainLayout->addLayout(toolLayout);
+
+    // 左侧管脚列表，右侧波形
+    QSplitter *splitter = new QSplitter(Qt::Horizontal, this);
+
+    m_pinListWidget = new QListWidget(splitter);
+    m_pinListWidget->setMaximumWidth(200);
+    splitter->addWidget(m_pinListWidget);
+
+    QScrollArea *scrollArea = new QScrollArea(splitter);
+    scrollArea->setWidgetResizable(true);
+    scrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    m_waveformView = new WaveformView(scrollArea);
+    scrollArea->setWidget(m_waveformView);
+    splitter->addWidget(scrollArea);
+    splitter->setStretchFactor(1, 1);
+
+    mainLayout->addWidget(splitter);
+
+    QLabel *hintLabel = new QLabel("提示: Ctrl+滚轮缩放，滚轮或拖动平移，双击跳转到对应向量行", this);
+    hintLabel->setStyleSheet("color: gray;");
+    mainLayout->addWidget(hintLabel);
+
+    // 连接信号和槽
+    connect(m_applyButton, &QPushButton::clicked, this, &WaveformDialog::reloadWaveform);
+    connect(m_zoomInButton, &QPushButton::clicked, m_waveformView, &WaveformView::zoomIn);
+    connect(m_zoomOutButton, &QPushButton::clicked, m_waveformView, &WaveformView::zoomOut);
+    connect(m_zoomFitButton, &QPushButton::clicked, m_waveformView, &WaveformView::zoomToFit);
+    connect(m_waveformView, &WaveformView::cursorMoved, this, &WaveformDialog::onCursorMoved);
+    connect(m_waveformView, &WaveformView::rowActivated, this, &WaveformDialog::rowActivated);
+}
+
+void WaveformDialog::loadPinList()
+{
+    m_pinListWidget->clear();
+
+    QSqlDatabase db = DatabaseManager::instance()->database();
+    if (!db.isOpen())
+    {
+        qDebug() << "WaveformDialog::loadPinList - 数据库未打开";
+        return;
+    }
+
+    QSqlQuery query(db);
+    query.prepare("SELECT vtp.id, pl.pin_name "
+                  "FROM vector_table_pins vtp "
+                  "JOIN pin_list pl ON vtp.pin_id = pl.id "
+                  "WHERE vtp.table_id = ? "
+                  "ORDER BY pl.pin_name");
+    query.addBindValue(m_tableId);
+
+    if (!query.exec())
+    {
+        qWarning() << "WaveformDialog::loadPinList - 查询管脚失败:" << query.lastError().text();
+        return;
+    }
+
+    while (query.next())
+    {
+        QListWidgetItem *item = new QListWidgetItem(query.value(1).toString(), m_pinListWidget);
+        item->setData(Qt::UserRole, query.value(0).toInt());
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        // 默认勾选前几个管脚
+        item->setCheckState(m_pinListWidget->count() <= 8 ? Qt::Checked : Qt::Unchecked);
+    }
+
+    reloadWaveform();
+}
+
+void WaveformDialog::reloadWaveform()
+{
+    QList<int> vectorPinIds;
+    for (int i = 0; i < m_pinListWidget->count(); ++i)
+    {
+        QListWidgetItem *item = m_pinListWidget->item(i);
+        if (item->checkState() == Qt::Checked)
+        {
+            vectorPinIds.append(item->data(Qt::UserRole).toInt());
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+
+    QString errorMessage;
+    bool success = m_data.load(m_tableId, vectorPinIds, errorMessage);
+
+    QApplication::restoreOverrideCursor();
+
+    if (!success)
+    {
+        m_data.clear();
+        QMessageBox::critical(this, "错误", "加载波形数据失败：" + errorMessage);
+    }
+
+    qDebug() << "WaveformDialog::reloadWaveform - 加载波形耗时(ms):" << timer.elapsed();
+    m_waveformView->setWaveformData(&m_data);
+    m_cursorLabel->setText(QString("共 %1 行").arg(m_data.rowCount()));
+}
+
+void WaveformDialog::showRow(int row)
+{
+    m_waveformView->centerOnRow(row);
+}
+
+void WaveformDialog::onCursorMoved(double time, int row)
+{
+    m_cursorLabel->setText(QString("时间: %1 ns  行: %2 / %3")
+                               .arg(time, 0, 'f', 3)
+                               .arg(row + 1)
+                               .arg(m_data.rowCount()));
+}
@@ -0,0 +1,46 @@
+#ifndef WAVEFORMDIALOG_H
+#define WAVEFORMDIALOG_H
+
+#include <QDialog>
+#include <QListWidget>
+#include <QPushButton>
+#include <QLabel>
+#include "waveformdata.h"
+
+class WaveformView;
+
+// 波形图窗口：选择管脚并按时间轴显示向量表波形
+class WaveformDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    WaveformDialog(int tableId, const QString &tableName, QWidget *parent = nullptr);
+
+    // 定位到指定行(0-based)
+    void showRow(int row);
+
+signals:
+    // 在波形上双击某行，通知主窗口跳转
+    void rowActivated(int row);
+
+private slots:
+    void reloadWaveform();
+    void onCursorMoved(double time, int row);
+
+private:
+    void setupUI();
+    void loadPinList();
+
+    int m_tableId;
+    WaveformData m_data;
+    WaveformView *m_waveformView;
+    QListWidget *m_pinListWidget;
+    QPushButton *m_applyButton;
+    QPushButton *m_zoomInButton;
+    QPushButton *m_zoomOutButton;
+    QPushButton *m_zoomFitButton;
+    QLabel *m_cursorLabel;
+};
+
+#endif // WAVEFORMDIALOG_H
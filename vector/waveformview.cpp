@@ -0,0 +1,392 @@
+#include "waveformview.h"
+#include "waveformdata.h"
+
+#include <QPainter>
+#include <QPaintEvent>
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include <QDebug>
+#include <cmath>
+
+namespace
+{
+    const int NAME_WIDTH = 100;   // 左侧管脚名称区域宽度
+    const int RULER_HEIGHT = 24;  // 顶部时间标尺高度
+    const int LANE_HEIGHT = 36;   // 每个管脚通道高度
+    const int LANE_MARGIN = 8;    // 通道内上下留白
+    const int DETAIL_ROW_PIXELS = 4; // 每行至少占用的像素数，低于此值时切换到金字塔概要绘制
+
+    // 将时间格式化为带单位的字符串
+    QString formatTime(double ns)
+    {
+        double absNs = std::fabs(ns);
+        if (absNs >= 1e6)
+            return QString::number(ns / 1e6, 'g', 6) + "ms";
+        if (absNs >= 1e3)
+            return QString::number(ns / 1e3, 'g', 6) + "us";
+        return QString::number(ns, 'g', 6) + "ns";
+    }
+}
+
+WaveformView::WaveformView(QWidget *parent)
+    : QWidget(parent), m_data(nullptr), m_viewStart(0.0), m_nsPerPixel(1.0), m_dragging(false)
+{
+    setMouseTracking(true);
+    setMinimumSize(400, 200);
+    setAutoFillBackground(true);
+
+    QPalette pal = palette();
+    pal.setColor(QPalette::Window, Qt::white);
+    setPalette(pal);
+}
+
+void WaveformView::setWaveformData(const WaveformData *data)
+{
+    m_data = data;
+    setMinimumHeight(RULER_HEIGHT + LANE_HEIGHT * qMax(1, m_data ? m_data->pinCount() : 0));
+    zoomToFit();
+}
+
+int WaveformView::plotWidth() const
+{
+    return qMax(1, width() - NAME_WIDTH);
+}
+
+double WaveformView::timeAtX(int x) const
+{
+    return m_viewStart + (x - NAME_WIDTH) * m_nsPerPixel;
+}
+
+int WaveformView::xAtTime(double time) const
+{
+    return NAME_WIDTH + static_cast<int>(std::floor((time - m_viewStart) / m_nsPerPixel));
+}
+
+int WaveformView::levelY(int top, int level) const
+{
+    if (level == 1)
+        return top + LANE_MARGIN;
+    if (level == 0)
+        return top + LANE_HEIGHT - LANE_MARGIN;
+    return top + LANE_HEIGHT / 2;
+}
+
+void WaveformView::zoomToFit()
+{
+    m_viewStart = 0.0;
+    if (m_data && m_data->totalTime() > 0)
+    {
+        m_nsPerPixel = m_data->totalTime() / plotWidth();
+    }
+    else
+    {
+        m_nsPerPixel = 1.0;
+    }
+    update();
+}
+
+void WaveformView::zoomIn()
+{
+    zoomAt(0.5, NAME_WIDTH + plotWidth() / 2);
+}
+
+void WaveformView::zoomOut()
+{
+    zoomAt(2.0, NAME_WIDTH + plotWidth() / 2);
+}
+
+void WaveformView::centerOnRow(int row)
+{
+    if (!m_data || row < 0 || row >= m_data->rowCount())
+        return;
+
+    // 放大到该行至少占据若干像素
+    double period = m_data->rowPeriod(row);
+    m_nsPerPixel = qMin(m_nsPerPixel, period / (DETAIL_ROW_PIXELS * 4));
+    m_viewStart = m_data->rowStartTime(row) + period / 2.0 - plotWidth() * m_nsPerPixel / 2.0;
+    clampView();
+    update();
+}
+
+void WaveformView::zoomAt(double factor, int x)
+{
+    if (!m_data || m_data->rowCount() == 0)
+        return;
+
+    double anchor = timeAtX(x);
+    double newNsPerPixel = m_nsPerPixel * factor;
+
+    // 最大放大到1ps/像素，最小缩小到整个图案占满视图
+    double maxNsPerPixel = m_data->totalTime() / plotWidth();
+    newNsPerPixel = qBound(0.001, newNsPerPixel, qMax(0.001, maxNsPerPixel));
+
+    m_viewStart = anchor - (x - NAME_WIDTH) * newNsPerPixel;
+    m_nsPerPixel = newNsPerPixel;
+    clampView();
+    update();
+}
+
+void WaveformView::clampView()
+{
+    if (!m_data)
+        return;
+
+    double maxStart = m_data->totalTime() - plotWidth() * m_nsPerPixel;
+    m_viewStart = qBound(0.0, m_viewStart, qMax(0.0, maxStart));
+}
+
+void WaveformView::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    clampView();
+}
+
+void WaveformView::wheelEvent(QWheelEvent *event)
+{
+    int delta = event->angleDelta().y();
+    if (delta == 0)
+    {
+        event->ignore();
+        return;
+    }
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    int x = static_cast<int>(event->position().x());
+#else
+    int x = event->pos().x();
+#endif
+
+    if (event->modifiers() & Qt::ControlModifier)
+    {
+        // Ctrl+滚轮以鼠标位置为中心缩放
+        zoomAt(delta > 0 ? 0.5 : 2.0, qMax(x, NAME_WIDTH));
+    }
+    else
+    {
+        // 滚轮平移十分之一视图宽度
+        m_viewStart -= (delta > 0 ? 1 : -1) * plotWidth() * m_nsPerPixel / 10.0;
+        clampView();
+        update();
+    }
+    event->accept();
+}
+
+void WaveformView::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton)
+    {
+        m_dragging = true;
+        m_lastMousePos = event->pos();
+        setCursor(Qt::ClosedHandCursor);
+    }
+    QWidget::mousePressEvent(event);
+}
+
+void WaveformView::mouseMoveEvent(QMouseEvent *event)
+{
+    if (m_dragging)
+    {
+        int dx = event->pos().x() - m_lastMousePos.x();
+        m_lastMousePos = event->pos();
+        m_viewStart -= dx * m_nsPerPixel;
+        clampView();
+        update();
+    }
+
+    if (m_data && m_data->rowCount() > 0 && event->pos().x() >= NAME_WIDTH)
+    {
+        double time = timeAtX(event->pos().x());
+        emit cursorMoved(time, m_data->rowAtTime(time));
+    }
+    QWidget::mouseMoveEvent(event);
+}
+
+void WaveformView::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton)
+    {
+        m_dragging = false;
+        unsetCursor();
+    }
+    QWidget::mouseReleaseEvent(event);
+}
+
+void WaveformView::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    if (m_data && m_data->rowCount() > 0 && event->pos().x() >= NAME_WIDTH)
+    {
+        int row = m_data->rowAtTime(timeAtX(event->pos().x()));
+        qDebug() << "WaveformView::mouseDoubleClickEvent - 双击行:" << row + 1;
+        emit rowActivated(row);
+    }
+    QWidget::mouseDoubleClickEvent(event);
+}
+
+void WaveformView::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    int width = plotWidth();
+
+    if (!m_data || m_data->rowCount() == 0 || m_data->pinCount() == 0)
+    {
+        painter.setPen(Qt::darkGray);
+        painter.drawText(rect(), Qt::AlignCenter, "请在左侧选择要显示的管脚");
+        return;
+    }
+
+    drawRuler(painter, width);
+
+    int firstRow = m_data->rowAtTime(m_viewStart);
+    int lastRow = m_data->rowAtTime(m_viewStart + width * m_nsPerPixel);
+    bool detailed = (lastRow - firstRow + 1) * DETAIL_ROW_PIXELS <= width;
+
+    for (int pin = 0; pin < m_data->pinCount(); ++pin)
+    {
+        int top = RULER_HEIGHT + pin * LANE_HEIGHT;
+        if (top > height())
+            break;
+
+        // 通道背景和名称
+        painter.fillRect(0, top, NAME_WIDTH, LANE_HEIGHT, pin % 2 ? QColor(240, 240, 240) : QColor(230, 240, 250));
+        painter.setPen(Qt::black);
+        painter.drawText(QRect(4, top, NAME_WIDTH - 8, LANE_HEIGHT), Qt::AlignVCenter | Qt::AlignLeft, m_data->pinName(pin));
+        painter.setPen(QColor(220, 220, 220));
+        painter.drawLine(0, top + LANE_HEIGHT - 1, NAME_WIDTH + width, top + LANE_HEIGHT - 1);
+
+        painter.save();
+        painter.setClipRect(NAME_WIDTH, top, width, LANE_HEIGHT);
+        if (detailed)
+            drawDetailedLane(painter, pin, top, firstRow, lastRow);
+        else
+            drawSummaryLane(painter, pin, top, width);
+        painter.restore();
+    }
+}
+
+void WaveformView::drawRuler(QPainter &painter, int plotWidth)
+{
+    painter.fillRect(0, 0, NAME_WIDTH + plotWidth, RULER_HEIGHT, QColor(245, 245, 245));
+    painter.setPen(Qt::darkGray);
+    painter.drawLine(NAME_WIDTH, RULER_HEIGHT - 1, NAME_WIDTH + plotWidth, RULER_HEIGHT - 1);
+
+    // 取1/2/5×10^n的刻度间隔，使相邻刻度约间隔100像素
+    double rawStep = m_nsPerPixel * 100.0;
+    double magnitude = std::pow(10.0, std::floor(std::log10(rawStep)));
+    double step = magnitude;
+    if (rawStep / magnitude >= 5.0)
+        step = magnitude * 5.0;
+    else if (rawStep / magnitude >= 2.0)
+        step = magnitude * 2.0;
+
+    double tick = std::ceil(m_viewStart / step) * step;
+    double viewEnd = m_viewStart + plotWidth * m_nsPerPixel;
+    for (; tick <= viewEnd; tick += step)
+    {
+        int x = xAtTime(tick);
+        painter.drawLine(x, RULER_HEIGHT - 6, x, RULER_HEIGHT - 1);
+        painter.drawText(x + 2, RULER_HEIGHT - 8, formatTime(tick));
+    }
+}
+
+void WaveformView::drawDetailedLane(QPainter &painter, int pinIndex, int top, int firstRow, int lastRow)
+{
+    const QColor driveColor(0, 128, 0);
+    const QColor compareColor(0, 0, 200);
+    const QColor unknownColor(150, 150, 150);
+
+    int previousY = -1;
+    for (int row = firstRow; row <= lastRow; ++row)
+    {
+        WaveformData::PinState state = m_data->pinState(pinIndex, row);
+        bool drive = WaveformData::isDriveState(state);
+
+        // 行边界虚线
+        int rowX = xAtTime(m_data->rowStartTime(row));
+        painter.setPen(QPen(QColor(235, 235, 235), 1, Qt::DotLine));
+        painter.drawLine(rowX, top, rowX, top + LANE_HEIGHT);
+
+        const QList<WaveformSegment> segments = m_data->rowSegments(pinIndex, row);
+        for (const WaveformSegment &segment : segments)
+        {
+            int x1 = xAtTime(segment.start);
+            int x2 = xAtTime(segment.end);
+            int y = levelY(top, segment.level);
+
+            if (segment.level == 2)
+            {
+                // X/Z用灰色填充带表示
+                painter.fillRect(QRect(x1, levelY(top, 1), qMax(1, x2 - x1), levelY(top, 0) - levelY(top, 1)),
+                                 QBrush(unknownColor, Qt::BDiagPattern));
+                painter.setPen(unknownColor);
+                painter.drawLine(x1, y, x2, y);
+            }
+            else
+            {
+                painter.setPen(QPen(drive ? driveColor : compareColor, 2));
+                painter.drawLine(x1, y, x2, y);
+            }
+
+            // 与前一段电平不同则画跳变沿
+            if (previousY >= 0 && previousY != y)
+            {
+                painter.setPen(QPen(drive ? driveColor : compareColor, 2));
+                painter.drawLine(x1, previousY, x1, y);
+            }
+            previousY = y;
+        }
+
+        // 比较状态标出选通位置
+        if (state == WaveformData::StateL || state == WaveformData::StateH)
+        {
+            int strobeX = xAtTime(m_data->rowStrobeTime(pinIndex, row));
+            painter.setPen(QPen(Qt::red, 1));
+            painter.drawLine(strobeX, top + 2, strobeX, top + LANE_HEIGHT - 2);
+        }
+    }
+}
+
+void WaveformView::drawSummaryLane(QPainter &painter, int pinIndex, int top, int plotWidth)
+{
+    const QColor lineColor(0, 128, 0);
+    const QColor busyColor(0, 90, 0);
+    const QColor unknownColor(150, 150, 150);
+
+    int highY = levelY(top, 1);
+    int lowY = levelY(top, 0);
+    int previousY = -1;
+
+    // 每个像素列查询一次金字塔，开销与行数无关
+    for (int px = 0; px < plotWidth; ++px)
+    {
+        double t1 = m_viewStart + px * m_nsPerPixel;
+        double t2 = t1 + m_nsPerPixel;
+        if (t1 >= m_data->totalTime())
+            break;
+
+        int firstRow = m_data->rowAtTime(t1);
+        int lastRow = m_data->rowAtTime(t2);
+        WaveformSummary summary = m_data->summarize(pinIndex, firstRow, lastRow + 1);
+        if (!summary.valid)
+            continue;
+
+        int x = NAME_WIDTH + px;
+        if (summary.minLevel == summary.maxLevel)
+        {
+            int y = levelY(top, summary.minLevel);
+            painter.setPen(summary.minLevel == 2 ? unknownColor : lineColor);
+            painter.drawLine(x, y, x + 1, y);
+            if (previousY >= 0 && previousY != y)
+                painter.drawLine(x, previousY, x, y);
+            previousY = y;
+        }
+        else
+        {
+            // 像素内有跳变：画满高竖线，翻转越密集颜色越深
+            painter.setPen(summary.maxLevel == 2 ? unknownColor : (summary.toggles > 2 ? busyColor : lineColor));
+            painter.drawLine(x, highY, x, lowY);
+            previousY = levelY(top, summary.lastLevel);
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef WAVEFORMVIEW_H
+#define WAVEFORMVIEW_H
+
+#include <QWidget>
+#include <QPoint>
+
+class WaveformData;
+class QPainter;
+
+// 波形绘制控件：细粒度时按TimeSet边沿逐行绘制，缩小后按像素列查询金字塔概要
+class WaveformView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit WaveformView(QWidget *parent = nullptr);
+
+    // 设置波形数据(不接管所有权)
+    void setWaveformData(const WaveformData *data);
+
+    // 缩放与定位
+    void zoomIn();
+    void zoomOut();
+    void zoomToFit();
+    void centerOnRow(int row);
+
+signals:
+    // 鼠标所在位置变化
+    void cursorMoved(double time, int row);
+
+    // 双击某行
+    void rowActivated(int row);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+
+private:
+    void drawRuler(QPainter &painter, int plotWidth);
+    void drawDetailedLane(QPainter &painter, int pinIndex, int top, int firstRow, int lastRow);
+    void drawSummaryLane(QPainter &painter, int pinIndex, int top, int plotWidth);
+    void zoomAt(double factor, int x);
+    void clampView();
+    int plotWidth() const;
+    double timeAtX(int x) const;
+    int xAtTime(double time) const;
+    int levelY(int top, int level) const;
+
+    const WaveformData *m_data;
+    double m_viewStart;  // 可见区域起始时间(ns)
+    double m_nsPerPixel; // 每像素对应的时间(ns)
+    bool m_dragging;
+    QPoint m_lastMousePos;
+};
+
+#endif // WAVEFORMVIEW_H